@@ -49,8 +49,13 @@ extern "C" {
  * INCLUDES
  ******************************************************************************/
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
+
+#include "proto.h"
+#include "shmq.h"
 
 /******************************************************************************
  * DEFINES
@@ -60,11 +65,62 @@ extern "C" {
 #define CLIENT_ERR_PARAM ((int32_t)1)   /**< Client error - parameters error */
 #define CLIENT_ERR_RESOLVE ((int32_t)2) /**< Client error - resolve error */
 #define CLIENT_ERR_CONNECT ((int32_t)3) /**< Client error - connect error */
+#define CLIENT_ERR_SOCKET ((int32_t)4)  /**< Client error - socket error */
+#define CLIENT_ERR_CLOSED ((int32_t)5)  /**< Client error - connection closed */
+#define CLIENT_ERR_INTR ((int32_t)6)    /**< Client error - interrupted */
+#define CLIENT_ERR_SHM ((int32_t)7)     /**< Client error - shared memory ring \
+                                           is not attached */
+
+#define CLIENT_UNIX_PREFIX "unix:" /**< Host prefix of unix socket path */
 
 /******************************************************************************
  * PUBLIC TYPES
  ******************************************************************************/
 
+/** Shared memory delivery of subscriber */
+typedef struct client_shm_s {
+    shmq_t ring;  /**< Ring filled by server */
+    bool backlog; /**< Socket may hold frames sent before ring was attached */
+} client_shm_t;
+
+/** Multicast frame waiting for its turn */
+typedef struct client_mcast_slot_s {
+    uint64_t seq;    /**< Sequence number in group, 0 - empty */
+    uint8_t* p_data; /**< Data frame */
+    size_t len;      /**< Data frame length */
+    size_t cap;      /**< Capacity of p_data */
+} client_mcast_slot_t;
+
+/** Multicast subscription statistics */
+typedef struct client_mcast_stats_s {
+    uint64_t lost;        /**< Frames not recovered by retransmit */
+    uint64_t nacks;       /**< Retransmit requests */
+    uint64_t retransmits; /**< Frames received over TCP */
+    uint64_t dups;        /**< Frames received twice */
+    uint64_t overruns;    /**< Frames ahead of window, asked again */
+} client_mcast_stats_t;
+
+/**
+ * Multicast subscription with gap-fill over TCP.
+ *
+ * Window keeps CONFIG_MCAST_WINDOW frames by sequence number of group, so
+ * reordered datagrams and retransmits are delivered in order.
+ */
+typedef struct client_mcast_s {
+    int fd;                       /**< UDP socket joined to group */
+    client_mcast_slot_t* p_slots; /**< Reorder window */
+    uint64_t next;                /**< Next sequence to deliver, 0 - none */
+    uint64_t high;                /**< Highest seen sequence + 1 */
+    size_t off;                   /**< Delivered part of next frame */
+    uint64_t nack_seq;            /**< First sequence of last request */
+    uint64_t nack_ms;             /**< Time of last request */
+    uint32_t nack_tries;          /**< Requests of nack_seq */
+    bool unicast;                 /**< Server has no group, TCP only */
+    proto_parser_t parser;        /**< Frames from TCP */
+    uint8_t* p_dgram;             /**< Receive buffer */
+    client_mcast_stats_t stats;   /**< Statistics */
+} client_mcast_t;
+
 /******************************************************************************
  * INLINE FUNCTIONS
  ******************************************************************************/
@@ -76,6 +132,33 @@ extern "C" {
 int32_t client_connect(const char* p_host, const char* p_serv,
                        int* p_socket_fd);
 int32_t client_disconnect(int* p_socket_fd);
+int32_t client_send(int socket_fd, uint16_t type, uint64_t seq,
+                    const void* p_buf, size_t len);
+int32_t client_publish(int socket_fd, uint64_t seq, const char* p_topic,
+                       const void* p_buf, size_t len);
+int32_t client_hello(int socket_fd, uint16_t roles,
+                     const char* const* pp_patterns, size_t count);
+int32_t client_hello_replay(int socket_fd, uint16_t roles,
+                            const char* const* pp_patterns, size_t count,
+                            uint64_t seq);
+int32_t client_hello_mcast(int socket_fd, uint16_t roles,
+                           const char* const* pp_patterns, size_t count);
+int32_t client_subscribe(int socket_fd, const char* p_pattern);
+int32_t client_unsubscribe(int socket_fd, const char* p_pattern);
+int32_t client_sendv(int socket_fd, struct iovec* p_iov, size_t iov_count);
+int32_t client_recv(int socket_fd, proto_parser_t* p_parser, void* p_buf,
+                    size_t size);
+int32_t client_shm_open(int socket_fd, client_shm_t* p_shm);
+int32_t client_shm_attached(client_shm_t* p_shm);
+int32_t client_shm_recv(int socket_fd, client_shm_t* p_shm,
+                        proto_parser_t* p_parser, void* p_buf, size_t size,
+                        bool busy);
+void client_shm_close(client_shm_t* p_shm);
+int32_t client_mcast_join(client_mcast_t* p_mc, const char* p_group,
+                          const char* p_port, const char* p_ifaddr);
+int32_t client_mcast_recv(int socket_fd, client_mcast_t* p_mc,
+                          proto_parser_t* p_parser, void* p_buf, size_t size);
+void client_mcast_leave(client_mcast_t* p_mc);
 
 /******************************************************************************
  * END OF HEADER'S CODE
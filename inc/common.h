@@ -49,6 +49,12 @@ extern "C" {
  * INCLUDES
  ******************************************************************************/
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
 /******************************************************************************
  * DEFINES
  ******************************************************************************/
@@ -59,6 +65,8 @@ extern "C" {
 #define COMMON_SOCKET_CLOSED                                                 \
     ((int)0) /**< Return of functions linked with sockets when connection is \
                 closed */
+#define COMMON_UNIX_ABSTRACT \
+    '@' /**< First char of unix socket path in abstract namespace */
 
 /******************************************************************************
  * PUBLIC TYPES
@@ -68,6 +76,41 @@ extern "C" {
  * INLINE FUNCTIONS
  ******************************************************************************/
 
+/**
+ * @brief Build unix socket address from path
+ *
+ * Path starting with COMMON_UNIX_ABSTRACT names socket in abstract
+ * namespace: it has no file and disappears with the last descriptor.
+ *
+ * @param p_path null-terminated path, e.g. "/tmp/srvc.sock" or "@srvc"
+ * @param p_addr output address
+ * @param p_len output address length for bind() / connect()
+ * @return bool true if OK, false if path is empty or too long
+ */
+static inline bool common_unix_addr(const char* p_path,
+                                    struct sockaddr_un* p_addr,
+                                    socklen_t* p_len) {
+    const size_t len = strlen(p_path);
+
+    if ((0 == len) || (len >= sizeof(p_addr->sun_path))) {
+        return false;
+    }
+
+    memset(p_addr, 0x00, sizeof(struct sockaddr_un));
+    p_addr->sun_family = AF_UNIX;
+    memcpy(p_addr->sun_path, p_path, len);
+
+    // NOTE: abstract name is not null-terminated, length tells its end
+    if (COMMON_UNIX_ABSTRACT == p_path[0]) {
+        p_addr->sun_path[0] = '\0';
+        *p_len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + len);
+    } else {
+        *p_len = (socklen_t)sizeof(struct sockaddr_un);
+    }
+
+    return true;
+}
+
 /******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES
  ******************************************************************************/
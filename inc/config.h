@@ -60,7 +60,127 @@ extern "C" {
 #define CONFIG_BUFFER_SIZE ((size_t)1024)  /**< Buffer size for send \ receive \
                                             */
 #define CONFIG_CTRL_PERIOD_SEC ((size_t)2) /**< Controller send period */
+#define CONFIG_CTRL_BATCH ((size_t)64) /**< Paced controller: default max \
+                                          messages per send */
+#define CONFIG_CTRL_REPORT_SEC ((uint64_t)1) /**< Paced controller: report \
+                                                period */
+#define CONFIG_CLIENT_RECV_SIZE ((size_t)65536) /**< Client receive buffer */
+#define CONFIG_BENCH_RATE ((uint64_t)10000) /**< Bench: default msgs/s per \
+                                              controller */
+#define CONFIG_BENCH_DURATION_SEC ((uint64_t)2) /**< Bench: measure time of \
+                                                   one run */
+#define CONFIG_BENCH_BATCH ((uint64_t)64) /**< Bench: max frames per send */
+#define CONFIG_BENCH_PUMP_ROUNDS ((size_t)16) /**< Bench: max batches per \
+                                                 controller wakeup */
+#define CONFIG_BENCH_TICK_US ((uint64_t)1000) /**< Bench: pacing tick */
+#define CONFIG_BENCH_WAIT_MS ((uint64_t)10) /**< Bench: max epoll wait */
+#define CONFIG_BENCH_WARMUP_SEC ((uint64_t)5) /**< Bench: max wait for \
+                                                 subscribers */
+#define CONFIG_BENCH_DRAIN_MS ((uint64_t)1000) /**< Bench: max wait for \
+                                                  frames in flight */
+#define CONFIG_BENCH_IDLE_SETTLE_SEC ((uint64_t)60) /**< Bench: max wait for \
+                                                       idle connections */
+#define CONFIG_BENCH_IDLE_PER_ADDR ((size_t)50000) /**< Bench: idle sockets \
+                                                      per loopback source */
 #define CONFIG_SRV_PORT ((uint16_t)8888)   /** Server port */
+#define CONFIG_SRV_BACKEND SERVER_BACKEND_EPOLL /**< Default reactor backend */
+#define CONFIG_SRV_EVENTS_MAX ((size_t)256) /**< Max events per reactor wait */
+#define CONFIG_SRV_SHARDS ((size_t)1)       /**< Default count of shards */
+#define CONFIG_SRV_INBOX_SIZE ((size_t)4096) /**< Cross-shard queue size */
+#define CONFIG_SRV_INBOX_RETRIES ((size_t)64) /**< Yields to shard with full \
+                                                 inbox before a drop */
+#define CONFIG_MSG_SLAB_PAYLOAD CONFIG_BUFFER_SIZE /**< Max payload of slab \
+                                                     message */
+#define CONFIG_POOL_CACHE_SIZE ((uint32_t)64) /**< Free objects per thread \
+                                                   and pool */
+#define CONFIG_POOL_BATCH ((uint32_t)32) /**< Objects moved between thread \
+                                              cache and pool at once */
+#define CONFIG_POOL_HUGETLB 1 /**< Try explicit huge pages for arenas */
+#define CONFIG_SRV_URING_ENTRIES ((size_t)1024) /**< io_uring SQ size */
+#define CONFIG_SRV_OUTQ_SIZE ((uint32_t)256) /**< Outbound queue of client. \
+                                                Power of 2, up to 32768 */
+#define CONFIG_SRV_OUTQ_MIN ((uint32_t)8) /**< First ring of outbound queue. \
+                                            Power of 2, less than above */
+#define CONFIG_SRV_IOV_MAX ((size_t)16) /**< Max iovecs per client flush */
+#define CONFIG_SRV_FLUSH_BATCH ((size_t)256) /**< Max clients per send batch */
+#define CONFIG_SRV_HISTORY_SIZE ((size_t)1024) /**< Retained messages for \
+                                                  replay, 0 - disabled */
+#define CONFIG_SRV_HISTORY_AGE_SEC ((uint32_t)0) /**< Max age of retained \
+                                                    message, 0 - unlimited */
+#define CONFIG_SRV_SLOW_POLICY SERVER_SLOW_DROP_OLDEST /**< Default policy */
+#define CONFIG_SRV_TICK_MS ((uint64_t)100) /**< Timing wheel tick */
+#define CONFIG_SRV_HEARTBEAT_SEC ((uint32_t)0) /**< Heartbeat period, 0 - \
+                                                  disabled */
+#define CONFIG_SRV_HEARTBEAT_MISSES ((uint32_t)3) /**< Unacked heartbeats \
+                                                     before peer is dead */
+#define CONFIG_SRV_IDLE_SEC ((uint32_t)0) /**< Read timeout, 0 - disabled */
+#define CONFIG_SRV_KEYED_BACKLOG ((uint32_t)32) /**< Keyed policy: backlog \
+                                                   to conflate above */
+#define CONFIG_SRV_RECV_SIZE ((size_t)65536) /**< Shard receive buffer */
+#define CONFIG_SRV_READ_BUDGET ((size_t)262144) /**< Max bytes read from \
+                                                  one client per iteration */
+#define CONFIG_SRV_STATS_PERIOD_SEC ((uint64_t)10) /**< Loop stats period */
+#define CONFIG_LOG_LEVEL LOG_LEVEL_INFO /**< Default log level */
+#define CONFIG_LOG_RING_SIZE ((size_t)262144) /**< Log ring of one thread. \
+                                                 Power of 2 */
+#define CONFIG_LOG_REC_MAX ((size_t)2048) /**< Max binary log record, longer \
+                                             strings are cut */
+#define CONFIG_LOG_LINE_MAX ((size_t)4096) /**< Max formatted log line */
+#define CONFIG_LOG_OUT_SIZE ((size_t)65536) /**< Log writer output batch */
+#define CONFIG_LOG_THREADS_MAX ((size_t)256) /**< Max logging threads */
+#define CONFIG_LOG_FLUSH_US ((long)1000) /**< Log writer idle sleep */
+#define CONFIG_JOURNAL_SEGMENT_SIZE ((size_t)64 * 1024 * 1024) /**< Size \
+                                                  of journal segment file */
+#define CONFIG_JOURNAL_SEGMENTS_MAX ((size_t)16) /**< Kept journal segments */
+#define CONFIG_JOURNAL_QUEUE_SIZE ((size_t)65536) /**< Messages waiting for \
+                                                     journal. Power of 2 */
+#define CONFIG_JOURNAL_BATCH ((size_t)1024) /**< Max records per append pass */
+#define CONFIG_JOURNAL_INDEX_STEP ((uint64_t)64) /**< Records per sparse \
+                                                    index entry */
+#define CONFIG_JOURNAL_SYNC_MS ((uint64_t)10) /**< Max age of not synced \
+                                                 record */
+#define CONFIG_JOURNAL_SYNC_BYTES ((size_t)4 * 1024 * 1024) /**< Sync when \
+                                                    this much is pending */
+#define CONFIG_JOURNAL_IDLE_US ((long)1000) /**< Journal writer idle sleep */
+#define CONFIG_SHM_PREFIX "/srvc_client." /**< Name prefix of shared \
+                                               memory ring of client */
+#define CONFIG_SHM_RING_SIZE ((size_t)1024 * 1024) /**< Shared memory ring \
+                                                      size. Power of 2 */
+#define CONFIG_SHM_SPINS ((uint32_t)2000) /**< Ring checks before sleep */
+#define CONFIG_SHM_BUSY_SPINS ((uint32_t)1000000) /**< Ring checks of busy \
+                                                     poll between socket \
+                                                     checks */
+#define CONFIG_SHM_WAIT_MS ((int)100) /**< Max sleep on ring, then the socket \
+                                         is checked for close */
+#define CONFIG_SHM_ATTACH_MS ((int)1000) /**< Max wait for server to map the \
+                                            ring */
+#define CONFIG_MCAST_TTL ((unsigned char)1) /**< Multicast TTL, 1 - subnet */
+#define CONFIG_MCAST_RING_SIZE ((size_t)65536) /**< Datagrams kept for \
+                                                  retransmit. Power of 2 */
+#define CONFIG_MCAST_DATAGRAM_MAX ((size_t)65507) /**< Max UDP payload, \
+                                                     bigger frames go TCP */
+#define CONFIG_MCAST_WINDOW ((uint64_t)4096) /**< Out of order datagrams \
+                                                kept by subscriber. Power \
+                                                of 2 */
+#define CONFIG_MCAST_NACK_MS ((uint64_t)20) /**< Retransmit request repeat */
+#define CONFIG_MCAST_NACK_RETRIES ((uint32_t)5) /**< Requests before the \
+                                                   gap is counted lost */
+#define CONFIG_MCAST_POLL_MS ((int)100) /**< Subscriber idle wait */
+#define CONFIG_MCAST_RCVBUF ((int)4 * 1024 * 1024) /**< Subscriber socket \
+                                                      receive buffer */
+#define CONFIG_TOPIC_LEN_MAX ((size_t)255) /**< Max topic or pattern length */
+#define CONFIG_TOPIC_SUBS_MAX ((uint32_t)1024) /**< Max patterns of client */
+#define CONFIG_METRICS_SHM_PREFIX "/srvc_server" /**< Metrics segment name \
+                                                    prefix, port is added */
+#define CONFIG_STAT_PERIOD_SEC ((uint64_t)1) /**< srvc_stat default period */
+#define CONFIG_SRV_BACKLOG ((int)4096) /**< Default listen backlog */
+#define CONFIG_SRV_ACCEPT_RATE ((uint32_t)0) /**< Default admitted \
+                                                connections per second, 0 - \
+                                                no limit */
+#define CONFIG_SRV_ACCEPT_BATCH ((size_t)64) /**< Max accepts per iteration */
+#define CONFIG_PROTO_PAYLOAD_MAX ((uint32_t)65536) /**< Max frame payload */
+#define CONFIG_SRV_URING_BUFS ((size_t)1024) /**< io_uring provided buffers. \
+                                                Power of 2 */
 
 /******************************************************************************
  * END OF HEADER'S CODE
@@ -0,0 +1,112 @@
+/**
+ * @file      hist.h
+ *
+ * @brief     HDR-style latency histogram
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup hist
+ *  @{
+ */
+
+#ifndef __HIST_H_
+#define __HIST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define HIST_SUB_BITS ((uint32_t)7) /**< Sub-bucket bits, error < 1/64 */
+#define HIST_SUB_COUNT ((size_t)1 << HIST_SUB_BITS) /**< Sub-buckets */
+#define HIST_HALF_COUNT (HIST_SUB_COUNT / 2) /**< Sub-buckets per octave */
+
+/** Buckets to cover whole uint64_t range */
+#define HIST_BUCKETS \
+    (HIST_SUB_COUNT + ((64 - HIST_SUB_BITS) * HIST_HALF_COUNT))
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Log-linear histogram.
+ *
+ * Values below HIST_SUB_COUNT are exact, every next power of two range is
+ * split into HIST_HALF_COUNT equal buckets. Recording is one array increment.
+ */
+typedef struct hist_s {
+    uint64_t counts[HIST_BUCKETS]; /**< Count per bucket */
+    uint64_t total;                /**< Recorded values */
+    uint64_t min;                  /**< Min recorded value */
+    uint64_t max;                  /**< Max recorded value */
+    double sum;                    /**< Sum of recorded values */
+} hist_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+void hist_reset(hist_t* p_hist);
+void hist_record(hist_t* p_hist, uint64_t value);
+void hist_merge(hist_t* p_dst, const hist_t* p_src);
+void hist_diff(hist_t* p_dst, const hist_t* p_cur, const hist_t* p_prev);
+uint64_t hist_percentile(const hist_t* p_hist, double percentile);
+void hist_print(const hist_t* p_hist, FILE* p_out, const char* p_prefix,
+                double unit);
+void hist_dump(const hist_t* p_hist, FILE* p_out, double unit);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __HIST_H_
+
+/** @}*/
@@ -0,0 +1,132 @@
+/**
+ * @file      history.h
+ *
+ * @brief     Bounded history of recent messages for replay
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup history
+ *  @{
+ */
+
+#ifndef __HISTORY_H_
+#define __HISTORY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "msg.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define HISTORY_ERR_OK ((int32_t)0)     /**< History error - no error */
+#define HISTORY_ERR_PARAMS ((int32_t)1) /**< History error - parameters error */
+#define HISTORY_ERR_NOMEM ((int32_t)2)  /**< History error - no memory */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Retained message. Sequence and time are copied to scan without the data */
+typedef struct history_entry_s {
+    msg_t* p_msg; /**< Message reference */
+    uint64_t seq; /**< Server sequence number */
+    uint64_t ts;  /**< Receive time, ns */
+} history_entry_t;
+
+/**
+ * Ring of the last messages.
+ *
+ * Positions grow forever, entry of a position is at (pos & mask). Every entry
+ * holds a message reference, so retained messages are shared with outbound
+ * queues and cost no copy. Oldest entries are released when the ring is full
+ * or older than max age. Not thread safe.
+ */
+typedef struct history_s {
+    history_entry_t* p_entries; /**< Entries, NULL - history is disabled */
+    uint64_t mask;              /**< Capacity - 1 */
+    uint64_t head;              /**< Position of next message */
+    uint64_t tail;              /**< Position of oldest retained message */
+    uint64_t age_ns;            /**< Max age of message, 0 - unlimited */
+} history_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Get retained entry
+ *
+ * @param p_history pointer to history
+ * @param pos position, tail <= pos < head
+ * @return const history_entry_t* entry or NULL if not retained
+ */
+static inline const history_entry_t* history_get(const history_t* p_history,
+                                                 uint64_t pos) {
+    if ((pos < p_history->tail) || (pos >= p_history->head)) {
+        return NULL;
+    }
+
+    return &p_history->p_entries[pos & p_history->mask];
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t history_init(history_t* p_history, size_t cap, uint64_t age_ns);
+void history_deinit(history_t* p_history);
+bool history_enabled(const history_t* p_history);
+void history_push(history_t* p_history, msg_t* p_msg, uint64_t seq);
+void history_expire(history_t* p_history, uint64_t now);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __HISTORY_H_
+
+/** @}*/
@@ -0,0 +1,200 @@
+/**
+ * @file      journal.h
+ *
+ * @brief     Memory-mapped append-only message journal
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup journal
+ *  @{
+ */
+
+#ifndef __JOURNAL_H_
+#define __JOURNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "msg.h"
+#include "ring.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define JOURNAL_ERR_OK ((int32_t)0)     /**< Journal error - no error */
+#define JOURNAL_ERR_PARAMS ((int32_t)1) /**< Journal error - parameters error */
+#define JOURNAL_ERR_NOMEM ((int32_t)2)  /**< Journal error - no memory */
+#define JOURNAL_ERR_IO ((int32_t)3)     /**< Journal error - file error */
+#define JOURNAL_ERR_FULL ((int32_t)4)   /**< Journal error - queue is full */
+#define JOURNAL_ERR_EMPTY ((int32_t)5)  /**< Journal error - no more records */
+#define JOURNAL_ERR_THREAD ((int32_t)6) /**< Journal error - no writer */
+
+#define JOURNAL_SEG_SUFFIX ".seg" /**< Segment file: <first record>.seg */
+#define JOURNAL_IDX_SUFFIX ".idx" /**< Sparse index of segment */
+#define JOURNAL_NAME_LEN ((size_t)24) /**< File name: 20 digits of record \
+                                         number and suffix */
+#define JOURNAL_DIR_MAX (PATH_MAX - JOURNAL_NAME_LEN - 1) /**< Directory \
+                                         with "/" and file name fits path */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Record header in segment. Followed by the frame and padding to 8 bytes.
+ * Zero size ends data of segment.
+ */
+typedef struct journal_rec_s {
+    uint32_t size; /**< Frame size */
+    uint32_t sum;  /**< FNV-1a of frame, detects torn record */
+    uint64_t seq;  /**< Sequence number of message */
+} journal_rec_t;
+
+/**
+ * Sparse index entry, one per CONFIG_JOURNAL_INDEX_STEP records. Entry N of
+ * segment is valid only if index is first + N * step.
+ */
+typedef struct journal_idx_s {
+    uint64_t index;  /**< Record number in journal */
+    uint64_t offset; /**< Record offset in segment */
+} journal_idx_t;
+
+/** Segment being written */
+typedef struct journal_seg_s {
+    uint64_t first;         /**< Number of first record, file name */
+    int fd;                 /**< Segment file */
+    uint8_t* p_map;         /**< Mapped segment */
+    size_t size;            /**< Segment size */
+    size_t used;            /**< End of written records */
+    size_t synced;          /**< End of synced records */
+    int idx_fd;             /**< Index file */
+    journal_idx_t* p_idx;   /**< Mapped index */
+    size_t idx_cap;         /**< Capacity of index in entries */
+    size_t idx_used;        /**< Written index entries */
+    size_t idx_synced;      /**< Synced index entries */
+} journal_seg_t;
+
+/** Journal writer statistics */
+typedef struct journal_stats_s {
+    uint64_t records;   /**< Appended records */
+    uint64_t bytes;     /**< Appended bytes with headers */
+    uint64_t syncs;     /**< Group commits */
+    uint64_t rotations; /**< Started segments */
+    uint64_t drops;     /**< Messages lost on full queue */
+} journal_stats_t;
+
+/**
+ * Append-only journal of data frames in a directory.
+ *
+ * Shards queue message references with @journal_append, one writer thread
+ * copies frames into mapped preallocated segments and commits them with one
+ * msync per batch, so publishers never wait for disk. Segment is rotated
+ * when next record does not fit, the oldest segments over limit are removed.
+ */
+typedef struct journal_s {
+    char dir[JOURNAL_DIR_MAX];  /**< Journal directory */
+    size_t seg_size;            /**< Size of new segment */
+    size_t segs_max;            /**< Max count of segments */
+    uint64_t* p_segs;           /**< First records of segments, ascending */
+    size_t segs_count;          /**< Count of segments */
+    size_t segs_cap;            /**< Capacity of segments list */
+    journal_seg_t seg;          /**< Last segment, written */
+    uint64_t next;              /**< Number of next record */
+    ring_mpsc_t queue;          /**< Messages from shards */
+    pthread_t thread;           /**< Writer thread */
+    atomic_bool running;        /**< Writer should keep running */
+    atomic_uint_fast64_t drops; /**< Messages lost on full queue */
+    journal_stats_t stats;      /**< Writer statistics */
+} journal_t;
+
+/** Reader of records. Maps segments read-only one by one */
+typedef struct journal_iter_s {
+    const journal_t* p_journal; /**< Journal */
+    size_t seg;                 /**< Position in segments list */
+    const uint8_t* p_map;       /**< Mapped segment or NULL */
+    size_t size;                /**< Size of mapped segment */
+    size_t off;                 /**< Offset of next record */
+    uint64_t index;             /**< Number of next record */
+} journal_iter_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Get number of the oldest retained record
+ *
+ * @param p_journal pointer to journal
+ * @return uint64_t record number
+ */
+static inline uint64_t journal_first(const journal_t* p_journal) {
+    return (p_journal->segs_count > 0) ? p_journal->p_segs[0] : p_journal->next;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t journal_open(journal_t* p_journal, const char* p_dir, size_t seg_size,
+                     size_t segs_max);
+int32_t journal_start(journal_t* p_journal);
+void journal_close(journal_t* p_journal);
+int32_t journal_append(journal_t* p_journal, msg_t* p_msg);
+int32_t journal_iter_init(const journal_t* p_journal, journal_iter_t* p_iter,
+                          uint64_t from);
+int32_t journal_iter_next(journal_iter_t* p_iter, const uint8_t** pp_frame,
+                          size_t* p_size, uint64_t* p_seq);
+void journal_iter_deinit(journal_iter_t* p_iter);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __JOURNAL_H_
+
+/** @}*/
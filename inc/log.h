@@ -0,0 +1,125 @@
+/**
+ * @file      log.h
+ *
+ * @brief     Asynchronous logging
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup log
+ *  @{
+ */
+
+#ifndef __LOG_H_
+#define __LOG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define LOG_ERR_OK ((int32_t)0)     /**< Log error - no error */
+#define LOG_ERR_PARAMS ((int32_t)1) /**< Log error - parameters error */
+#define LOG_ERR_THREAD ((int32_t)2) /**< Log error - cannot start writer */
+
+#define LOG_LEVEL_ERROR ((int)0) /**< Errors, written to stderr */
+#define LOG_LEVEL_WARN ((int)1)  /**< Warnings, written to stderr */
+#define LOG_LEVEL_INFO ((int)2)  /**< Connection and state events */
+#define LOG_LEVEL_DEBUG ((int)3) /**< Per message events */
+
+/** Check level before arguments are evaluated */
+#define LOG_ENABLED(level) ((level) <= g_log_level)
+
+/**
+ * Log record if level is enabled. Disabled call costs one compare.
+ *
+ * Format must be a string literal: only pointer to it is queued. Supported
+ * conversions are d i u o x X c s p e f g a with any flags, width, precision
+ * and length modifiers; %s arguments are copied. Newline is appended.
+ */
+#define LOG_WRITE(level, ...)              \
+    do {                                   \
+        if (LOG_ENABLED(level)) {          \
+            log_write((level), __VA_ARGS__); \
+        }                                  \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_WRITE(LOG_LEVEL_ERROR, __VA_ARGS__) /**< Error */
+#define LOG_WARN(...) LOG_WRITE(LOG_LEVEL_WARN, __VA_ARGS__)   /**< Warning */
+#define LOG_INFO(...) LOG_WRITE(LOG_LEVEL_INFO, __VA_ARGS__)   /**< Info */
+#define LOG_DEBUG(...) LOG_WRITE(LOG_LEVEL_DEBUG, __VA_ARGS__) /**< Debug */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+extern int g_log_level; /**< Max enabled level */
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t log_init(int level);
+void log_deinit(void);
+void log_flush(void);
+int32_t log_level_parse(const char* p_name, int* p_level);
+void log_write(int level, const char* p_fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __LOG_H_
+
+/** @}*/
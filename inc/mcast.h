@@ -0,0 +1,121 @@
+/**
+ * @file      mcast.h
+ *
+ * @brief     Multicast publisher with retransmit store
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup mcast
+ *  @{
+ */
+
+#ifndef __MCAST_H_
+#define __MCAST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "msg.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define MCAST_ERR_OK ((int32_t)0)     /**< Multicast error - no error */
+#define MCAST_ERR_PARAMS ((int32_t)1) /**< Multicast error - parameters error */
+#define MCAST_ERR_NOMEM ((int32_t)2)  /**< Multicast error - no memory */
+#define MCAST_ERR_SOCKET ((int32_t)3) /**< Multicast error - socket error */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Multicast statistics, updated by publishing thread */
+typedef struct mcast_stats_s {
+    uint64_t sent;     /**< Datagrams sent */
+    uint64_t errors;   /**< Datagrams not sent */
+    uint64_t oversize; /**< Frames too big for datagram, TCP only */
+} mcast_stats_t;
+
+/**
+ * Multicast publisher.
+ *
+ * Every data frame is sent once to the group wrapped in a PROTO_TYPE_MCAST
+ * frame with own sequence number, so egress cost does not depend on count
+ * of subscribers. Sent datagrams are kept in a ring for retransmit over TCP:
+ * the same message is queued to the subscriber that reported a gap.
+ * Only one thread publishes, any thread may take messages for retransmit.
+ */
+typedef struct mcast_s {
+    int fd;                   /**< UDP socket */
+    struct sockaddr_in group; /**< Group address and port */
+    pthread_mutex_t lock;     /**< Guards ring against retransmit readers */
+    msg_t** pp_ring;          /**< Sent datagrams by sequence number */
+    uint64_t mask;            /**< Ring size - 1 */
+    uint64_t seq;             /**< Last assigned sequence number */
+    mcast_stats_t stats;      /**< Statistics */
+} mcast_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t mcast_open(mcast_t* p_mcast, const char* p_group, const char* p_port,
+                   const char* p_ifaddr, size_t ring_size);
+void mcast_close(mcast_t* p_mcast);
+int32_t mcast_publish(mcast_t* p_mcast, const msg_t* p_frame);
+msg_t* mcast_get(mcast_t* p_mcast, uint64_t seq);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __MCAST_H_
+
+/** @}*/
@@ -0,0 +1,187 @@
+/**
+ * @file      metrics.h
+ *
+ * @brief     Server metrics in shared memory
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup metrics
+ *  @{
+ */
+
+#ifndef __METRICS_H_
+#define __METRICS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hist.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define METRICS_ERR_OK ((int32_t)0)      /**< Metrics error - no error */
+#define METRICS_ERR_PARAMS ((int32_t)1)  /**< Metrics error - parameters */
+#define METRICS_ERR_SHM ((int32_t)2)     /**< Metrics error - shm error */
+#define METRICS_ERR_VERSION ((int32_t)3) /**< Metrics error - bad segment */
+
+#define METRICS_MAGIC ((uint32_t)0x53525643) /**< Segment magic, "SRVC" */
+#define METRICS_VERSION ((uint32_t)2)        /**< Layout version */
+#define METRICS_NAME_SIZE ((size_t)64)       /**< Max segment name length */
+#define METRICS_CACHE_LINE ((size_t)64)      /**< Cache line size */
+
+/** Size of segment for shards count */
+#define METRICS_SIZE(shards) \
+    (sizeof(metrics_t) + ((size_t)(shards) * sizeof(metrics_shard_t)))
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Counter written by one shard thread, read by other processes */
+typedef _Atomic uint64_t metrics_counter_t;
+
+/**
+ * Metrics of one shard.
+ *
+ * Every shard writes only own block and blocks are cache line aligned, so
+ * shards never share a line. Histograms are updated without atomics: a reader
+ * may see one of concurrent records partially applied.
+ */
+typedef struct metrics_shard_s {
+    _Alignas(METRICS_CACHE_LINE) metrics_counter_t conns; /**< Open now */
+    metrics_counter_t pubs;         /**< Open with publisher role */
+    metrics_counter_t subs;         /**< Open with subscriber role */
+    metrics_counter_t accepts;      /**< Accepted connections */
+    metrics_counter_t rejects;      /**< Closed by admission limit */
+    metrics_counter_t closes;       /**< Closed connections */
+    metrics_counter_t msgs_in;      /**< Frames received from clients */
+    metrics_counter_t bytes_in;     /**< Bytes received from clients */
+    metrics_counter_t msgs_out;     /**< Frames completely sent to clients */
+    metrics_counter_t bytes_out;    /**< Bytes sent to clients */
+    metrics_counter_t send_errors;  /**< Sends failed with error */
+    metrics_counter_t queued;       /**< Frames in outbound queues now */
+    metrics_counter_t drops;        /**< Slow clients and full inboxes of
+                                         other shards: dropped frames */
+    metrics_counter_t conflations;  /**< Slow clients: conflated frames */
+    metrics_counter_t slow_closes;  /**< Slow clients: disconnects */
+    metrics_counter_t inbox;        /**< Frames taken from other shards */
+    metrics_counter_t loops;        /**< Event loop iterations */
+    metrics_counter_t wakeups;      /**< Iterations with ready events */
+    _Alignas(METRICS_CACHE_LINE) hist_t recv_lag; /**< Publisher send to
+                                                       server read, ns */
+    hist_t queue_wait; /**< Age of oldest queued frame on flush, ns */
+} metrics_shard_t;
+
+/** Shared memory segment */
+typedef struct metrics_s {
+    uint32_t magic;     /**< METRICS_MAGIC, written last on create */
+    uint32_t version;   /**< METRICS_VERSION */
+    uint32_t shards;    /**< Count of shard blocks */
+    int32_t pid;        /**< Server process */
+    uint64_t start_ns;  /**< Server start, CLOCK_MONOTONIC */
+    uint16_t port;      /**< Server port */
+    metrics_shard_t shard[]; /**< Per shard blocks */
+} metrics_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Add to counter. Only owner shard writes, so no locked instruction
+ *
+ * @param p_counter pointer to counter
+ * @param value value to add
+ */
+static inline void metrics_add(metrics_counter_t* p_counter, uint64_t value) {
+    atomic_store_explicit(
+        p_counter,
+        atomic_load_explicit(p_counter, memory_order_relaxed) + value,
+        memory_order_relaxed);
+}
+
+/**
+ * @brief Subtract from gauge. Only owner shard writes
+ *
+ * @param p_counter pointer to gauge
+ * @param value value to subtract
+ */
+static inline void metrics_sub(metrics_counter_t* p_counter, uint64_t value) {
+    atomic_store_explicit(
+        p_counter,
+        atomic_load_explicit(p_counter, memory_order_relaxed) - value,
+        memory_order_relaxed);
+}
+
+/**
+ * @brief Read counter
+ *
+ * @param p_counter pointer to counter
+ * @return uint64_t value
+ */
+static inline uint64_t metrics_get(const metrics_counter_t* p_counter) {
+    return atomic_load_explicit((metrics_counter_t*)p_counter,
+                                memory_order_relaxed);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+void metrics_name(char* p_name, uint16_t port);
+int32_t metrics_create(metrics_t** pp_metrics, uint16_t port, size_t shards);
+int32_t metrics_open(const metrics_t** pp_metrics, size_t* p_size,
+                     uint16_t port);
+void metrics_close(const metrics_t* p_metrics, size_t size);
+void metrics_unlink(uint16_t port);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __METRICS_H_
+
+/** @}*/
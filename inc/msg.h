@@ -0,0 +1,124 @@
+/**
+ * @file      msg.h
+ *
+ * @brief     Refcounted immutable messages
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup msg
+ *  @{
+ */
+
+#ifndef __MSG_H_
+#define __MSG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define MSG_ERR_OK ((int32_t)0)     /**< Message error - no error */
+#define MSG_ERR_PARAMS ((int32_t)1) /**< Message error - parameters error */
+#define MSG_ERR_NOMEM ((int32_t)2)  /**< Message error - no memory */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Message shared by all subscribers.
+ *
+ * Filled once by owner, then immutable. Every queue holding the message owns
+ * one reference, the last @msg_unref returns memory to the pool.
+ */
+typedef struct msg_s {
+    atomic_uint refcnt; /**< References count */
+    uint32_t slab_idx;  /**< Size class or MSG_SLAB_NONE */
+    size_t len;         /**< Payload length */
+    uint64_t ts;        /**< Owner defined timestamp, e.g. receive time */
+    uint64_t seq;       /**< Owner defined sequence number */
+    uint8_t data[];     /**< Payload */
+} msg_t;
+
+/** Message pools statistics */
+typedef struct msg_stats_s {
+    size_t slabs;     /**< Slab objects carved so far */
+    size_t in_use;    /**< Messages alive (slab and heap) */
+    size_t heap;      /**< Alive messages too big for slab */
+} msg_stats_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Take reference to message
+ *
+ * @param p_msg pointer to message
+ * @return msg_t* the same message
+ */
+static inline msg_t* msg_ref(msg_t* p_msg) {
+    atomic_fetch_add_explicit(&p_msg->refcnt, 1, memory_order_relaxed);
+    return p_msg;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+msg_t* msg_alloc(size_t len);
+msg_t* msg_create(const void* p_buf, size_t len);
+void msg_unref(msg_t* p_msg);
+void msg_stats(msg_stats_t* p_stats);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __MSG_H_
+
+/** @}*/
@@ -0,0 +1,128 @@
+/**
+ * @file      pool.h
+ *
+ * @brief     Size-class slab pools with per-thread caches
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup pool
+ *  @{
+ */
+
+#ifndef __POOL_H_
+#define __POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+
+#define POOL_MAX ((uint32_t)16) /**< Max count of pools with thread caches */
+#define POOL_NAME_SIZE ((size_t)16) /**< Max pool name length with '\0' */
+
+/** Static initializer of pool of objects of given size */
+#define POOL_INITIALIZER(name, obj_size) \
+    {.p_name = (name), .size = (obj_size), .lock = PTHREAD_MUTEX_INITIALIZER}
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Pool of objects of one size class.
+ *
+ * Objects are carved from 2 MiB arena chunks (huge pages where available)
+ * and never returned to the system. Every thread keeps a small cache of
+ * free objects per pool, so allocation and free are a few instructions;
+ * the shared free list is locked only to move a batch between it and a
+ * cache. Registration on first use gives the pool its cache index.
+ */
+typedef struct pool_s {
+    const char* p_name;   /**< Name for statistics */
+    size_t size;          /**< Object size */
+    size_t stride;        /**< Object size rounded up to cache line */
+    atomic_uint id;       /**< Thread cache index + 1, 0 - not registered */
+    pthread_mutex_t lock; /**< Guards shared free list and counters */
+    void* p_free;         /**< Shared free list, linked through object */
+    size_t free_count;    /**< Objects in shared free list */
+    size_t objects;       /**< Carved objects */
+    size_t chunks;        /**< Arena chunks */
+    size_t huge_chunks;   /**< Arena chunks backed by huge pages */
+} pool_t;
+
+/** Pool usage statistics */
+typedef struct pool_stats_s {
+    char name[POOL_NAME_SIZE]; /**< Pool name */
+    size_t size;               /**< Object size */
+    size_t objects;            /**< Carved objects */
+    size_t used;               /**< In use or in thread caches */
+    size_t chunks;             /**< Arena chunks */
+    size_t huge_chunks;        /**< Arena chunks backed by huge pages */
+} pool_stats_t;
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+void* pool_alloc(pool_t* p_pool);
+void pool_free(pool_t* p_pool, void* p_obj);
+void pool_usage(pool_t* p_pool, pool_stats_t* p_stats);
+size_t pool_stats(pool_stats_t* p_stats, size_t max);
+void* pool_arena_alloc(size_t size, bool* p_huge);
+void pool_arena_free(void* p_arena, size_t size);
+void* pool_reserve_alloc(size_t size);
+void pool_reserve_free(void* p_area, size_t size);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __POOL_H_
+
+/** @}*/
@@ -0,0 +1,186 @@
+/**
+ * @file      proto.h
+ *
+ * @brief     Framed wire protocol
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup proto
+ *  @{
+ */
+
+#ifndef __PROTO_H_
+#define __PROTO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define PROTO_ERR_OK ((int32_t)0)     /**< Protocol error - no error */
+#define PROTO_ERR_PARAMS ((int32_t)1) /**< Protocol error - parameters error */
+#define PROTO_ERR_NOMEM ((int32_t)2)  /**< Protocol error - no memory */
+#define PROTO_ERR_AGAIN ((int32_t)3)  /**< Protocol error - need more data */
+#define PROTO_ERR_FRAME ((int32_t)4)  /**< Protocol error - malformed frame */
+
+#define PROTO_HDR_SIZE ((size_t)24) /**< Size of encoded header */
+
+#define PROTO_TYPE_DATA ((uint16_t)1) /**< Frame type - data to retranslate */
+#define PROTO_TYPE_SUB ((uint16_t)2)  /**< Frame type - subscribe, payload is \
+                                         topic pattern */
+#define PROTO_TYPE_UNSUB ((uint16_t)3) /**< Frame type - unsubscribe, payload \
+                                          is topic pattern */
+#define PROTO_TYPE_HELLO ((uint16_t)4) /**< Frame type - role handshake */
+#define PROTO_TYPE_SHM ((uint16_t)5) /**< Frame type - deliver via shared \
+                                        memory ring, payload is ring name */
+#define PROTO_TYPE_MCAST ((uint16_t)6) /**< Frame type - multicast datagram \
+                                          or its retransmit, payload is data \
+                                          frame */
+#define PROTO_TYPE_NACK ((uint16_t)7) /**< Frame type - retransmit request, \
+                                         flags is count from seq */
+#define PROTO_TYPE_PING ((uint16_t)8) /**< Frame type - server heartbeat, \
+                                         no payload, to be ignored */
+
+#define PROTO_ROLE_PUB ((uint16_t)0x01) /**< Hello role - sends data frames */
+#define PROTO_ROLE_SUB ((uint16_t)0x02) /**< Hello role - receives data */
+#define PROTO_ROLE_BOTH \
+    (PROTO_ROLE_PUB | PROTO_ROLE_SUB) /**< Hello role - both, as without hello */
+#define PROTO_HELLO_REPLAY \
+    ((uint16_t)0x0100) /**< Hello flag - replay history from seq first */
+#define PROTO_HELLO_MCAST \
+    ((uint16_t)0x0200) /**< Hello flag - data comes from multicast group */
+
+/** Topic length of data frame, topic is the head of payload */
+#define PROTO_TOPIC_LEN(p_hdr) ((size_t)(p_hdr)->flags)
+
+/** Full size of frame with header */
+#define PROTO_FRAME_SIZE(p_hdr) (PROTO_HDR_SIZE + (size_t)(p_hdr)->len)
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Frame header in host byte order.
+ *
+ * On the wire all fields are big-endian:
+ * | len (4) | type (2) | flags (2) | seq (8) | ts (8) | payload (len) |
+ *
+ * Flags of data frame is topic length: payload starts with topic bytes,
+ * 0 - no topic. Pattern of subscription ending with '*' matches all topics
+ * with the same prefix.
+ *
+ * Flags of hello frame is mask of PROTO_ROLE_*, payload is '\n' separated
+ * topic patterns to subscribe. Connection without hello has both roles. With
+ * PROTO_HELLO_REPLAY subscriber first gets retained messages with sequence
+ * number not less than seq of hello.
+ *
+ * Shm frame is sent by same-host subscriber before hello. Server maps the
+ * named ring and delivers frames through it instead of the socket, which
+ * then carries only the close. If the ring can't be mapped, delivery stays
+ * on the socket.
+ *
+ * With PROTO_HELLO_MCAST subscriber gets data frames from multicast group
+ * only. Every datagram is a multicast frame: seq is own sequence of group,
+ * payload is data frame. Subscriber asks for missed ones with nack frame
+ * (seq is the first, flags is count) and gets them over TCP as the same
+ * multicast frames.
+ */
+typedef struct proto_hdr_s {
+    uint32_t len;   /**< Payload length without header */
+    uint16_t type;  /**< PROTO_TYPE_* */
+    uint16_t flags; /**< Type specific flags */
+    uint64_t seq;   /**< Sequence number set by publisher */
+    uint64_t ts;    /**< Publisher CLOCK_MONOTONIC send time in ns, 0 - none */
+} proto_hdr_t;
+
+/** Parsed frame. Points into parser input or parser buffer */
+typedef struct proto_frame_s {
+    proto_hdr_t hdr;          /**< Decoded header */
+    const uint8_t* p_data;    /**< Whole encoded frame, header included */
+    const uint8_t* p_payload; /**< Payload, hdr.len bytes */
+} proto_frame_t;
+
+/**
+ * Incremental parser.
+ *
+ * Complete frames are returned as views into the fed input, only a frame
+ * split between two reads is copied to own buffer.
+ */
+typedef struct proto_parser_s {
+    uint8_t* p_buf;       /**< Partial frame storage, allocated on demand */
+    size_t cap;           /**< Capacity of storage */
+    size_t len;           /**< Bytes of partial frame in storage */
+    const uint8_t* p_in;  /**< Borrowed input not parsed yet */
+    size_t in_len;        /**< Length of input not parsed yet */
+} proto_parser_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+uint64_t proto_ts_now(void);
+
+void proto_hdr_encode(uint8_t* p_dst, const proto_hdr_t* p_hdr);
+void proto_hdr_decode(const uint8_t* p_src, proto_hdr_t* p_hdr);
+
+void proto_parser_init(proto_parser_t* p_parser);
+void proto_parser_deinit(proto_parser_t* p_parser);
+void proto_parser_feed(proto_parser_t* p_parser, const void* p_buf,
+                       size_t len);
+int32_t proto_parser_next(proto_parser_t* p_parser, proto_frame_t* p_frame);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __PROTO_H_
+
+/** @}*/
@@ -0,0 +1,115 @@
+/**
+ * @file      ring.h
+ *
+ * @brief     Lock-free rings
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup ring
+ *  @{
+ */
+
+#ifndef __RING_H_
+#define __RING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define RING_ERR_OK ((int32_t)0)     /**< Ring error - no error */
+#define RING_ERR_PARAMS ((int32_t)1) /**< Ring error - parameters error */
+#define RING_ERR_NOMEM ((int32_t)2)  /**< Ring error - no memory */
+#define RING_ERR_FULL ((int32_t)3)   /**< Ring error - ring is full */
+#define RING_ERR_EMPTY ((int32_t)4)  /**< Ring error - ring is empty */
+
+#define RING_CACHE_LINE ((size_t)64) /**< Cache line size for padding */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Ring cell. Sequence tells which lap of the ring owns the cell */
+typedef struct ring_cell_s {
+    atomic_size_t seq; /**< Cell sequence */
+    void* p_data;      /**< Stored pointer */
+} ring_cell_t;
+
+/**
+ * Bounded multi-producer single-consumer ring of pointers.
+ *
+ * Producers reserve a cell by CAS on head, consumer owns tail exclusively.
+ * No locks and no allocations after init.
+ */
+typedef struct ring_mpsc_s {
+    alignas(RING_CACHE_LINE) atomic_size_t head; /**< Enqueue position */
+    alignas(RING_CACHE_LINE) atomic_size_t tail; /**< Dequeue position */
+    alignas(RING_CACHE_LINE) ring_cell_t* p_cells; /**< Cells */
+    size_t mask;                                    /**< Capacity - 1 */
+} ring_mpsc_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t ring_mpsc_init(ring_mpsc_t* p_ring, size_t capacity);
+int32_t ring_mpsc_deinit(ring_mpsc_t* p_ring);
+int32_t ring_mpsc_push(ring_mpsc_t* p_ring, void* p_data);
+int32_t ring_mpsc_pop(ring_mpsc_t* p_ring, void** pp_data);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __RING_H_
+
+/** @}*/
@@ -53,8 +53,14 @@ extern "C" {
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include "msg.h"
+#include "proto.h"
+#include "shmq.h"
+#include "twheel.h"
+
 /******************************************************************************
  * DEFINES
  ******************************************************************************/
@@ -63,36 +69,204 @@ extern "C" {
 #define SERVER_ERR_NG ((int32_t)1)     /**< Server error - general error */
 #define SERVER_ERR_PARAMS ((int32_t)2) /**< Server error - parameters error*/
 #define SERVER_ERR_SOCKET ((int32_t)3) /**< Server error - socket error*/
+#define SERVER_ERR_AGAIN ((int32_t)4)  /**< Server error - try again later */
+#define SERVER_ERR_FULL ((int32_t)5)   /**< Server error - queue is full */
+#define SERVER_ERR_EXIST ((int32_t)6)  /**< Server error - unix path is in use \
+                                            or not a socket */
+
+#define SERVER_UNIX_PATH_SIZE ((size_t)108) /**< Size of sun_path with '\0' */
+
+#define SERVER_EV_READ ((uint32_t)0x01)  /**< Reactor event - readable */
+#define SERVER_EV_WRITE ((uint32_t)0x02) /**< Reactor event - writable */
+#define SERVER_EV_ERROR ((uint32_t)0x04) /**< Reactor event - error / hangup */
+#define SERVER_EV_ACCEPT                                                    \
+    ((uint32_t)0x08) /**< Reactor event - connection accepted by backend. \
+                        As interest: backend may accept on its own */
+#define SERVER_EV_DATA                                                     \
+    ((uint32_t)0x10) /**< Reactor event - data received by backend. As \
+                        interest: backend may receive on its own */
+
+#define SERVER_CLIENT_F_DIRTY ((uint32_t)0x01) /**< Client - in flush list */
+#define SERVER_CLIENT_F_WRITE \
+    ((uint32_t)0x02) /**< Client - waits for writability */
+#define SERVER_CLIENT_F_READ \
+    ((uint32_t)0x04) /**< Client - unread data left after fairness budget */
+#define SERVER_CLIENT_F_TOPICS \
+    ((uint32_t)0x08) /**< Client - subscribed to topics, not to everything */
+#define SERVER_CLIENT_F_PUB \
+    ((uint32_t)0x10) /**< Client - publisher, its data frames are relayed */
+#define SERVER_CLIENT_F_SUB \
+    ((uint32_t)0x20) /**< Client - subscriber, gets data frames */
+#define SERVER_CLIENT_F_HELLO \
+    ((uint32_t)0x40) /**< Client - roles are set by hello */
+#define SERVER_CLIENT_F_REPLAY \
+    ((uint32_t)0x80) /**< Client - gets history, live fanout skips it */
+#define SERVER_CLIENT_F_SHM_WAIT \
+    ((uint32_t)0x100) /**< Client - shared memory ring is full, retry */
+#define SERVER_CLIENT_F_MCAST \
+    ((uint32_t)0x200) /**< Client - gets data from multicast group */
+
+/** Build client ID from table slot and slot generation */
+#define SERVER_ID(slot, gen) ((((uint64_t)(gen)) << 32) | (uint64_t)(slot))
+/** Get table slot from client ID */
+#define SERVER_ID_SLOT(id) ((uint32_t)((id) & 0xFFFFFFFFu))
 
 /******************************************************************************
  * PUBLIC TYPES
  ******************************************************************************/
 
+/** Reactor backend */
+typedef enum server_backend_e {
+    SERVER_BACKEND_POLL = 0, /**< poll() - portable fallback */
+    SERVER_BACKEND_EPOLL,    /**< epoll() edge-triggered - O(ready fds) */
+    SERVER_BACKEND_URING,    /**< io_uring - completions, batched submits */
+} server_backend_t;
+
+/** What to do when outbound queue of slow client is full */
+typedef enum server_slow_policy_e {
+    SERVER_SLOW_DROP_OLDEST = 0, /**< Drop oldest not started message */
+    SERVER_SLOW_DISCONNECT,      /**< Disconnect client */
+    SERVER_SLOW_CONFLATE,        /**< Replace newest queued message */
+    SERVER_SLOW_KEYED,           /**< Replace queued message of same topic */
+} server_slow_policy_t;
+
 /** Server config structure */
 typedef struct server_conf_s {
-    uint16_t port; /**< Server port. 0 < PORT < 65355 */
-    uint32_t addr; /**< Server address. For local use INADDR_ANY */
+    uint16_t port;            /**< Server port. 0 < PORT < 65355 */
+    uint32_t addr;            /**< Server address. For local use INADDR_ANY */
+    server_backend_t backend; /**< Reactor backend for the event loop */
+    bool reuseport;           /**< Share port between listeners (shards) */
+    server_slow_policy_t slow_policy; /**< Policy for slow clients */
+    uint32_t keyed_backlog;   /**< Keyed policy: conflate above this backlog */
+    uint32_t heartbeat_ms;    /**< Heartbeat to silent subscriber, 0 - none */
+    uint32_t idle_ms;         /**< Close client not sending that long, 0 - no */
+    int backlog;              /**< Listen backlog. Capped by somaxconn */
+    uint32_t accept_rate;     /**< Admitted connections per second, 0 - all */
+    size_t history_size;      /**< Retained messages for replay, 0 - none */
+    uint32_t history_age_sec; /**< Max age of retained message, 0 - any */
+    char unix_path[SERVER_UNIX_PATH_SIZE]; /**< Unix socket listener, '@' -
+                                              abstract namespace, "" - none */
 } server_conf_t;
 
 /** Server handle structure */
 typedef struct server_handle_s {
     int socket_fd;               /**< Socket file descriptor */
+    int unix_fd;                 /**< Unix socket listener or -1 */
+    uint32_t accept_turn;        /**< Listener to accept from first */
     struct sockaddr_in sockaddr; /**< Internet sockaddr structure */
     size_t max_clients;          /**< Max clients */
     server_conf_t conf;          /**< Config structure. See @server_conf_t */
 } server_handle_t;
 
-/** Client structure for use with server */
+/**
+ * Bounded outbound ring of client. Holds references to shared messages.
+ *
+ * Ring and last-value index come from pools on first push and go back when
+ * the queue drains, so an idle client holds no send memory. A small first
+ * ring takes a single frame or a short burst and grows into a full one.
+ */
+typedef struct server_outq_s {
+    msg_t** pp_msgs;                /**< Ring, NULL while queue is empty */
+    uint32_t* p_last;               /**< Last-value index: ring position + 1
+                                       of newest entry per topic hash */
+    uint32_t sent;                  /**< Already sent bytes of oldest entry */
+    uint16_t head;                  /**< Index of oldest entry */
+    uint16_t count;                 /**< Count of entries */
+    uint16_t cap;                   /**< Ring size, 0 while queue is empty */
+} server_outq_t;
+
+/** Client state only some clients need, allocated on demand */
+typedef struct server_client_ext_s {
+    shmq_t* p_shm;               /**< Shared memory ring, NULL - socket */
+    uint64_t replay_pos;         /**< Next history position to replay */
+    uint64_t replay_seq;         /**< Replay messages from this sequence */
+} server_client_ext_t;
+
+/**
+ * Client structure for use with server.
+ *
+ * Kept small for many idle connections: partial inbound frame, outbound
+ * ring and rare state live in pooled objects only while needed.
+ */
 typedef struct server_client_s {
     int socket_fd;               /**< Socket file descriptor */
-    struct sockaddr_in sockaddr; /**< Internet sockaddr structure */
-    int sockaddr_len;            /**< Internet sockaddr structure length */
+    uint32_t flags;              /**< Mask of SERVER_CLIENT_F_* */
+    uint64_t id;                 /**< Stable ID, set by connection table */
+    server_outq_t outq;          /**< Outbound queue */
+    twheel_node_t timer;         /**< Idle and heartbeat timer */
+    proto_parser_t* p_rx;        /**< Partial inbound frame or NULL */
+    server_client_ext_t* p_ext;  /**< Rare state or NULL */
+    uint32_t rx_ms;              /**< Time of last read, loop clock low bits */
+    uint32_t tx_ms;              /**< Time of last queued frame, loop clock
+                                      low bits */
+    uint32_t live_idx;           /**< Position in live list of table */
+    uint32_t drops;              /**< Messages dropped or conflated */
 } server_client_t;
 
+/**
+ * Connection table.
+ *
+ * Slots are taken from a free-list and live slots are kept dense, so add and
+ * remove are O(1) and iteration touches only connected clients. Slot of a
+ * client never moves, its ID also carries a generation to detect reuse.
+ * Arrays are reserved for all slots but a slot is touched only when taken
+ * first time, so unused capacity costs address space, not memory.
+ */
+typedef struct server_table_s {
+    server_client_t* p_slots; /**< Clients by slot */
+    uint32_t* p_free;         /**< Stack of released slots */
+    uint32_t free_count;      /**< Count of released slots */
+    uint32_t* p_live;         /**< Slots in use, dense */
+    uint32_t live_count;      /**< Count of slots in use */
+    uint32_t used;            /**< Slots taken at least once */
+    uint32_t cap;             /**< Count of slots */
+} server_table_t;
+
+/** Reactor event returned by @server_reactor_wait */
+typedef struct server_event_s {
+    uint64_t data;        /**< User data passed on registration */
+    uint32_t events;      /**< Mask of SERVER_EV_* */
+    int32_t res;          /**< EV_ACCEPT: new fd, EV_DATA: length or -errno */
+    const uint8_t* p_buf; /**< EV_DATA: received bytes */
+    uint32_t buf_id;      /**< EV_DATA: backend buffer. See @server_reactor_release */
+} server_event_t;
+
+/** One send of @server_reactor_send_batch */
+typedef struct server_send_s {
+    int fd;                    /**< Socket descriptor */
+    uint32_t slot;             /**< Owner slot, not used by reactor */
+    const struct iovec* p_iov; /**< Data */
+    size_t iov_count;          /**< Count of iovecs */
+    ssize_t res;               /**< Output. Sent bytes or -errno */
+} server_send_t;
+
+/** Reactor - readiness notification over one of the backends */
+typedef struct server_reactor_s {
+    server_backend_t backend;          /**< Selected backend */
+    size_t max_fds;                    /**< Max registered descriptors */
+    int epoll_fd;                      /**< epoll: instance descriptor */
+    struct epoll_event* p_epoll_evts;  /**< epoll: buffer for epoll_wait */
+    struct pollfd* p_pollfds;          /**< poll: descriptors set */
+    uint64_t* p_poll_data;             /**< poll: user data per pollfd */
+    size_t* p_poll_idx;                /**< poll: pollfd index by fd */
+    size_t poll_count;                 /**< poll: count of pollfds, dense */
+    struct server_uring_s* p_uring;    /**< io_uring: private state */
+} server_reactor_t;
+
 /******************************************************************************
  * INLINE FUNCTIONS
  ******************************************************************************/
 
+/**
+ * @brief Get oldest queued message
+ *
+ * @param p_outq pointer to queue, not empty
+ * @return const msg_t* message
+ */
+static inline const msg_t* server_outq_head(const server_outq_t* p_outq) {
+    return p_outq->pp_msgs[p_outq->head];
+}
+
 /******************************************************************************
  * PUBLIC FUNCTION PROTOTYPES
  ******************************************************************************/
@@ -102,6 +276,46 @@ int32_t server_deinit(server_handle_t* p_handle);
 int32_t server_accept(server_handle_t* p_handle, server_client_t* p_client);
 size_t server_max_clients(void);
 int32_t server_concurrent(server_handle_t* p_handle);
+int32_t server_set_nonblock(int socket_fd);
+int32_t server_listen_queue(const server_handle_t* p_handle,
+                            uint32_t* p_queued, uint32_t* p_backlog);
+int32_t server_client_age(int socket_fd, uint32_t* p_age_ms);
+uint64_t server_listen_overflows(void);
+
+int32_t server_outq_push(server_outq_t* p_outq, msg_t* p_msg);
+int32_t server_outq_drop_oldest(server_outq_t* p_outq);
+int32_t server_outq_replace_newest(server_outq_t* p_outq, msg_t* p_msg);
+int32_t server_outq_push_key(server_outq_t* p_outq, msg_t* p_msg,
+                             uint32_t key);
+int32_t server_outq_replace_key(server_outq_t* p_outq, msg_t* p_msg,
+                                uint32_t key);
+size_t server_outq_iov(const server_outq_t* p_outq, struct iovec* p_iov,
+                       size_t max_iov);
+void server_outq_consume(server_outq_t* p_outq, size_t bytes);
+void server_outq_clear(server_outq_t* p_outq);
+
+int32_t server_table_init(server_table_t* p_table, size_t cap);
+int32_t server_table_deinit(server_table_t* p_table);
+server_client_t* server_table_add(server_table_t* p_table,
+                                  const server_client_t* p_client);
+void server_table_remove(server_table_t* p_table, uint32_t slot);
+server_client_t* server_table_get(const server_table_t* p_table, uint64_t id);
+
+int32_t server_reactor_init(server_reactor_t* p_reactor,
+                            server_backend_t backend, size_t max_fds);
+int32_t server_reactor_deinit(server_reactor_t* p_reactor);
+int32_t server_reactor_add(server_reactor_t* p_reactor, int fd,
+                           uint32_t events, uint64_t data);
+int32_t server_reactor_mod(server_reactor_t* p_reactor, int fd,
+                           uint32_t events, uint64_t data);
+int32_t server_reactor_del(server_reactor_t* p_reactor, int fd);
+int server_reactor_wait(server_reactor_t* p_reactor, server_event_t* p_events,
+                        size_t max_events, int timeout_ms);
+int32_t server_reactor_release(server_reactor_t* p_reactor,
+                               const server_event_t* p_event);
+int32_t server_reactor_send_batch(server_reactor_t* p_reactor,
+                                  server_send_t* p_sends, size_t count);
+const char* server_backend_name(server_backend_t backend);
 
 /******************************************************************************
  * END OF HEADER'S CODE
@@ -0,0 +1,145 @@
+/**
+ * @file      shmq.h
+ *
+ * @brief     Shared memory SPSC byte ring for same-host subscribers
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup shmq
+ *  @{
+ */
+
+#ifndef __SHMQ_H_
+#define __SHMQ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define SHMQ_ERR_OK ((int32_t)0)     /**< Ring error - no error */
+#define SHMQ_ERR_PARAMS ((int32_t)1) /**< Ring error - parameters error */
+#define SHMQ_ERR_SHM ((int32_t)2)    /**< Ring error - shared memory error */
+#define SHMQ_ERR_AGAIN ((int32_t)3)  /**< Ring error - no data yet */
+#define SHMQ_ERR_OWNER ((int32_t)4)  /**< Ring error - segment of other user \
+                                          or open to others */
+
+#define SHMQ_MAGIC ((uint32_t)0x53514D52) /**< "SQMR", segment is a ring */
+#define SHMQ_VERSION ((uint32_t)1)        /**< Layout version */
+#define SHMQ_NAME_SIZE ((size_t)64)       /**< Max segment name with '\0' */
+#define SHMQ_CACHE_LINE ((size_t)64)      /**< Cache line size for padding */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/**
+ * Ring header at the start of segment, data area follows it.
+ *
+ * Producer owns head, consumer owns tail, each on own cache line. Consumer
+ * going to sleep raises waiting and waits on futex word wake, producer
+ * bumps wake only when waiting is raised, so a busy consumer costs no
+ * syscalls on either side.
+ */
+typedef struct shmq_hdr_s {
+    uint32_t magic;                  /**< SHMQ_MAGIC */
+    uint32_t version;                /**< SHMQ_VERSION */
+    uint64_t size;                   /**< Data area size, power of 2 */
+    atomic_uint attached;            /**< Set by producer after mapping */
+    alignas(SHMQ_CACHE_LINE) _Atomic uint64_t head; /**< Write position */
+    alignas(SHMQ_CACHE_LINE) _Atomic uint64_t tail; /**< Read position */
+    atomic_uint waiting;             /**< Consumer sleeps on wake */
+    atomic_uint wake;                /**< Futex word, bumped by producer */
+    alignas(SHMQ_CACHE_LINE) uint8_t data[]; /**< Data area */
+} shmq_hdr_t;
+
+/** Process-local handle of ring */
+typedef struct shmq_s {
+    shmq_hdr_t* p_hdr;         /**< Mapped segment */
+    size_t map_size;           /**< Mapped size */
+    uint64_t mask;             /**< Data area size - 1 */
+    uint64_t peer;             /**< Cached position of the other side */
+    char name[SHMQ_NAME_SIZE]; /**< Segment name */
+} shmq_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Check if producer mapped the ring
+ *
+ * @param p_q pointer to ring
+ * @return bool true if attached
+ */
+static inline bool shmq_attached(const shmq_t* p_q) {
+    return 0 != atomic_load_explicit(&p_q->p_hdr->attached,
+                                     memory_order_acquire);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t shmq_create(shmq_t* p_q, const char* p_name, size_t size);
+int32_t shmq_attach(shmq_t* p_q, const char* p_name, uid_t owner);
+void shmq_unlink(const shmq_t* p_q);
+void shmq_close(shmq_t* p_q);
+bool shmq_write(shmq_t* p_q, const void* p_buf, size_t len);
+void shmq_notify(shmq_t* p_q);
+size_t shmq_read(shmq_t* p_q, void* p_buf, size_t size);
+int32_t shmq_wait(shmq_t* p_q, uint32_t spins, int timeout_ms);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __SHMQ_H_
+
+/** @}*/
@@ -0,0 +1,163 @@
+/**
+ * @file      topic.h
+ *
+ * @brief     Topic subscriptions index
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup topic
+ *  @{
+ */
+
+#ifndef __TOPIC_H_
+#define __TOPIC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define TOPIC_ERR_OK ((int32_t)0)     /**< Topic error - no error */
+#define TOPIC_ERR_PARAMS ((int32_t)1) /**< Topic error - parameters error */
+#define TOPIC_ERR_NOMEM ((int32_t)2)  /**< Topic error - no memory */
+#define TOPIC_ERR_LIMIT ((int32_t)3)  /**< Topic error - too many patterns */
+#define TOPIC_ERR_NOENT ((int32_t)4)  /**< Topic error - not subscribed */
+
+#define TOPIC_WILDCARD ((uint8_t)'*') /**< Last pattern byte - prefix match */
+#define TOPIC_NONE ((uint32_t)0) /**< No record, record 0 is never used */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Subscribers of one pattern. Holds record indexes, dense */
+typedef struct topic_set_s {
+    uint32_t* p_recs; /**< Records of subscribers */
+    uint32_t count;   /**< Count of records */
+    uint32_t cap;     /**< Capacity of records array */
+} topic_set_t;
+
+/** Exact topic - hash table entry */
+typedef struct topic_entry_s {
+    topic_set_t set;               /**< Subscribers, must be first */
+    struct topic_entry_s* p_next;  /**< Next entry in bucket */
+    uint32_t hash;                 /**< Hash of topic */
+    uint32_t len;                  /**< Topic length */
+    uint8_t topic[];               /**< Topic bytes */
+} topic_entry_t;
+
+/** Prefix - trie node, one byte per level */
+typedef struct topic_node_s {
+    topic_set_t set;               /**< Subscribers, must be first */
+    struct topic_node_s* p_parent; /**< Parent or NULL for root */
+    struct topic_node_s** pp_kids; /**< Children */
+    uint8_t* p_keys;               /**< Byte of every child */
+    uint16_t kids_count;           /**< Count of children */
+    uint16_t kids_cap;             /**< Capacity of children arrays */
+    uint8_t key;                   /**< Own byte in parent */
+} topic_node_t;
+
+/** Subscription of one subscriber to one pattern */
+typedef struct topic_rec_s {
+    topic_set_t* p_set; /**< Set holding record */
+    uint32_t sub;       /**< Subscriber */
+    uint32_t pos;       /**< Position in set */
+    uint32_t next;      /**< Next record of subscriber or free record */
+    bool prefix;        /**< Set is in trie node, else in hash entry */
+} topic_rec_t;
+
+/**
+ * Routing index: pattern to subscribers.
+ *
+ * Exact topics live in hash table, prefix patterns in byte trie, so a match
+ * costs one lookup plus one trie walk of topic length. Subscribers are small
+ * integers below capacity, e.g. connection table slots. Not thread safe.
+ */
+typedef struct topic_index_s {
+    topic_entry_t** pp_buckets; /**< Hash buckets */
+    uint32_t mask;              /**< Count of buckets - 1 */
+    uint32_t entries;           /**< Count of entries */
+    topic_node_t root;          /**< Trie root, pattern "*" */
+    topic_rec_t* p_recs;        /**< Records pool */
+    uint32_t recs_cap;          /**< Capacity of records pool */
+    uint32_t recs_free;         /**< Free records list */
+    uint32_t* p_heads;          /**< Records of subscriber, list head */
+    uint32_t* p_counts;         /**< Count of patterns of subscriber */
+    uint64_t* p_marks;          /**< Last match of subscriber */
+    uint64_t match_gen;         /**< Generation of last match */
+    uint32_t* p_match;          /**< Output of last match */
+    uint32_t cap;               /**< Count of subscribers */
+} topic_index_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+uint32_t topic_hash(const uint8_t* p_topic, size_t len);
+int32_t topic_index_init(topic_index_t* p_index, uint32_t cap);
+void topic_index_deinit(topic_index_t* p_index);
+int32_t topic_subscribe(topic_index_t* p_index, uint32_t sub,
+                        const void* p_pattern, size_t len);
+int32_t topic_unsubscribe(topic_index_t* p_index, uint32_t sub,
+                          const void* p_pattern, size_t len);
+void topic_unsubscribe_all(topic_index_t* p_index, uint32_t sub);
+bool topic_is_subscribed(const topic_index_t* p_index, uint32_t sub);
+size_t topic_match(topic_index_t* p_index, const void* p_topic, size_t len,
+                   const uint32_t** pp_subs);
+bool topic_sub_matches(const topic_index_t* p_index, uint32_t sub,
+                       const void* p_topic, size_t len);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __TOPIC_H_
+
+/** @}*/
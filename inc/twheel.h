@@ -0,0 +1,129 @@
+/**
+ * @file      twheel.h
+ *
+ * @brief     Hierarchical timing wheel
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup twheel
+ *  @{
+ */
+
+#ifndef __TWHEEL_H_
+#define __TWHEEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define TWHEEL_ERR_OK ((int32_t)0)     /**< Wheel error - no error */
+#define TWHEEL_ERR_PARAMS ((int32_t)1) /**< Wheel error - parameters error */
+
+#define TWHEEL_BITS ((uint32_t)6)                /**< Slot index bits */
+#define TWHEEL_SLOTS ((size_t)1 << TWHEEL_BITS)  /**< Slots per level */
+#define TWHEEL_LEVELS ((size_t)4)                /**< Levels, 2^24 ticks */
+
+/******************************************************************************
+ * PUBLIC TYPES
+ ******************************************************************************/
+
+/** Timer. Embedded into its owner, the wheel never allocates */
+typedef struct twheel_node_s {
+    struct twheel_node_s* p_next; /**< Next in slot list, NULL - not armed */
+    struct twheel_node_s* p_prev; /**< Previous in slot list */
+    uint64_t expires;             /**< Expiration tick */
+} twheel_node_t;
+
+/**
+ * Hierarchical timing wheel.
+ *
+ * Level L slot covers 64^L ticks. A timer is linked to the slot of the
+ * lowest level that reaches its expiration and moves one level down when
+ * the wheel passes that slot, so every timer is touched at most
+ * TWHEEL_LEVELS times. Arm and cancel are O(1) list operations, a tick
+ * without due timers costs one empty slot check. Not thread safe.
+ */
+typedef struct twheel_s {
+    twheel_node_t slots[TWHEEL_LEVELS][TWHEEL_SLOTS]; /**< Slot list heads */
+    twheel_node_t expired; /**< Due timers not taken yet */
+    uint64_t tick;         /**< Last processed tick */
+    uint64_t tick_ms;      /**< Tick length, ms */
+    size_t count;          /**< Armed timers, due ones included */
+} twheel_t;
+
+/******************************************************************************
+ * INLINE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Check if timer is armed or due and not taken yet
+ *
+ * @param p_node pointer to timer
+ * @return bool true if armed
+ */
+static inline bool twheel_armed(const twheel_node_t* p_node) {
+    return NULL != p_node->p_next;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+int32_t twheel_init(twheel_t* p_wheel, uint64_t tick_ms, uint64_t now_ms);
+void twheel_arm(twheel_t* p_wheel, twheel_node_t* p_node, uint64_t at_ms);
+void twheel_cancel(twheel_t* p_wheel, twheel_node_t* p_node);
+void twheel_advance(twheel_t* p_wheel, uint64_t now_ms);
+twheel_node_t* twheel_pop(twheel_t* p_wheel);
+int twheel_wait_ms(const twheel_t* p_wheel, uint64_t now_ms);
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __TWHEEL_H_
+
+/** @}*/
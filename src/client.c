@@ -44,21 +44,36 @@
 
 #include "client.h"
 
+#include <arpa/inet.h>
+#include <errno.h>
+#include <limits.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "common.h"
+#include "config.h"
 
 /******************************************************************************
  * DEFINES, CONSTS, ENUMS
  ******************************************************************************/
 
+#ifndef IOV_MAX
+#define IOV_MAX ((size_t)1024) /**< Linux UIO_MAXIOV */
+#endif
+
 /******************************************************************************
  * PRIVATE TYPES
  ******************************************************************************/
@@ -67,6 +82,8 @@
  * PRIVATE DATA
  ******************************************************************************/
 
+static unsigned g_shm_count = 0; /**< Rings created by this process */
+
 /******************************************************************************
  * PUBLIC DATA
  ******************************************************************************/
@@ -83,10 +100,361 @@
  * PRIVATE FUNCTION PROTOTYPES
  ******************************************************************************/
 
+static int32_t client_hello_send(int socket_fd, uint16_t flags,
+                                 const char* const* pp_patterns, size_t count,
+                                 uint64_t seq);
+static int32_t client_connect_unix(const char* p_path, int* p_socket_fd);
+static uint64_t client_now_ms(void);
+static void client_mcast_store(client_mcast_t* p_mc, uint64_t seq,
+                               const uint8_t* p_data, size_t len);
+static size_t client_mcast_deliver(client_mcast_t* p_mc, uint8_t* p_buf,
+                                   size_t size);
+static int32_t client_mcast_nack(int socket_fd, client_mcast_t* p_mc);
+static int32_t client_mcast_read_group(client_mcast_t* p_mc);
+static int32_t client_mcast_read_socket(int socket_fd, client_mcast_t* p_mc);
+
 /******************************************************************************
  * PRIVATE FUNCTIONS
  ******************************************************************************/
 
+/**
+ * @brief Encode and send hello frame
+ *
+ * @param socket_fd client socket descriptor
+ * @param flags mask of PROTO_ROLE_* and PROTO_HELLO_*
+ * @param pp_patterns topic patterns
+ * @param count count of patterns
+ * @param seq replay start, used with PROTO_HELLO_REPLAY
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t client_hello_send(int socket_fd, uint16_t flags,
+                                 const char* const* pp_patterns, size_t count,
+                                 uint64_t seq) {
+    const uint16_t roles = flags & PROTO_ROLE_BOTH;
+
+    if ((0 == roles) ||
+        (0 != (flags &
+               ~(PROTO_ROLE_BOTH | PROTO_HELLO_REPLAY | PROTO_HELLO_MCAST))) ||
+        ((NULL == pp_patterns) && (count > 0))) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    size_t len = 0;
+    for (size_t idx = 0; idx < count; idx++) {
+        const size_t pattern_len = strlen(pp_patterns[idx]);
+        if ((pattern_len > CONFIG_TOPIC_LEN_MAX) ||
+            (NULL != memchr(pp_patterns[idx], '\n', pattern_len))) {
+            return CLIENT_ERR_PARAM;
+        }
+        len += pattern_len + 1;
+    }
+
+    if (len > CONFIG_PROTO_PAYLOAD_MAX) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    uint8_t* p_buf = malloc(PROTO_HDR_SIZE + len);
+    if (NULL == p_buf) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    proto_hdr_t hdr = {.len = (uint32_t)len,
+                       .type = PROTO_TYPE_HELLO,
+                       .flags = flags,
+                       .seq = seq,
+                       .ts = proto_ts_now()};
+    proto_hdr_encode(p_buf, &hdr);
+
+    size_t off = PROTO_HDR_SIZE;
+    for (size_t idx = 0; idx < count; idx++) {
+        const size_t pattern_len = strlen(pp_patterns[idx]);
+        memcpy(&p_buf[off], pp_patterns[idx], pattern_len);
+        off += pattern_len;
+        p_buf[off++] = '\n';
+    }
+
+    struct iovec iov = {.iov_base = p_buf, .iov_len = off};
+    int32_t ret = client_sendv(socket_fd, &iov, 1);
+    free(p_buf);
+
+    return ret;
+}
+
+/**
+ * @brief Connect to unix socket
+ *
+ * @param p_path socket path, '@' at start - abstract namespace
+ * @param p_socket_fd output parameter. File Descriptor of create socket
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t client_connect_unix(const char* p_path, int* p_socket_fd) {
+    struct sockaddr_un addr;
+    socklen_t addr_len = 0;
+
+    if (!common_unix_addr(p_path, &addr, &addr_len)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    *p_socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (COMMON_SOCKET_ERR == *p_socket_fd) {
+        return CLIENT_ERR_SOCKET;
+    }
+
+    if (COMMON_SOCKET_ERR ==
+        connect(*p_socket_fd, (struct sockaddr*)&addr, addr_len)) {
+        close(*p_socket_fd);
+        *p_socket_fd = COMMON_SOCKET_ERR;
+        return CLIENT_ERR_CONNECT;
+    }
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Get monotonic time
+ *
+ * @return uint64_t time in milliseconds
+ */
+static uint64_t client_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000u) + ((uint64_t)ts.tv_nsec / 1000000u);
+}
+
+/**
+ * @brief Put data frame to reorder window
+ *
+ * Frames behind the window are dropped: they are asked again once the
+ * window moves.
+ *
+ * @param p_mc pointer to subscription
+ * @param seq sequence number in group
+ * @param p_data data frame
+ * @param len data frame length
+ */
+static void client_mcast_store(client_mcast_t* p_mc, uint64_t seq,
+                               const uint8_t* p_data, size_t len) {
+    // NOTE: the first frame seen starts the stream
+    if (0 == p_mc->next) {
+        p_mc->next = seq;
+        p_mc->high = seq;
+    }
+
+    if (seq < p_mc->next) {
+        p_mc->stats.dups++;
+        return;
+    }
+
+    if (seq >= p_mc->high) {
+        p_mc->high = seq + 1u;
+    }
+
+    if ((seq - p_mc->next) >= CONFIG_MCAST_WINDOW) {
+        p_mc->stats.overruns++;
+        return;
+    }
+
+    client_mcast_slot_t* p_slot =
+        &p_mc->p_slots[seq & (CONFIG_MCAST_WINDOW - 1u)];
+    if (seq == p_slot->seq) {
+        p_mc->stats.dups++;
+        return;
+    }
+
+    if (p_slot->cap < len) {
+        uint8_t* p_new = realloc(p_slot->p_data, len);
+        if (NULL == p_new) {
+            return;
+        }
+        p_slot->p_data = p_new;
+        p_slot->cap = len;
+    }
+
+    memcpy(p_slot->p_data, p_data, len);
+    p_slot->len = len;
+    p_slot->seq = seq;
+}
+
+/**
+ * @brief Copy frames ready in order to buffer
+ *
+ * Frame may be split between calls, parser assembles it.
+ *
+ * @param p_mc pointer to subscription
+ * @param p_buf output buffer
+ * @param size buffer size
+ * @return size_t count of copied bytes
+ */
+static size_t client_mcast_deliver(client_mcast_t* p_mc, uint8_t* p_buf,
+                                   size_t size) {
+    size_t used = 0;
+
+    while ((used < size) && (0 != p_mc->next)) {
+        client_mcast_slot_t* p_slot =
+            &p_mc->p_slots[p_mc->next & (CONFIG_MCAST_WINDOW - 1u)];
+        if (p_mc->next != p_slot->seq) {
+            break;
+        }
+
+        size_t len = p_slot->len - p_mc->off;
+        if (len > (size - used)) {
+            len = size - used;
+        }
+
+        memcpy(&p_buf[used], &p_slot->p_data[p_mc->off], len);
+        used += len;
+        p_mc->off += len;
+
+        if (p_mc->off == p_slot->len) {
+            p_slot->seq = 0;
+            p_mc->off = 0;
+            p_mc->next++;
+        }
+    }
+
+    return used;
+}
+
+/**
+ * @brief Ask server for frames missing at the head of window
+ *
+ * Request is repeated every CONFIG_MCAST_NACK_MS. After
+ * CONFIG_MCAST_NACK_RETRIES requests the gap is counted lost and skipped,
+ * e.g. when server ring does not have it anymore.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_mc pointer to subscription
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t client_mcast_nack(int socket_fd, client_mcast_t* p_mc) {
+    const uint64_t mask = CONFIG_MCAST_WINDOW - 1u;
+
+    if ((0 == p_mc->next) || (p_mc->next >= p_mc->high) ||
+        (p_mc->next == p_mc->p_slots[p_mc->next & mask].seq)) {
+        return CLIENT_ERR_OK;
+    }
+
+    uint64_t count = 0;
+    while (((p_mc->next + count) < p_mc->high) && (count < UINT16_MAX) &&
+           (count < CONFIG_MCAST_WINDOW) &&
+           ((p_mc->next + count) !=
+            p_mc->p_slots[(p_mc->next + count) & mask].seq)) {
+        count++;
+    }
+
+    const uint64_t now = client_now_ms();
+    if (p_mc->next == p_mc->nack_seq) {
+        if ((now - p_mc->nack_ms) < CONFIG_MCAST_NACK_MS) {
+            return CLIENT_ERR_OK;
+        }
+
+        if (p_mc->nack_tries >= CONFIG_MCAST_NACK_RETRIES) {
+            p_mc->stats.lost += count;
+            p_mc->next += count;
+            p_mc->off = 0;
+            p_mc->nack_seq = 0;
+            return CLIENT_ERR_OK;
+        }
+    } else {
+        p_mc->nack_seq = p_mc->next;
+        p_mc->nack_tries = 0;
+    }
+
+    p_mc->nack_tries++;
+    p_mc->nack_ms = now;
+    p_mc->stats.nacks++;
+
+    uint8_t buf[PROTO_HDR_SIZE];
+    const proto_hdr_t hdr = {.type = PROTO_TYPE_NACK,
+                             .flags = (uint16_t)count,
+                             .seq = p_mc->next,
+                             .ts = proto_ts_now()};
+    proto_hdr_encode(buf, &hdr);
+
+    if (sizeof(buf) != send(socket_fd, buf, sizeof(buf), MSG_NOSIGNAL)) {
+        return CLIENT_ERR_SOCKET;
+    }
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Read pending datagrams of group into window
+ *
+ * @param p_mc pointer to subscription
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t client_mcast_read_group(client_mcast_t* p_mc) {
+    for (uint64_t idx = 0; idx < CONFIG_MCAST_WINDOW; idx++) {
+        ssize_t ret = recv(p_mc->fd, p_mc->p_dgram, CONFIG_CLIENT_RECV_SIZE,
+                           MSG_DONTWAIT);
+        if (COMMON_SOCKET_ERR == ret) {
+            return ((EAGAIN == errno) || (EWOULDBLOCK == errno) ||
+                    (EINTR == errno))
+                       ? CLIENT_ERR_OK
+                       : CLIENT_ERR_SOCKET;
+        }
+
+        // NOTE: server without group sends over TCP, stray datagrams are
+        // ignored then
+        proto_hdr_t hdr;
+        if ((p_mc->unicast) || ((size_t)ret < PROTO_HDR_SIZE)) {
+            continue;
+        }
+
+        proto_hdr_decode(p_mc->p_dgram, &hdr);
+        if ((PROTO_TYPE_MCAST != hdr.type) ||
+            (PROTO_FRAME_SIZE(&hdr) != (size_t)ret) || (0 == hdr.seq)) {
+            continue;
+        }
+
+        client_mcast_store(p_mc, hdr.seq, &p_mc->p_dgram[PROTO_HDR_SIZE],
+                           hdr.len);
+    }
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Read retransmitted frames from TCP into window
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_mc pointer to subscription
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t client_mcast_read_socket(int socket_fd, client_mcast_t* p_mc) {
+    ssize_t ret = recv(socket_fd, p_mc->p_dgram, CONFIG_CLIENT_RECV_SIZE,
+                       MSG_DONTWAIT);
+    if (COMMON_SOCKET_ERR == ret) {
+        return ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno))
+                   ? CLIENT_ERR_OK
+                   : CLIENT_ERR_SOCKET;
+    } else if (COMMON_SOCKET_CLOSED == ret) {
+        return CLIENT_ERR_CLOSED;
+    }
+
+    proto_parser_feed(&p_mc->parser, p_mc->p_dgram, (size_t)ret);
+
+    proto_frame_t frame;
+    int32_t parsed = PROTO_ERR_OK;
+    while (PROTO_ERR_OK ==
+           (parsed = proto_parser_next(&p_mc->parser, &frame))) {
+        if ((PROTO_TYPE_MCAST == frame.hdr.type) && (0 != frame.hdr.seq)) {
+            p_mc->stats.retransmits++;
+            client_mcast_store(p_mc, frame.hdr.seq, frame.p_payload,
+                               frame.hdr.len);
+        } else if (PROTO_TYPE_DATA == frame.hdr.type) {
+            // NOTE: server has no group - frames get own order numbers
+            p_mc->unicast = true;
+            client_mcast_store(p_mc, (0 != p_mc->high) ? p_mc->high : 1u,
+                               frame.p_data, PROTO_FRAME_SIZE(&frame.hdr));
+        }
+    }
+
+    return (PROTO_ERR_AGAIN == parsed) ? CLIENT_ERR_OK : CLIENT_ERR_SOCKET;
+}
+
 /******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
@@ -94,7 +462,11 @@
 /**
  * @brief Connect client
  *
- * @param p_host null-terminated string with host. Ex "borchevkin.com"
+ * Host "unix:<path>" connects to unix socket, "unix:@<name>" - to abstract
+ * one. Service is not used then.
+ *
+ * @param p_host null-terminated string with host. Ex "borchevkin.com",
+ * "unix:/tmp/srvc.sock"
  * @param p_serv null-terminated string with service or port. Ex "ssh", "8888"
  * @param p_socket_fd output parameter. File Descriptor of create socket
  * @return int32_t 0 if OK, error otherwise
@@ -113,6 +485,11 @@ int32_t client_connect(const char* p_host, const char* p_serv,
         return CLIENT_ERR_PARAM;
     }
 
+    if (0 == strncmp(p_host, CLIENT_UNIX_PREFIX, strlen(CLIENT_UNIX_PREFIX))) {
+        return client_connect_unix(&p_host[strlen(CLIENT_UNIX_PREFIX)],
+                                   p_socket_fd);
+    }
+
     struct addrinfo hints;
     struct addrinfo* p_result;
     struct addrinfo* p_rp;
@@ -152,6 +529,10 @@ int32_t client_connect(const char* p_host, const char* p_serv,
         return CLIENT_ERR_CONNECT;
     }
 
+    // NOTE: frames are small - do not wait for ACK before sending next one
+    int opt = 1;
+    setsockopt(*p_socket_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
     return CLIENT_ERR_OK;
 }
 
@@ -172,6 +553,546 @@ int32_t client_disconnect(int* p_socket_fd) {
     return CLIENT_ERR_OK;
 }
 
+/**
+ * @brief Send one frame. Blocks until whole frame is sent
+ *
+ * @param socket_fd client socket descriptor
+ * @param type frame type, PROTO_TYPE_*
+ * @param seq frame sequence number
+ * @param p_buf payload
+ * @param len payload length
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_send(int socket_fd, uint16_t type, uint64_t seq,
+                    const void* p_buf, size_t len) {
+    if ((NULL == p_buf) && (len > 0)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    if (len > CONFIG_PROTO_PAYLOAD_MAX) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    uint8_t hdr_buf[PROTO_HDR_SIZE];
+    proto_hdr_t hdr = {
+        .len = (uint32_t)len, .type = type, .seq = seq, .ts = proto_ts_now()};
+    proto_hdr_encode(hdr_buf, &hdr);
+
+    struct iovec iov[2] = {{.iov_base = hdr_buf, .iov_len = PROTO_HDR_SIZE},
+                           {.iov_base = (void*)p_buf, .iov_len = len}};
+
+    return client_sendv(socket_fd, iov, 2);
+}
+
+/**
+ * @brief Send one data frame with topic. Blocks until whole frame is sent
+ *
+ * @param socket_fd client socket descriptor
+ * @param seq frame sequence number
+ * @param p_topic topic, NULL or empty - no topic
+ * @param p_buf payload
+ * @param len payload length
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_publish(int socket_fd, uint64_t seq, const char* p_topic,
+                       const void* p_buf, size_t len) {
+    const size_t topic_len = (NULL != p_topic) ? strlen(p_topic) : 0;
+
+    if (((NULL == p_buf) && (len > 0)) || (topic_len > CONFIG_TOPIC_LEN_MAX) ||
+        ((topic_len + len) > CONFIG_PROTO_PAYLOAD_MAX)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    uint8_t hdr_buf[PROTO_HDR_SIZE];
+    proto_hdr_t hdr = {.len = (uint32_t)(topic_len + len),
+                       .type = PROTO_TYPE_DATA,
+                       .flags = (uint16_t)topic_len,
+                       .seq = seq,
+                       .ts = proto_ts_now()};
+    proto_hdr_encode(hdr_buf, &hdr);
+
+    struct iovec iov[3] = {{.iov_base = hdr_buf, .iov_len = PROTO_HDR_SIZE},
+                           {.iov_base = (void*)p_topic, .iov_len = topic_len},
+                           {.iov_base = (void*)p_buf, .iov_len = len}};
+
+    return client_sendv(socket_fd, iov, 3);
+}
+
+/**
+ * @brief Send role handshake with initial subscriptions
+ *
+ * Subscriber-only connection is not read by server after hello, so all its
+ * patterns must be given here.
+ *
+ * @param socket_fd client socket descriptor
+ * @param roles mask of PROTO_ROLE_*
+ * @param pp_patterns topic patterns, used with PROTO_ROLE_SUB
+ * @param count count of patterns
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_hello(int socket_fd, uint16_t roles,
+                     const char* const* pp_patterns, size_t count) {
+    if (0 != (roles & (PROTO_HELLO_REPLAY | PROTO_HELLO_MCAST))) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    return client_hello_send(socket_fd, roles, pp_patterns, count, 0);
+}
+
+/**
+ * @brief Send subscriber handshake asking for replay of retained messages
+ *
+ * Server first sends retained messages of the patterns with sequence number
+ * not less than seq, then live ones.
+ *
+ * @param socket_fd client socket descriptor
+ * @param roles mask of PROTO_ROLE_*, must have PROTO_ROLE_SUB
+ * @param pp_patterns topic patterns
+ * @param count count of patterns
+ * @param seq first sequence number to replay, 0 - all retained
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_hello_replay(int socket_fd, uint16_t roles,
+                            const char* const* pp_patterns, size_t count,
+                            uint64_t seq) {
+    if ((0 == (roles & PROTO_ROLE_SUB)) ||
+        (0 != (roles & PROTO_HELLO_REPLAY))) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    return client_hello_send(socket_fd, roles | PROTO_HELLO_REPLAY,
+                             pp_patterns, count, seq);
+}
+
+/**
+ * @brief Send subscriber handshake asking for data from multicast group
+ *
+ * Group must be joined with @client_mcast_join before, data frames are then
+ * taken with @client_mcast_recv. Server without group keeps sending them
+ * over TCP, @client_mcast_recv delivers those as well.
+ *
+ * @param socket_fd client socket descriptor
+ * @param roles mask of PROTO_ROLE_*, must have PROTO_ROLE_SUB
+ * @param pp_patterns topic patterns
+ * @param count count of patterns
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_hello_mcast(int socket_fd, uint16_t roles,
+                           const char* const* pp_patterns, size_t count) {
+    if ((0 == (roles & PROTO_ROLE_SUB)) ||
+        (0 != (roles & (PROTO_HELLO_REPLAY | PROTO_HELLO_MCAST)))) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    return client_hello_send(socket_fd, roles | PROTO_HELLO_MCAST, pp_patterns,
+                             count, 0);
+}
+
+/**
+ * @brief Subscribe to topic pattern, e.g. "prices.*"
+ *
+ * Until the first subscription server sends everything to the client.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_pattern topic or prefix ending with '*'
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_subscribe(int socket_fd, const char* p_pattern) {
+    if ((NULL == p_pattern) || (strlen(p_pattern) > CONFIG_TOPIC_LEN_MAX)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    return client_send(socket_fd, PROTO_TYPE_SUB, 0, p_pattern,
+                       strlen(p_pattern));
+}
+
+/**
+ * @brief Unsubscribe from topic pattern given at subscription
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_pattern topic or prefix ending with '*'
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_unsubscribe(int socket_fd, const char* p_pattern) {
+    if ((NULL == p_pattern) || (strlen(p_pattern) > CONFIG_TOPIC_LEN_MAX)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    return client_send(socket_fd, PROTO_TYPE_UNSUB, 0, p_pattern,
+                       strlen(p_pattern));
+}
+
+/**
+ * @brief Send data gathered from iovecs. Blocks until everything is sent
+ *
+ * Used to send batch of encoded frames with one syscall.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_iov data. Array is modified on partial writes
+ * @param iov_count count of iovecs
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_sendv(int socket_fd, struct iovec* p_iov, size_t iov_count) {
+    if ((NULL == p_iov) && (iov_count > 0)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    struct msghdr msg = {.msg_iov = p_iov, .msg_iovlen = iov_count};
+
+    while (msg.msg_iovlen > 0) {
+        // NOTE: kernel takes at most IOV_MAX iovecs per call
+        size_t iovlen = msg.msg_iovlen;
+        if (msg.msg_iovlen > (size_t)IOV_MAX) {
+            msg.msg_iovlen = (size_t)IOV_MAX;
+        }
+
+        ssize_t ret = sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+        msg.msg_iovlen = iovlen;
+        if (COMMON_SOCKET_ERR == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return CLIENT_ERR_SOCKET;
+        }
+
+        // NOTE: partial write - skip sent part
+        size_t sent = (size_t)ret;
+        while ((msg.msg_iovlen > 0) && (sent >= msg.msg_iov->iov_len)) {
+            sent -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (uint8_t*)msg.msg_iov->iov_base + sent;
+            msg.msg_iov->iov_len -= sent;
+        }
+    }
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Receive available data and feed it to parser
+ *
+ * Frames are taken by @proto_parser_next afterwards. They may point into
+ * p_buf, so buffer must not be reused until parser returns PROTO_ERR_AGAIN.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_parser pointer to parser
+ * @param p_buf receive buffer
+ * @param size receive buffer size
+ * @return int32_t 0 if OK, CLIENT_ERR_INTR on signal, error otherwise
+ */
+int32_t client_recv(int socket_fd, proto_parser_t* p_parser, void* p_buf,
+                    size_t size) {
+    if ((NULL == p_parser) || (NULL == p_buf)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    ssize_t ret = recv(socket_fd, p_buf, size, 0);
+
+    if (COMMON_SOCKET_ERR == ret) {
+        // NOTE: let caller handle signal flags
+        return (EINTR == errno) ? CLIENT_ERR_INTR : CLIENT_ERR_SOCKET;
+    } else if (COMMON_SOCKET_CLOSED == ret) {
+        return CLIENT_ERR_CLOSED;
+    }
+
+    proto_parser_feed(p_parser, p_buf, (size_t)ret);
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Create shared memory ring and ask server to deliver through it
+ *
+ * Must be sent before hello, while server still reads the socket. Ring
+ * is usable only if @client_shm_attached confirms it.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_shm pointer to delivery
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_shm_open(int socket_fd, client_shm_t* p_shm) {
+    if (NULL == p_shm) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    char name[SHMQ_NAME_SIZE];
+    snprintf(name, sizeof(name), CONFIG_SHM_PREFIX "%d.%u", (int)getpid(),
+             g_shm_count++);
+
+    memset(p_shm, 0x00, sizeof(client_shm_t));
+    if (SHMQ_ERR_OK != shmq_create(&p_shm->ring, name, CONFIG_SHM_RING_SIZE)) {
+        return CLIENT_ERR_SHM;
+    }
+
+    int32_t ret =
+        client_send(socket_fd, PROTO_TYPE_SHM, 0, name, strlen(name));
+    if (CLIENT_ERR_OK != ret) {
+        shmq_unlink(&p_shm->ring);
+        shmq_close(&p_shm->ring);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Wait until server maps the ring
+ *
+ * Ring name is removed in any case, so nobody else can map it. Server which
+ * cannot map the ring, e.g. on another host, keeps using the socket.
+ *
+ * @param p_shm pointer to delivery
+ * @return int32_t 0 if ring is attached, CLIENT_ERR_SHM if ring is closed
+ * and the socket must be used
+ */
+int32_t client_shm_attached(client_shm_t* p_shm) {
+    if (NULL == p_shm) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    const struct timespec step = {.tv_sec = 0, .tv_nsec = 1000000L};
+    for (int ms = 0; ms < CONFIG_SHM_ATTACH_MS; ms++) {
+        if (shmq_attached(&p_shm->ring)) {
+            break;
+        }
+        nanosleep(&step, NULL);
+    }
+
+    shmq_unlink(&p_shm->ring);
+
+    if (!shmq_attached(&p_shm->ring)) {
+        shmq_close(&p_shm->ring);
+        return CLIENT_ERR_SHM;
+    }
+
+    // NOTE: frames sent before attach are read from socket first
+    p_shm->backlog = true;
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Receive available data from ring and feed it to parser
+ *
+ * Steady state makes no syscalls: ring is checked in a loop, then consumer
+ * sleeps on futex (or keeps spinning if busy). Only an idle ring makes the
+ * socket be checked for close.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_shm pointer to attached delivery
+ * @param p_parser pointer to parser
+ * @param p_buf receive buffer
+ * @param size receive buffer size
+ * @param busy do not sleep, spin only
+ * @return int32_t 0 if OK, CLIENT_ERR_INTR if there is no data yet, error
+ * otherwise
+ */
+int32_t client_shm_recv(int socket_fd, client_shm_t* p_shm,
+                        proto_parser_t* p_parser, void* p_buf, size_t size,
+                        bool busy) {
+    if ((NULL == p_shm) || (NULL == p_parser) || (NULL == p_buf)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    ssize_t ret = 0;
+
+    if (!p_shm->backlog) {
+        const int32_t wait =
+            busy ? shmq_wait(&p_shm->ring, CONFIG_SHM_BUSY_SPINS, 0)
+                 : shmq_wait(&p_shm->ring, CONFIG_SHM_SPINS,
+                             CONFIG_SHM_WAIT_MS);
+        if (SHMQ_ERR_OK == wait) {
+            ret = (ssize_t)shmq_read(&p_shm->ring, p_buf, size);
+            proto_parser_feed(p_parser, p_buf, (size_t)ret);
+            return CLIENT_ERR_OK;
+        }
+    }
+
+    // NOTE: idle ring - socket carries only frames before attach and close
+    ret = recv(socket_fd, p_buf, size, MSG_DONTWAIT);
+
+    if (COMMON_SOCKET_ERR == ret) {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) {
+            p_shm->backlog = false;
+            return CLIENT_ERR_INTR;
+        }
+        return CLIENT_ERR_SOCKET;
+    } else if (COMMON_SOCKET_CLOSED == ret) {
+        return CLIENT_ERR_CLOSED;
+    }
+
+    proto_parser_feed(p_parser, p_buf, (size_t)ret);
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Unmap ring
+ *
+ * @param p_shm pointer to delivery
+ */
+void client_shm_close(client_shm_t* p_shm) {
+    if (NULL != p_shm) {
+        shmq_close(&p_shm->ring);
+    }
+}
+
+/**
+ * @brief Join multicast group
+ *
+ * @param p_mc pointer to subscription
+ * @param p_group group address, e.g. "239.1.1.1"
+ * @param p_port group port
+ * @param p_ifaddr address of interface to join on, NULL - any
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t client_mcast_join(client_mcast_t* p_mc, const char* p_group,
+                          const char* p_port, const char* p_ifaddr) {
+    if ((NULL == p_mc) || (NULL == p_group) || (NULL == p_port)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    memset(p_mc, 0x00, sizeof(client_mcast_t));
+    p_mc->fd = COMMON_SOCKET_ERR;
+    proto_parser_init(&p_mc->parser);
+
+    struct sockaddr_in addr = {.sin_family = AF_INET,
+                               .sin_port =
+                                   htons((uint16_t)strtoul(p_port, NULL, 10))};
+    struct ip_mreq mreq = {.imr_interface.s_addr = htonl(INADDR_ANY)};
+    if ((1 != inet_pton(AF_INET, p_group, &addr.sin_addr)) ||
+        !IN_MULTICAST(ntohl(addr.sin_addr.s_addr)) || (0 == addr.sin_port) ||
+        ((NULL != p_ifaddr) &&
+         (1 != inet_pton(AF_INET, p_ifaddr, &mreq.imr_interface)))) {
+        return CLIENT_ERR_PARAM;
+    }
+    mreq.imr_multiaddr = addr.sin_addr;
+
+    p_mc->p_slots = calloc(CONFIG_MCAST_WINDOW, sizeof(client_mcast_slot_t));
+    p_mc->p_dgram = malloc(CONFIG_CLIENT_RECV_SIZE);
+    if ((NULL == p_mc->p_slots) || (NULL == p_mc->p_dgram)) {
+        client_mcast_leave(p_mc);
+        return CLIENT_ERR_PARAM;
+    }
+
+    p_mc->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (COMMON_SOCKET_ERR == p_mc->fd) {
+        client_mcast_leave(p_mc);
+        return CLIENT_ERR_SOCKET;
+    }
+
+    // NOTE: several subscribers of one host share the port, bound to group
+    // address they get only its datagrams
+    int opt = 1;
+    int rcvbuf = CONFIG_MCAST_RCVBUF;
+    setsockopt(p_mc->fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    setsockopt(p_mc->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    if ((COMMON_SOCKET_ERR ==
+         bind(p_mc->fd, (struct sockaddr*)&addr, sizeof(addr))) ||
+        (COMMON_SOCKET_ERR == setsockopt(p_mc->fd, IPPROTO_IP,
+                                         IP_ADD_MEMBERSHIP, &mreq,
+                                         sizeof(mreq)))) {
+        client_mcast_leave(p_mc);
+        return CLIENT_ERR_SOCKET;
+    }
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Receive data frames of group in order and feed them to parser
+ *
+ * Datagrams are reordered in a window. Frames missing at the head of the
+ * window are asked from server and taken from TCP. Frames are fed to
+ * parser as one stream, exactly like @client_recv does.
+ *
+ * @param socket_fd client socket descriptor
+ * @param p_mc pointer to subscription
+ * @param p_parser pointer to parser
+ * @param p_buf receive buffer
+ * @param size receive buffer size
+ * @return int32_t 0 if OK, CLIENT_ERR_INTR if there is no data yet, error
+ * otherwise
+ */
+int32_t client_mcast_recv(int socket_fd, client_mcast_t* p_mc,
+                          proto_parser_t* p_parser, void* p_buf, size_t size) {
+    if ((NULL == p_mc) || (NULL == p_parser) || (NULL == p_buf)) {
+        return CLIENT_ERR_PARAM;
+    }
+
+    size_t len = client_mcast_deliver(p_mc, p_buf, size);
+    if (len > 0) {
+        proto_parser_feed(p_parser, p_buf, len);
+        return CLIENT_ERR_OK;
+    }
+
+    // NOTE: pending gap wakes up to repeat request
+    struct pollfd fds[] = {{.fd = p_mc->fd, .events = POLLIN},
+                           {.fd = socket_fd, .events = POLLIN}};
+    const int timeout_ms = (p_mc->next < p_mc->high) ? (int)CONFIG_MCAST_NACK_MS
+                                                     : CONFIG_MCAST_POLL_MS;
+    if (COMMON_SOCKET_ERR == poll(fds, 2, timeout_ms)) {
+        return (EINTR == errno) ? CLIENT_ERR_INTR : CLIENT_ERR_SOCKET;
+    }
+
+    int32_t ret = CLIENT_ERR_OK;
+    if (fds[0].revents & POLLIN) {
+        ret = client_mcast_read_group(p_mc);
+    }
+
+    if ((CLIENT_ERR_OK == ret) && (0 != fds[1].revents)) {
+        ret = client_mcast_read_socket(socket_fd, p_mc);
+    }
+
+    if (CLIENT_ERR_OK == ret) {
+        ret = client_mcast_nack(socket_fd, p_mc);
+    }
+
+    if (CLIENT_ERR_OK != ret) {
+        return ret;
+    }
+
+    len = client_mcast_deliver(p_mc, p_buf, size);
+    if (0 == len) {
+        return CLIENT_ERR_INTR;
+    }
+
+    proto_parser_feed(p_parser, p_buf, len);
+
+    return CLIENT_ERR_OK;
+}
+
+/**
+ * @brief Leave group and release window
+ *
+ * @param p_mc pointer to subscription
+ */
+void client_mcast_leave(client_mcast_t* p_mc) {
+    if (NULL == p_mc) {
+        return;
+    }
+
+    if (COMMON_SOCKET_ERR != p_mc->fd) {
+        close(p_mc->fd);
+        p_mc->fd = COMMON_SOCKET_ERR;
+    }
+
+    if (NULL != p_mc->p_slots) {
+        for (uint64_t idx = 0; idx < CONFIG_MCAST_WINDOW; idx++) {
+            free(p_mc->p_slots[idx].p_data);
+        }
+        free(p_mc->p_slots);
+        p_mc->p_slots = NULL;
+    }
+
+    free(p_mc->p_dgram);
+    p_mc->p_dgram = NULL;
+    proto_parser_deinit(&p_mc->parser);
+}
+
 /******************************************************************************
  * END OF SOURCE'S CODE
  ******************************************************************************/
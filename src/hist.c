@@ -0,0 +1,314 @@
+/**
+ * @file      hist.c
+ *
+ * @brief     HDR-style latency histogram
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup hist
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "hist.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static size_t hist_index(uint64_t value);
+static uint64_t hist_value(size_t idx);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Get bucket of value
+ *
+ * @param value value
+ * @return size_t bucket index
+ */
+static size_t hist_index(uint64_t value) {
+    if (value < HIST_SUB_COUNT) {
+        return (size_t)value;
+    }
+
+    // NOTE: keep top HIST_SUB_BITS bits of value, shift is octave
+    const uint32_t msb = 63u - (uint32_t)__builtin_clzll(value);
+    const uint32_t shift = msb - (HIST_SUB_BITS - 1);
+    const size_t top = (size_t)(value >> shift);
+
+    return HIST_SUB_COUNT + ((shift - 1) * HIST_HALF_COUNT) +
+           (top - HIST_HALF_COUNT);
+}
+
+/**
+ * @brief Get highest value of bucket
+ *
+ * @param idx bucket index
+ * @return uint64_t highest value which falls into bucket
+ */
+static uint64_t hist_value(size_t idx) {
+    if (idx < HIST_SUB_COUNT) {
+        return (uint64_t)idx;
+    }
+
+    const uint32_t shift =
+        (uint32_t)((idx - HIST_SUB_COUNT) / HIST_HALF_COUNT) + 1;
+    const uint64_t top =
+        (uint64_t)((idx - HIST_SUB_COUNT) % HIST_HALF_COUNT) + HIST_HALF_COUNT;
+
+    return ((top + 1) << shift) - 1;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Clear histogram
+ *
+ * @param p_hist pointer to histogram
+ */
+void hist_reset(hist_t* p_hist) {
+    memset(p_hist, 0x00, sizeof(*p_hist));
+    p_hist->min = UINT64_MAX;
+}
+
+/**
+ * @brief Record one value
+ *
+ * @param p_hist pointer to histogram
+ * @param value value
+ */
+void hist_record(hist_t* p_hist, uint64_t value) {
+    p_hist->counts[hist_index(value)]++;
+    p_hist->total++;
+    p_hist->sum += (double)value;
+
+    if (value < p_hist->min) {
+        p_hist->min = value;
+    }
+
+    if (value > p_hist->max) {
+        p_hist->max = value;
+    }
+}
+
+/**
+ * @brief Add all values of one histogram to another
+ *
+ * @param p_dst pointer to destination histogram
+ * @param p_src pointer to source histogram
+ */
+void hist_merge(hist_t* p_dst, const hist_t* p_src) {
+    for (size_t idx = 0; idx < HIST_BUCKETS; idx++) {
+        p_dst->counts[idx] += p_src->counts[idx];
+    }
+
+    p_dst->total += p_src->total;
+    p_dst->sum += p_src->sum;
+
+    if (p_src->min < p_dst->min) {
+        p_dst->min = p_src->min;
+    }
+
+    if (p_src->max > p_dst->max) {
+        p_dst->max = p_src->max;
+    }
+}
+
+/**
+ * @brief Get values recorded between two snapshots of one histogram
+ *
+ * Min and max are restored from buckets, so they are bucket precise.
+ *
+ * @param p_dst pointer to output histogram
+ * @param p_cur pointer to later snapshot
+ * @param p_prev pointer to earlier snapshot
+ */
+void hist_diff(hist_t* p_dst, const hist_t* p_cur, const hist_t* p_prev) {
+    hist_reset(p_dst);
+
+    for (size_t idx = 0; idx < HIST_BUCKETS; idx++) {
+        const uint64_t count = p_cur->counts[idx] - p_prev->counts[idx];
+        if (0 == count) {
+            continue;
+        }
+
+        p_dst->counts[idx] = count;
+        p_dst->total += count;
+
+        if (UINT64_MAX == p_dst->min) {
+            p_dst->min = hist_value(idx);
+        }
+        p_dst->max = hist_value(idx);
+    }
+
+    p_dst->sum = p_cur->sum - p_prev->sum;
+}
+
+/**
+ * @brief Get value at percentile
+ *
+ * @param p_hist pointer to histogram
+ * @param percentile percentile, 0.0 - 100.0
+ * @return uint64_t highest value of bucket where percentile falls, 0 if empty
+ */
+uint64_t hist_percentile(const hist_t* p_hist, double percentile) {
+    if (0 == p_hist->total) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)((percentile / 100.0) * (double)p_hist->total);
+    if (rank >= p_hist->total) {
+        return p_hist->max;
+    }
+
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < HIST_BUCKETS; idx++) {
+        seen += p_hist->counts[idx];
+        if (seen > rank) {
+            uint64_t value = hist_value(idx);
+            return (value < p_hist->max) ? value : p_hist->max;
+        }
+    }
+
+    return p_hist->max;
+}
+
+/**
+ * @brief Print one line summary
+ *
+ * @param p_hist pointer to histogram
+ * @param p_out output stream
+ * @param p_prefix line prefix
+ * @param unit divider of printed values, e.g. 1e3 to print ns as us
+ */
+void hist_print(const hist_t* p_hist, FILE* p_out, const char* p_prefix,
+                double unit) {
+    if (0 == p_hist->total) {
+        fprintf(p_out, "%s count <0>\n", p_prefix);
+        return;
+    }
+
+    fprintf(p_out,
+            "%s count <%lu> min <%.1f> avg <%.1f> p50 <%.1f> p90 <%.1f> "
+            "p99 <%.1f> p99.9 <%.1f> p99.99 <%.1f> max <%.1f>\n",
+            p_prefix, p_hist->total, (double)p_hist->min / unit,
+            p_hist->sum / (double)p_hist->total / unit,
+            (double)hist_percentile(p_hist, 50.0) / unit,
+            (double)hist_percentile(p_hist, 90.0) / unit,
+            (double)hist_percentile(p_hist, 99.0) / unit,
+            (double)hist_percentile(p_hist, 99.9) / unit,
+            (double)hist_percentile(p_hist, 99.99) / unit,
+            (double)p_hist->max / unit);
+}
+
+/**
+ * @brief Print percentile distribution, one line per non-empty bucket
+ *
+ * Columns follow HdrHistogram text output: value, percentile, total count
+ * and 1/(1-percentile), so dumps can be plotted with the same tools.
+ *
+ * @param p_hist pointer to histogram
+ * @param p_out output stream
+ * @param unit divider of printed values, e.g. 1e3 to print ns as us
+ */
+void hist_dump(const hist_t* p_hist, FILE* p_out, double unit) {
+    fprintf(p_out, "%12s %14s %10s %14s\n\n", "Value", "Percentile",
+            "TotalCount", "1/(1-Percentile)");
+
+    uint64_t seen = 0;
+    for (size_t idx = 0; idx < HIST_BUCKETS; idx++) {
+        if (0 == p_hist->counts[idx]) {
+            continue;
+        }
+
+        seen += p_hist->counts[idx];
+        const double ratio = (double)seen / (double)p_hist->total;
+        const uint64_t value =
+            (hist_value(idx) < p_hist->max) ? hist_value(idx) : p_hist->max;
+
+        if (seen < p_hist->total) {
+            fprintf(p_out, "%12.3f %14.12f %10lu %14.2f\n",
+                    (double)value / unit, ratio, seen, 1.0 / (1.0 - ratio));
+        } else {
+            fprintf(p_out, "%12.3f %14.12f %10lu\n", (double)value / unit,
+                    ratio, seen);
+        }
+    }
+
+    fprintf(p_out, "#[Mean    = %12.3f, Max     = %12.3f]\n",
+            (0 == p_hist->total) ? 0.0
+                                 : (p_hist->sum / (double)p_hist->total / unit),
+            (double)p_hist->max / unit);
+    fprintf(p_out, "#[Total count    = %12lu]\n", p_hist->total);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
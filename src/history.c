@@ -0,0 +1,221 @@
+/**
+ * @file      history.c
+ *
+ * @brief     Bounded history of recent messages for replay
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup history
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "history.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static void history_release(history_t* p_history);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Release oldest entry
+ *
+ * @param p_history pointer to history, not empty
+ */
+static void history_release(history_t* p_history) {
+    history_entry_t* p_entry =
+        &p_history->p_entries[p_history->tail & p_history->mask];
+
+    msg_unref(p_entry->p_msg);
+    p_entry->p_msg = NULL;
+    p_history->tail++;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Init history
+ *
+ * @param p_history pointer to history
+ * @param cap max count of messages, rounded up to power of 2. 0 - disabled
+ * @param age_ns max age of message in ns, 0 - unlimited
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t history_init(history_t* p_history, size_t cap, uint64_t age_ns) {
+    if (NULL == p_history) {
+        return HISTORY_ERR_PARAMS;
+    }
+
+    p_history->p_entries = NULL;
+    p_history->mask = 0;
+    p_history->head = 0;
+    p_history->tail = 0;
+    p_history->age_ns = age_ns;
+
+    if (0 == cap) {
+        return HISTORY_ERR_OK;
+    }
+
+    size_t size = 1;
+    while (size < cap) {
+        size <<= 1;
+    }
+
+    p_history->p_entries = calloc(size, sizeof(history_entry_t));
+    if (NULL == p_history->p_entries) {
+        return HISTORY_ERR_NOMEM;
+    }
+    p_history->mask = size - 1;
+
+    return HISTORY_ERR_OK;
+}
+
+/**
+ * @brief Deinit history and release all messages
+ *
+ * @param p_history pointer to history
+ */
+void history_deinit(history_t* p_history) {
+    if ((NULL == p_history) || (NULL == p_history->p_entries)) {
+        return;
+    }
+
+    while (p_history->tail < p_history->head) {
+        history_release(p_history);
+    }
+
+    free(p_history->p_entries);
+    p_history->p_entries = NULL;
+}
+
+/**
+ * @brief Check if history retains messages
+ *
+ * @param p_history pointer to history
+ * @return bool true if enabled
+ */
+bool history_enabled(const history_t* p_history) {
+    return (NULL != p_history) && (NULL != p_history->p_entries);
+}
+
+/**
+ * @brief Append message, releasing the oldest one if history is full
+ *
+ * @param p_history pointer to history
+ * @param p_msg message. History takes own reference
+ * @param seq server sequence number of message
+ */
+void history_push(history_t* p_history, msg_t* p_msg, uint64_t seq) {
+    if (!history_enabled(p_history) || (NULL == p_msg)) {
+        return;
+    }
+
+    history_expire(p_history, p_msg->ts);
+
+    if ((p_history->head - p_history->tail) > p_history->mask) {
+        history_release(p_history);
+    }
+
+    history_entry_t* p_entry =
+        &p_history->p_entries[p_history->head & p_history->mask];
+    p_entry->p_msg = msg_ref(p_msg);
+    p_entry->seq = seq;
+    p_entry->ts = p_msg->ts;
+    p_history->head++;
+}
+
+/**
+ * @brief Release messages older than max age
+ *
+ * @param p_history pointer to history
+ * @param now current time in ns, the same clock as message time
+ */
+void history_expire(history_t* p_history, uint64_t now) {
+    if (!history_enabled(p_history) || (0 == p_history->age_ns) ||
+        (now < p_history->age_ns)) {
+        return;
+    }
+
+    const uint64_t oldest = now - p_history->age_ns;
+
+    // NOTE: messages of other shards may be a bit out of receive order, so
+    // expiry stops at the first fresh one
+    while ((p_history->tail < p_history->head) &&
+           (p_history->p_entries[p_history->tail & p_history->mask].ts <
+            oldest)) {
+        history_release(p_history);
+    }
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,932 @@
+/**
+ * @file      journal.c
+ *
+ * @brief     Memory-mapped append-only message journal
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup journal
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "journal.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "log.h"
+#include "proto.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/** Size of record with header and padding */
+#define JOURNAL_REC_LEN(size) \
+    ((sizeof(journal_rec_t) + (size_t)(size) + 7u) & ~(size_t)7u)
+/** Smallest record - frame without payload */
+#define JOURNAL_REC_MIN JOURNAL_REC_LEN(PROTO_HDR_SIZE)
+/** Largest record - frame with max payload */
+#define JOURNAL_REC_MAX \
+    JOURNAL_REC_LEN(PROTO_HDR_SIZE + CONFIG_PROTO_PAYLOAD_MAX)
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static uint32_t journal_sum(uint64_t seq, const uint8_t* p_buf, size_t len);
+static size_t journal_rec_check(const uint8_t* p_map, size_t size, size_t off);
+static void journal_path(const journal_t* p_journal, uint64_t first,
+                         const char* p_suffix, char* p_path);
+static int journal_cmp(const void* p_a, const void* p_b);
+static int32_t journal_segs_add(journal_t* p_journal, uint64_t first);
+static int32_t journal_scan(journal_t* p_journal);
+static int32_t journal_file_map(const char* p_path, size_t size, int* p_fd,
+                                void** pp_map, size_t* p_size);
+static int32_t journal_seg_open(journal_t* p_journal, uint64_t first,
+                                bool create);
+static void journal_seg_recover(journal_t* p_journal);
+static void journal_seg_close(journal_seg_t* p_seg);
+static void journal_sync(journal_t* p_journal);
+static int32_t journal_rotate(journal_t* p_journal);
+static void journal_write(journal_t* p_journal, const msg_t* p_msg);
+static size_t journal_drain(journal_t* p_journal);
+static uint64_t journal_now_ms(void);
+static int32_t journal_iter_map(journal_iter_t* p_iter, size_t seg);
+static void* journal_writer(void* p_arg);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief FNV-1a checksum of record: sequence number and frame
+ *
+ * @param seq sequence number of record
+ * @param p_buf data
+ * @param len data length
+ * @return uint32_t checksum
+ */
+static uint32_t journal_sum(uint64_t seq, const uint8_t* p_buf, size_t len) {
+    uint32_t sum = 2166136261u;
+
+    for (size_t idx = 0; idx < sizeof(seq); idx++) {
+        sum ^= (uint8_t)(seq >> (idx * 8u));
+        sum *= 16777619u;
+    }
+
+    for (size_t idx = 0; idx < len; idx++) {
+        sum ^= p_buf[idx];
+        sum *= 16777619u;
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Check record at offset
+ *
+ * @param p_map mapped segment
+ * @param size segment size
+ * @param off record offset
+ * @return size_t frame size or 0 if there is no valid record
+ */
+static size_t journal_rec_check(const uint8_t* p_map, size_t size, size_t off) {
+    journal_rec_t rec;
+
+    if ((off + sizeof(rec)) > size) {
+        return 0;
+    }
+
+    memcpy(&rec, &p_map[off], sizeof(rec));
+    if ((rec.size < PROTO_HDR_SIZE) ||
+        (JOURNAL_REC_LEN(rec.size) > (size - off)) ||
+        (rec.sum !=
+         journal_sum(rec.seq, &p_map[off + sizeof(rec)], rec.size))) {
+        return 0;
+    }
+
+    return rec.size;
+}
+
+/**
+ * @brief Build path of segment or index file
+ *
+ * @param p_journal pointer to journal
+ * @param first first record of segment
+ * @param p_suffix JOURNAL_SEG_SUFFIX or JOURNAL_IDX_SUFFIX
+ * @param p_path output, PATH_MAX bytes
+ */
+static void journal_path(const journal_t* p_journal, uint64_t first,
+                         const char* p_suffix, char* p_path) {
+    snprintf(p_path, PATH_MAX, "%s/%020" PRIu64 "%s", p_journal->dir, first,
+             p_suffix);
+}
+
+/**
+ * @brief Compare first records of segments for qsort
+ *
+ * @param p_a pointer to first record
+ * @param p_b pointer to first record
+ * @return int order
+ */
+static int journal_cmp(const void* p_a, const void* p_b) {
+    const uint64_t a = *(const uint64_t*)p_a;
+    const uint64_t b = *(const uint64_t*)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Append segment to list
+ *
+ * @param p_journal pointer to journal
+ * @param first first record of segment
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_segs_add(journal_t* p_journal, uint64_t first) {
+    if (p_journal->segs_count == p_journal->segs_cap) {
+        const size_t cap =
+            (0 == p_journal->segs_cap) ? 16u : (2u * p_journal->segs_cap);
+        uint64_t* p_segs = realloc(p_journal->p_segs, cap * sizeof(uint64_t));
+        if (NULL == p_segs) {
+            return JOURNAL_ERR_NOMEM;
+        }
+        p_journal->p_segs = p_segs;
+        p_journal->segs_cap = cap;
+    }
+
+    p_journal->p_segs[p_journal->segs_count++] = first;
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Find segments in directory, oldest first
+ *
+ * @param p_journal pointer to journal
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_scan(journal_t* p_journal) {
+    DIR* p_dir = opendir(p_journal->dir);
+    if (NULL == p_dir) {
+        return JOURNAL_ERR_IO;
+    }
+
+    int32_t ret = JOURNAL_ERR_OK;
+    struct dirent* p_ent = NULL;
+    while ((JOURNAL_ERR_OK == ret) && (NULL != (p_ent = readdir(p_dir)))) {
+        char* p_end = NULL;
+        const uint64_t first = strtoull(p_ent->d_name, &p_end, 10);
+
+        if ((JOURNAL_NAME_LEN == strlen(p_ent->d_name)) &&
+            (0 == strcmp(p_end, JOURNAL_SEG_SUFFIX))) {
+            ret = journal_segs_add(p_journal, first);
+        }
+    }
+    closedir(p_dir);
+
+    if (p_journal->segs_count > 1) {
+        qsort(p_journal->p_segs, p_journal->segs_count, sizeof(uint64_t),
+              journal_cmp);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Map file for writing, creating and preallocating it if needed
+ *
+ * Blocks are allocated up front, so stores to mapping cannot fail on full
+ * disk later.
+ *
+ * @param p_path file path
+ * @param size size of new file, 0 - file must exist
+ * @param p_fd output: file descriptor
+ * @param pp_map output: mapping
+ * @param p_size output: mapped size
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_file_map(const char* p_path, size_t size, int* p_fd,
+                                void** pp_map, size_t* p_size) {
+    const int flags = O_RDWR | O_CLOEXEC | ((size > 0) ? O_CREAT : 0);
+    const int fd = open(p_path, flags, 0644);
+    if (-1 == fd) {
+        return JOURNAL_ERR_IO;
+    }
+
+    struct stat st;
+    if ((0 != fstat(fd, &st)) ||
+        ((size > 0) && (0 != posix_fallocate(fd, 0, (off_t)size)))) {
+        close(fd);
+        return JOURNAL_ERR_IO;
+    }
+
+    if (0 == size) {
+        size = (size_t)st.st_size;
+    }
+
+    void* p_map = (size > 0) ? mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED, fd, 0)
+                             : MAP_FAILED;
+    if (MAP_FAILED == p_map) {
+        close(fd);
+        return JOURNAL_ERR_IO;
+    }
+
+    *p_fd = fd;
+    *pp_map = p_map;
+    *p_size = size;
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Open segment and its index for writing
+ *
+ * @param p_journal pointer to journal
+ * @param first first record of segment
+ * @param create create new segment, else open existing one
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_seg_open(journal_t* p_journal, uint64_t first,
+                                bool create) {
+    journal_seg_t* p_seg = &p_journal->seg;
+    char path[PATH_MAX];
+    void* p_map = NULL;
+
+    memset(p_seg, 0x00, sizeof(journal_seg_t));
+    p_seg->first = first;
+    p_seg->fd = -1;
+    p_seg->idx_fd = -1;
+
+    journal_path(p_journal, first, JOURNAL_SEG_SUFFIX, path);
+    int32_t ret = journal_file_map(path, create ? p_journal->seg_size : 0,
+                                   &p_seg->fd, &p_map, &p_seg->size);
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+    p_seg->p_map = p_map;
+
+    // NOTE: enough entries for a segment of smallest records
+    const size_t idx_size =
+        ((p_seg->size / (CONFIG_JOURNAL_INDEX_STEP * JOURNAL_REC_MIN)) + 1u) *
+        sizeof(journal_idx_t);
+
+    journal_path(p_journal, first, JOURNAL_IDX_SUFFIX, path);
+    ret = journal_file_map(path, idx_size, &p_seg->idx_fd, &p_map,
+                           &p_seg->idx_cap);
+    if (JOURNAL_ERR_OK != ret) {
+        journal_seg_close(p_seg);
+        return ret;
+    }
+    p_seg->p_idx = p_map;
+    p_seg->idx_cap /= sizeof(journal_idx_t);
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Find end of written records of last segment after restart
+ *
+ * Scan starts from the last index entry pointing to a valid record. Torn
+ * record and stale index entries after it are cleared, so new records are
+ * never followed by garbage.
+ *
+ * @param p_journal pointer to journal
+ */
+static void journal_seg_recover(journal_t* p_journal) {
+    journal_seg_t* p_seg = &p_journal->seg;
+    uint64_t index = p_seg->first;
+    size_t off = 0;
+
+    for (size_t entry = p_seg->idx_cap; entry > 0; entry--) {
+        const journal_idx_t* p_idx = &p_seg->p_idx[entry - 1];
+        if ((p_idx->index ==
+             (p_seg->first + ((entry - 1) * CONFIG_JOURNAL_INDEX_STEP))) &&
+            (0 != journal_rec_check(p_seg->p_map, p_seg->size,
+                                    (size_t)p_idx->offset))) {
+            index = p_idx->index;
+            off = (size_t)p_idx->offset;
+            p_seg->idx_used = entry;
+            break;
+        }
+    }
+
+    size_t size = 0;
+    while (0 != (size = journal_rec_check(p_seg->p_map, p_seg->size, off))) {
+        if (((index - p_seg->first) ==
+             (p_seg->idx_used * CONFIG_JOURNAL_INDEX_STEP)) &&
+            (p_seg->idx_used < p_seg->idx_cap)) {
+            p_seg->p_idx[p_seg->idx_used].index = index;
+            p_seg->p_idx[p_seg->idx_used].offset = off;
+            p_seg->idx_used++;
+        }
+        off += JOURNAL_REC_LEN(size);
+        index++;
+    }
+
+    const size_t tail = p_seg->size - off;
+    memset(&p_seg->p_map[off], 0x00,
+           (tail < JOURNAL_REC_MAX) ? tail : JOURNAL_REC_MAX);
+    memset(&p_seg->p_idx[p_seg->idx_used], 0x00,
+           (p_seg->idx_cap - p_seg->idx_used) * sizeof(journal_idx_t));
+
+    p_seg->used = off;
+    p_seg->synced = 0;
+    p_seg->idx_synced = 0;
+    p_journal->next = index;
+}
+
+/**
+ * @brief Unmap and close segment. Written data stays in page cache
+ *
+ * @param p_seg pointer to segment
+ */
+static void journal_seg_close(journal_seg_t* p_seg) {
+    if (NULL != p_seg->p_map) {
+        munmap(p_seg->p_map, p_seg->size);
+        p_seg->p_map = NULL;
+    }
+
+    if (NULL != p_seg->p_idx) {
+        munmap(p_seg->p_idx, p_seg->idx_cap * sizeof(journal_idx_t));
+        p_seg->p_idx = NULL;
+    }
+
+    if (-1 != p_seg->fd) {
+        close(p_seg->fd);
+        p_seg->fd = -1;
+    }
+
+    if (-1 != p_seg->idx_fd) {
+        close(p_seg->idx_fd);
+        p_seg->idx_fd = -1;
+    }
+}
+
+/**
+ * @brief Group commit: write back all records appended since last sync
+ *
+ * @param p_journal pointer to journal
+ */
+static void journal_sync(journal_t* p_journal) {
+    journal_seg_t* p_seg = &p_journal->seg;
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (p_seg->used > p_seg->synced) {
+        const size_t start = p_seg->synced & ~(page - 1u);
+        if (0 != msync(&p_seg->p_map[start], p_seg->used - start, MS_SYNC)) {
+            LOG_ERROR("[JOURNAL] Error: cannot sync segment <%" PRIu64
+                      ">. Errno <%d>",
+                      p_seg->first, errno);
+        }
+        p_seg->synced = p_seg->used;
+        p_journal->stats.syncs++;
+    }
+
+    if (p_seg->idx_used > p_seg->idx_synced) {
+        const size_t start =
+            (p_seg->idx_synced * sizeof(journal_idx_t)) & ~(page - 1u);
+        const size_t end = p_seg->idx_used * sizeof(journal_idx_t);
+        msync((uint8_t*)p_seg->p_idx + start, end - start, MS_SYNC);
+        p_seg->idx_synced = p_seg->idx_used;
+    }
+}
+
+/**
+ * @brief Close full segment, start next one and remove segments over limit
+ *
+ * @param p_journal pointer to journal
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_rotate(journal_t* p_journal) {
+    char path[PATH_MAX];
+
+    journal_sync(p_journal);
+    journal_seg_close(&p_journal->seg);
+
+    int32_t ret = journal_seg_open(p_journal, p_journal->next, true);
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+
+    ret = journal_segs_add(p_journal, p_journal->next);
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+    p_journal->stats.rotations++;
+
+    while (p_journal->segs_count > p_journal->segs_max) {
+        journal_path(p_journal, p_journal->p_segs[0], JOURNAL_SEG_SUFFIX, path);
+        unlink(path);
+        journal_path(p_journal, p_journal->p_segs[0], JOURNAL_IDX_SUFFIX, path);
+        unlink(path);
+
+        p_journal->segs_count--;
+        memmove(p_journal->p_segs, &p_journal->p_segs[1],
+                p_journal->segs_count * sizeof(uint64_t));
+    }
+
+    LOG_INFO("[JOURNAL] Segment <%020" PRIu64 "> started", p_journal->next);
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Append message to segment
+ *
+ * Frame is stored before its header, so a reader never takes a header of
+ * incomplete record.
+ *
+ * @param p_journal pointer to journal
+ * @param p_msg message, whole data frame
+ */
+static void journal_write(journal_t* p_journal, const msg_t* p_msg) {
+    journal_seg_t* p_seg = &p_journal->seg;
+    const size_t len = JOURNAL_REC_LEN(p_msg->len);
+
+    if (((p_seg->used + len) > p_seg->size) &&
+        (JOURNAL_ERR_OK != journal_rotate(p_journal))) {
+        LOG_ERROR("[JOURNAL] Error: cannot start segment <%020" PRIu64
+                  ">. Errno <%d>",
+                  p_journal->next, errno);
+        p_journal->stats.drops++;
+        return;
+    }
+
+    if (((p_journal->next - p_seg->first) ==
+         (p_seg->idx_used * CONFIG_JOURNAL_INDEX_STEP)) &&
+        (p_seg->idx_used < p_seg->idx_cap)) {
+        p_seg->p_idx[p_seg->idx_used].index = p_journal->next;
+        p_seg->p_idx[p_seg->idx_used].offset = p_seg->used;
+        p_seg->idx_used++;
+    }
+
+    const journal_rec_t rec = {
+        .size = (uint32_t)p_msg->len,
+        .sum = journal_sum(p_msg->seq, p_msg->data, p_msg->len),
+        .seq = p_msg->seq};
+    memcpy(&p_seg->p_map[p_seg->used + sizeof(rec)], p_msg->data, p_msg->len);
+    memcpy(&p_seg->p_map[p_seg->used], &rec, sizeof(rec));
+
+    p_seg->used += len;
+    p_journal->next++;
+    p_journal->stats.records++;
+    p_journal->stats.bytes += len;
+}
+
+/**
+ * @brief Append batch of queued messages
+ *
+ * @param p_journal pointer to journal
+ * @return size_t count of appended messages
+ */
+static size_t journal_drain(journal_t* p_journal) {
+    void* p_data = NULL;
+    size_t count = 0;
+
+    while ((count < CONFIG_JOURNAL_BATCH) &&
+           (RING_ERR_OK == ring_mpsc_pop(&p_journal->queue, &p_data))) {
+        // NOTE: segment may be unavailable after failed rotation
+        if (NULL != p_journal->seg.p_map) {
+            journal_write(p_journal, (const msg_t*)p_data);
+        } else {
+            p_journal->stats.drops++;
+        }
+        msg_unref((msg_t*)p_data);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get monotonic time
+ *
+ * @return uint64_t time in milliseconds
+ */
+static uint64_t journal_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000u) + ((uint64_t)ts.tv_nsec / 1000000u);
+}
+
+/**
+ * @brief Map segment of journal for reading
+ *
+ * @param p_iter pointer to reader, previous segment is unmapped
+ * @param seg position in segments list
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t journal_iter_map(journal_iter_t* p_iter, size_t seg) {
+    const journal_t* p_journal = p_iter->p_journal;
+    char path[PATH_MAX];
+    struct stat st;
+
+    journal_iter_deinit(p_iter);
+
+    journal_path(p_journal, p_journal->p_segs[seg], JOURNAL_SEG_SUFFIX, path);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd) {
+        return JOURNAL_ERR_IO;
+    }
+
+    void* p_map = MAP_FAILED;
+    if ((0 == fstat(fd, &st)) && (st.st_size > 0)) {
+        p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (MAP_FAILED == p_map) {
+        return JOURNAL_ERR_IO;
+    }
+
+    p_iter->seg = seg;
+    p_iter->p_map = p_map;
+    p_iter->size = (size_t)st.st_size;
+    p_iter->off = 0;
+    p_iter->index = p_journal->p_segs[seg];
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Writer thread. Appends queued messages and commits them in groups
+ *
+ * Sync happens when CONFIG_JOURNAL_SYNC_BYTES are pending or the oldest
+ * pending record waits CONFIG_JOURNAL_SYNC_MS, so under load one msync
+ * covers thousands of records.
+ *
+ * @param p_arg pointer to journal
+ * @return void* NULL
+ */
+static void* journal_writer(void* p_arg) {
+    journal_t* p_journal = (journal_t*)p_arg;
+    const journal_seg_t* p_seg = &p_journal->seg;
+    const struct timespec idle = {.tv_sec = 0,
+                                  .tv_nsec = CONFIG_JOURNAL_IDLE_US * 1000};
+    uint64_t sync_ms = journal_now_ms();
+
+    while (atomic_load(&p_journal->running)) {
+        const size_t count = journal_drain(p_journal);
+        const uint64_t now = journal_now_ms();
+
+        if (p_seg->used == p_seg->synced) {
+            sync_ms = now;
+        } else if (((now - sync_ms) >= CONFIG_JOURNAL_SYNC_MS) ||
+                   ((p_seg->used - p_seg->synced) >=
+                    CONFIG_JOURNAL_SYNC_BYTES)) {
+            journal_sync(p_journal);
+            sync_ms = now;
+        }
+
+        const uint64_t drops = atomic_exchange(&p_journal->drops, 0);
+        if (drops > 0) {
+            p_journal->stats.drops += drops;
+            LOG_WARN("[JOURNAL] Queue is full. Lost <%" PRIu64 "> messages",
+                     drops);
+        }
+
+        if (0 == count) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Open journal directory and recover end of the last segment
+ *
+ * Directory is created if needed. Records written before a crash are kept
+ * up to the first torn one.
+ *
+ * @param p_journal pointer to journal
+ * @param p_dir journal directory
+ * @param seg_size size of new segments, at least one max frame
+ * @param segs_max max count of segments kept, older are removed
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t journal_open(journal_t* p_journal, const char* p_dir, size_t seg_size,
+                     size_t segs_max) {
+    if ((NULL == p_journal) || (NULL == p_dir) ||
+        (strlen(p_dir) >= JOURNAL_DIR_MAX) ||
+        (seg_size < JOURNAL_REC_MAX) || (0 == segs_max)) {
+        return JOURNAL_ERR_PARAMS;
+    }
+
+    memset(p_journal, 0x00, sizeof(journal_t));
+    strcpy(p_journal->dir, p_dir);
+    p_journal->seg_size = seg_size;
+    p_journal->segs_max = segs_max;
+    p_journal->seg.fd = -1;
+    p_journal->seg.idx_fd = -1;
+    atomic_init(&p_journal->running, false);
+    atomic_init(&p_journal->drops, 0);
+
+    if ((0 != mkdir(p_dir, 0755)) && (EEXIST != errno)) {
+        return JOURNAL_ERR_IO;
+    }
+
+    int32_t ret = journal_scan(p_journal);
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+
+    if (0 == p_journal->segs_count) {
+        ret = journal_seg_open(p_journal, 0, true);
+        if (JOURNAL_ERR_OK == ret) {
+            ret = journal_segs_add(p_journal, 0);
+        }
+    } else {
+        ret = journal_seg_open(
+            p_journal, p_journal->p_segs[p_journal->segs_count - 1u], false);
+        if (JOURNAL_ERR_OK == ret) {
+            journal_seg_recover(p_journal);
+        }
+    }
+
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+
+    if (RING_ERR_OK !=
+        ring_mpsc_init(&p_journal->queue, CONFIG_JOURNAL_QUEUE_SIZE)) {
+        journal_seg_close(&p_journal->seg);
+        return JOURNAL_ERR_NOMEM;
+    }
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Start writer thread
+ *
+ * @param p_journal pointer to opened journal
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t journal_start(journal_t* p_journal) {
+    if ((NULL == p_journal) || (NULL == p_journal->seg.p_map)) {
+        return JOURNAL_ERR_PARAMS;
+    }
+
+    if (atomic_exchange(&p_journal->running, true)) {
+        return JOURNAL_ERR_OK;
+    }
+
+    if (0 != pthread_create(&p_journal->thread, NULL, journal_writer,
+                            p_journal)) {
+        atomic_store(&p_journal->running, false);
+        return JOURNAL_ERR_THREAD;
+    }
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Stop writer, append and sync queued messages, close journal
+ *
+ * @param p_journal pointer to journal
+ */
+void journal_close(journal_t* p_journal) {
+    if (NULL == p_journal) {
+        return;
+    }
+
+    if (atomic_exchange(&p_journal->running, false)) {
+        pthread_join(p_journal->thread, NULL);
+    }
+
+    while (journal_drain(p_journal) > 0) {
+    }
+
+    if (NULL != p_journal->seg.p_map) {
+        journal_sync(p_journal);
+    }
+    journal_seg_close(&p_journal->seg);
+    ring_mpsc_deinit(&p_journal->queue);
+    free(p_journal->p_segs);
+    p_journal->p_segs = NULL;
+    p_journal->segs_count = 0;
+}
+
+/**
+ * @brief Queue message to journal. Never blocks, safe from any thread
+ *
+ * @param p_journal pointer to journal
+ * @param p_msg message, whole data frame, and its sequence number. Journal
+ * takes own reference
+ * @return int32_t 0 if OK, JOURNAL_ERR_FULL if writer is behind
+ */
+int32_t journal_append(journal_t* p_journal, msg_t* p_msg) {
+    if ((NULL == p_journal) || (NULL == p_msg)) {
+        return JOURNAL_ERR_PARAMS;
+    }
+
+    if (RING_ERR_OK != ring_mpsc_push(&p_journal->queue, msg_ref(p_msg))) {
+        msg_unref(p_msg);
+        atomic_fetch_add(&p_journal->drops, 1);
+        return JOURNAL_ERR_FULL;
+    }
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Start reading records from given number
+ *
+ * Sparse index gives offset of a record at most CONFIG_JOURNAL_INDEX_STEP
+ * records before the wanted one. Must not run together with writer.
+ *
+ * @param p_journal pointer to journal
+ * @param p_iter pointer to reader
+ * @param from number of first record, older than retained - from the oldest
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t journal_iter_init(const journal_t* p_journal, journal_iter_t* p_iter,
+                          uint64_t from) {
+    if ((NULL == p_journal) || (NULL == p_iter)) {
+        return JOURNAL_ERR_PARAMS;
+    }
+
+    memset(p_iter, 0x00, sizeof(journal_iter_t));
+    p_iter->p_journal = p_journal;
+
+    if ((0 == p_journal->segs_count) || (from >= p_journal->next)) {
+        return JOURNAL_ERR_EMPTY;
+    }
+
+    if (from < journal_first(p_journal)) {
+        from = journal_first(p_journal);
+    }
+
+    size_t seg = 0;
+    while (((seg + 1u) < p_journal->segs_count) &&
+           (p_journal->p_segs[seg + 1u] <= from)) {
+        seg++;
+    }
+
+    int32_t ret = journal_iter_map(p_iter, seg);
+    if (JOURNAL_ERR_OK != ret) {
+        return ret;
+    }
+
+    const uint64_t first = p_journal->p_segs[seg];
+    char path[PATH_MAX];
+
+    // NOTE: without index entry the segment is scanned from start
+    const uint64_t entry = (from - first) / CONFIG_JOURNAL_INDEX_STEP;
+    journal_idx_t idx = {0};
+    journal_path(p_journal, first, JOURNAL_IDX_SUFFIX, path);
+    const int idx_fd = open(path, O_RDONLY | O_CLOEXEC);
+    if ((-1 != idx_fd) &&
+        (sizeof(idx) == pread(idx_fd, &idx, sizeof(idx),
+                              (off_t)(entry * sizeof(idx)))) &&
+        (idx.index == (first + (entry * CONFIG_JOURNAL_INDEX_STEP))) &&
+        (0 != journal_rec_check(p_iter->p_map, p_iter->size,
+                                (size_t)idx.offset))) {
+        p_iter->index = idx.index;
+        p_iter->off = (size_t)idx.offset;
+    }
+    if (-1 != idx_fd) {
+        close(idx_fd);
+    }
+
+    const uint8_t* p_frame = NULL;
+    size_t size = 0;
+    uint64_t seq = 0;
+    while (p_iter->index < from) {
+        if (JOURNAL_ERR_OK !=
+            journal_iter_next(p_iter, &p_frame, &size, &seq)) {
+            return JOURNAL_ERR_EMPTY;
+        }
+    }
+
+    return JOURNAL_ERR_OK;
+}
+
+/**
+ * @brief Get next record
+ *
+ * @param p_iter pointer to reader
+ * @param pp_frame output: frame, valid until next call
+ * @param p_size output: frame size
+ * @param p_seq output: sequence number of message
+ * @return int32_t 0 if OK, JOURNAL_ERR_EMPTY after the last record
+ */
+int32_t journal_iter_next(journal_iter_t* p_iter, const uint8_t** pp_frame,
+                          size_t* p_size, uint64_t* p_seq) {
+    if ((NULL == p_iter) || (NULL == pp_frame) || (NULL == p_size) ||
+        (NULL == p_seq)) {
+        return JOURNAL_ERR_PARAMS;
+    }
+
+    while (NULL != p_iter->p_map) {
+        const size_t size =
+            journal_rec_check(p_iter->p_map, p_iter->size, p_iter->off);
+        if (0 != size) {
+            journal_rec_t rec;
+            memcpy(&rec, &p_iter->p_map[p_iter->off], sizeof(rec));
+            *pp_frame = &p_iter->p_map[p_iter->off + sizeof(rec)];
+            *p_size = size;
+            *p_seq = rec.seq;
+            p_iter->off += JOURNAL_REC_LEN(size);
+            p_iter->index++;
+            return JOURNAL_ERR_OK;
+        }
+
+        // NOTE: end of segment data - continue with the next segment
+        if (((p_iter->seg + 1u) >= p_iter->p_journal->segs_count) ||
+            (JOURNAL_ERR_OK != journal_iter_map(p_iter, p_iter->seg + 1u))) {
+            journal_iter_deinit(p_iter);
+        }
+    }
+
+    return JOURNAL_ERR_EMPTY;
+}
+
+/**
+ * @brief Release reader
+ *
+ * @param p_iter pointer to reader
+ */
+void journal_iter_deinit(journal_iter_t* p_iter) {
+    if ((NULL == p_iter) || (NULL == p_iter->p_map)) {
+        return;
+    }
+
+    munmap((void*)p_iter->p_map, p_iter->size);
+    p_iter->p_map = NULL;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,841 @@
+/**
+ * @file      log.c
+ *
+ * @brief     Asynchronous logging
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup log
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "log.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define LOG_REC_PAD ((uint16_t)0xFFFF) /**< Record level - skip to ring end */
+#define LOG_ALIGN(size) (((size) + 7u) & ~(size_t)7u) /**< Record alignment */
+#define LOG_SPEC_MAX ((size_t)32) /**< Max length of one conversion spec */
+
+/** Argument class of conversion */
+typedef enum log_arg_e {
+    LOG_ARG_NONE = 0, /**< Unsupported conversion - rest is printed as is */
+    LOG_ARG_INT,      /**< Signed integer, stored as int64_t */
+    LOG_ARG_UINT,     /**< Unsigned integer, stored as uint64_t */
+    LOG_ARG_CHAR,     /**< Character, stored as int64_t */
+    LOG_ARG_DOUBLE,   /**< Floating point, stored as double */
+    LOG_ARG_PTR,      /**< Pointer, stored as uint64_t */
+    LOG_ARG_STR,      /**< String, stored as length and bytes */
+} log_arg_t;
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/** Header of binary record. Arguments follow in 8 byte slots */
+typedef struct log_rec_s {
+    uint32_t size;       /**< Record size with header, aligned to 8 */
+    uint16_t level;      /**< LOG_LEVEL_* or LOG_REC_PAD */
+    uint16_t reserved;   /**< Reserved */
+    const char* p_fmt;   /**< Format, string literal */
+} log_rec_t;
+
+/** Parsed conversion spec */
+typedef struct log_spec_s {
+    const char* p_start; /**< Points to '%' */
+    const char* p_flags; /**< Flags and width, without '*' */
+    size_t flags_len;    /**< Length of flags and width */
+    bool star_width;     /**< Width is argument */
+    bool has_prec;       /**< Precision is given */
+    bool star_prec;      /**< Precision is argument */
+    int prec;            /**< Precision if given by digits */
+    char length;         /**< 'H' hh, 'h', 'l', 'q' ll, 'z', 'j', 't', 'L' */
+    char conv;           /**< Conversion character */
+    log_arg_t arg;       /**< Argument class */
+} log_spec_t;
+
+/**
+ * Ring of one producer thread.
+ *
+ * Producer owns head, writer owns tail. Indexes grow forever and are masked
+ * on access.
+ */
+typedef struct log_ring_s {
+    _Alignas(64) atomic_size_t head; /**< Write position, producer */
+    atomic_uint_fast64_t drops;      /**< Records lost on full ring */
+    _Alignas(64) atomic_size_t tail; /**< Read position, writer */
+    uint64_t drops_seen;             /**< Drops already reported, writer */
+    uint8_t* p_buf;                  /**< CONFIG_LOG_RING_SIZE bytes */
+    atomic_bool ready;               /**< Buffer is published to writer */
+} log_ring_t;
+
+/** Output batch of one descriptor */
+typedef struct log_out_s {
+    int fd;                        /**< Destination */
+    size_t len;                    /**< Bytes in buffer */
+    char buf[CONFIG_LOG_OUT_SIZE]; /**< Formatted lines */
+} log_out_t;
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static log_ring_t g_rings[CONFIG_LOG_THREADS_MAX]; /**< Rings of threads */
+static atomic_size_t g_rings_count;                /**< Registered rings */
+static atomic_uint_fast64_t g_drops_unregistered;  /**< Threads over max */
+static _Thread_local log_ring_t* g_p_ring = NULL;  /**< Ring of thread */
+
+static atomic_bool g_started;   /**< Writer runs, records are queued */
+static atomic_bool g_running;   /**< Writer should keep running */
+static pthread_t g_writer;      /**< Writer thread */
+static pthread_mutex_t g_drain_lock = PTHREAD_MUTEX_INITIALIZER; /**< Writer
+                                                                    side */
+static log_out_t g_out = {.fd = STDOUT_FILENO}; /**< Info and debug */
+static log_out_t g_err = {.fd = STDERR_FILENO}; /**< Errors and warnings */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+int g_log_level = CONFIG_LOG_LEVEL; /**< Max enabled level */
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static const char* log_spec_parse(const char* p_fmt, log_spec_t* p_spec);
+static size_t log_encode(uint8_t* p_rec, int level, const char* p_fmt,
+                         va_list args);
+static log_ring_t* log_ring_get(void);
+static bool log_ring_push(log_ring_t* p_ring, const uint8_t* p_rec);
+static size_t log_format(char* p_line, size_t size, const log_rec_t* p_rec);
+static void log_out_write(log_out_t* p_out);
+static void log_out_put(log_out_t* p_out, const char* p_line, size_t len);
+static size_t log_drain(void);
+static void* log_writer(void* p_arg);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Parse one conversion spec
+ *
+ * @param p_fmt points right after '%'
+ * @param p_spec output spec
+ * @return const char* position after spec
+ */
+static const char* log_spec_parse(const char* p_fmt, log_spec_t* p_spec) {
+    memset(p_spec, 0x00, sizeof(log_spec_t));
+    p_spec->p_start = p_fmt - 1;
+    p_spec->p_flags = p_fmt;
+
+    while ((NULL != strchr("-+ #0", *p_fmt)) && ('\0' != *p_fmt)) {
+        p_fmt++;
+    }
+
+    if ('*' == *p_fmt) {
+        p_spec->star_width = true;
+        p_spec->flags_len = (size_t)(p_fmt - p_spec->p_flags);
+        p_fmt++;
+    } else {
+        while ((*p_fmt >= '0') && (*p_fmt <= '9')) {
+            p_fmt++;
+        }
+        p_spec->flags_len = (size_t)(p_fmt - p_spec->p_flags);
+    }
+
+    if ('.' == *p_fmt) {
+        p_fmt++;
+        p_spec->has_prec = true;
+        if ('*' == *p_fmt) {
+            p_spec->star_prec = true;
+            p_fmt++;
+        } else {
+            while ((*p_fmt >= '0') && (*p_fmt <= '9')) {
+                p_spec->prec = (p_spec->prec * 10) + (*p_fmt - '0');
+                p_fmt++;
+            }
+        }
+    }
+
+    switch (*p_fmt) {
+        case 'h':
+            p_spec->length = ('h' == p_fmt[1]) ? 'H' : 'h';
+            p_fmt += ('H' == p_spec->length) ? 2 : 1;
+            break;
+        case 'l':
+            p_spec->length = ('l' == p_fmt[1]) ? 'q' : 'l';
+            p_fmt += ('q' == p_spec->length) ? 2 : 1;
+            break;
+        case 'z':
+        case 'j':
+        case 't':
+        case 'L':
+            p_spec->length = *p_fmt++;
+            break;
+        default:
+            break;
+    }
+
+    p_spec->conv = *p_fmt;
+    if ('\0' == *p_fmt) {
+        return p_fmt;
+    }
+
+    if (NULL != strchr("di", p_spec->conv)) {
+        p_spec->arg = LOG_ARG_INT;
+    } else if (NULL != strchr("uoxX", p_spec->conv)) {
+        p_spec->arg = LOG_ARG_UINT;
+    } else if ('c' == p_spec->conv) {
+        p_spec->arg = LOG_ARG_CHAR;
+    } else if (NULL != strchr("eEfFgGaA", p_spec->conv)) {
+        p_spec->arg = LOG_ARG_DOUBLE;
+    } else if ('p' == p_spec->conv) {
+        p_spec->arg = LOG_ARG_PTR;
+    } else if ('s' == p_spec->conv) {
+        p_spec->arg = LOG_ARG_STR;
+    }
+
+    return p_fmt + 1;
+}
+
+/**
+ * @brief Store arguments as binary record. Nothing is formatted here
+ *
+ * @param p_rec output, CONFIG_LOG_REC_MAX bytes, 8 byte aligned
+ * @param level record level
+ * @param p_fmt format
+ * @param args arguments
+ * @return size_t record size
+ */
+static size_t log_encode(uint8_t* p_rec, int level, const char* p_fmt,
+                         va_list args) {
+    log_rec_t* p_hdr = (log_rec_t*)p_rec;
+    size_t size = sizeof(log_rec_t);
+
+    p_hdr->level = (uint16_t)level;
+    p_hdr->p_fmt = p_fmt;
+
+    while ('\0' != *p_fmt) {
+        if ('%' != *p_fmt++) {
+            continue;
+        }
+
+        if ('%' == *p_fmt) {
+            p_fmt++;
+            continue;
+        }
+
+        log_spec_t spec;
+        p_fmt = log_spec_parse(p_fmt, &spec);
+        if (LOG_ARG_NONE == spec.arg) {
+            break;
+        }
+
+        // NOTE: string needs at least length slot, other args one slot
+        if ((size + (3 * sizeof(uint64_t))) > CONFIG_LOG_REC_MAX) {
+            break;
+        }
+
+        int64_t* p_slot = (int64_t*)&p_rec[size];
+        int prec = spec.prec;
+
+        if (spec.star_width) {
+            *p_slot++ = va_arg(args, int);
+        }
+        if (spec.star_prec) {
+            prec = va_arg(args, int);
+            *p_slot++ = prec;
+        }
+
+        switch (spec.arg) {
+            case LOG_ARG_INT:
+                if ('l' == spec.length) {
+                    *p_slot = va_arg(args, long);
+                } else if ('q' == spec.length) {
+                    *p_slot = va_arg(args, long long);
+                } else if ('z' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, ssize_t);
+                } else if ('j' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, intmax_t);
+                } else if ('t' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, ptrdiff_t);
+                } else {
+                    *p_slot = va_arg(args, int);
+                }
+                break;
+
+            case LOG_ARG_UINT:
+                if ('l' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, unsigned long);
+                } else if ('q' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, unsigned long long);
+                } else if ('z' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, size_t);
+                } else if ('j' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, uintmax_t);
+                } else if ('t' == spec.length) {
+                    *p_slot = (int64_t)va_arg(args, ptrdiff_t);
+                } else {
+                    *p_slot = (int64_t)va_arg(args, unsigned int);
+                }
+                break;
+
+            case LOG_ARG_CHAR:
+                *p_slot = va_arg(args, int);
+                break;
+
+            case LOG_ARG_DOUBLE: {
+                double value = ('L' == spec.length)
+                                   ? (double)va_arg(args, long double)
+                                   : va_arg(args, double);
+                memcpy(p_slot, &value, sizeof(value));
+            } break;
+
+            case LOG_ARG_PTR:
+                *p_slot = (int64_t)(uintptr_t)va_arg(args, void*);
+                break;
+
+            case LOG_ARG_STR:
+            default: {
+                const char* p_str = va_arg(args, const char*);
+                if (NULL == p_str) {
+                    p_str = "(null)";
+                }
+
+                // NOTE: precision bounds string which may be not terminated
+                uint8_t* p_data = (uint8_t*)(p_slot + 1);
+                size_t room = CONFIG_LOG_REC_MAX - (size_t)(p_data - p_rec);
+                size_t len = (spec.has_prec && (prec >= 0))
+                                 ? strnlen(p_str, (size_t)prec)
+                                 : strlen(p_str);
+                if (len > room) {
+                    len = room;
+                }
+
+                *p_slot = (int64_t)len;
+                memcpy(p_data, p_str, len);
+                p_slot = (int64_t*)(p_data + LOG_ALIGN(len)) - 1;
+            } break;
+        }
+
+        size = (size_t)((uint8_t*)(p_slot + 1) - p_rec);
+    }
+
+    p_hdr->size = (uint32_t)size;
+
+    return size;
+}
+
+/**
+ * @brief Get ring of calling thread, register it on first call
+ *
+ * @return log_ring_t* ring or NULL if no more rings
+ */
+static log_ring_t* log_ring_get(void) {
+    if (NULL != g_p_ring) {
+        return g_p_ring;
+    }
+
+    size_t idx = atomic_fetch_add(&g_rings_count, 1);
+    if (idx >= CONFIG_LOG_THREADS_MAX) {
+        atomic_fetch_sub(&g_rings_count, 1);
+        return NULL;
+    }
+
+    log_ring_t* p_ring = &g_rings[idx];
+    p_ring->p_buf = malloc(CONFIG_LOG_RING_SIZE);
+    if (NULL == p_ring->p_buf) {
+        // NOTE: slot stays registered but never ready
+        return NULL;
+    }
+
+    atomic_store_explicit(&p_ring->ready, true, memory_order_release);
+    g_p_ring = p_ring;
+
+    return p_ring;
+}
+
+/**
+ * @brief Copy record into ring. Never blocks
+ *
+ * @param p_ring pointer to ring
+ * @param p_rec record
+ * @return bool false if ring is full and record is dropped
+ */
+static bool log_ring_push(log_ring_t* p_ring, const uint8_t* p_rec) {
+    const size_t size = ((const log_rec_t*)p_rec)->size;
+    const size_t mask = CONFIG_LOG_RING_SIZE - 1;
+    size_t head = atomic_load_explicit(&p_ring->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&p_ring->tail, memory_order_acquire);
+    const size_t pos = head & mask;
+    const size_t contiguous = CONFIG_LOG_RING_SIZE - pos;
+    const size_t need = (size > contiguous) ? (size + contiguous) : size;
+
+    if ((CONFIG_LOG_RING_SIZE - (head - tail)) < need) {
+        return false;
+    }
+
+    // NOTE: record never wraps - the rest of ring is skipped
+    if (size > contiguous) {
+        log_rec_t* p_pad = (log_rec_t*)&p_ring->p_buf[pos];
+        p_pad->size = (uint32_t)contiguous;
+        p_pad->level = LOG_REC_PAD;
+        head += contiguous;
+    }
+
+    memcpy(&p_ring->p_buf[head & mask], p_rec, size);
+    atomic_store_explicit(&p_ring->head, head + size, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Format binary record to text line
+ *
+ * @param p_line output buffer
+ * @param size output buffer size
+ * @param p_rec record
+ * @return size_t line length, at most size - 1
+ */
+static size_t log_format(char* p_line, size_t size, const log_rec_t* p_rec) {
+    const uint8_t* p_arg = (const uint8_t*)(p_rec + 1);
+    const uint8_t* p_end = (const uint8_t*)p_rec + p_rec->size;
+    const char* p_fmt = p_rec->p_fmt;
+    size_t len = 0;
+
+    while (('\0' != *p_fmt) && (len < (size - 1))) {
+        if ('%' != *p_fmt) {
+            p_line[len++] = *p_fmt++;
+            continue;
+        }
+
+        if ('%' == p_fmt[1]) {
+            p_line[len++] = '%';
+            p_fmt += 2;
+            continue;
+        }
+
+        log_spec_t spec;
+        const char* p_next = log_spec_parse(p_fmt + 1, &spec);
+        if ((LOG_ARG_NONE == spec.arg) || (p_arg >= p_end)) {
+            // NOTE: unsupported or cut off - print the rest as is
+            int ret = snprintf(&p_line[len], size - len, "%s", p_fmt);
+            len += (ret > 0) ? (size_t)ret : 0;
+            break;
+        }
+
+        int stars[2];
+        int stars_count = 0;
+        int64_t slot = 0;
+
+        if (spec.star_width) {
+            memcpy(&slot, p_arg, sizeof(slot));
+            stars[stars_count++] = (int)slot;
+            p_arg += sizeof(slot);
+        }
+        if (spec.star_prec) {
+            memcpy(&slot, p_arg, sizeof(slot));
+            p_arg += sizeof(slot);
+            // NOTE: string precision is replaced by stored length below
+            if (LOG_ARG_STR != spec.arg) {
+                stars[stars_count++] = (int)slot;
+            }
+        }
+
+        memcpy(&slot, p_arg, sizeof(slot));
+        p_arg += sizeof(slot);
+
+        // NOTE: rebuild spec - integers are passed as long long
+        char fmt[LOG_SPEC_MAX];
+        size_t fmt_len = 0;
+        fmt[fmt_len++] = '%';
+        if (spec.flags_len < (LOG_SPEC_MAX - 16)) {
+            memcpy(&fmt[fmt_len], spec.p_flags, spec.flags_len);
+            fmt_len += spec.flags_len;
+        }
+        if (spec.star_width) {
+            fmt[fmt_len++] = '*';
+        }
+
+        const char* p_str = NULL;
+        if (LOG_ARG_STR == spec.arg) {
+            p_str = (const char*)p_arg;
+            stars[stars_count++] = (int)slot;
+            p_arg += LOG_ALIGN((size_t)slot);
+            fmt[fmt_len++] = '.';
+            fmt[fmt_len++] = '*';
+        } else if (spec.has_prec) {
+            fmt_len += (size_t)(spec.star_prec
+                                    ? snprintf(&fmt[fmt_len], 3, ".*")
+                                    : snprintf(&fmt[fmt_len], 12, ".%d",
+                                               spec.prec));
+        }
+
+        if ((LOG_ARG_INT == spec.arg) || (LOG_ARG_UINT == spec.arg)) {
+            fmt[fmt_len++] = 'l';
+            fmt[fmt_len++] = 'l';
+        }
+        fmt[fmt_len++] = spec.conv;
+        fmt[fmt_len] = '\0';
+
+        char* p_dst = &p_line[len];
+        const size_t room = size - len;
+        int ret = 0;
+
+#define LOG_SNPRINTF(value)                                                 \
+    ret = (0 == stars_count)                                                \
+              ? snprintf(p_dst, room, fmt, value)                           \
+              : ((1 == stars_count)                                         \
+                     ? snprintf(p_dst, room, fmt, stars[0], value)          \
+                     : snprintf(p_dst, room, fmt, stars[0], stars[1], value))
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+        switch (spec.arg) {
+            case LOG_ARG_INT:
+                LOG_SNPRINTF((long long)slot);
+                break;
+            case LOG_ARG_UINT:
+                LOG_SNPRINTF((unsigned long long)slot);
+                break;
+            case LOG_ARG_CHAR:
+                LOG_SNPRINTF((int)slot);
+                break;
+            case LOG_ARG_DOUBLE: {
+                double value = 0.0;
+                memcpy(&value, &slot, sizeof(value));
+                LOG_SNPRINTF(value);
+            } break;
+            case LOG_ARG_PTR:
+                LOG_SNPRINTF((void*)(uintptr_t)slot);
+                break;
+            case LOG_ARG_STR:
+            default:
+                LOG_SNPRINTF(p_str);
+                break;
+        }
+#pragma GCC diagnostic pop
+#undef LOG_SNPRINTF
+
+        if (ret > 0) {
+            len += ((size_t)ret < room) ? (size_t)ret : (room - 1);
+        }
+        p_fmt = p_next;
+    }
+
+    p_line[len] = '\0';
+
+    return len;
+}
+
+/**
+ * @brief Write whole output batch
+ *
+ * @param p_out pointer to output
+ */
+static void log_out_write(log_out_t* p_out) {
+    size_t off = 0;
+
+    while (off < p_out->len) {
+        ssize_t ret = write(p_out->fd, &p_out->buf[off], p_out->len - off);
+        if (ret < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            // NOTE: nowhere to report - output is lost
+            break;
+        }
+        off += (size_t)ret;
+    }
+
+    p_out->len = 0;
+}
+
+/**
+ * @brief Append line to output batch
+ *
+ * @param p_out pointer to output
+ * @param p_line line
+ * @param len line length
+ */
+static void log_out_put(log_out_t* p_out, const char* p_line, size_t len) {
+    if ((p_out->len + len) > CONFIG_LOG_OUT_SIZE) {
+        log_out_write(p_out);
+    }
+
+    memcpy(&p_out->buf[p_out->len], p_line, len);
+    p_out->len += len;
+}
+
+/**
+ * @brief Format and write everything queued by all threads
+ *
+ * Caller holds g_drain_lock.
+ *
+ * @return size_t count of written records
+ */
+static size_t log_drain(void) {
+    static char line[CONFIG_LOG_LINE_MAX];
+    const size_t mask = CONFIG_LOG_RING_SIZE - 1;
+    const size_t count = atomic_load(&g_rings_count);
+    size_t records = 0;
+
+    for (size_t idx = 0; idx < count; idx++) {
+        log_ring_t* p_ring = &g_rings[idx];
+        if (!atomic_load_explicit(&p_ring->ready, memory_order_acquire)) {
+            continue;
+        }
+
+        size_t tail = atomic_load_explicit(&p_ring->tail, memory_order_relaxed);
+        const size_t head =
+            atomic_load_explicit(&p_ring->head, memory_order_acquire);
+
+        while (tail != head) {
+            const log_rec_t* p_rec = (const log_rec_t*)&p_ring->p_buf[tail & mask];
+            tail += p_rec->size;
+
+            if (LOG_REC_PAD == p_rec->level) {
+                continue;
+            }
+
+            size_t len = log_format(line, sizeof(line) - 1, p_rec);
+            line[len++] = '\n';
+            log_out_put((p_rec->level <= LOG_LEVEL_WARN) ? &g_err : &g_out,
+                        line, len);
+            records++;
+        }
+
+        atomic_store_explicit(&p_ring->tail, tail, memory_order_release);
+
+        const uint64_t drops = atomic_load(&p_ring->drops);
+        if (drops != p_ring->drops_seen) {
+            int len = snprintf(line, sizeof(line),
+                               "[LOG] Ring full: <%lu> records dropped\n",
+                               drops - p_ring->drops_seen);
+            log_out_put(&g_err, line, (size_t)len);
+            p_ring->drops_seen = drops;
+        }
+    }
+
+    const uint64_t unregistered = atomic_exchange(&g_drops_unregistered, 0);
+    if (0 != unregistered) {
+        int len = snprintf(line, sizeof(line),
+                           "[LOG] No free ring: <%lu> records dropped\n",
+                           unregistered);
+        log_out_put(&g_err, line, (size_t)len);
+    }
+
+    // NOTE: stderr first - errors usually explain following lines
+    log_out_write(&g_err);
+    log_out_write(&g_out);
+
+    return records;
+}
+
+/**
+ * @brief Writer thread. Polls rings, producers never wake it up
+ *
+ * @param p_arg not used
+ * @return void* NULL
+ */
+static void* log_writer(void* p_arg) {
+    (void)p_arg;
+
+    const struct timespec idle = {.tv_sec = 0,
+                                  .tv_nsec = CONFIG_LOG_FLUSH_US * 1000};
+
+    while (atomic_load(&g_running)) {
+        pthread_mutex_lock(&g_drain_lock);
+        size_t records = log_drain();
+        pthread_mutex_unlock(&g_drain_lock);
+
+        if (0 == records) {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Set level and start writer thread. Before it records are written
+ * synchronously
+ *
+ * @param level max enabled level
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t log_init(int level) {
+    if ((level < LOG_LEVEL_ERROR) || (level > LOG_LEVEL_DEBUG)) {
+        return LOG_ERR_PARAMS;
+    }
+
+    g_log_level = level;
+
+    if (atomic_exchange(&g_running, true)) {
+        return LOG_ERR_OK;
+    }
+
+    if (0 != pthread_create(&g_writer, NULL, log_writer, NULL)) {
+        atomic_store(&g_running, false);
+        return LOG_ERR_THREAD;
+    }
+
+    atomic_store(&g_started, true);
+    atexit(log_deinit);
+
+    return LOG_ERR_OK;
+}
+
+/**
+ * @brief Stop writer thread and write the rest
+ */
+void log_deinit(void) {
+    if (!atomic_exchange(&g_running, false)) {
+        return;
+    }
+
+    pthread_join(g_writer, NULL);
+    atomic_store(&g_started, false);
+    log_flush();
+}
+
+/**
+ * @brief Write everything queued so far before return
+ */
+void log_flush(void) {
+    pthread_mutex_lock(&g_drain_lock);
+    log_drain();
+    pthread_mutex_unlock(&g_drain_lock);
+}
+
+/**
+ * @brief Parse level name
+ *
+ * @param p_name error, warn, info or debug
+ * @param p_level output level
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t log_level_parse(const char* p_name, int* p_level) {
+    static const char* const names[] = {"error", "warn", "info", "debug"};
+
+    if ((NULL == p_name) || (NULL == p_level)) {
+        return LOG_ERR_PARAMS;
+    }
+
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_DEBUG; level++) {
+        if (0 == strcmp(p_name, names[level])) {
+            *p_level = level;
+            return LOG_ERR_OK;
+        }
+    }
+
+    return LOG_ERR_PARAMS;
+}
+
+/**
+ * @brief Queue record. Use LOG_* macros, they skip disabled levels
+ *
+ * @param level record level
+ * @param p_fmt printf format, string literal
+ */
+void log_write(int level, const char* p_fmt, ...) {
+    _Alignas(8) uint8_t rec[CONFIG_LOG_REC_MAX];
+    va_list args;
+
+    if (!atomic_load_explicit(&g_started, memory_order_relaxed)) {
+        // NOTE: no writer yet or already - format in place
+        va_start(args, p_fmt);
+        FILE* p_file = (level <= LOG_LEVEL_WARN) ? stderr : stdout;
+        vfprintf(p_file, p_fmt, args);
+        fputc('\n', p_file);
+        va_end(args);
+        return;
+    }
+
+    log_ring_t* p_ring = log_ring_get();
+    if (NULL == p_ring) {
+        atomic_fetch_add(&g_drops_unregistered, 1);
+        return;
+    }
+
+    va_start(args, p_fmt);
+    log_encode(rec, level, p_fmt, args);
+    va_end(args);
+
+    if (!log_ring_push(p_ring, rec)) {
+        // NOTE: single producer - no locked add needed
+        atomic_store_explicit(
+            &p_ring->drops,
+            atomic_load_explicit(&p_ring->drops, memory_order_relaxed) + 1,
+            memory_order_relaxed);
+    }
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,263 @@
+/**
+ * @file      mcast.c
+ *
+ * @brief     Multicast publisher with retransmit store
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup mcast
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "mcast.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "config.h"
+#include "log.h"
+#include "proto.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Open multicast publisher
+ *
+ * @param p_mcast pointer to publisher
+ * @param p_group group address, e.g. "239.1.1.1"
+ * @param p_port group port
+ * @param p_ifaddr address of outgoing interface, NULL - by routing table
+ * @param ring_size retransmit ring size, power of 2
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t mcast_open(mcast_t* p_mcast, const char* p_group, const char* p_port,
+                   const char* p_ifaddr, size_t ring_size) {
+    if ((NULL == p_mcast) || (NULL == p_group) || (NULL == p_port) ||
+        (0 == ring_size) || (0 != (ring_size & (ring_size - 1u)))) {
+        return MCAST_ERR_PARAMS;
+    }
+
+    memset(p_mcast, 0x00, sizeof(mcast_t));
+    p_mcast->fd = COMMON_SOCKET_ERR;
+
+    p_mcast->group.sin_family = AF_INET;
+    p_mcast->group.sin_port = htons((uint16_t)strtoul(p_port, NULL, 10));
+    if ((1 != inet_pton(AF_INET, p_group, &p_mcast->group.sin_addr)) ||
+        !IN_MULTICAST(ntohl(p_mcast->group.sin_addr.s_addr)) ||
+        (0 == p_mcast->group.sin_port)) {
+        return MCAST_ERR_PARAMS;
+    }
+
+    struct in_addr ifaddr = {.s_addr = htonl(INADDR_ANY)};
+    if ((NULL != p_ifaddr) && (1 != inet_pton(AF_INET, p_ifaddr, &ifaddr))) {
+        return MCAST_ERR_PARAMS;
+    }
+
+    p_mcast->pp_ring = calloc(ring_size, sizeof(msg_t*));
+    if (NULL == p_mcast->pp_ring) {
+        return MCAST_ERR_NOMEM;
+    }
+    p_mcast->mask = ring_size - 1u;
+
+    p_mcast->fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (COMMON_SOCKET_ERR == p_mcast->fd) {
+        mcast_close(p_mcast);
+        return MCAST_ERR_SOCKET;
+    }
+
+    // NOTE: loop lets subscribers on the same host receive the group
+    const unsigned char ttl = CONFIG_MCAST_TTL;
+    const unsigned char loop = 1;
+    if ((0 != setsockopt(p_mcast->fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl,
+                         sizeof(ttl))) ||
+        (0 != setsockopt(p_mcast->fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+                         sizeof(loop))) ||
+        (0 != setsockopt(p_mcast->fd, IPPROTO_IP, IP_MULTICAST_IF, &ifaddr,
+                         sizeof(ifaddr)))) {
+        mcast_close(p_mcast);
+        return MCAST_ERR_SOCKET;
+    }
+
+    pthread_mutex_init(&p_mcast->lock, NULL);
+
+    return MCAST_ERR_OK;
+}
+
+/**
+ * @brief Close publisher and release retained datagrams
+ *
+ * @param p_mcast pointer to publisher
+ */
+void mcast_close(mcast_t* p_mcast) {
+    if (NULL == p_mcast) {
+        return;
+    }
+
+    if (COMMON_SOCKET_ERR != p_mcast->fd) {
+        close(p_mcast->fd);
+        p_mcast->fd = COMMON_SOCKET_ERR;
+    }
+
+    if (NULL != p_mcast->pp_ring) {
+        for (uint64_t idx = 0; idx <= p_mcast->mask; idx++) {
+            if (NULL != p_mcast->pp_ring[idx]) {
+                msg_unref(p_mcast->pp_ring[idx]);
+            }
+        }
+        free(p_mcast->pp_ring);
+        p_mcast->pp_ring = NULL;
+    }
+}
+
+/**
+ * @brief Send data frame to group and retain it for retransmit
+ *
+ * Frame too big for a datagram is only retained: subscribers see the gap
+ * and take it over TCP.
+ *
+ * @param p_mcast pointer to publisher
+ * @param p_frame message with whole data frame
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t mcast_publish(mcast_t* p_mcast, const msg_t* p_frame) {
+    msg_t* p_msg = msg_alloc(PROTO_HDR_SIZE + p_frame->len);
+    if (NULL == p_msg) {
+        return MCAST_ERR_NOMEM;
+    }
+
+    const proto_hdr_t hdr = {.len = (uint32_t)p_frame->len,
+                             .type = PROTO_TYPE_MCAST,
+                             .seq = p_mcast->seq + 1u,
+                             .ts = proto_ts_now()};
+    proto_hdr_encode(p_msg->data, &hdr);
+    memcpy(&p_msg->data[PROTO_HDR_SIZE], p_frame->data, p_frame->len);
+    p_msg->ts = p_frame->ts;
+
+    // NOTE: retransmit readers take references under the same lock
+    pthread_mutex_lock(&p_mcast->lock);
+    msg_t** pp_slot = &p_mcast->pp_ring[hdr.seq & p_mcast->mask];
+    msg_t* p_old = *pp_slot;
+    *pp_slot = p_msg;
+    p_mcast->seq = hdr.seq;
+    pthread_mutex_unlock(&p_mcast->lock);
+
+    if (NULL != p_old) {
+        msg_unref(p_old);
+    }
+
+    if (p_msg->len > CONFIG_MCAST_DATAGRAM_MAX) {
+        p_mcast->stats.oversize++;
+        return MCAST_ERR_OK;
+    }
+
+    ssize_t ret = sendto(p_mcast->fd, p_msg->data, p_msg->len, MSG_DONTWAIT,
+                         (const struct sockaddr*)&p_mcast->group,
+                         sizeof(p_mcast->group));
+    if (COMMON_SOCKET_ERR == ret) {
+        // NOTE: lost datagram is recovered by gap-fill like a network loss
+        p_mcast->stats.errors++;
+        return MCAST_ERR_SOCKET;
+    }
+
+    p_mcast->stats.sent++;
+
+    return MCAST_ERR_OK;
+}
+
+/**
+ * @brief Take retained datagram for retransmit
+ *
+ * @param p_mcast pointer to publisher
+ * @param seq sequence number
+ * @return msg_t* own reference to datagram, NULL if not sent yet or already
+ * overwritten
+ */
+msg_t* mcast_get(mcast_t* p_mcast, uint64_t seq) {
+    msg_t* p_msg = NULL;
+
+    pthread_mutex_lock(&p_mcast->lock);
+    if ((seq > 0) && (seq <= p_mcast->seq) &&
+        ((p_mcast->seq - seq) <= p_mcast->mask)) {
+        p_msg = msg_ref(p_mcast->pp_ring[seq & p_mcast->mask]);
+    }
+    pthread_mutex_unlock(&p_mcast->lock);
+
+    return p_msg;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
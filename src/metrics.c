@@ -0,0 +1,245 @@
+/**
+ * @file      metrics.c
+ *
+ * @brief     Server metrics in shared memory
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup metrics
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "metrics.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Build segment name of server
+ *
+ * @param p_name output, METRICS_NAME_SIZE bytes
+ * @param port server port
+ */
+void metrics_name(char* p_name, uint16_t port) {
+    snprintf(p_name, METRICS_NAME_SIZE, "%s.%u", CONFIG_METRICS_SHM_PREFIX,
+             port);
+}
+
+/**
+ * @brief Create zeroed segment for server. Old segment of the port is replaced
+ *
+ * @param pp_metrics output pointer to mapped segment
+ * @param port server port
+ * @param shards count of shards
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t metrics_create(metrics_t** pp_metrics, uint16_t port, size_t shards) {
+    if ((NULL == pp_metrics) || (0 == shards)) {
+        return METRICS_ERR_PARAMS;
+    }
+
+    char name[METRICS_NAME_SIZE];
+    metrics_name(name, port);
+
+    // NOTE: new inode, so readers of previous server keep their mapping
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (-1 == fd) {
+        return METRICS_ERR_SHM;
+    }
+
+    const size_t size = METRICS_SIZE(shards);
+    if (0 != ftruncate(fd, (off_t)size)) {
+        close(fd);
+        shm_unlink(name);
+        return METRICS_ERR_SHM;
+    }
+
+    metrics_t* p_metrics =
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == p_metrics) {
+        shm_unlink(name);
+        return METRICS_ERR_SHM;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    p_metrics->version = METRICS_VERSION;
+    p_metrics->shards = (uint32_t)shards;
+    p_metrics->pid = (int32_t)getpid();
+    p_metrics->start_ns =
+        ((uint64_t)ts.tv_sec * (uint64_t)1000000000u) + (uint64_t)ts.tv_nsec;
+    p_metrics->port = port;
+
+    for (size_t idx = 0; idx < shards; idx++) {
+        hist_reset(&p_metrics->shard[idx].recv_lag);
+        hist_reset(&p_metrics->shard[idx].queue_wait);
+    }
+
+    // NOTE: readers check magic, so it is published after the rest
+    atomic_thread_fence(memory_order_release);
+    p_metrics->magic = METRICS_MAGIC;
+
+    *pp_metrics = p_metrics;
+
+    return METRICS_ERR_OK;
+}
+
+/**
+ * @brief Map segment of running server read-only
+ *
+ * @param pp_metrics output pointer to mapped segment
+ * @param p_size output size of mapping, for @metrics_close
+ * @param port server port
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t metrics_open(const metrics_t** pp_metrics, size_t* p_size,
+                     uint16_t port) {
+    if ((NULL == pp_metrics) || (NULL == p_size)) {
+        return METRICS_ERR_PARAMS;
+    }
+
+    char name[METRICS_NAME_SIZE];
+    metrics_name(name, port);
+
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (-1 == fd) {
+        return METRICS_ERR_SHM;
+    }
+
+    struct stat st;
+    if ((0 != fstat(fd, &st)) || ((size_t)st.st_size < sizeof(metrics_t))) {
+        close(fd);
+        return METRICS_ERR_VERSION;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    const metrics_t* p_metrics = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == p_metrics) {
+        return METRICS_ERR_SHM;
+    }
+
+    if ((METRICS_MAGIC != p_metrics->magic) ||
+        (METRICS_VERSION != p_metrics->version) ||
+        (size < METRICS_SIZE(p_metrics->shards))) {
+        munmap((void*)p_metrics, size);
+        return METRICS_ERR_VERSION;
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+
+    *pp_metrics = p_metrics;
+    *p_size = size;
+
+    return METRICS_ERR_OK;
+}
+
+/**
+ * @brief Unmap segment
+ *
+ * @param p_metrics pointer to mapped segment
+ * @param size size of mapping
+ */
+void metrics_close(const metrics_t* p_metrics, size_t size) {
+    if (NULL != p_metrics) {
+        munmap((void*)p_metrics, size);
+    }
+}
+
+/**
+ * @brief Remove segment name. Mappings stay valid until unmapped
+ *
+ * @param port server port
+ */
+void metrics_unlink(uint16_t port) {
+    char name[METRICS_NAME_SIZE];
+    metrics_name(name, port);
+    shm_unlink(name);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
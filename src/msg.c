@@ -0,0 +1,234 @@
+/**
+ * @file      msg.c
+ *
+ * @brief     Refcounted immutable messages implementation
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup msg
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "msg.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "pool.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define MSG_SLAB_NONE ((uint32_t)0xFFFFFFFF) /**< Message is not from slab */
+#define MSG_SLAB_CLASSES ((uint32_t)3) /**< Count of size classes */
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/** Max payload of size classes, the last one is the biggest slab message */
+static const size_t g_class_payload[MSG_SLAB_CLASSES] = {
+    64, 256, CONFIG_MSG_SLAB_PAYLOAD};
+
+/** Size class pools, one per entry of g_class_payload */
+static pool_t g_pools[MSG_SLAB_CLASSES] = {
+    POOL_INITIALIZER("msg64", sizeof(msg_t) + 64),
+    POOL_INITIALIZER("msg256", sizeof(msg_t) + 256),
+    POOL_INITIALIZER("msg", sizeof(msg_t) + CONFIG_MSG_SLAB_PAYLOAD),
+};
+
+static atomic_size_t g_in_use; /**< Alive messages */
+static atomic_size_t g_heap;   /**< Alive heap messages */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static uint32_t slab_class(size_t len);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Get smallest size class fitting payload
+ *
+ * @param len payload length
+ * @return uint32_t class index or MSG_SLAB_NONE if payload is too big
+ */
+static uint32_t slab_class(size_t len) {
+    for (uint32_t idx = 0; idx < MSG_SLAB_CLASSES; idx++) {
+        if (len <= g_class_payload[idx]) {
+            return idx;
+        }
+    }
+
+    return MSG_SLAB_NONE;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Allocate message for payload of given length. Reference count is 1
+ *
+ * Small messages come from size class pools, big ones from heap.
+ *
+ * @param len payload length
+ * @return msg_t* message or NULL if no memory
+ */
+msg_t *msg_alloc(size_t len) {
+    msg_t *p_msg = NULL;
+    const uint32_t slab_idx = slab_class(len);
+
+    if (MSG_SLAB_NONE != slab_idx) {
+        p_msg = pool_alloc(&g_pools[slab_idx]);
+        if (NULL != p_msg) {
+            p_msg->slab_idx = slab_idx;
+        }
+    }
+
+    if (NULL == p_msg) {
+        p_msg = malloc(sizeof(msg_t) + len);
+        if (NULL == p_msg) {
+            return NULL;
+        }
+
+        p_msg->slab_idx = MSG_SLAB_NONE;
+        atomic_fetch_add_explicit(&g_heap, 1, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&p_msg->refcnt, 1, memory_order_relaxed);
+    p_msg->len = len;
+    atomic_fetch_add_explicit(&g_in_use, 1, memory_order_relaxed);
+
+    return p_msg;
+}
+
+/**
+ * @brief Allocate message and copy payload into it
+ *
+ * @param p_buf payload
+ * @param len payload length
+ * @return msg_t* message or NULL if no memory
+ */
+msg_t *msg_create(const void *p_buf, size_t len) {
+    if ((NULL == p_buf) && (len > 0)) {
+        return NULL;
+    }
+
+    msg_t *p_msg = msg_alloc(len);
+    if (NULL != p_msg) {
+        memcpy(p_msg->data, p_buf, len);
+    }
+
+    return p_msg;
+}
+
+/**
+ * @brief Drop reference. The last one frees message
+ *
+ * @param p_msg pointer to message
+ */
+void msg_unref(msg_t *p_msg) {
+    if (NULL == p_msg) {
+        return;
+    }
+
+    if (1 != atomic_fetch_sub_explicit(&p_msg->refcnt, 1,
+                                       memory_order_acq_rel)) {
+        return;
+    }
+
+    atomic_fetch_sub_explicit(&g_in_use, 1, memory_order_relaxed);
+
+    if (MSG_SLAB_NONE == p_msg->slab_idx) {
+        atomic_fetch_sub_explicit(&g_heap, 1, memory_order_relaxed);
+        free(p_msg);
+        return;
+    }
+
+    pool_free(&g_pools[p_msg->slab_idx], p_msg);
+}
+
+/**
+ * @brief Get pool statistics
+ *
+ * @param p_stats output statistics
+ */
+void msg_stats(msg_stats_t *p_stats) {
+    if (NULL == p_stats) {
+        return;
+    }
+
+    p_stats->slabs = 0;
+    for (uint32_t idx = 0; idx < MSG_SLAB_CLASSES; idx++) {
+        pool_stats_t stats;
+        pool_usage(&g_pools[idx], &stats);
+        p_stats->slabs += stats.objects;
+    }
+
+    p_stats->in_use = atomic_load(&g_in_use);
+    p_stats->heap = atomic_load(&g_heap);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,415 @@
+/**
+ * @file      pool.c
+ *
+ * @brief     Size-class slab pools with per-thread caches
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup pool
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "pool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "config.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define POOL_CACHE_LINE ((size_t)64) /**< Object alignment */
+#define POOL_CHUNK_SIZE ((size_t)2 * 1024 * 1024) /**< Arena chunk, one huge
+                                                     page */
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/** Free objects of one pool owned by one thread */
+typedef struct pool_cache_s {
+    uint32_t count;                          /**< Cached objects */
+    void* p_objs[CONFIG_POOL_CACHE_SIZE];    /**< Cached objects, LIFO */
+} pool_cache_t;
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static _Thread_local pool_cache_t g_caches[POOL_MAX]; /**< Thread caches */
+static pool_t* g_p_pools[POOL_MAX];                    /**< Registered pools */
+static atomic_uint g_pools_count;                      /**< Registered pools */
+static pthread_mutex_t g_register_lock = PTHREAD_MUTEX_INITIALIZER; /**< Reg */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static uint32_t pool_register(pool_t* p_pool);
+static bool pool_carve(pool_t* p_pool);
+static void* pool_take(pool_t* p_pool, pool_cache_t* p_cache);
+static void pool_give(pool_t* p_pool, pool_cache_t* p_cache, void* p_obj);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Give pool its thread cache index on first use
+ *
+ * @param p_pool pointer to pool
+ * @return uint32_t cache index + 1, 0 - all indexes are taken and pool works
+ * without caches
+ */
+static uint32_t pool_register(pool_t* p_pool) {
+    pthread_mutex_lock(&g_register_lock);
+
+    uint32_t id = atomic_load_explicit(&p_pool->id, memory_order_relaxed);
+    const uint32_t count = atomic_load(&g_pools_count);
+    if ((0 == id) && (count < POOL_MAX)) {
+        size_t size = (p_pool->size < sizeof(void*)) ? sizeof(void*)
+                                                     : p_pool->size;
+        p_pool->stride =
+            (size + POOL_CACHE_LINE - 1u) & ~(POOL_CACHE_LINE - 1u);
+        g_p_pools[count] = p_pool;
+        atomic_store(&g_pools_count, count + 1u);
+        id = count + 1u;
+        atomic_store_explicit(&p_pool->id, id, memory_order_release);
+    }
+
+    pthread_mutex_unlock(&g_register_lock);
+
+    return id;
+}
+
+/**
+ * @brief Carve one arena chunk into free objects. Pool lock is held
+ *
+ * @param p_pool pointer to pool
+ * @return bool true if shared free list got new objects
+ */
+static bool pool_carve(pool_t* p_pool) {
+    // NOTE: uncached pool may be used before its stride is known
+    if (0 == p_pool->stride) {
+        size_t size = (p_pool->size < sizeof(void*)) ? sizeof(void*)
+                                                     : p_pool->size;
+        p_pool->stride =
+            (size + POOL_CACHE_LINE - 1u) & ~(POOL_CACHE_LINE - 1u);
+    }
+
+    const size_t chunk_size = (p_pool->stride > POOL_CHUNK_SIZE)
+                                  ? p_pool->stride
+                                  : POOL_CHUNK_SIZE;
+    bool huge = false;
+    uint8_t* p_chunk = pool_arena_alloc(chunk_size, &huge);
+    if (NULL == p_chunk) {
+        return false;
+    }
+
+    const size_t count = chunk_size / p_pool->stride;
+    for (size_t idx = count; idx > 0; idx--) {
+        void* p_obj = &p_chunk[(idx - 1u) * p_pool->stride];
+        *(void**)p_obj = p_pool->p_free;
+        p_pool->p_free = p_obj;
+    }
+
+    p_pool->free_count += count;
+    p_pool->objects += count;
+    p_pool->chunks++;
+    p_pool->huge_chunks += huge ? 1u : 0u;
+
+    return true;
+}
+
+/**
+ * @brief Take object from shared free list, refill thread cache on the way
+ *
+ * @param p_pool pointer to pool
+ * @param p_cache thread cache or NULL
+ * @return void* object or NULL if no memory
+ */
+static void* pool_take(pool_t* p_pool, pool_cache_t* p_cache) {
+    void* p_obj = NULL;
+
+    pthread_mutex_lock(&p_pool->lock);
+
+    if ((NULL != p_pool->p_free) || pool_carve(p_pool)) {
+        p_obj = p_pool->p_free;
+        p_pool->p_free = *(void**)p_obj;
+        p_pool->free_count--;
+
+        // NOTE: one lock serves next CONFIG_POOL_BATCH allocations
+        while ((NULL != p_cache) && (NULL != p_pool->p_free) &&
+               (p_cache->count < CONFIG_POOL_BATCH)) {
+            p_cache->p_objs[p_cache->count++] = p_pool->p_free;
+            p_pool->p_free = *(void**)p_pool->p_free;
+            p_pool->free_count--;
+        }
+    }
+
+    pthread_mutex_unlock(&p_pool->lock);
+
+    return p_obj;
+}
+
+/**
+ * @brief Return object to shared free list, drain full thread cache with it
+ *
+ * @param p_pool pointer to pool
+ * @param p_cache thread cache or NULL
+ * @param p_obj object
+ */
+static void pool_give(pool_t* p_pool, pool_cache_t* p_cache, void* p_obj) {
+    pthread_mutex_lock(&p_pool->lock);
+
+    *(void**)p_obj = p_pool->p_free;
+    p_pool->p_free = p_obj;
+    p_pool->free_count++;
+
+    // NOTE: objects freed by other thread than allocated them flow back here
+    for (uint32_t idx = 0; (NULL != p_cache) && (idx < CONFIG_POOL_BATCH);
+         idx++) {
+        void* p_cached = p_cache->p_objs[--p_cache->count];
+        *(void**)p_cached = p_pool->p_free;
+        p_pool->p_free = p_cached;
+        p_pool->free_count++;
+    }
+
+    pthread_mutex_unlock(&p_pool->lock);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Allocate object. Its content is undefined
+ *
+ * @param p_pool pointer to pool
+ * @return void* object or NULL if no memory
+ */
+void* pool_alloc(pool_t* p_pool) {
+    uint32_t id = atomic_load_explicit(&p_pool->id, memory_order_acquire);
+    if (0 == id) {
+        id = pool_register(p_pool);
+    }
+
+    pool_cache_t* p_cache = (0 != id) ? &g_caches[id - 1u] : NULL;
+    if ((NULL != p_cache) && (p_cache->count > 0)) {
+        return p_cache->p_objs[--p_cache->count];
+    }
+
+    return pool_take(p_pool, p_cache);
+}
+
+/**
+ * @brief Free object to cache of calling thread
+ *
+ * Any thread may free object of any other one.
+ *
+ * @param p_pool pointer to pool object was allocated from
+ * @param p_obj object, NULL is ignored
+ */
+void pool_free(pool_t* p_pool, void* p_obj) {
+    if (NULL == p_obj) {
+        return;
+    }
+
+    const uint32_t id = atomic_load_explicit(&p_pool->id, memory_order_acquire);
+    pool_cache_t* p_cache = (0 != id) ? &g_caches[id - 1u] : NULL;
+    if ((NULL != p_cache) && (p_cache->count < CONFIG_POOL_CACHE_SIZE)) {
+        p_cache->p_objs[p_cache->count++] = p_obj;
+        return;
+    }
+
+    pool_give(p_pool, p_cache, p_obj);
+}
+
+/**
+ * @brief Get usage statistics of one pool
+ *
+ * @param p_pool pointer to pool
+ * @param p_stats output statistics
+ */
+void pool_usage(pool_t* p_pool, pool_stats_t* p_stats) {
+    pthread_mutex_lock(&p_pool->lock);
+    strncpy(p_stats->name, p_pool->p_name, sizeof(p_stats->name) - 1u);
+    p_stats->name[sizeof(p_stats->name) - 1u] = '\0';
+    p_stats->size = p_pool->size;
+    p_stats->objects = p_pool->objects;
+    p_stats->used = p_pool->objects - p_pool->free_count;
+    p_stats->chunks = p_pool->chunks;
+    p_stats->huge_chunks = p_pool->huge_chunks;
+    pthread_mutex_unlock(&p_pool->lock);
+}
+
+/**
+ * @brief Get usage statistics of registered pools
+ *
+ * @param p_stats output statistics
+ * @param max size of output array
+ * @return size_t count of filled entries
+ */
+size_t pool_stats(pool_stats_t* p_stats, size_t max) {
+    size_t count = atomic_load(&g_pools_count);
+    if ((NULL == p_stats) || (count > max)) {
+        count = (NULL == p_stats) ? 0 : max;
+    }
+
+    for (size_t idx = 0; idx < count; idx++) {
+        pool_usage(g_p_pools[idx], &p_stats[idx]);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Map zeroed memory, backed by huge pages where available
+ *
+ * Explicit huge pages are tried first (need vm.nr_hugepages), then
+ * transparent ones are requested for a regular mapping.
+ *
+ * @param size size in bytes
+ * @param p_huge set to true if explicit huge pages are used, may be NULL
+ * @return void* memory or NULL if no memory
+ */
+void* pool_arena_alloc(size_t size, bool* p_huge) {
+    const size_t huge_size =
+        (size + POOL_CHUNK_SIZE - 1u) & ~(POOL_CHUNK_SIZE - 1u);
+    void* p_arena = MAP_FAILED;
+
+    if (NULL != p_huge) {
+        *p_huge = false;
+    }
+
+    if (0 == size) {
+        return NULL;
+    }
+
+#if CONFIG_POOL_HUGETLB
+    p_arena = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if ((MAP_FAILED != p_arena) && (NULL != p_huge)) {
+        *p_huge = true;
+    }
+#endif
+
+    if (MAP_FAILED == p_arena) {
+        p_arena = mmap(NULL, huge_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == p_arena) {
+            return NULL;
+        }
+
+        madvise(p_arena, huge_size, MADV_HUGEPAGE);
+    }
+
+    return p_arena;
+}
+
+/**
+ * @brief Unmap memory of @pool_arena_alloc
+ *
+ * @param p_arena memory, NULL is ignored
+ * @param size size passed to @pool_arena_alloc
+ */
+void pool_arena_free(void* p_arena, size_t size) {
+    if (NULL == p_arena) {
+        return;
+    }
+
+    munmap(p_arena, (size + POOL_CHUNK_SIZE - 1u) & ~(POOL_CHUNK_SIZE - 1u));
+}
+
+/**
+ * @brief Reserve zeroed address space, committed page by page on first touch
+ *
+ * Unlike @pool_arena_alloc, no huge pages are used: explicit ones would be
+ * taken for the whole size up front and transparent ones would commit 2 MiB
+ * on first touch of any byte. Swap is not reserved either, so size may be
+ * far above what is ever touched.
+ *
+ * @param size size in bytes
+ * @return void* memory or NULL if no address space
+ */
+void* pool_reserve_alloc(size_t size) {
+    if (0 == size) {
+        return NULL;
+    }
+
+    void* p_area = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    return (MAP_FAILED == p_area) ? NULL : p_area;
+}
+
+/**
+ * @brief Unmap memory of @pool_reserve_alloc
+ *
+ * @param p_area memory, NULL is ignored
+ * @param size size passed to @pool_reserve_alloc
+ */
+void pool_reserve_free(void* p_area, size_t size) {
+    if (NULL == p_area) {
+        return;
+    }
+
+    munmap(p_area, size);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
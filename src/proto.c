@@ -0,0 +1,293 @@
+/**
+ * @file      proto.c
+ *
+ * @brief     Framed wire protocol
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup proto
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "proto.h"
+
+#include <endian.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static int32_t parser_take(proto_parser_t* p_parser, size_t want);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Move input bytes to storage until it holds want bytes
+ *
+ * @param p_parser pointer to parser
+ * @param want required bytes in storage
+ * @return int32_t PROTO_ERR_OK if storage holds want bytes, PROTO_ERR_AGAIN if
+ * input is exhausted, error otherwise
+ */
+static int32_t parser_take(proto_parser_t* p_parser, size_t want) {
+    if (p_parser->len >= want) {
+        return PROTO_ERR_OK;
+    }
+
+    if (want > p_parser->cap) {
+        uint8_t* p_buf = realloc(p_parser->p_buf, want);
+        if (NULL == p_buf) {
+            return PROTO_ERR_NOMEM;
+        }
+
+        p_parser->p_buf = p_buf;
+        p_parser->cap = want;
+    }
+
+    size_t count = want - p_parser->len;
+    if (count > p_parser->in_len) {
+        count = p_parser->in_len;
+    }
+
+    memcpy(&p_parser->p_buf[p_parser->len], p_parser->p_in, count);
+    p_parser->len += count;
+    p_parser->p_in += count;
+    p_parser->in_len -= count;
+
+    return (p_parser->len == want) ? PROTO_ERR_OK : PROTO_ERR_AGAIN;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Get timestamp for header ts field
+ *
+ * CLOCK_MONOTONIC is shared by all processes of the host, so latency is
+ * measured only between peers on the same host.
+ *
+ * @return uint64_t monotonic time in nanoseconds
+ */
+uint64_t proto_ts_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * (uint64_t)1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Encode header to wire format
+ *
+ * @param p_dst destination, at least PROTO_HDR_SIZE bytes
+ * @param p_hdr header in host byte order
+ */
+void proto_hdr_encode(uint8_t* p_dst, const proto_hdr_t* p_hdr) {
+    uint32_t len = htobe32(p_hdr->len);
+    uint16_t type = htobe16(p_hdr->type);
+    uint16_t flags = htobe16(p_hdr->flags);
+    uint64_t seq = htobe64(p_hdr->seq);
+    uint64_t ts = htobe64(p_hdr->ts);
+
+    memcpy(&p_dst[0], &len, sizeof(len));
+    memcpy(&p_dst[4], &type, sizeof(type));
+    memcpy(&p_dst[6], &flags, sizeof(flags));
+    memcpy(&p_dst[8], &seq, sizeof(seq));
+    memcpy(&p_dst[16], &ts, sizeof(ts));
+}
+
+/**
+ * @brief Decode header from wire format
+ *
+ * @param p_src source, at least PROTO_HDR_SIZE bytes
+ * @param p_hdr output header in host byte order
+ */
+void proto_hdr_decode(const uint8_t* p_src, proto_hdr_t* p_hdr) {
+    uint32_t len = 0;
+    uint16_t type = 0;
+    uint16_t flags = 0;
+    uint64_t seq = 0;
+    uint64_t ts = 0;
+
+    memcpy(&len, &p_src[0], sizeof(len));
+    memcpy(&type, &p_src[4], sizeof(type));
+    memcpy(&flags, &p_src[6], sizeof(flags));
+    memcpy(&seq, &p_src[8], sizeof(seq));
+    memcpy(&ts, &p_src[16], sizeof(ts));
+
+    p_hdr->len = be32toh(len);
+    p_hdr->type = be16toh(type);
+    p_hdr->flags = be16toh(flags);
+    p_hdr->seq = be64toh(seq);
+    p_hdr->ts = be64toh(ts);
+}
+
+/**
+ * @brief Init parser. Storage is allocated on first split frame
+ *
+ * @param p_parser pointer to parser
+ */
+void proto_parser_init(proto_parser_t* p_parser) {
+    memset(p_parser, 0x00, sizeof(proto_parser_t));
+}
+
+/**
+ * @brief Free parser storage and drop partial frame
+ *
+ * @param p_parser pointer to parser
+ */
+void proto_parser_deinit(proto_parser_t* p_parser) {
+    free(p_parser->p_buf);
+    proto_parser_init(p_parser);
+}
+
+/**
+ * @brief Feed parser with received data
+ *
+ * Data is not copied and must stay valid until @proto_parser_next returns
+ * PROTO_ERR_AGAIN.
+ *
+ * @param p_parser pointer to parser
+ * @param p_buf received data
+ * @param len received data length
+ */
+void proto_parser_feed(proto_parser_t* p_parser, const void* p_buf,
+                       size_t len) {
+    p_parser->p_in = (const uint8_t*)p_buf;
+    p_parser->in_len = len;
+}
+
+/**
+ * @brief Get next complete frame
+ *
+ * Frame is valid until next call of parser functions.
+ *
+ * @param p_parser pointer to parser
+ * @param p_frame output frame
+ * @return int32_t PROTO_ERR_OK if frame is returned, PROTO_ERR_AGAIN if more
+ * data is needed, error otherwise. After error the stream is unusable
+ */
+int32_t proto_parser_next(proto_parser_t* p_parser, proto_frame_t* p_frame) {
+    if ((NULL == p_parser) || (NULL == p_frame)) {
+        return PROTO_ERR_PARAMS;
+    }
+
+    const uint8_t* p_data = NULL;
+
+    if ((0 == p_parser->len) && (p_parser->in_len >= PROTO_HDR_SIZE)) {
+        // NOTE: fast path - frame is parsed in place
+        proto_hdr_decode(p_parser->p_in, &p_frame->hdr);
+        if (p_frame->hdr.len > CONFIG_PROTO_PAYLOAD_MAX) {
+            return PROTO_ERR_FRAME;
+        }
+
+        const size_t size = PROTO_FRAME_SIZE(&p_frame->hdr);
+        if (p_parser->in_len >= size) {
+            p_data = p_parser->p_in;
+            p_parser->p_in += size;
+            p_parser->in_len -= size;
+        }
+    }
+
+    if (NULL == p_data) {
+        // NOTE: frame is split between reads - assemble it in storage
+        if (0 == p_parser->in_len) {
+            return PROTO_ERR_AGAIN;
+        }
+
+        int32_t ret = parser_take(p_parser, PROTO_HDR_SIZE);
+        if (PROTO_ERR_OK != ret) {
+            return ret;
+        }
+
+        proto_hdr_decode(p_parser->p_buf, &p_frame->hdr);
+        if (p_frame->hdr.len > CONFIG_PROTO_PAYLOAD_MAX) {
+            return PROTO_ERR_FRAME;
+        }
+
+        ret = parser_take(p_parser, PROTO_FRAME_SIZE(&p_frame->hdr));
+        if (PROTO_ERR_OK != ret) {
+            return ret;
+        }
+
+        // NOTE: storage is reused only by next call, so view stays valid
+        p_data = p_parser->p_buf;
+        p_parser->len = 0;
+    }
+
+    p_frame->p_data = p_data;
+    p_frame->p_payload = &p_data[PROTO_HDR_SIZE];
+
+    return PROTO_ERR_OK;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,197 @@
+/**
+ * @file      ring.c
+ *
+ * @brief     Lock-free rings implementation
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup ring
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "ring.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Init MPSC ring
+ *
+ * @param p_ring pointer to ring
+ * @param capacity count of cells. Must be power of 2
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t ring_mpsc_init(ring_mpsc_t *p_ring, size_t capacity) {
+    if (NULL == p_ring) {
+        return RING_ERR_PARAMS;
+    }
+
+    if ((capacity < 2) || (0 != (capacity & (capacity - 1)))) {
+        return RING_ERR_PARAMS;
+    }
+
+    p_ring->p_cells = calloc(capacity, sizeof(ring_cell_t));
+    if (NULL == p_ring->p_cells) {
+        return RING_ERR_NOMEM;
+    }
+
+    for (size_t idx = 0; idx < capacity; idx++) {
+        atomic_init(&p_ring->p_cells[idx].seq, idx);
+    }
+
+    p_ring->mask = capacity - 1;
+    atomic_init(&p_ring->head, 0);
+    atomic_init(&p_ring->tail, 0);
+
+    return RING_ERR_OK;
+}
+
+/**
+ * @brief Deinit MPSC ring. Stored pointers are not freed
+ *
+ * @param p_ring pointer to ring
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t ring_mpsc_deinit(ring_mpsc_t *p_ring) {
+    if (NULL == p_ring) {
+        return RING_ERR_PARAMS;
+    }
+
+    free(p_ring->p_cells);
+    p_ring->p_cells = NULL;
+
+    return RING_ERR_OK;
+}
+
+/**
+ * @brief Push pointer into ring. Safe to call from any thread
+ *
+ * @param p_ring pointer to ring
+ * @param p_data pointer to store
+ * @return int32_t 0 if OK, RING_ERR_FULL if ring is full
+ */
+int32_t ring_mpsc_push(ring_mpsc_t *p_ring, void *p_data) {
+    size_t pos = atomic_load_explicit(&p_ring->head, memory_order_relaxed);
+
+    while (true) {
+        ring_cell_t *p_cell = &p_ring->p_cells[pos & p_ring->mask];
+        size_t seq = atomic_load_explicit(&p_cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (0 == diff) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &p_ring->head, &pos, pos + 1, memory_order_relaxed,
+                    memory_order_relaxed)) {
+                p_cell->p_data = p_data;
+                atomic_store_explicit(&p_cell->seq, pos + 1,
+                                      memory_order_release);
+                return RING_ERR_OK;
+            }
+        } else if (diff < 0) {
+            return RING_ERR_FULL;
+        } else {
+            pos = atomic_load_explicit(&p_ring->head, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Pop pointer from ring. Must be called from the single consumer
+ *
+ * @param p_ring pointer to ring
+ * @param pp_data output pointer
+ * @return int32_t 0 if OK, RING_ERR_EMPTY if ring is empty
+ */
+int32_t ring_mpsc_pop(ring_mpsc_t *p_ring, void **pp_data) {
+    size_t pos = atomic_load_explicit(&p_ring->tail, memory_order_relaxed);
+    ring_cell_t *p_cell = &p_ring->p_cells[pos & p_ring->mask];
+    size_t seq = atomic_load_explicit(&p_cell->seq, memory_order_acquire);
+
+    if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+        return RING_ERR_EMPTY;
+    }
+
+    *pp_data = p_cell->p_data;
+    atomic_store_explicit(&p_cell->seq, pos + p_ring->mask + 1,
+                          memory_order_release);
+    atomic_store_explicit(&p_ring->tail, pos + 1, memory_order_relaxed);
+
+    return RING_ERR_OK;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -42,19 +42,33 @@
  * INCLUDES
  ******************************************************************************/
 
+#define _GNU_SOURCE
+
 #include "server.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "common.h"
 #include "config.h"
+#include "pool.h"
 
 /******************************************************************************
  * DEFINES, CONSTS, ENUMS
@@ -62,14 +76,82 @@
 
 #define POLL_TIMEOUT_INF ((int)-1) /**< Infinite timeout for polling */
 
+#define URING_BGID ((uint16_t)0)       /**< io_uring provided buffers group */
+#define URING_OP_SHIFT ((uint64_t)56)  /**< user_data: operation bits */
+#define URING_GEN_SHIFT ((uint64_t)32) /**< user_data: generation bits */
+#define URING_GEN_MASK ((uint32_t)0x00FFFFFF) /**< user_data: gen mask */
+
+/** io_uring operations encoded into user_data */
+enum {
+    URING_OP_ACCEPT = 1, /**< Multishot accept */
+    URING_OP_RECV,       /**< Multishot recv with provided buffers */
+    URING_OP_POLL,       /**< Multishot poll for readability */
+    URING_OP_POLLOUT,    /**< Oneshot poll for writability */
+    URING_OP_SEND,       /**< Send of batch. Low bits is index in batch */
+    URING_OP_CANCEL,     /**< Cancel of previous operation */
+};
+
 /******************************************************************************
  * PRIVATE TYPES
  ******************************************************************************/
 
+/** io_uring: registration of descriptor */
+typedef struct uring_reg_s {
+    uint64_t data;   /**< User data */
+    uint32_t gen;    /**< Generation. Completions of old ones are dropped */
+    uint32_t events; /**< Interest mask */
+    uint32_t armed;  /**< Mask of (1 << URING_OP_*) in flight */
+} uring_reg_t;
+
+/** io_uring: private state of reactor */
+struct server_uring_s {
+    int ring_fd;                     /**< io_uring descriptor */
+    uint8_t *p_sq_ptr;               /**< SQ ring mapping */
+    size_t sq_sz;                    /**< SQ ring mapping size */
+    uint8_t *p_cq_ptr;               /**< CQ ring mapping */
+    size_t cq_sz;                    /**< CQ ring mapping size */
+    struct io_uring_sqe *p_sqes;     /**< SQEs mapping */
+    size_t sqes_sz;                  /**< SQEs mapping size */
+    unsigned *p_sq_head;             /**< SQ head (kernel) */
+    unsigned *p_sq_tail;             /**< SQ tail (user) */
+    unsigned sq_mask;                /**< SQ mask */
+    unsigned sq_entries;             /**< SQ entries */
+    unsigned sq_tail;                /**< Local SQ tail */
+    unsigned to_submit;              /**< Prepared but not submitted SQEs */
+    unsigned *p_cq_head;             /**< CQ head (user) */
+    unsigned *p_cq_tail;             /**< CQ tail (kernel) */
+    unsigned cq_mask;                /**< CQ mask */
+    struct io_uring_cqe *p_cqes;     /**< CQEs */
+    struct io_uring_buf_ring *p_br;  /**< Provided buffers ring */
+    size_t br_sz;                    /**< Provided buffers ring size */
+    uint8_t *p_bufs;                 /**< Provided buffers memory */
+    uint16_t br_tail;                /**< Local provided buffers tail */
+    uint16_t br_mask;                /**< Provided buffers ring mask */
+    uring_reg_t *p_regs;             /**< Registrations indexed by fd */
+    server_event_t *p_backlog;       /**< Events reaped during sends */
+    size_t backlog_head;             /**< First not returned event */
+    size_t backlog_count;            /**< Count of events in backlog */
+    size_t backlog_cap;              /**< Capacity of backlog */
+    struct msghdr *p_msgs;           /**< Headers of batch sends */
+    size_t msgs_cap;                 /**< Capacity of headers */
+};
+
 /******************************************************************************
  * PRIVATE DATA
  ******************************************************************************/
 
+/** First rings of outbound queues, allocated on first push */
+static pool_t g_outq_min_pool =
+    POOL_INITIALIZER("outq_min", CONFIG_SRV_OUTQ_MIN * sizeof(msg_t *));
+
+/** Full rings of outbound queues, a first ring grows into one when full */
+static pool_t g_outq_pool =
+    POOL_INITIALIZER("outq", CONFIG_SRV_OUTQ_SIZE * sizeof(msg_t *));
+
+/** Last-value indexes of keyed queues, allocated on first keyed push */
+static pool_t g_last_pool =
+    POOL_INITIALIZER("outq_last", CONFIG_SRV_OUTQ_SIZE * sizeof(uint32_t));
+
 /******************************************************************************
  * PUBLIC DATA
  ******************************************************************************/
@@ -86,100 +168,1931 @@
  * PRIVATE FUNCTION PROTOTYPES
  ******************************************************************************/
 
+static uint32_t epoll_events_to(uint32_t events);
+static uint32_t epoll_events_from(uint32_t events);
+static short poll_events_to(uint32_t events);
+static uint32_t poll_events_from(short revents);
+static size_t poll_find(const server_reactor_t *p_reactor, int fd);
+static uint64_t uring_ud(uint32_t op, uint32_t gen, uint32_t low);
+static int uring_enter(struct server_uring_s *p_uring, unsigned min_complete,
+                       int timeout_ms);
+static struct io_uring_sqe *uring_sqe(struct server_uring_s *p_uring);
+static void uring_arm(struct server_uring_s *p_uring, int fd, uint32_t op);
+static void uring_buf_recycle(struct server_uring_s *p_uring, uint32_t bid);
+static bool uring_cqe_to_event(struct server_uring_s *p_uring,
+                               const struct io_uring_cqe *p_cqe,
+                               server_event_t *p_event);
+static int32_t uring_backlog_push(struct server_uring_s *p_uring,
+                                  const server_event_t *p_event);
+static int32_t uring_init(server_reactor_t *p_reactor);
+static void uring_deinit(server_reactor_t *p_reactor);
+static int uring_wait(server_reactor_t *p_reactor, server_event_t *p_events,
+                      size_t max_events, int timeout_ms);
+static int32_t uring_send_batch(server_reactor_t *p_reactor,
+                                server_send_t *p_sends, size_t count);
+static int32_t server_unix_stale(const struct sockaddr_un *p_addr,
+                                 socklen_t addr_len);
+static int32_t server_unix_listen(server_handle_t *p_handle);
+static int32_t server_accept_fd(int listen_fd, server_client_t *p_client);
+static int32_t server_outq_grow(server_outq_t *p_outq);
+
 /******************************************************************************
  * PRIVATE FUNCTIONS
  ******************************************************************************/
 
-/******************************************************************************
- * PUBLIC FUNCTIONS
- ******************************************************************************/
+/**
+ * @brief Convert SERVER_EV_* mask into edge-triggered epoll mask
+ */
+static uint32_t epoll_events_to(uint32_t events) {
+    uint32_t ret = EPOLLET | EPOLLRDHUP;
+
+    if (events & SERVER_EV_READ) {
+        ret |= EPOLLIN;
+    }
+
+    if (events & SERVER_EV_WRITE) {
+        ret |= EPOLLOUT;
+    }
+
+    return ret;
+}
 
 /**
- * @brief Init server
+ * @brief Convert epoll mask into SERVER_EV_* mask
  *
- * @param p_handle pointer to server handle
- * @param p_conf pointer to server config
+ * @note Hangup is reported as readable too, so the owner reads the EOF out
+ */
+static uint32_t epoll_events_from(uint32_t events) {
+    uint32_t ret = 0;
+
+    if (events & (EPOLLIN | EPOLLRDHUP)) {
+        ret |= SERVER_EV_READ;
+    }
+
+    if (events & EPOLLOUT) {
+        ret |= SERVER_EV_WRITE;
+    }
+
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        ret |= SERVER_EV_ERROR | SERVER_EV_READ;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Convert SERVER_EV_* mask into poll mask
+ */
+static short poll_events_to(uint32_t events) {
+    // NOTE: as with epoll, peer shutdown is reported without read interest
+    short ret = POLLRDHUP;
+
+    if (events & SERVER_EV_READ) {
+        ret |= POLLIN;
+    }
+
+    if (events & SERVER_EV_WRITE) {
+        ret |= POLLOUT;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Convert poll mask into SERVER_EV_* mask
+ */
+static uint32_t poll_events_from(short revents) {
+    uint32_t ret = 0;
+
+    if (revents & (POLLIN | POLLRDHUP)) {
+        ret |= SERVER_EV_READ;
+    }
+
+    if (revents & POLLOUT) {
+        ret |= SERVER_EV_WRITE;
+    }
+
+    if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+        ret |= SERVER_EV_ERROR | SERVER_EV_READ;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find index of descriptor in poll set
+ *
+ * @return size_t index or max_fds if not found
+ */
+static size_t poll_find(const server_reactor_t *p_reactor, int fd) {
+    if ((fd < 0) || ((size_t)fd >= p_reactor->max_fds)) {
+        return p_reactor->max_fds;
+    }
+
+    size_t idx = p_reactor->p_poll_idx[fd];
+    if ((idx >= p_reactor->poll_count) ||
+        (p_reactor->p_pollfds[idx].fd != fd)) {
+        return p_reactor->max_fds;
+    }
+
+    return idx;
+}
+
+/**
+ * @brief Build io_uring user_data
+ *
+ * @param op URING_OP_*
+ * @param gen registration generation
+ * @param low fd or index in batch
+ * @return uint64_t user_data
+ */
+static uint64_t uring_ud(uint32_t op, uint32_t gen, uint32_t low) {
+    return ((uint64_t)op << URING_OP_SHIFT) |
+           ((uint64_t)(gen & URING_GEN_MASK) << URING_GEN_SHIFT) | low;
+}
+
+/**
+ * @brief Submit prepared SQEs and optionally wait for completions
+ *
+ * @param p_uring pointer to io_uring state
+ * @param min_complete count of completions to wait for
+ * @param timeout_ms timeout in ms, -1 for infinite
+ * @return int io_uring_enter result or -1
+ */
+static int uring_enter(struct server_uring_s *p_uring, unsigned min_complete,
+                       int timeout_ms) {
+    unsigned flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+    struct __kernel_timespec ts = {.tv_sec = timeout_ms / 1000,
+                                   .tv_nsec = (timeout_ms % 1000) * 1000000L};
+    struct io_uring_getevents_arg arg = {.sigmask = 0,
+                                         .sigmask_sz = _NSIG / 8,
+                                         .ts = (uint64_t)(uintptr_t)&ts};
+    void *p_arg = NULL;
+    size_t arg_sz = 0;
+
+    if ((min_complete > 0) && (timeout_ms >= 0)) {
+        flags |= IORING_ENTER_EXT_ARG;
+        p_arg = &arg;
+        arg_sz = sizeof(arg);
+    }
+
+    __atomic_store_n(p_uring->p_sq_tail, p_uring->sq_tail, __ATOMIC_RELEASE);
+
+    int ret = (int)syscall(__NR_io_uring_enter, p_uring->ring_fd,
+                           p_uring->to_submit, min_complete, flags, p_arg,
+                           arg_sz);
+    if (ret >= 0) {
+        p_uring->to_submit -=
+            ((unsigned)ret < p_uring->to_submit) ? (unsigned)ret
+                                                 : p_uring->to_submit;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Get zeroed SQE, submitting pending ones if SQ is full
+ *
+ * @param p_uring pointer to io_uring state
+ * @return struct io_uring_sqe* SQE
+ */
+static struct io_uring_sqe *uring_sqe(struct server_uring_s *p_uring) {
+    while (p_uring->sq_tail -
+               __atomic_load_n(p_uring->p_sq_head, __ATOMIC_ACQUIRE) >=
+           p_uring->sq_entries) {
+        uring_enter(p_uring, 0, 0);
+    }
+
+    struct io_uring_sqe *p_sqe =
+        &p_uring->p_sqes[p_uring->sq_tail & p_uring->sq_mask];
+    memset(p_sqe, 0x00, sizeof(struct io_uring_sqe));
+    p_uring->sq_tail++;
+    p_uring->to_submit++;
+
+    return p_sqe;
+}
+
+/**
+ * @brief Prepare multishot / oneshot operation for registered descriptor
+ *
+ * @param p_uring pointer to io_uring state
+ * @param fd descriptor
+ * @param op URING_OP_*
+ */
+static void uring_arm(struct server_uring_s *p_uring, int fd, uint32_t op) {
+    uring_reg_t *p_reg = &p_uring->p_regs[fd];
+    struct io_uring_sqe *p_sqe = uring_sqe(p_uring);
+
+    p_sqe->fd = fd;
+    p_sqe->user_data = uring_ud(op, p_reg->gen, (uint32_t)fd);
+
+    switch (op) {
+        case URING_OP_ACCEPT:
+            p_sqe->opcode = IORING_OP_ACCEPT;
+            p_sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            p_sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+            break;
+
+        case URING_OP_RECV:
+            p_sqe->opcode = IORING_OP_RECV;
+            p_sqe->ioprio = IORING_RECV_MULTISHOT;
+            p_sqe->flags = IOSQE_BUFFER_SELECT;
+            p_sqe->buf_group = URING_BGID;
+            break;
+
+        case URING_OP_POLL:
+            p_sqe->opcode = IORING_OP_POLL_ADD;
+            p_sqe->poll32_events = POLLIN;
+            p_sqe->len = IORING_POLL_ADD_MULTI;
+            break;
+
+        case URING_OP_POLLOUT:
+            p_sqe->opcode = IORING_OP_POLL_ADD;
+            p_sqe->poll32_events = POLLOUT;
+            break;
+
+        default:
+            break;
+    }
+
+    p_reg->armed |= (1U << op);
+}
+
+/**
+ * @brief Return provided buffer to the kernel
+ *
+ * @param p_uring pointer to io_uring state
+ * @param bid buffer id
+ */
+static void uring_buf_recycle(struct server_uring_s *p_uring, uint32_t bid) {
+    struct io_uring_buf *p_buf =
+        &p_uring->p_br->bufs[p_uring->br_tail & p_uring->br_mask];
+
+    // NOTE: ring tail overlays resv field of bufs[0], so set fields one by one
+    p_buf->addr = (uint64_t)(uintptr_t)(p_uring->p_bufs +
+                                        (size_t)bid * CONFIG_BUFFER_SIZE);
+    p_buf->len = (uint32_t)CONFIG_BUFFER_SIZE;
+    p_buf->bid = (uint16_t)bid;
+    p_uring->br_tail++;
+
+    __atomic_store_n(&p_uring->p_br->tail, p_uring->br_tail,
+                     __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Convert CQE into reactor event, re-arming finished multishots
+ *
+ * @param p_uring pointer to io_uring state
+ * @param p_cqe pointer to CQE
+ * @param p_event output event
+ * @return true if event must be reported
+ */
+static bool uring_cqe_to_event(struct server_uring_s *p_uring,
+                               const struct io_uring_cqe *p_cqe,
+                               server_event_t *p_event) {
+    uint32_t op = (uint32_t)(p_cqe->user_data >> URING_OP_SHIFT);
+    uint32_t gen = (uint32_t)(p_cqe->user_data >> URING_GEN_SHIFT) &
+                   URING_GEN_MASK;
+    int fd = (int)(uint32_t)p_cqe->user_data;
+    bool has_buf = (0 != (p_cqe->flags & IORING_CQE_F_BUFFER));
+    uint32_t bid = p_cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+    bool is_more = (0 != (p_cqe->flags & IORING_CQE_F_MORE));
+
+    if ((URING_OP_CANCEL == op) || (URING_OP_SEND == op)) {
+        return false;
+    }
+
+    uring_reg_t *p_reg = &p_uring->p_regs[fd];
+
+    // NOTE: completion of unregistered descriptor or previous registration
+    if ((0 == p_reg->events) || ((p_reg->gen & URING_GEN_MASK) != gen)) {
+        if (has_buf) {
+            uring_buf_recycle(p_uring, bid);
+        }
+        return false;
+    }
+
+    if (!is_more) {
+        p_reg->armed &= ~(1U << op);
+    }
+
+    memset(p_event, 0x00, sizeof(server_event_t));
+    p_event->data = p_reg->data;
+    p_event->res = p_cqe->res;
+
+    switch (op) {
+        case URING_OP_ACCEPT:
+            if (!is_more) {
+                uring_arm(p_uring, fd, URING_OP_ACCEPT);
+            }
+
+            if (p_cqe->res < 0) {
+                return false;
+            }
+
+            p_event->events = SERVER_EV_ACCEPT;
+            return true;
+
+        case URING_OP_RECV:
+            if (-ENOBUFS == p_cqe->res) {
+                uring_arm(p_uring, fd, URING_OP_RECV);
+                return false;
+            }
+
+            if ((p_cqe->res > 0) && !is_more) {
+                uring_arm(p_uring, fd, URING_OP_RECV);
+            }
+
+            p_event->events = SERVER_EV_DATA;
+            if (p_cqe->res < 0) {
+                p_event->events |= SERVER_EV_ERROR;
+            }
+
+            if (has_buf) {
+                p_event->p_buf =
+                    p_uring->p_bufs + (size_t)bid * CONFIG_BUFFER_SIZE;
+                p_event->buf_id = bid + 1;
+            }
+            return true;
+
+        case URING_OP_POLL:
+            if (!is_more) {
+                uring_arm(p_uring, fd, URING_OP_POLL);
+            }
+
+            p_event->events = SERVER_EV_READ;
+            return true;
+
+        case URING_OP_POLLOUT:
+            p_event->events = SERVER_EV_WRITE;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Keep event reaped while waiting for sends for next wait
+ *
+ * @param p_uring pointer to io_uring state
+ * @param p_event pointer to event
  * @return int32_t 0 if OK, error otherwise
  */
-int32_t server_init(server_handle_t *p_handle, const server_conf_t *p_conf) {
-    if (NULL == p_handle) {
-        return SERVER_ERR_PARAMS;
+static int32_t uring_backlog_push(struct server_uring_s *p_uring,
+                                  const server_event_t *p_event) {
+    if (p_uring->backlog_head + p_uring->backlog_count ==
+        p_uring->backlog_cap) {
+        size_t cap = (0 == p_uring->backlog_cap) ? CONFIG_SRV_EVENTS_MAX
+                                                 : 2 * p_uring->backlog_cap;
+        server_event_t *p_new =
+            realloc(p_uring->p_backlog, cap * sizeof(server_event_t));
+        if (NULL == p_new) {
+            return SERVER_ERR_NG;
+        }
+
+        p_uring->p_backlog = p_new;
+        p_uring->backlog_cap = cap;
     }
 
-    if (NULL == p_conf) {
-        return SERVER_ERR_PARAMS;
+    p_uring->p_backlog[p_uring->backlog_head + p_uring->backlog_count] =
+        *p_event;
+    p_uring->backlog_count++;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Init io_uring backend: rings and provided buffers
+ *
+ * @param p_reactor pointer to reactor
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t uring_init(server_reactor_t *p_reactor) {
+    struct server_uring_s *p_uring = calloc(1, sizeof(struct server_uring_s));
+    if (NULL == p_uring) {
+        return SERVER_ERR_NG;
     }
 
-    memset(p_handle, 0x00, sizeof(server_handle_t));
-    memcpy(&p_handle->conf, p_conf, sizeof(server_conf_t));
+    p_reactor->p_uring = p_uring;
+    p_uring->ring_fd = COMMON_SOCKET_ERR;
 
-    p_handle->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (COMMON_SOCKET_ERR == p_handle->socket_fd) {
-        return SERVER_ERR_SOCKET;
+    p_uring->p_regs = calloc(p_reactor->max_fds, sizeof(uring_reg_t));
+    if (NULL == p_uring->p_regs) {
+        return SERVER_ERR_NG;
     }
 
-    p_handle->sockaddr.sin_family = AF_INET;
-    p_handle->sockaddr.sin_addr.s_addr = htonl(p_handle->conf.addr);
-    p_handle->sockaddr.sin_port = htons(p_handle->conf.port);
+    struct io_uring_params params;
+    memset(&params, 0x00, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = (unsigned)CONFIG_SRV_URING_ENTRIES * 4;
 
-    int ret = bind(p_handle->socket_fd, (struct sockaddr *)&p_handle->sockaddr,
-                   sizeof(p_handle->sockaddr));
-    if (COMMON_SOCKET_ERR == ret) {
+    p_uring->ring_fd = (int)syscall(__NR_io_uring_setup,
+                                    (unsigned)CONFIG_SRV_URING_ENTRIES, &params);
+    if (COMMON_SOCKET_ERR == p_uring->ring_fd) {
         return SERVER_ERR_SOCKET;
     }
 
-    p_handle->max_clients = server_max_clients();
-    ret = listen(p_handle->socket_fd, p_handle->max_clients);
-    if (COMMON_SOCKET_ERR == ret) {
-        return SERVER_ERR_SOCKET;
+    if (0 == (params.features & IORING_FEAT_EXT_ARG)) {
+        return SERVER_ERR_NG;
+    }
+
+    p_uring->sq_sz = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    p_uring->cq_sz =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (p_uring->cq_sz > p_uring->sq_sz) {
+            p_uring->sq_sz = p_uring->cq_sz;
+        }
+        p_uring->cq_sz = 0;
+    }
+
+    p_uring->p_sq_ptr =
+        mmap(NULL, p_uring->sq_sz, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, p_uring->ring_fd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == p_uring->p_sq_ptr) {
+        p_uring->p_sq_ptr = NULL;
+        return SERVER_ERR_NG;
+    }
+
+    p_uring->p_cq_ptr = p_uring->p_sq_ptr;
+    if (0 != p_uring->cq_sz) {
+        p_uring->p_cq_ptr = mmap(NULL, p_uring->cq_sz, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, p_uring->ring_fd,
+                                 IORING_OFF_CQ_RING);
+        if (MAP_FAILED == p_uring->p_cq_ptr) {
+            p_uring->p_cq_ptr = NULL;
+            return SERVER_ERR_NG;
+        }
+    }
+
+    p_uring->sqes_sz = params.sq_entries * sizeof(struct io_uring_sqe);
+    p_uring->p_sqes =
+        mmap(NULL, p_uring->sqes_sz, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, p_uring->ring_fd, IORING_OFF_SQES);
+    if (MAP_FAILED == p_uring->p_sqes) {
+        p_uring->p_sqes = NULL;
+        return SERVER_ERR_NG;
+    }
+
+    p_uring->p_sq_head = (unsigned *)(p_uring->p_sq_ptr + params.sq_off.head);
+    p_uring->p_sq_tail = (unsigned *)(p_uring->p_sq_ptr + params.sq_off.tail);
+    p_uring->sq_mask =
+        *(unsigned *)(p_uring->p_sq_ptr + params.sq_off.ring_mask);
+    p_uring->sq_entries = params.sq_entries;
+    p_uring->sq_tail = *p_uring->p_sq_tail;
+    p_uring->p_cq_head = (unsigned *)(p_uring->p_cq_ptr + params.cq_off.head);
+    p_uring->p_cq_tail = (unsigned *)(p_uring->p_cq_ptr + params.cq_off.tail);
+    p_uring->cq_mask =
+        *(unsigned *)(p_uring->p_cq_ptr + params.cq_off.ring_mask);
+    p_uring->p_cqes =
+        (struct io_uring_cqe *)(p_uring->p_cq_ptr + params.cq_off.cqes);
+
+    // NOTE: identity mapping, SQE index is always equal to SQ slot
+    unsigned *p_array = (unsigned *)(p_uring->p_sq_ptr + params.sq_off.array);
+    for (unsigned idx = 0; idx < params.sq_entries; idx++) {
+        p_array[idx] = idx;
+    }
+
+    const size_t bufs = CONFIG_SRV_URING_BUFS;
+
+    p_uring->br_sz = bufs * sizeof(struct io_uring_buf);
+    p_uring->p_br = mmap(NULL, p_uring->br_sz, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == p_uring->p_br) {
+        p_uring->p_br = NULL;
+        return SERVER_ERR_NG;
+    }
+
+    p_uring->p_bufs = malloc(bufs * CONFIG_BUFFER_SIZE);
+    if (NULL == p_uring->p_bufs) {
+        return SERVER_ERR_NG;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0x00, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)p_uring->p_br;
+    reg.ring_entries = (uint32_t)bufs;
+    reg.bgid = URING_BGID;
+
+    if (0 != syscall(__NR_io_uring_register, p_uring->ring_fd,
+                     IORING_REGISTER_PBUF_RING, &reg, 1)) {
+        return SERVER_ERR_NG;
+    }
+
+    p_uring->br_mask = (uint16_t)(bufs - 1);
+    for (size_t bid = 0; bid < bufs; bid++) {
+        uring_buf_recycle(p_uring, (uint32_t)bid);
     }
 
     return SERVER_ERR_OK;
 }
 
-int32_t server_deinit(server_handle_t *p_handle) {
-    if (NULL == p_handle) {
-        return SERVER_ERR_PARAMS;
+/**
+ * @brief Deinit io_uring backend
+ *
+ * @param p_reactor pointer to reactor
+ */
+static void uring_deinit(server_reactor_t *p_reactor) {
+    struct server_uring_s *p_uring = p_reactor->p_uring;
+    if (NULL == p_uring) {
+        return;
     }
 
-    close(p_handle->socket_fd);
-    p_handle->socket_fd = COMMON_SOCKET_ERR;
+    if (COMMON_SOCKET_ERR != p_uring->ring_fd) {
+        close(p_uring->ring_fd);
+    }
 
-    return SERVER_ERR_OK;
+    if (NULL != p_uring->p_sqes) {
+        munmap(p_uring->p_sqes, p_uring->sqes_sz);
+    }
+
+    if ((NULL != p_uring->p_cq_ptr) && (p_uring->p_cq_ptr != p_uring->p_sq_ptr)) {
+        munmap(p_uring->p_cq_ptr, p_uring->cq_sz);
+    }
+
+    if (NULL != p_uring->p_sq_ptr) {
+        munmap(p_uring->p_sq_ptr, p_uring->sq_sz);
+    }
+
+    if (NULL != p_uring->p_br) {
+        munmap(p_uring->p_br, p_uring->br_sz);
+    }
+
+    free(p_uring->p_bufs);
+    free(p_uring->p_regs);
+    free(p_uring->p_backlog);
+    free(p_uring->p_msgs);
+    free(p_uring);
+    p_reactor->p_uring = NULL;
 }
 
 /**
- * @brief Accept incoming connecion
+ * @brief Wait for completions of io_uring backend
  *
- * @param p_handle pointer to server handle
- * @param p_client pointer to server client
+ * @param p_reactor pointer to reactor
+ * @param p_events output array of events
+ * @param max_events size of output array
+ * @param timeout_ms timeout in ms, -1 for infinite
+ * @return int count of events, 0 on timeout
+ */
+static int uring_wait(server_reactor_t *p_reactor, server_event_t *p_events,
+                      size_t max_events, int timeout_ms) {
+    struct server_uring_s *p_uring = p_reactor->p_uring;
+    size_t count = 0;
+
+    while ((count < max_events) && (p_uring->backlog_count > 0)) {
+        p_events[count++] = p_uring->p_backlog[p_uring->backlog_head++];
+        p_uring->backlog_count--;
+    }
+
+    if (0 == p_uring->backlog_count) {
+        p_uring->backlog_head = 0;
+    }
+
+    unsigned head = *p_uring->p_cq_head;
+    bool is_ready =
+        (head != __atomic_load_n(p_uring->p_cq_tail, __ATOMIC_ACQUIRE));
+
+    // NOTE: one syscall submits everything prepared and waits for completions
+    if ((count > 0) || is_ready) {
+        if (p_uring->to_submit > 0) {
+            uring_enter(p_uring, 0, 0);
+        }
+    } else {
+        uring_enter(p_uring, 1, timeout_ms);
+    }
+
+    unsigned tail = __atomic_load_n(p_uring->p_cq_tail, __ATOMIC_ACQUIRE);
+    while ((count < max_events) && (head != tail)) {
+        const struct io_uring_cqe *p_cqe =
+            &p_uring->p_cqes[head & p_uring->cq_mask];
+        if (uring_cqe_to_event(p_uring, p_cqe, &p_events[count])) {
+            count++;
+        }
+        head++;
+    }
+
+    __atomic_store_n(p_uring->p_cq_head, head, __ATOMIC_RELEASE);
+
+    return (int)count;
+}
+
+/**
+ * @brief Send batch with io_uring: one SQE per send, one syscall for all
+ *
+ * Sends are not linked: a descriptor takes at most one send per batch, so
+ * order of completions does not matter.
+ *
+ * @param p_reactor pointer to reactor
+ * @param p_sends array of sends
+ * @param count count of sends
  * @return int32_t 0 if OK, error otherwise
  */
-int32_t server_accept(server_handle_t *p_handle, server_client_t *p_client) {
-    if (NULL == p_handle) {
-        return SERVER_ERR_PARAMS;
+static int32_t uring_send_batch(server_reactor_t *p_reactor,
+                                server_send_t *p_sends, size_t count) {
+    struct server_uring_s *p_uring = p_reactor->p_uring;
+    size_t in_flight = 0;
+
+    if (count > p_uring->msgs_cap) {
+        struct msghdr *p_new =
+            realloc(p_uring->p_msgs, count * sizeof(struct msghdr));
+        if (NULL == p_new) {
+            return SERVER_ERR_NG;
+        }
+
+        p_uring->p_msgs = p_new;
+        p_uring->msgs_cap = count;
     }
 
-    if (NULL == p_client) {
-        return SERVER_ERR_PARAMS;
+    for (size_t idx = 0; idx < count; idx++) {
+        struct msghdr *p_msg = &p_uring->p_msgs[idx];
+        memset(p_msg, 0x00, sizeof(struct msghdr));
+        p_msg->msg_iov = (struct iovec *)p_sends[idx].p_iov;
+        p_msg->msg_iovlen = p_sends[idx].iov_count;
+
+        struct io_uring_sqe *p_sqe = uring_sqe(p_uring);
+        p_sqe->opcode = IORING_OP_SENDMSG;
+        p_sqe->fd = p_sends[idx].fd;
+        p_sqe->addr = (uint64_t)(uintptr_t)p_msg;
+        p_sqe->len = 1;
+        p_sqe->msg_flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+        p_sqe->user_data = uring_ud(URING_OP_SEND, 0, (uint32_t)idx);
+
+        p_sends[idx].res = -EINPROGRESS;
+        in_flight++;
     }
 
-    memset(p_client, 0x00, sizeof(server_client_t));
+    while (in_flight > 0) {
+        int ret = uring_enter(p_uring, (unsigned)in_flight, -1);
+        if ((ret < 0) && (EINTR != errno)) {
+            return SERVER_ERR_SOCKET;
+        }
 
-    p_client->sockaddr_len = sizeof(p_client->sockaddr);
-    p_client->socket_fd =
-        accept(p_handle->socket_fd, (struct sockaddr *)&p_client->sockaddr,
-               &p_client->sockaddr_len);
+        unsigned head = *p_uring->p_cq_head;
+        unsigned tail = __atomic_load_n(p_uring->p_cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const struct io_uring_cqe *p_cqe =
+                &p_uring->p_cqes[head & p_uring->cq_mask];
+            uint32_t op = (uint32_t)(p_cqe->user_data >> URING_OP_SHIFT);
+
+            if (URING_OP_SEND == op) {
+                p_sends[(uint32_t)p_cqe->user_data].res = p_cqe->res;
+                in_flight--;
+                continue;
+            }
+
+            server_event_t event;
+            if (uring_cqe_to_event(p_uring, p_cqe, &event)) {
+                if (SERVER_ERR_OK != uring_backlog_push(p_uring, &event)) {
+                    if (event.buf_id > 0) {
+                        uring_buf_recycle(p_uring, event.buf_id - 1);
+                    }
+                }
+            }
+        }
+
+        __atomic_store_n(p_uring->p_cq_head, head, __ATOMIC_RELEASE);
+    }
 
     return SERVER_ERR_OK;
 }
 
 /**
- * @brief Return max possible clients for server
+ * @brief Remove socket file left by previous run
  *
- * @return size_t max count of clients
+ * File is removed only if it is a socket nobody listens on, so another
+ * running server or a file which is not a socket is never removed.
+ *
+ * @param p_addr pointer to unix address with file path
+ * @param addr_len length of address
+ * @return int32_t 0 if path is free, SERVER_ERR_EXIST if it is in use or not
+ *         a socket, error otherwise
  */
-size_t server_max_clients(void) { return ((size_t)sysconf(_SC_OPEN_MAX)); }
+static int32_t server_unix_stale(const struct sockaddr_un *p_addr,
+                                 socklen_t addr_len) {
+    struct stat st;
+    if (0 != lstat(p_addr->sun_path, &st)) {
+        return (ENOENT == errno) ? SERVER_ERR_OK : SERVER_ERR_SOCKET;
+    }
+
+    if (!S_ISSOCK(st.st_mode)) {
+        return SERVER_ERR_EXIST;
+    }
+
+    // NOTE: non-blocking, so a listener with full backlog is not waited for
+    const int probe_fd =
+        socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (COMMON_SOCKET_ERR == probe_fd) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    const int ret = connect(probe_fd, (const struct sockaddr *)p_addr,
+                            addr_len);
+    const int err = errno;
+    close(probe_fd);
+    if ((COMMON_SOCKET_ERR != ret) || (ECONNREFUSED != err)) {
+        return SERVER_ERR_EXIST;
+    }
+
+    if ((0 != unlink(p_addr->sun_path)) && (ENOENT != errno)) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Create unix socket listener of handle
+ *
+ * Stale socket file of previous run is removed before bind, a path in use
+ * is not.
+ *
+ * @param p_handle pointer to server handle with conf.unix_path set
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t server_unix_listen(server_handle_t *p_handle) {
+    const char *p_path = p_handle->conf.unix_path;
+    struct sockaddr_un addr;
+    socklen_t addr_len = 0;
+
+    if (!common_unix_addr(p_path, &addr, &addr_len)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    p_handle->unix_fd =
+        socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (COMMON_SOCKET_ERR == p_handle->unix_fd) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    if (COMMON_UNIX_ABSTRACT != p_path[0]) {
+        const int32_t ret = server_unix_stale(&addr, addr_len);
+        if (SERVER_ERR_OK != ret) {
+            return ret;
+        }
+    }
+
+    if ((COMMON_SOCKET_ERR ==
+         bind(p_handle->unix_fd, (struct sockaddr *)&addr, addr_len)) ||
+        (COMMON_SOCKET_ERR ==
+         listen(p_handle->unix_fd, p_handle->conf.backlog))) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Accept incoming connection from listener
+ *
+ * @param listen_fd listener
+ * @param p_client pointer to server client
+ * @return int32_t 0 if OK, SERVER_ERR_AGAIN if no pending connections,
+ *         error otherwise
+ */
+static int32_t server_accept_fd(int listen_fd, server_client_t *p_client) {
+    memset(p_client, 0x00, sizeof(server_client_t));
+
+    // NOTE: peer address is not kept, getpeername() gives it when needed
+    p_client->socket_fd =
+        accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (COMMON_SOCKET_ERR == p_client->socket_fd) {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+            return SERVER_ERR_AGAIN;
+        }
+
+        // NOTE: peer gave up while waiting in backlog - try next one
+        if ((ECONNABORTED == errno) || (EINTR == errno)) {
+            return SERVER_ERR_AGAIN;
+        }
+
+        return SERVER_ERR_SOCKET;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Init server
+ *
+ * @param p_handle pointer to server handle
+ * @param p_conf pointer to server config
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_init(server_handle_t *p_handle, const server_conf_t *p_conf) {
+    if (NULL == p_handle) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (NULL == p_conf) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    memset(p_handle, 0x00, sizeof(server_handle_t));
+    memcpy(&p_handle->conf, p_conf, sizeof(server_conf_t));
+    p_handle->unix_fd = COMMON_SOCKET_ERR;
+
+    p_handle->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (COMMON_SOCKET_ERR == p_handle->socket_fd) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    int opt = 1;
+    setsockopt(p_handle->socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt,
+               sizeof(opt));
+
+    // NOTE: every shard binds own listener, kernel balances connections
+    if (p_handle->conf.reuseport) {
+        int ret = setsockopt(p_handle->socket_fd, SOL_SOCKET, SO_REUSEPORT,
+                             &opt, sizeof(opt));
+        if (COMMON_SOCKET_ERR == ret) {
+            return SERVER_ERR_SOCKET;
+        }
+    }
+
+    // NOTE: listener is drained until EAGAIN, so it must not block
+    if (SERVER_ERR_OK != server_set_nonblock(p_handle->socket_fd)) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    p_handle->sockaddr.sin_family = AF_INET;
+    p_handle->sockaddr.sin_addr.s_addr = htonl(p_handle->conf.addr);
+    p_handle->sockaddr.sin_port = htons(p_handle->conf.port);
+
+    int ret = bind(p_handle->socket_fd, (struct sockaddr *)&p_handle->sockaddr,
+                   sizeof(p_handle->sockaddr));
+    if (COMMON_SOCKET_ERR == ret) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    p_handle->max_clients = server_max_clients();
+    ret = listen(p_handle->socket_fd, p_handle->conf.backlog);
+    if (COMMON_SOCKET_ERR == ret) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    if ('\0' != p_handle->conf.unix_path[0]) {
+        return server_unix_listen(p_handle);
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Deinit server
+ *
+ * @param p_handle pointer to server handle
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_deinit(server_handle_t *p_handle) {
+    if (NULL == p_handle) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    close(p_handle->socket_fd);
+    p_handle->socket_fd = COMMON_SOCKET_ERR;
+
+    if (COMMON_SOCKET_ERR != p_handle->unix_fd) {
+        close(p_handle->unix_fd);
+        p_handle->unix_fd = COMMON_SOCKET_ERR;
+        if (COMMON_UNIX_ABSTRACT != p_handle->conf.unix_path[0]) {
+            unlink(p_handle->conf.unix_path);
+        }
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Accept incoming connecion from TCP or unix socket listener
+ *
+ * Listeners take turns to be tried first, so a storm on one of them does
+ * not starve the other. Accepted socket is switched to non-blocking mode.
+ *
+ * @param p_handle pointer to server handle
+ * @param p_client pointer to server client
+ * @return int32_t 0 if OK, SERVER_ERR_AGAIN if no pending connections,
+ *         error otherwise
+ */
+int32_t server_accept(server_handle_t *p_handle, server_client_t *p_client) {
+    if (NULL == p_handle) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (NULL == p_client) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (COMMON_SOCKET_ERR == p_handle->unix_fd) {
+        return server_accept_fd(p_handle->socket_fd, p_client);
+    }
+
+    const int fds[] = {p_handle->socket_fd, p_handle->unix_fd};
+    const uint32_t first = (p_handle->accept_turn++) & 1u;
+
+    int32_t ret = server_accept_fd(fds[first], p_client);
+    if (SERVER_ERR_AGAIN == ret) {
+        ret = server_accept_fd(fds[first ^ 1u], p_client);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Return max possible clients for server
+ *
+ * @return size_t max count of clients
+ */
+size_t server_max_clients(void) { return ((size_t)sysconf(_SC_OPEN_MAX)); }
+
+/**
+ * @brief Get accept queue of listener
+ *
+ * @param p_handle pointer to server handle
+ * @param p_queued output. Connections waiting for accept
+ * @param p_backlog output. Max length of accept queue
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_listen_queue(const server_handle_t *p_handle,
+                            uint32_t *p_queued, uint32_t *p_backlog) {
+    if ((NULL == p_handle) || (NULL == p_queued) || (NULL == p_backlog)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (COMMON_SOCKET_ERR ==
+        getsockopt(p_handle->socket_fd, IPPROTO_TCP, TCP_INFO, &info, &len)) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    // NOTE: for listener kernel reports queue length and backlog here
+    *p_queued = info.tcpi_unacked;
+    *p_backlog = info.tcpi_sacked;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Get time since last segment from peer
+ *
+ * Right after accept it is time spent in accept queue since handshake,
+ * unless peer already sent data. Resolution is about one jiffy.
+ *
+ * @param socket_fd socket of accepted client
+ * @param p_age_ms output. Time in milliseconds
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_client_age(int socket_fd, uint32_t *p_age_ms) {
+    if (NULL == p_age_ms) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (COMMON_SOCKET_ERR ==
+        getsockopt(socket_fd, IPPROTO_TCP, TCP_INFO, &info, &len)) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    *p_age_ms = info.tcpi_last_ack_recv;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Get count of accept queue overflows of whole host
+ *
+ * Kernel has no per-listener counter, so TcpExt ListenOverflows from
+ * /proc/net/netstat is used.
+ *
+ * @return uint64_t counter value or 0 if not available
+ */
+uint64_t server_listen_overflows(void) {
+    FILE *p_file = fopen("/proc/net/netstat", "r");
+    if (NULL == p_file) {
+        return 0;
+    }
+
+    char names[4096];
+    char values[4096];
+    uint64_t result = 0;
+
+    // NOTE: file is pairs of lines - names and values with same prefix
+    while ((NULL != fgets(names, sizeof(names), p_file)) &&
+           (NULL != fgets(values, sizeof(values), p_file))) {
+        if (0 != strncmp(names, "TcpExt:", 7)) {
+            continue;
+        }
+
+        char *p_name_save = NULL;
+        char *p_value_save = NULL;
+        char *p_name = strtok_r(names, " \n", &p_name_save);
+        char *p_value = strtok_r(values, " \n", &p_value_save);
+
+        while ((NULL != p_name) && (NULL != p_value)) {
+            if (0 == strcmp(p_name, "ListenOverflows")) {
+                result = strtoull(p_value, NULL, 10);
+                break;
+            }
+
+            p_name = strtok_r(NULL, " \n", &p_name_save);
+            p_value = strtok_r(NULL, " \n", &p_value_save);
+        }
+        break;
+    }
+
+    fclose(p_file);
+
+    return result;
+}
+
+/**
+ * @brief Switch socket into non-blocking mode
+ *
+ * @param socket_fd socket descriptor
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_set_nonblock(int socket_fd) {
+    int flags = fcntl(socket_fd, F_GETFL, 0);
+    if (-1 == flags) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    if (-1 == fcntl(socket_fd, F_SETFL, flags | O_NONBLOCK)) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Move full first ring of queue to a full size one
+ *
+ * Entries are moved to the start of new ring, so positions kept in the
+ * last-value index are moved as well.
+ *
+ * @param p_outq pointer to queue
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t server_outq_grow(server_outq_t *p_outq) {
+    msg_t **pp_msgs = pool_alloc(&g_outq_pool);
+    if (NULL == pp_msgs) {
+        return SERVER_ERR_NG;
+    }
+
+    const uint32_t mask = p_outq->cap - 1u;
+    for (uint32_t idx = 0; idx < p_outq->count; idx++) {
+        pp_msgs[idx] = p_outq->pp_msgs[(p_outq->head + idx) & mask];
+    }
+
+    for (uint32_t key = 0; (NULL != p_outq->p_last) &&
+                           (key < CONFIG_SRV_OUTQ_SIZE);
+         key++) {
+        if (0 != p_outq->p_last[key]) {
+            p_outq->p_last[key] =
+                ((p_outq->p_last[key] - 1u - p_outq->head) & mask) + 1u;
+        }
+    }
+
+    pool_free(&g_outq_min_pool, p_outq->pp_msgs);
+    p_outq->pp_msgs = pp_msgs;
+    p_outq->head = 0;
+    p_outq->cap = (uint16_t)CONFIG_SRV_OUTQ_SIZE;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Append message to outbound queue. Queue takes own reference
+ *
+ * @param p_outq pointer to queue
+ * @param p_msg message
+ * @return int32_t 0 if OK, SERVER_ERR_FULL if queue is full, error otherwise
+ */
+int32_t server_outq_push(server_outq_t *p_outq, msg_t *p_msg) {
+    if ((NULL == p_outq) || (NULL == p_msg)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (p_outq->count == CONFIG_SRV_OUTQ_SIZE) {
+        return SERVER_ERR_FULL;
+    }
+
+    if (NULL == p_outq->pp_msgs) {
+        p_outq->pp_msgs = pool_alloc(&g_outq_min_pool);
+        if (NULL == p_outq->pp_msgs) {
+            return SERVER_ERR_NG;
+        }
+        p_outq->cap = (uint16_t)CONFIG_SRV_OUTQ_MIN;
+    }
+
+    if ((p_outq->count == p_outq->cap) &&
+        (SERVER_ERR_OK != server_outq_grow(p_outq))) {
+        return SERVER_ERR_NG;
+    }
+
+    p_outq->pp_msgs[(p_outq->head + p_outq->count) & (p_outq->cap - 1u)] =
+        msg_ref(p_msg);
+    p_outq->count++;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Drop oldest message which is not started to be sent
+ *
+ * @param p_outq pointer to queue
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_outq_drop_oldest(server_outq_t *p_outq) {
+    if (NULL == p_outq) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    const uint32_t mask = p_outq->cap - 1u;
+
+    if (0 == p_outq->sent) {
+        if (0 == p_outq->count) {
+            return SERVER_ERR_PARAMS;
+        }
+
+        msg_unref(p_outq->pp_msgs[p_outq->head]);
+        p_outq->head = (p_outq->head + 1) & mask;
+        p_outq->count--;
+        if (0 == p_outq->count) {
+            server_outq_clear(p_outq);
+        }
+        return SERVER_ERR_OK;
+    }
+
+    // NOTE: head is partially sent, so drop next one and move head in place
+    if (p_outq->count < 2) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    uint32_t next = (p_outq->head + 1) & mask;
+    msg_unref(p_outq->pp_msgs[next]);
+    p_outq->pp_msgs[next] = p_outq->pp_msgs[p_outq->head];
+    p_outq->head = next;
+    p_outq->count--;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Replace newest message which is not started to be sent
+ *
+ * @param p_outq pointer to queue
+ * @param p_msg message. Queue takes own reference
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_outq_replace_newest(server_outq_t *p_outq, msg_t *p_msg) {
+    if ((NULL == p_outq) || (NULL == p_msg)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if ((0 == p_outq->count) || ((1 == p_outq->count) && (p_outq->sent > 0))) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    msg_t **pp_slot = &p_outq->pp_msgs[(p_outq->head + p_outq->count - 1) &
+                                       (p_outq->cap - 1u)];
+    msg_unref(*pp_slot);
+    *pp_slot = msg_ref(p_msg);
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Push data frame and remember it as the newest of its topic
+ *
+ * Last-value index is direct-mapped by topic hash and allocated on first
+ * use. A collision only overwrites the position of another topic, which
+ * then is pushed instead of replaced.
+ *
+ * @param p_outq pointer to queue
+ * @param p_msg data frame. Queue takes own reference
+ * @param key hash of topic
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_outq_push_key(server_outq_t *p_outq, msg_t *p_msg,
+                             uint32_t key) {
+    if ((NULL == p_outq) || (NULL == p_msg)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (NULL == p_outq->p_last) {
+        p_outq->p_last = pool_alloc(&g_last_pool);
+        if (NULL == p_outq->p_last) {
+            return SERVER_ERR_NG;
+        }
+        memset(p_outq->p_last, 0x00, CONFIG_SRV_OUTQ_SIZE * sizeof(uint32_t));
+    }
+
+    int32_t ret = server_outq_push(p_outq, p_msg);
+    if (SERVER_ERR_OK == ret) {
+        p_outq->p_last[key & (CONFIG_SRV_OUTQ_SIZE - 1)] =
+            ((p_outq->head + p_outq->count - 1) & (p_outq->cap - 1u)) + 1;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Replace pending data frame of the same topic in place
+ *
+ * Only the newest entry of the topic is replaced, so the client never gets
+ * an older value after a newer one. Partially sent head is kept.
+ *
+ * @param p_outq pointer to queue
+ * @param p_msg data frame. Queue takes own reference
+ * @param key hash of topic
+ * @return int32_t 0 if replaced, SERVER_ERR_AGAIN if there is no pending
+ * frame of the topic, error otherwise
+ */
+int32_t server_outq_replace_key(server_outq_t *p_outq, msg_t *p_msg,
+                                uint32_t key) {
+    if ((NULL == p_outq) || (NULL == p_msg)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    const uint32_t mask = CONFIG_SRV_OUTQ_SIZE - 1;
+    if ((NULL == p_outq->p_last) || (0 == p_outq->p_last[key & mask])) {
+        return SERVER_ERR_AGAIN;
+    }
+
+    // NOTE: position may be consumed or reused by another topic since
+    const uint32_t pos = p_outq->p_last[key & mask] - 1;
+    const uint32_t offset = (pos - p_outq->head) & (p_outq->cap - 1u);
+    if ((offset >= p_outq->count) || ((0 == offset) && (p_outq->sent > 0))) {
+        return SERVER_ERR_AGAIN;
+    }
+
+    proto_hdr_t old_hdr;
+    proto_hdr_t new_hdr;
+    const msg_t *p_old = p_outq->pp_msgs[pos];
+    proto_hdr_decode(p_old->data, &old_hdr);
+    proto_hdr_decode(p_msg->data, &new_hdr);
+    if ((PROTO_TYPE_DATA != old_hdr.type) ||
+        (PROTO_TOPIC_LEN(&old_hdr) != PROTO_TOPIC_LEN(&new_hdr)) ||
+        (0 != memcmp(&p_old->data[PROTO_HDR_SIZE],
+                     &p_msg->data[PROTO_HDR_SIZE],
+                     PROTO_TOPIC_LEN(&new_hdr)))) {
+        return SERVER_ERR_AGAIN;
+    }
+
+    msg_unref(p_outq->pp_msgs[pos]);
+    p_outq->pp_msgs[pos] = msg_ref(p_msg);
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Fill iovecs with not sent data of queue
+ *
+ * iovecs point right into shared messages, nothing is copied.
+ *
+ * @param p_outq pointer to queue
+ * @param p_iov output iovecs
+ * @param max_iov size of output iovecs
+ * @return size_t count of filled iovecs
+ */
+size_t server_outq_iov(const server_outq_t *p_outq, struct iovec *p_iov,
+                       size_t max_iov) {
+    size_t count = 0;
+
+    for (; (count < p_outq->count) && (count < max_iov); count++) {
+        const msg_t *p_msg =
+            p_outq->pp_msgs[(p_outq->head + count) & (p_outq->cap - 1u)];
+        size_t offset = (0 == count) ? p_outq->sent : 0;
+
+        p_iov[count].iov_base = (void *)(p_msg->data + offset);
+        p_iov[count].iov_len = p_msg->len - offset;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Remove sent bytes from queue, releasing completed messages
+ *
+ * Queue which becomes empty returns its ring and index to pools.
+ *
+ * @param p_outq pointer to queue
+ * @param bytes count of sent bytes
+ */
+void server_outq_consume(server_outq_t *p_outq, size_t bytes) {
+    while ((bytes > 0) && (p_outq->count > 0)) {
+        msg_t *p_msg = p_outq->pp_msgs[p_outq->head];
+        size_t left = p_msg->len - p_outq->sent;
+
+        if (bytes < left) {
+            p_outq->sent += (uint32_t)bytes;
+            return;
+        }
+
+        bytes -= left;
+        msg_unref(p_msg);
+        p_outq->head = (p_outq->head + 1) & (p_outq->cap - 1u);
+        p_outq->count--;
+        p_outq->sent = 0;
+    }
+
+    // NOTE: drained queue gives the ring back, idle client holds none
+    if (0 == p_outq->count) {
+        server_outq_clear(p_outq);
+    }
+}
+
+/**
+ * @brief Release all messages and the ring itself
+ *
+ * @param p_outq pointer to queue
+ */
+void server_outq_clear(server_outq_t *p_outq) {
+    while (p_outq->count > 0) {
+        msg_unref(p_outq->pp_msgs[p_outq->head]);
+        p_outq->head = (p_outq->head + 1) & (p_outq->cap - 1u);
+        p_outq->count--;
+    }
+
+    pool_free((CONFIG_SRV_OUTQ_MIN == p_outq->cap) ? &g_outq_min_pool
+                                                   : &g_outq_pool,
+              p_outq->pp_msgs);
+    pool_free(&g_last_pool, p_outq->p_last);
+    memset(p_outq, 0x00, sizeof(server_outq_t));
+}
+
+/**
+ * @brief Init connection table
+ *
+ * @param p_table pointer to table
+ * @param cap max count of clients
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_table_init(server_table_t *p_table, size_t cap) {
+    if ((NULL == p_table) || (0 == cap) || (cap >= UINT32_MAX)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    // NOTE: arrays are zeroed and committed by the kernel page by page
+    memset(p_table, 0x00, sizeof(server_table_t));
+    p_table->cap = (uint32_t)cap;
+    p_table->p_slots = pool_reserve_alloc(cap * sizeof(server_client_t));
+    p_table->p_free = pool_reserve_alloc(cap * sizeof(uint32_t));
+    p_table->p_live = pool_reserve_alloc(cap * sizeof(uint32_t));
+    if ((NULL == p_table->p_slots) || (NULL == p_table->p_free) ||
+        (NULL == p_table->p_live)) {
+        server_table_deinit(p_table);
+        return SERVER_ERR_NG;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Deinit connection table. Clients are not closed
+ *
+ * @param p_table pointer to table
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_table_deinit(server_table_t *p_table) {
+    if (NULL == p_table) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    pool_reserve_free(p_table->p_slots,
+                      p_table->cap * sizeof(server_client_t));
+    pool_reserve_free(p_table->p_free, p_table->cap * sizeof(uint32_t));
+    pool_reserve_free(p_table->p_live, p_table->cap * sizeof(uint32_t));
+    memset(p_table, 0x00, sizeof(server_table_t));
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Put client into free slot
+ *
+ * Released slots are reused first, newest first, so the table stays as
+ * compact as the peak of connections. Flags of list membership survive slot
+ * reuse, so stale entries in owner lists stay accounted.
+ *
+ * @param p_table pointer to table
+ * @param p_client client to copy into slot
+ * @return server_client_t* client in table or NULL if table is full
+ */
+server_client_t *server_table_add(server_table_t *p_table,
+                                  const server_client_t *p_client) {
+    if ((NULL == p_table) || (NULL == p_client) ||
+        ((0 == p_table->free_count) && (p_table->used == p_table->cap))) {
+        return NULL;
+    }
+
+    uint32_t slot = 0;
+    if (p_table->free_count > 0) {
+        slot = p_table->p_free[--p_table->free_count];
+    } else {
+        slot = p_table->used++;
+        p_table->p_slots[slot].id = SERVER_ID(slot, 0);
+    }
+
+    server_client_t *p_slot = &p_table->p_slots[slot];
+    const uint64_t id = p_slot->id;
+    const uint32_t listed =
+        p_slot->flags & (SERVER_CLIENT_F_DIRTY | SERVER_CLIENT_F_READ);
+
+    *p_slot = *p_client;
+    p_slot->id = id;
+    p_slot->flags |= listed;
+    p_slot->live_idx = p_table->live_count;
+    p_table->p_live[p_table->live_count++] = slot;
+
+    return p_slot;
+}
+
+/**
+ * @brief Free slot of client. Its ID becomes stale
+ *
+ * Last live slot takes place of removed one, so live list stays dense.
+ *
+ * @param p_table pointer to table
+ * @param slot slot of client
+ */
+void server_table_remove(server_table_t *p_table, uint32_t slot) {
+    if ((NULL == p_table) || (slot >= p_table->used)) {
+        return;
+    }
+
+    server_client_t *p_slot = &p_table->p_slots[slot];
+    if (COMMON_SOCKET_ERR == p_slot->socket_fd) {
+        return;
+    }
+
+    const uint32_t last = p_table->p_live[--p_table->live_count];
+    p_table->p_live[p_slot->live_idx] = last;
+    p_table->p_slots[last].live_idx = p_slot->live_idx;
+
+    p_slot->socket_fd = COMMON_SOCKET_ERR;
+    p_slot->id = SERVER_ID(slot, (p_slot->id >> 32) + 1);
+    p_table->p_free[p_table->free_count++] = slot;
+}
+
+/**
+ * @brief Find client by ID
+ *
+ * @param p_table pointer to table
+ * @param id client ID
+ * @return server_client_t* client or NULL if ID is stale
+ */
+server_client_t *server_table_get(const server_table_t *p_table, uint64_t id) {
+    if ((NULL == p_table) || (SERVER_ID_SLOT(id) >= p_table->used)) {
+        return NULL;
+    }
+
+    server_client_t *p_slot = &p_table->p_slots[SERVER_ID_SLOT(id)];
+    if ((COMMON_SOCKET_ERR == p_slot->socket_fd) || (id != p_slot->id)) {
+        return NULL;
+    }
+
+    return p_slot;
+}
+
+/**
+ * @brief Init reactor
+ *
+ * @param p_reactor pointer to reactor
+ * @param backend backend to use
+ * @param max_fds max count of registered descriptors
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_init(server_reactor_t *p_reactor,
+                            server_backend_t backend, size_t max_fds) {
+    if (NULL == p_reactor) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (0 == max_fds) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    memset(p_reactor, 0x00, sizeof(server_reactor_t));
+    p_reactor->backend = backend;
+    p_reactor->max_fds = max_fds;
+    p_reactor->epoll_fd = COMMON_SOCKET_ERR;
+
+    switch (backend) {
+        case SERVER_BACKEND_EPOLL:
+            p_reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            if (COMMON_SOCKET_ERR == p_reactor->epoll_fd) {
+                return SERVER_ERR_SOCKET;
+            }
+
+            p_reactor->p_epoll_evts =
+                calloc(CONFIG_SRV_EVENTS_MAX, sizeof(struct epoll_event));
+            if (NULL == p_reactor->p_epoll_evts) {
+                server_reactor_deinit(p_reactor);
+                return SERVER_ERR_NG;
+            }
+            break;
+
+        case SERVER_BACKEND_POLL:
+            p_reactor->p_pollfds = calloc(max_fds, sizeof(struct pollfd));
+            p_reactor->p_poll_data = calloc(max_fds, sizeof(uint64_t));
+            p_reactor->p_poll_idx = calloc(max_fds, sizeof(size_t));
+            if ((NULL == p_reactor->p_pollfds) ||
+                (NULL == p_reactor->p_poll_data) ||
+                (NULL == p_reactor->p_poll_idx)) {
+                server_reactor_deinit(p_reactor);
+                return SERVER_ERR_NG;
+            }
+            break;
+
+        case SERVER_BACKEND_URING: {
+            int32_t ret = uring_init(p_reactor);
+            if (SERVER_ERR_OK != ret) {
+                server_reactor_deinit(p_reactor);
+                return ret;
+            }
+            break;
+        }
+
+        default:
+            return SERVER_ERR_PARAMS;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Deinit reactor. Registered descriptors are not closed
+ *
+ * @param p_reactor pointer to reactor
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_deinit(server_reactor_t *p_reactor) {
+    if (NULL == p_reactor) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (COMMON_SOCKET_ERR != p_reactor->epoll_fd) {
+        close(p_reactor->epoll_fd);
+        p_reactor->epoll_fd = COMMON_SOCKET_ERR;
+    }
+
+    uring_deinit(p_reactor);
+    free(p_reactor->p_epoll_evts);
+    free(p_reactor->p_pollfds);
+    free(p_reactor->p_poll_data);
+    free(p_reactor->p_poll_idx);
+    p_reactor->p_epoll_evts = NULL;
+    p_reactor->p_pollfds = NULL;
+    p_reactor->p_poll_data = NULL;
+    p_reactor->p_poll_idx = NULL;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Register descriptor in reactor
+ *
+ * @note epoll backend is edge-triggered: owner must drain descriptor until
+ * EAGAIN on each event
+ *
+ * @param p_reactor pointer to reactor
+ * @param fd descriptor
+ * @param events mask of SERVER_EV_*
+ * @param data user data returned with events
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_add(server_reactor_t *p_reactor, int fd,
+                           uint32_t events, uint64_t data) {
+    if (NULL == p_reactor) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (SERVER_BACKEND_EPOLL == p_reactor->backend) {
+        struct epoll_event ev = {.events = epoll_events_to(events),
+                                 .data.u64 = data};
+        if (COMMON_SOCKET_ERR ==
+            epoll_ctl(p_reactor->epoll_fd, EPOLL_CTL_ADD, fd, &ev)) {
+            return SERVER_ERR_SOCKET;
+        }
+
+        return SERVER_ERR_OK;
+    }
+
+    if (SERVER_BACKEND_URING == p_reactor->backend) {
+        if ((fd < 0) || ((size_t)fd >= p_reactor->max_fds)) {
+            return SERVER_ERR_PARAMS;
+        }
+
+        uring_reg_t *p_reg = &p_reactor->p_uring->p_regs[fd];
+        p_reg->data = data;
+        p_reg->events = events | SERVER_EV_ERROR;
+        p_reg->armed = 0;
+
+        if (events & SERVER_EV_ACCEPT) {
+            uring_arm(p_reactor->p_uring, fd, URING_OP_ACCEPT);
+        } else if (events & SERVER_EV_DATA) {
+            uring_arm(p_reactor->p_uring, fd, URING_OP_RECV);
+        } else if (events & SERVER_EV_READ) {
+            uring_arm(p_reactor->p_uring, fd, URING_OP_POLL);
+        }
+
+        if (events & SERVER_EV_WRITE) {
+            uring_arm(p_reactor->p_uring, fd, URING_OP_POLLOUT);
+        }
+
+        return SERVER_ERR_OK;
+    }
+
+    if ((fd < 0) || ((size_t)fd >= p_reactor->max_fds)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if ((p_reactor->poll_count == p_reactor->max_fds) ||
+        (p_reactor->max_fds != poll_find(p_reactor, fd))) {
+        return SERVER_ERR_NG;
+    }
+
+    // NOTE: set stays dense - new descriptor goes to the end
+    const size_t idx = p_reactor->poll_count++;
+    p_reactor->p_pollfds[idx].fd = fd;
+    p_reactor->p_pollfds[idx].events = poll_events_to(events);
+    p_reactor->p_pollfds[idx].revents = 0;
+    p_reactor->p_poll_data[idx] = data;
+    p_reactor->p_poll_idx[fd] = idx;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Change interest mask of registered descriptor
+ *
+ * @param p_reactor pointer to reactor
+ * @param fd descriptor
+ * @param events mask of SERVER_EV_*
+ * @param data user data returned with events
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_mod(server_reactor_t *p_reactor, int fd,
+                           uint32_t events, uint64_t data) {
+    if (NULL == p_reactor) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (SERVER_BACKEND_EPOLL == p_reactor->backend) {
+        struct epoll_event ev = {.events = epoll_events_to(events),
+                                 .data.u64 = data};
+        if (COMMON_SOCKET_ERR ==
+            epoll_ctl(p_reactor->epoll_fd, EPOLL_CTL_MOD, fd, &ev)) {
+            return SERVER_ERR_SOCKET;
+        }
+
+        return SERVER_ERR_OK;
+    }
+
+    if (SERVER_BACKEND_URING == p_reactor->backend) {
+        if ((fd < 0) || ((size_t)fd >= p_reactor->max_fds)) {
+            return SERVER_ERR_PARAMS;
+        }
+
+        // NOTE: only write interest may be changed, reads stay armed
+        uring_reg_t *p_reg = &p_reactor->p_uring->p_regs[fd];
+        p_reg->data = data;
+        p_reg->events = events | SERVER_EV_ERROR;
+
+        if ((events & SERVER_EV_WRITE) &&
+            (0 == (p_reg->armed & (1U << URING_OP_POLLOUT)))) {
+            uring_arm(p_reactor->p_uring, fd, URING_OP_POLLOUT);
+        }
+
+        return SERVER_ERR_OK;
+    }
+
+    size_t idx = poll_find(p_reactor, fd);
+    if (idx == p_reactor->max_fds) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    p_reactor->p_pollfds[idx].events = poll_events_to(events);
+    p_reactor->p_poll_data[idx] = data;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Unregister descriptor from reactor
+ *
+ * @param p_reactor pointer to reactor
+ * @param fd descriptor
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_del(server_reactor_t *p_reactor, int fd) {
+    if (NULL == p_reactor) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (SERVER_BACKEND_EPOLL == p_reactor->backend) {
+        if (COMMON_SOCKET_ERR ==
+            epoll_ctl(p_reactor->epoll_fd, EPOLL_CTL_DEL, fd, NULL)) {
+            return SERVER_ERR_SOCKET;
+        }
+
+        return SERVER_ERR_OK;
+    }
+
+    if (SERVER_BACKEND_URING == p_reactor->backend) {
+        if ((fd < 0) || ((size_t)fd >= p_reactor->max_fds)) {
+            return SERVER_ERR_PARAMS;
+        }
+
+        struct server_uring_s *p_uring = p_reactor->p_uring;
+        uring_reg_t *p_reg = &p_uring->p_regs[fd];
+
+        // NOTE: cancel by user_data, so it is safe to close fd right away
+        for (uint32_t op = URING_OP_ACCEPT; op <= URING_OP_POLLOUT; op++) {
+            if (p_reg->armed & (1U << op)) {
+                struct io_uring_sqe *p_sqe = uring_sqe(p_uring);
+                p_sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                p_sqe->fd = COMMON_SOCKET_ERR;
+                p_sqe->addr = uring_ud(op, p_reg->gen, (uint32_t)fd);
+                p_sqe->user_data = uring_ud(URING_OP_CANCEL, 0, (uint32_t)fd);
+            }
+        }
+
+        p_reg->gen++;
+        p_reg->events = 0;
+        p_reg->armed = 0;
+
+        return SERVER_ERR_OK;
+    }
+
+    size_t idx = poll_find(p_reactor, fd);
+    if (idx == p_reactor->max_fds) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    // NOTE: swap-remove - last descriptor takes freed place
+    const size_t last = --p_reactor->poll_count;
+    p_reactor->p_pollfds[idx] = p_reactor->p_pollfds[last];
+    p_reactor->p_poll_data[idx] = p_reactor->p_poll_data[last];
+    p_reactor->p_poll_idx[p_reactor->p_pollfds[idx].fd] = idx;
+    p_reactor->p_pollfds[last].fd = COMMON_SOCKET_ERR;
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Wait for events
+ *
+ * @param p_reactor pointer to reactor
+ * @param p_events output array of events
+ * @param max_events size of output array
+ * @param timeout_ms timeout in ms, -1 for infinite
+ * @return int count of events, 0 on timeout, -1 on error
+ */
+int server_reactor_wait(server_reactor_t *p_reactor, server_event_t *p_events,
+                        size_t max_events, int timeout_ms) {
+    if ((NULL == p_reactor) || (NULL == p_events) || (0 == max_events)) {
+        return COMMON_SOCKET_ERR;
+    }
+
+    if (SERVER_BACKEND_EPOLL == p_reactor->backend) {
+        if (max_events > CONFIG_SRV_EVENTS_MAX) {
+            max_events = CONFIG_SRV_EVENTS_MAX;
+        }
+
+        int count = epoll_wait(p_reactor->epoll_fd, p_reactor->p_epoll_evts,
+                               (int)max_events, timeout_ms);
+        for (int idx = 0; idx < count; idx++) {
+            memset(&p_events[idx], 0x00, sizeof(server_event_t));
+            p_events[idx].data = p_reactor->p_epoll_evts[idx].data.u64;
+            p_events[idx].events =
+                epoll_events_from(p_reactor->p_epoll_evts[idx].events);
+        }
+
+        return count;
+    }
+
+    if (SERVER_BACKEND_URING == p_reactor->backend) {
+        return uring_wait(p_reactor, p_events, max_events, timeout_ms);
+    }
+
+    int count_ready =
+        poll(p_reactor->p_pollfds, (nfds_t)p_reactor->poll_count, timeout_ms);
+    if (count_ready <= 0) {
+        return count_ready;
+    }
+
+    // NOTE: poll is level-triggered, so skipped ready fds show up next time
+    size_t count = 0;
+    for (size_t idx = 0; (idx < p_reactor->poll_count) && (count < max_events);
+         idx++) {
+        struct pollfd *p_pfd = &p_reactor->p_pollfds[idx];
+        if (0 == p_pfd->revents) {
+            continue;
+        }
+
+        memset(&p_events[count], 0x00, sizeof(server_event_t));
+        p_events[count].data = p_reactor->p_poll_data[idx];
+        p_events[count].events = poll_events_from(p_pfd->revents);
+        count++;
+    }
+
+    return (int)count;
+}
+
+/**
+ * @brief Release resources held by event
+ *
+ * Must be called for each SERVER_EV_DATA event when its bytes are consumed.
+ *
+ * @param p_reactor pointer to reactor
+ * @param p_event pointer to event
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_release(server_reactor_t *p_reactor,
+                               const server_event_t *p_event) {
+    if ((NULL == p_reactor) || (NULL == p_event)) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if ((SERVER_BACKEND_URING == p_reactor->backend) &&
+        (p_event->buf_id > 0)) {
+        uring_buf_recycle(p_reactor->p_uring, p_event->buf_id - 1);
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Send batch of iovecs without blocking
+ *
+ * io_uring backend submits whole batch with single syscall, other backends
+ * send one by one. Short writes are reported as is. A descriptor must appear
+ * at most once per batch.
+ *
+ * @param p_reactor pointer to reactor
+ * @param p_sends array of sends. res of each is set to sent bytes or -errno
+ * @param count count of sends
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t server_reactor_send_batch(server_reactor_t *p_reactor,
+                                  server_send_t *p_sends, size_t count) {
+    if ((NULL == p_reactor) || ((NULL == p_sends) && (count > 0))) {
+        return SERVER_ERR_PARAMS;
+    }
+
+    if (0 == count) {
+        return SERVER_ERR_OK;
+    }
+
+    if (SERVER_BACKEND_URING == p_reactor->backend) {
+        return uring_send_batch(p_reactor, p_sends, count);
+    }
+
+    for (size_t idx = 0; idx < count; idx++) {
+        struct msghdr msg;
+        memset(&msg, 0x00, sizeof(msg));
+        msg.msg_iov = (struct iovec *)p_sends[idx].p_iov;
+        msg.msg_iovlen = p_sends[idx].iov_count;
+
+        ssize_t ret;
+        do {
+            ret = sendmsg(p_sends[idx].fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        } while ((COMMON_SOCKET_ERR == ret) && (EINTR == errno));
+
+        p_sends[idx].res = (COMMON_SOCKET_ERR == ret) ? -errno : ret;
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Return printable name of backend
+ *
+ * @param backend backend
+ * @return const char* name
+ */
+const char *server_backend_name(server_backend_t backend) {
+    switch (backend) {
+        case SERVER_BACKEND_POLL:
+            return "poll";
+        case SERVER_BACKEND_EPOLL:
+            return "epoll";
+        case SERVER_BACKEND_URING:
+            return "io_uring";
+        default:
+            return "unknown";
+    }
+}
 
 /******************************************************************************
  * END OF SOURCE'S CODE
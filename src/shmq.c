@@ -0,0 +1,434 @@
+/**
+ * @file      shmq.c
+ *
+ * @brief     Shared memory SPSC byte ring for same-host subscribers
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup shmq
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "shmq.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SHMQ_RELAX() __builtin_ia32_pause()
+#else
+#define SHMQ_RELAX() atomic_signal_fence(memory_order_seq_cst)
+#endif
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static void shmq_copy_in(shmq_t* p_q, uint64_t pos, const void* p_buf,
+                         size_t len);
+static void shmq_copy_out(const shmq_t* p_q, uint64_t pos, void* p_buf,
+                          size_t len);
+static bool shmq_empty(shmq_t* p_q);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Copy data into ring at position, wrapping at the end of data area
+ *
+ * @param p_q pointer to ring
+ * @param pos write position
+ * @param p_buf data
+ * @param len data length
+ */
+static void shmq_copy_in(shmq_t* p_q, uint64_t pos, const void* p_buf,
+                         size_t len) {
+    const size_t off = (size_t)(pos & p_q->mask);
+    const size_t first = ((p_q->mask + 1u - off) < len)
+                             ? (size_t)(p_q->mask + 1u - off)
+                             : len;
+
+    memcpy(&p_q->p_hdr->data[off], p_buf, first);
+    memcpy(p_q->p_hdr->data, (const uint8_t*)p_buf + first, len - first);
+}
+
+/**
+ * @brief Copy data out of ring at position, wrapping at the end of data area
+ *
+ * @param p_q pointer to ring
+ * @param pos read position
+ * @param p_buf output buffer
+ * @param len data length
+ */
+static void shmq_copy_out(const shmq_t* p_q, uint64_t pos, void* p_buf,
+                          size_t len) {
+    const size_t off = (size_t)(pos & p_q->mask);
+    const size_t first = ((p_q->mask + 1u - off) < len)
+                             ? (size_t)(p_q->mask + 1u - off)
+                             : len;
+
+    memcpy(p_buf, &p_q->p_hdr->data[off], first);
+    memcpy((uint8_t*)p_buf + first, p_q->p_hdr->data, len - first);
+}
+
+/**
+ * @brief Check if ring is empty, refreshing cached head of producer
+ *
+ * @param p_q pointer to ring, consumer side
+ * @return bool true if there is nothing to read
+ */
+static bool shmq_empty(shmq_t* p_q) {
+    const uint64_t tail =
+        atomic_load_explicit(&p_q->p_hdr->tail, memory_order_relaxed);
+
+    if (p_q->peer == tail) {
+        p_q->peer =
+            atomic_load_explicit(&p_q->p_hdr->head, memory_order_acquire);
+    }
+
+    return p_q->peer == tail;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Create ring segment. Called by consumer
+ *
+ * @param p_q pointer to ring
+ * @param p_name segment name, e.g. "/srvc_client.123.0"
+ * @param size data area size, power of 2
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t shmq_create(shmq_t* p_q, const char* p_name, size_t size) {
+    if ((NULL == p_q) || (NULL == p_name) ||
+        (strlen(p_name) >= SHMQ_NAME_SIZE) || (size < SHMQ_CACHE_LINE) ||
+        (0 != (size & (size - 1u)))) {
+        return SHMQ_ERR_PARAMS;
+    }
+
+    memset(p_q, 0x00, sizeof(shmq_t));
+    strcpy(p_q->name, p_name);
+
+    // NOTE: only the same user may attach
+    const int fd =
+        shm_open(p_name, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (-1 == fd) {
+        return SHMQ_ERR_SHM;
+    }
+
+    const size_t map_size = sizeof(shmq_hdr_t) + size;
+    if (0 != ftruncate(fd, (off_t)map_size)) {
+        close(fd);
+        shm_unlink(p_name);
+        return SHMQ_ERR_SHM;
+    }
+
+    shmq_hdr_t* p_hdr =
+        mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == p_hdr) {
+        shm_unlink(p_name);
+        return SHMQ_ERR_SHM;
+    }
+
+    p_hdr->version = SHMQ_VERSION;
+    p_hdr->size = size;
+    atomic_init(&p_hdr->attached, 0);
+    atomic_init(&p_hdr->head, 0);
+    atomic_init(&p_hdr->tail, 0);
+    atomic_init(&p_hdr->waiting, 0);
+    atomic_init(&p_hdr->wake, 0);
+
+    // NOTE: producer checks magic, so it is published after the rest
+    atomic_thread_fence(memory_order_release);
+    p_hdr->magic = SHMQ_MAGIC;
+
+    p_q->p_hdr = p_hdr;
+    p_q->map_size = map_size;
+    p_q->mask = size - 1u;
+
+    return SHMQ_ERR_OK;
+}
+
+/**
+ * @brief Map ring created by consumer and mark it attached. Called by
+ * producer
+ *
+ * Segment is accepted only if its size matches the header, so a wrong name
+ * cannot make producer write outside of mapping. It must also belong to
+ * @owner and be closed to group and others, so a ring of one user is not
+ * handed to a peer of another.
+ *
+ * @param p_q pointer to ring
+ * @param p_name segment name
+ * @param owner expected owner of segment
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t shmq_attach(shmq_t* p_q, const char* p_name, uid_t owner) {
+    if ((NULL == p_q) || (NULL == p_name) ||
+        (strlen(p_name) >= SHMQ_NAME_SIZE)) {
+        return SHMQ_ERR_PARAMS;
+    }
+
+    memset(p_q, 0x00, sizeof(shmq_t));
+    strcpy(p_q->name, p_name);
+
+    const int fd = shm_open(p_name, O_RDWR | O_CLOEXEC, 0);
+    if (-1 == fd) {
+        return SHMQ_ERR_SHM;
+    }
+
+    struct stat st;
+    if (0 != fstat(fd, &st)) {
+        close(fd);
+        return SHMQ_ERR_SHM;
+    }
+
+    if ((owner != st.st_uid) || (0 != (st.st_mode & (S_IRWXG | S_IRWXO)))) {
+        close(fd);
+        return SHMQ_ERR_OWNER;
+    }
+
+    if (((size_t)st.st_size < (sizeof(shmq_hdr_t) + SHMQ_CACHE_LINE))) {
+        close(fd);
+        return SHMQ_ERR_SHM;
+    }
+
+    const size_t map_size = (size_t)st.st_size;
+    shmq_hdr_t* p_hdr =
+        mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == p_hdr) {
+        return SHMQ_ERR_SHM;
+    }
+
+    if ((SHMQ_MAGIC != p_hdr->magic) || (SHMQ_VERSION != p_hdr->version) ||
+        (0 != (p_hdr->size & (p_hdr->size - 1u))) ||
+        ((sizeof(shmq_hdr_t) + p_hdr->size) != map_size) ||
+        (0 != atomic_load(&p_hdr->attached))) {
+        munmap(p_hdr, map_size);
+        return SHMQ_ERR_SHM;
+    }
+
+    p_q->p_hdr = p_hdr;
+    p_q->map_size = map_size;
+    p_q->mask = p_hdr->size - 1u;
+    p_q->peer = atomic_load_explicit(&p_hdr->tail, memory_order_acquire);
+
+    atomic_store_explicit(&p_hdr->attached, 1, memory_order_release);
+
+    return SHMQ_ERR_OK;
+}
+
+/**
+ * @brief Remove segment name. Mappings stay valid
+ *
+ * @param p_q pointer to ring
+ */
+void shmq_unlink(const shmq_t* p_q) {
+    if ((NULL != p_q) && ('\0' != p_q->name[0])) {
+        shm_unlink(p_q->name);
+    }
+}
+
+/**
+ * @brief Unmap ring
+ *
+ * @param p_q pointer to ring
+ */
+void shmq_close(shmq_t* p_q) {
+    if ((NULL == p_q) || (NULL == p_q->p_hdr)) {
+        return;
+    }
+
+    munmap(p_q->p_hdr, p_q->map_size);
+    p_q->p_hdr = NULL;
+}
+
+/**
+ * @brief Write data as a whole. Called by producer
+ *
+ * Consumer is not woken up, call @shmq_notify after a batch.
+ *
+ * @param p_q pointer to ring
+ * @param p_buf data
+ * @param len data length
+ * @return bool true if written, false if there is not enough space
+ */
+bool shmq_write(shmq_t* p_q, const void* p_buf, size_t len) {
+    shmq_hdr_t* p_hdr = p_q->p_hdr;
+    const uint64_t head =
+        atomic_load_explicit(&p_hdr->head, memory_order_relaxed);
+    const uint64_t size = p_q->mask + 1u;
+
+    // NOTE: consumer tail is read only when cached one says ring is full
+    if ((head + len - p_q->peer) > size) {
+        p_q->peer = atomic_load_explicit(&p_hdr->tail, memory_order_acquire);
+        if ((head + len - p_q->peer) > size) {
+            return false;
+        }
+    }
+
+    shmq_copy_in(p_q, head, p_buf, len);
+    atomic_store_explicit(&p_hdr->head, head + len, memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief Wake consumer if it sleeps. Called by producer after a batch
+ *
+ * @param p_q pointer to ring
+ */
+void shmq_notify(shmq_t* p_q) {
+    shmq_hdr_t* p_hdr = p_q->p_hdr;
+
+    // NOTE: pairs with the fence of consumer between waiting and head check
+    atomic_thread_fence(memory_order_seq_cst);
+    if (0 == atomic_load_explicit(&p_hdr->waiting, memory_order_relaxed)) {
+        return;
+    }
+
+    atomic_store_explicit(&p_hdr->waiting, 0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&p_hdr->wake, 1, memory_order_release);
+    syscall(SYS_futex, &p_hdr->wake, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/**
+ * @brief Read available data. Called by consumer
+ *
+ * @param p_q pointer to ring
+ * @param p_buf output buffer
+ * @param size buffer size
+ * @return size_t count of read bytes, 0 if ring is empty
+ */
+size_t shmq_read(shmq_t* p_q, void* p_buf, size_t size) {
+    if (shmq_empty(p_q)) {
+        return 0;
+    }
+
+    shmq_hdr_t* p_hdr = p_q->p_hdr;
+    const uint64_t tail =
+        atomic_load_explicit(&p_hdr->tail, memory_order_relaxed);
+    const size_t len =
+        ((p_q->peer - tail) < size) ? (size_t)(p_q->peer - tail) : size;
+
+    shmq_copy_out(p_q, tail, p_buf, len);
+    atomic_store_explicit(&p_hdr->tail, tail + len, memory_order_release);
+
+    return len;
+}
+
+/**
+ * @brief Wait for data: spin first, then sleep on futex. Called by consumer
+ *
+ * @param p_q pointer to ring
+ * @param spins count of checks before sleep
+ * @param timeout_ms max sleep, 0 - only spin
+ * @return int32_t 0 if data is available, SHMQ_ERR_AGAIN on timeout or signal
+ */
+int32_t shmq_wait(shmq_t* p_q, uint32_t spins, int timeout_ms) {
+    shmq_hdr_t* p_hdr = p_q->p_hdr;
+
+    for (uint32_t idx = 0; idx < spins; idx++) {
+        if (!shmq_empty(p_q)) {
+            return SHMQ_ERR_OK;
+        }
+        SHMQ_RELAX();
+    }
+
+    if (0 == timeout_ms) {
+        return shmq_empty(p_q) ? SHMQ_ERR_AGAIN : SHMQ_ERR_OK;
+    }
+
+    const unsigned wake =
+        atomic_load_explicit(&p_hdr->wake, memory_order_acquire);
+    atomic_store_explicit(&p_hdr->waiting, 1, memory_order_relaxed);
+
+    // NOTE: producer may have written before it saw waiting
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!shmq_empty(p_q)) {
+        atomic_store_explicit(&p_hdr->waiting, 0, memory_order_relaxed);
+        return SHMQ_ERR_OK;
+    }
+
+    const struct timespec ts = {.tv_sec = timeout_ms / 1000,
+                                .tv_nsec = (timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, &p_hdr->wake, FUTEX_WAIT, wake, &ts, NULL, 0);
+    atomic_store_explicit(&p_hdr->waiting, 0, memory_order_relaxed);
+
+    return shmq_empty(p_q) ? SHMQ_ERR_AGAIN : SHMQ_ERR_OK;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,1243 @@
+/**
+ * @file      srvc_bench.c
+ *
+ * @brief     Service - Benchmark
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup Doxygen group
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "client.h"
+#include "common.h"
+#include "config.h"
+#include "hist.h"
+#include "metrics.h"
+#include "proto.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define BENCH_ERR_OK ((int32_t)0)      /**< Bench error - no error */
+#define BENCH_ERR_PARAM ((int32_t)1)   /**< Bench error - parameters error */
+#define BENCH_ERR_NOMEM ((int32_t)2)   /**< Bench error - no memory */
+#define BENCH_ERR_SOCKET ((int32_t)3)  /**< Bench error - socket error */
+#define BENCH_ERR_TIMEOUT ((int32_t)4) /**< Bench error - peers not ready */
+
+#define ARGS_COUNT ((size_t)2)    /**< Positional args count for invocations*/
+#define ARGS_IDX_HOST ((size_t)0) /**< Host arg index after options */
+#define ARGS_IDX_PORT ((size_t)1) /**< Port arg index after options */
+
+#define OPTS "m:n:s:r:t:o:i:h" /**< Command line options */
+
+#define BENCH_LIST_MAX ((size_t)16) /**< Max values in sweep list */
+#define BENCH_CTRL_MAX ((size_t)64) /**< Max controllers */
+
+/** Controller index is kept in top bits of seq, message number in the rest */
+#define BENCH_SEQ_SHIFT ((uint32_t)48)
+#define BENCH_SEQ(ctrl, num) (((uint64_t)(ctrl) << BENCH_SEQ_SHIFT) | (num))
+#define BENCH_SEQ_CTRL(seq) ((size_t)((seq) >> BENCH_SEQ_SHIFT))
+#define BENCH_SEQ_NUM(seq) ((seq) & ((1ull << BENCH_SEQ_SHIFT) - 1))
+
+/** Kind of descriptor is kept in top half of epoll data, index in the rest */
+#define BENCH_EV(kind, idx) (((uint64_t)(kind) << 32) | (uint64_t)(idx))
+#define BENCH_EV_KIND(data) ((uint32_t)((data) >> 32))
+#define BENCH_EV_IDX(data) ((size_t)((data) & UINT32_MAX))
+
+#define NSEC_PER_SEC ((uint64_t)1000000000u) /**< Nanoseconds in second */
+#define NSEC_PER_USEC ((double)1e3) /**< Nanoseconds in microsecond */
+
+/** Kind of descriptor registered in epoll */
+typedef enum bench_kind_e {
+    BENCH_KIND_TIMER = 0, /**< Pacing timer */
+    BENCH_KIND_CTRL,      /**< Controller socket */
+    BENCH_KIND_SUB,       /**< Subscriber socket */
+} bench_kind_t;
+
+/** Phase of one run */
+typedef enum bench_phase_e {
+    BENCH_PHASE_WARMUP = 0, /**< Wait until every subscriber gets a frame */
+    BENCH_PHASE_MEASURE,    /**< Controllers publish at target rate */
+    BENCH_PHASE_DRAIN,      /**< Wait for frames in flight */
+} bench_phase_t;
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/** Benchmark configuration */
+typedef struct bench_conf_s {
+    size_t controllers;                 /**< Publishers per run */
+    size_t widths[BENCH_LIST_MAX];      /**< Sweep of subscribers count */
+    size_t widths_count;                /**< Count of widths */
+    size_t sizes[BENCH_LIST_MAX];       /**< Sweep of payload sizes */
+    size_t sizes_count;                 /**< Count of sizes */
+    size_t idles[BENCH_LIST_MAX];       /**< Sweep of idle connections */
+    size_t idles_count;                 /**< Count of idles, 0 - no sweep */
+    uint64_t rate;                      /**< Msgs/s per controller, 0 - max */
+    uint64_t duration_sec;              /**< Measure phase of one run */
+    const char *p_dir;                  /**< Report directory */
+    const char *p_host;                 /**< Server host */
+    const char *p_port;                 /**< Server port */
+} bench_conf_t;
+
+/** Simulated controller */
+typedef struct bench_ctrl_s {
+    int fd;         /**< Socket descriptor */
+    uint64_t sent;  /**< Measured messages built */
+    uint8_t *p_buf; /**< Frames not sent yet */
+    size_t len;     /**< Bytes in p_buf */
+    size_t off;     /**< Sent bytes of p_buf */
+} bench_ctrl_t;
+
+/** Simulated subscriber */
+typedef struct bench_sub_s {
+    int fd;                         /**< Socket descriptor */
+    proto_parser_t parser;          /**< Frame parser */
+    bool ready;                     /**< Got first frame */
+    uint64_t last[BENCH_CTRL_MAX];  /**< Last message number per controller */
+} bench_sub_t;
+
+/** State of one run of sweep */
+typedef struct bench_run_s {
+    const bench_conf_t *p_conf; /**< Configuration */
+    size_t width;               /**< Subscribers count */
+    size_t size;                /**< Payload size */
+    bench_phase_t phase;        /**< Current phase */
+    int epoll_fd;               /**< epoll instance */
+    int timer_fd;               /**< Pacing timer */
+    bench_ctrl_t *p_ctrls;      /**< Controllers */
+    bench_sub_t *p_subs;        /**< Subscribers */
+    size_t ready;               /**< Subscribers which got first frame */
+    uint64_t warmups;           /**< Warmup frames sent */
+    uint64_t start_ns;          /**< Start of measure phase */
+    uint64_t end_ns;            /**< End of measure phase */
+    uint64_t received;          /**< Measured frames received */
+    uint64_t bytes;             /**< Measured bytes received */
+    uint64_t lost;              /**< Gaps detected by subscribers */
+    hist_t latency;             /**< One-way latency, ns */
+} bench_run_t;
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static volatile sig_atomic_t g_running = 1; /**< Cleared by Ctrl+C */
+static bench_run_t g_run;                   /**< Current run */
+static uint8_t g_recv_buf[CONFIG_CLIENT_RECV_SIZE]; /**< Shared receive buffer */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static void sigint_handler(int ctx);
+static size_t bench_parse_list(const char *p_str, size_t *p_list);
+static int32_t bench_open(int *p_fd, const bench_conf_t *p_conf,
+                          uint16_t roles);
+static int32_t bench_ctrl_flush(bench_ctrl_t *p_ctrl);
+static void bench_ctrl_fill(bench_run_t *p_run, size_t idx, uint64_t now,
+                            uint64_t count);
+static void bench_ctrl_pump(bench_run_t *p_run, size_t idx);
+static void bench_ctrl_discard(bench_run_t *p_run, size_t idx);
+static void bench_sub_frame(bench_run_t *p_run, bench_sub_t *p_sub,
+                            const proto_frame_t *p_frame, uint64_t now);
+static int32_t bench_sub_read(bench_run_t *p_run, size_t idx);
+static void bench_tick(bench_run_t *p_run);
+static int32_t bench_loop(bench_run_t *p_run, uint64_t until_ns);
+static int32_t bench_setup(bench_run_t *p_run);
+static void bench_teardown(bench_run_t *p_run);
+static int32_t bench_run(bench_run_t *p_run, FILE *p_csv);
+static uint64_t bench_rss_kb(int pid);
+static uint64_t bench_tcp_kb(void);
+static int32_t bench_idle_wait(const metrics_t *p_metrics, uint64_t conns);
+static int32_t bench_idle_open(int *p_fd, const struct addrinfo *p_addr,
+                               size_t idx);
+static void bench_idle_drain(const int *p_fds, size_t count);
+static int32_t bench_idle_run(const metrics_t *p_metrics,
+                              const struct addrinfo *p_addr, size_t width,
+                              uint64_t base_kb, FILE *p_csv);
+static int32_t bench_idle(const bench_conf_t *p_conf);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Sigint handler
+ *
+ * @param sig received signal
+ */
+static void sigint_handler(int sig) {
+    (void)sig;
+
+    // NOTE: current run stops, report is written for finished runs
+    g_running = 0;
+}
+
+/**
+ * @brief Parse comma separated list of numbers
+ *
+ * @param p_str string
+ * @param p_list output list, BENCH_LIST_MAX values
+ * @return size_t count of values, 0 on error
+ */
+static size_t bench_parse_list(const char *p_str, size_t *p_list) {
+    size_t count = 0;
+
+    while ('\0' != *p_str) {
+        char *p_end = NULL;
+        unsigned long value = strtoul(p_str, &p_end, 10);
+        if ((p_end == p_str) || (count >= BENCH_LIST_MAX)) {
+            return 0;
+        }
+
+        p_list[count++] = (size_t)value;
+        p_str = (',' == *p_end) ? (p_end + 1) : p_end;
+        if (('\0' != *p_str) && (p_end == p_str)) {
+            return 0;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Connect to server, send hello and switch socket to non-blocking mode
+ *
+ * @param p_fd output socket descriptor
+ * @param p_conf pointer to configuration
+ * @param roles mask of PROTO_ROLE_*
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_open(int *p_fd, const bench_conf_t *p_conf,
+                          uint16_t roles) {
+    if (CLIENT_ERR_OK != client_connect(p_conf->p_host, p_conf->p_port, p_fd)) {
+        return BENCH_ERR_SOCKET;
+    }
+
+    if (CLIENT_ERR_OK != client_hello(*p_fd, roles, NULL, 0)) {
+        client_disconnect(p_fd);
+        return BENCH_ERR_SOCKET;
+    }
+
+    int flags = fcntl(*p_fd, F_GETFL, 0);
+    if ((COMMON_SOCKET_ERR == flags) ||
+        (COMMON_SOCKET_ERR == fcntl(*p_fd, F_SETFL, flags | O_NONBLOCK))) {
+        client_disconnect(p_fd);
+        return BENCH_ERR_SOCKET;
+    }
+
+    return BENCH_ERR_OK;
+}
+
+/**
+ * @brief Send pending frames of controller without blocking
+ *
+ * @param p_ctrl pointer to controller
+ * @return int32_t 0 if OK or socket is full, error otherwise
+ */
+static int32_t bench_ctrl_flush(bench_ctrl_t *p_ctrl) {
+    while (p_ctrl->off < p_ctrl->len) {
+        ssize_t ret = send(p_ctrl->fd, &p_ctrl->p_buf[p_ctrl->off],
+                           p_ctrl->len - p_ctrl->off, MSG_NOSIGNAL);
+        if (COMMON_SOCKET_ERR == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+
+            // NOTE: EPOLLOUT edge continues the flush
+            return ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+                       ? BENCH_ERR_OK
+                       : BENCH_ERR_SOCKET;
+        }
+
+        p_ctrl->off += (size_t)ret;
+    }
+
+    p_ctrl->off = 0;
+    p_ctrl->len = 0;
+
+    return BENCH_ERR_OK;
+}
+
+/**
+ * @brief Build frames of controller into its pending buffer
+ *
+ * Message number 0 marks warmup frames, they are not measured.
+ *
+ * @param p_run pointer to run
+ * @param idx controller index
+ * @param now send timestamp
+ * @param count count of frames, at most CONFIG_BENCH_BATCH
+ */
+static void bench_ctrl_fill(bench_run_t *p_run, size_t idx, uint64_t now,
+                            uint64_t count) {
+    bench_ctrl_t *p_ctrl = &p_run->p_ctrls[idx];
+    const bool warmup = (BENCH_PHASE_WARMUP == p_run->phase);
+
+    for (uint64_t num = 0; num < count; num++) {
+        uint8_t *p_frame = &p_ctrl->p_buf[p_ctrl->len];
+        proto_hdr_t hdr = {.len = (uint32_t)p_run->size,
+                           .type = PROTO_TYPE_DATA,
+                           .seq = BENCH_SEQ(idx, warmup ? 0 : ++p_ctrl->sent),
+                           .ts = now};
+
+        proto_hdr_encode(p_frame, &hdr);
+        p_ctrl->len += PROTO_HDR_SIZE + p_run->size;
+    }
+}
+
+/**
+ * @brief Build and send frames which are due by target rate
+ *
+ * @param p_run pointer to run
+ * @param idx controller index
+ */
+static void bench_ctrl_pump(bench_run_t *p_run, size_t idx) {
+    bench_ctrl_t *p_ctrl = &p_run->p_ctrls[idx];
+    const uint64_t rate = p_run->p_conf->rate;
+
+    for (size_t round = 0; round < CONFIG_BENCH_PUMP_ROUNDS; round++) {
+        if (BENCH_ERR_OK != bench_ctrl_flush(p_ctrl)) {
+            fprintf(stderr, "[BENCH] Controller <%zu> socket error\n", idx);
+            g_running = 0;
+            return;
+        }
+
+        // NOTE: buffer is refilled only when everything is sent, so slow
+        // server pushes back instead of growing the buffer
+        if ((p_ctrl->len > 0) || (BENCH_PHASE_MEASURE != p_run->phase)) {
+            return;
+        }
+
+        const uint64_t now = proto_ts_now();
+        uint64_t due = p_ctrl->sent + CONFIG_BENCH_BATCH;
+        if (rate > 0) {
+            due = ((now - p_run->start_ns) * rate) / NSEC_PER_SEC;
+        }
+
+        if (due <= p_ctrl->sent) {
+            return;
+        }
+
+        uint64_t count = due - p_ctrl->sent;
+        bench_ctrl_fill(p_run, idx, now,
+                        (count < CONFIG_BENCH_BATCH) ? count
+                                                     : CONFIG_BENCH_BATCH);
+    }
+}
+
+/**
+ * @brief Read and drop anything sent to controller. Publisher-only
+ * controllers get no frames, the socket is drained to consume its events
+ *
+ * @param p_run pointer to run
+ * @param idx controller index
+ */
+static void bench_ctrl_discard(bench_run_t *p_run, size_t idx) {
+    ssize_t ret = 0;
+
+    do {
+        ret = recv(p_run->p_ctrls[idx].fd, g_recv_buf, sizeof(g_recv_buf), 0);
+    } while ((ret > 0) || ((COMMON_SOCKET_ERR == ret) && (EINTR == errno)));
+}
+
+/**
+ * @brief Account frame received by subscriber
+ *
+ * @param p_run pointer to run
+ * @param p_sub pointer to subscriber
+ * @param p_frame pointer to frame
+ * @param now receive timestamp
+ */
+static void bench_sub_frame(bench_run_t *p_run, bench_sub_t *p_sub,
+                            const proto_frame_t *p_frame, uint64_t now) {
+    const size_t ctrl = BENCH_SEQ_CTRL(p_frame->hdr.seq);
+    const uint64_t num = BENCH_SEQ_NUM(p_frame->hdr.seq);
+
+    if (!p_sub->ready) {
+        p_sub->ready = true;
+        p_run->ready++;
+    }
+
+    if ((0 == num) || (ctrl >= p_run->p_conf->controllers)) {
+        return;
+    }
+
+    if (num > (p_sub->last[ctrl] + 1)) {
+        p_run->lost += num - p_sub->last[ctrl] - 1;
+    }
+
+    if (num > p_sub->last[ctrl]) {
+        p_sub->last[ctrl] = num;
+    }
+
+    p_run->received++;
+    p_run->bytes += PROTO_FRAME_SIZE(&p_frame->hdr);
+
+    if (now >= p_frame->hdr.ts) {
+        hist_record(&p_run->latency, now - p_frame->hdr.ts);
+    }
+}
+
+/**
+ * @brief Read everything available on subscriber socket
+ *
+ * @param p_run pointer to run
+ * @param idx subscriber index
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_sub_read(bench_run_t *p_run, size_t idx) {
+    bench_sub_t *p_sub = &p_run->p_subs[idx];
+
+    while (true) {
+        int32_t ret = client_recv(p_sub->fd, &p_sub->parser, g_recv_buf,
+                                  sizeof(g_recv_buf));
+        if (CLIENT_ERR_INTR == ret) {
+            continue;
+        } else if ((CLIENT_ERR_SOCKET == ret) &&
+                   ((EAGAIN == errno) || (EWOULDBLOCK == errno))) {
+            return BENCH_ERR_OK;
+        } else if (CLIENT_ERR_OK != ret) {
+            fprintf(stderr, "[BENCH] Subscriber <%zu> is disconnected\n", idx);
+            return BENCH_ERR_SOCKET;
+        }
+
+        // NOTE: one timestamp per read, frames of one read arrived together
+        const uint64_t now = proto_ts_now();
+        proto_frame_t frame;
+        while (PROTO_ERR_OK ==
+               (ret = proto_parser_next(&p_sub->parser, &frame))) {
+            if (PROTO_TYPE_DATA == frame.hdr.type) {
+                bench_sub_frame(p_run, p_sub, &frame, now);
+            }
+        }
+
+        if (PROTO_ERR_AGAIN != ret) {
+            fprintf(stderr, "[BENCH] Subscriber <%zu> got malformed frame\n",
+                    idx);
+            return BENCH_ERR_SOCKET;
+        }
+    }
+}
+
+/**
+ * @brief Pacing timer tick
+ *
+ * @param p_run pointer to run
+ */
+static void bench_tick(bench_run_t *p_run) {
+    uint64_t expirations = 0;
+    if (sizeof(expirations) !=
+        read(p_run->timer_fd, &expirations, sizeof(expirations))) {
+        return;
+    }
+
+    if (BENCH_PHASE_WARMUP == p_run->phase) {
+        // NOTE: one frame per tick until server registers all subscribers
+        bench_ctrl_t *p_ctrl = &p_run->p_ctrls[0];
+        if (0 == p_ctrl->len) {
+            bench_ctrl_fill(p_run, 0, proto_ts_now(), 1);
+            p_run->warmups++;
+        }
+
+        bench_ctrl_pump(p_run, 0);
+        return;
+    }
+
+    for (size_t idx = 0; idx < p_run->p_conf->controllers; idx++) {
+        bench_ctrl_pump(p_run, idx);
+    }
+}
+
+/**
+ * @brief Serve sockets until deadline or end of phase
+ *
+ * Warmup ends when all subscribers are ready, drain - when every published
+ * frame is received or lost.
+ *
+ * @param p_run pointer to run
+ * @param until_ns monotonic deadline
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_loop(bench_run_t *p_run, uint64_t until_ns) {
+    struct epoll_event events[CONFIG_SRV_EVENTS_MAX];
+
+    while (g_running && (proto_ts_now() < until_ns)) {
+        if ((BENCH_PHASE_WARMUP == p_run->phase) &&
+            (p_run->ready == p_run->width)) {
+            return BENCH_ERR_OK;
+        }
+
+        if (BENCH_PHASE_DRAIN == p_run->phase) {
+            uint64_t expected = 0;
+            for (size_t idx = 0; idx < p_run->p_conf->controllers; idx++) {
+                expected += p_run->p_ctrls[idx].sent * p_run->width;
+            }
+
+            if ((p_run->received + p_run->lost) >= expected) {
+                return BENCH_ERR_OK;
+            }
+        }
+
+        int count = epoll_wait(p_run->epoll_fd, events, CONFIG_SRV_EVENTS_MAX,
+                               (int)CONFIG_BENCH_WAIT_MS);
+        if ((COMMON_SOCKET_ERR == count) && (EINTR != errno)) {
+            return BENCH_ERR_SOCKET;
+        }
+
+        for (int evt = 0; evt < count; evt++) {
+            const uint64_t data = events[evt].data.u64;
+            const size_t idx = BENCH_EV_IDX(data);
+
+            switch (BENCH_EV_KIND(data)) {
+                case BENCH_KIND_TIMER:
+                    bench_tick(p_run);
+                    break;
+
+                case BENCH_KIND_CTRL:
+                    if (events[evt].events & EPOLLIN) {
+                        bench_ctrl_discard(p_run, idx);
+                    }
+                    if (events[evt].events & EPOLLOUT) {
+                        bench_ctrl_pump(p_run, idx);
+                    }
+                    break;
+
+                case BENCH_KIND_SUB:
+                default:
+                    if (BENCH_ERR_OK != bench_sub_read(p_run, idx)) {
+                        return BENCH_ERR_SOCKET;
+                    }
+                    break;
+            }
+        }
+    }
+
+    return (BENCH_PHASE_WARMUP == p_run->phase) ? BENCH_ERR_TIMEOUT
+                                                : BENCH_ERR_OK;
+}
+
+/**
+ * @brief Connect controllers and subscribers of run
+ *
+ * @param p_run pointer to run, width and size are set
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_setup(bench_run_t *p_run) {
+    const bench_conf_t *p_conf = p_run->p_conf;
+
+    p_run->phase = BENCH_PHASE_WARMUP;
+    p_run->ready = 0;
+    p_run->warmups = 0;
+    p_run->received = 0;
+    p_run->bytes = 0;
+    p_run->lost = 0;
+    hist_reset(&p_run->latency);
+
+    p_run->p_ctrls = calloc(p_conf->controllers, sizeof(bench_ctrl_t));
+    p_run->p_subs = calloc(p_run->width, sizeof(bench_sub_t));
+    p_run->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    p_run->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ((NULL == p_run->p_ctrls) || (NULL == p_run->p_subs)) {
+        return BENCH_ERR_NOMEM;
+    }
+
+    for (size_t idx = 0; idx < p_conf->controllers; idx++) {
+        p_run->p_ctrls[idx].fd = COMMON_SOCKET_ERR;
+    }
+    for (size_t idx = 0; idx < p_run->width; idx++) {
+        p_run->p_subs[idx].fd = COMMON_SOCKET_ERR;
+        proto_parser_init(&p_run->p_subs[idx].parser);
+    }
+
+    if ((COMMON_SOCKET_ERR == p_run->epoll_fd) ||
+        (COMMON_SOCKET_ERR == p_run->timer_fd)) {
+        return BENCH_ERR_SOCKET;
+    }
+
+    struct epoll_event ev = {.events = EPOLLIN,
+                             .data.u64 = BENCH_EV(BENCH_KIND_TIMER, 0)};
+    epoll_ctl(p_run->epoll_fd, EPOLL_CTL_ADD, p_run->timer_fd, &ev);
+
+    // NOTE: subscribers first, so controllers never publish to nobody
+    for (size_t idx = 0; idx < p_run->width; idx++) {
+        bench_sub_t *p_sub = &p_run->p_subs[idx];
+        if (BENCH_ERR_OK != bench_open(&p_sub->fd, p_conf, PROTO_ROLE_SUB)) {
+            return BENCH_ERR_SOCKET;
+        }
+
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = BENCH_EV(BENCH_KIND_SUB, idx);
+        epoll_ctl(p_run->epoll_fd, EPOLL_CTL_ADD, p_sub->fd, &ev);
+    }
+
+    const size_t buf_size = CONFIG_BENCH_BATCH * (PROTO_HDR_SIZE + p_run->size);
+    for (size_t idx = 0; idx < p_conf->controllers; idx++) {
+        bench_ctrl_t *p_ctrl = &p_run->p_ctrls[idx];
+        p_ctrl->p_buf = malloc(buf_size);
+        if (NULL == p_ctrl->p_buf) {
+            return BENCH_ERR_NOMEM;
+        }
+
+        // NOTE: payload is not inspected, fill it once
+        for (size_t frame = 0; frame < CONFIG_BENCH_BATCH; frame++) {
+            memset(&p_ctrl->p_buf[(frame * (PROTO_HDR_SIZE + p_run->size)) +
+                                  PROTO_HDR_SIZE],
+                   'x', p_run->size);
+        }
+
+        if (BENCH_ERR_OK != bench_open(&p_ctrl->fd, p_conf, PROTO_ROLE_PUB)) {
+            return BENCH_ERR_SOCKET;
+        }
+
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        ev.data.u64 = BENCH_EV(BENCH_KIND_CTRL, idx);
+        epoll_ctl(p_run->epoll_fd, EPOLL_CTL_ADD, p_ctrl->fd, &ev);
+    }
+
+    struct itimerspec its = {
+        .it_interval = {.tv_nsec = (long)CONFIG_BENCH_TICK_US * 1000},
+        .it_value = {.tv_nsec = (long)CONFIG_BENCH_TICK_US * 1000}};
+    timerfd_settime(p_run->timer_fd, 0, &its, NULL);
+
+    return BENCH_ERR_OK;
+}
+
+/**
+ * @brief Close sockets and free memory of run
+ *
+ * @param p_run pointer to run
+ */
+static void bench_teardown(bench_run_t *p_run) {
+    if (NULL != p_run->p_ctrls) {
+        for (size_t idx = 0; idx < p_run->p_conf->controllers; idx++) {
+            if (COMMON_SOCKET_ERR != p_run->p_ctrls[idx].fd) {
+                client_disconnect(&p_run->p_ctrls[idx].fd);
+            }
+            free(p_run->p_ctrls[idx].p_buf);
+        }
+    }
+
+    if (NULL != p_run->p_subs) {
+        for (size_t idx = 0; idx < p_run->width; idx++) {
+            if (COMMON_SOCKET_ERR != p_run->p_subs[idx].fd) {
+                client_disconnect(&p_run->p_subs[idx].fd);
+            }
+            proto_parser_deinit(&p_run->p_subs[idx].parser);
+        }
+    }
+
+    if (COMMON_SOCKET_ERR != p_run->timer_fd) {
+        close(p_run->timer_fd);
+    }
+
+    if (COMMON_SOCKET_ERR != p_run->epoll_fd) {
+        close(p_run->epoll_fd);
+    }
+
+    free(p_run->p_ctrls);
+    free(p_run->p_subs);
+    p_run->p_ctrls = NULL;
+    p_run->p_subs = NULL;
+    p_run->timer_fd = COMMON_SOCKET_ERR;
+    p_run->epoll_fd = COMMON_SOCKET_ERR;
+}
+
+/**
+ * @brief Run one point of sweep and write its reports
+ *
+ * @param p_run pointer to run, width and size are set
+ * @param p_csv summary report
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_run(bench_run_t *p_run, FILE *p_csv) {
+    const bench_conf_t *p_conf = p_run->p_conf;
+
+    int32_t ret = bench_setup(p_run);
+    if (BENCH_ERR_OK == ret) {
+        ret = bench_loop(p_run, proto_ts_now() +
+                                    (CONFIG_BENCH_WARMUP_SEC * NSEC_PER_SEC));
+    }
+
+    if (BENCH_ERR_OK == ret) {
+        // NOTE: warmup frames still in flight are not measured
+        p_run->phase = BENCH_PHASE_MEASURE;
+        p_run->start_ns = proto_ts_now();
+        ret = bench_loop(p_run,
+                         p_run->start_ns + (p_conf->duration_sec * NSEC_PER_SEC));
+        p_run->end_ns = proto_ts_now();
+    }
+
+    if (BENCH_ERR_OK == ret) {
+        p_run->phase = BENCH_PHASE_DRAIN;
+        ret = bench_loop(p_run, proto_ts_now() + (CONFIG_BENCH_DRAIN_MS *
+                                                  (NSEC_PER_SEC / 1000u)));
+    }
+
+    if (BENCH_ERR_OK != ret) {
+        fprintf(stderr,
+                "[BENCH] Run subscribers <%zu> size <%zu> failed. Error <%d> "
+                "ready <%zu>\n",
+                p_run->width, p_run->size, ret, p_run->ready);
+        bench_teardown(p_run);
+        return ret;
+    }
+
+    uint64_t sent = 0;
+    for (size_t idx = 0; idx < p_conf->controllers; idx++) {
+        sent += p_run->p_ctrls[idx].sent;
+    }
+
+    // NOTE: frames lost after the last received one are not seen as gaps
+    const uint64_t expected = sent * p_run->width;
+    const uint64_t lost = (expected > p_run->received)
+                              ? (expected - p_run->received)
+                              : 0;
+    const double sec = (double)(p_run->end_ns - p_run->start_ns) / 1e9;
+    const hist_t *p_hist = &p_run->latency;
+
+    printf("[BENCH] subs <%5zu> size <%5zu> sent <%9.0f> msgs/s delivered "
+           "<%10.0f> msgs/s <%8.2f> MB/s lost <%lu> latency us p50 <%.1f> "
+           "p99 <%.1f> p99.9 <%.1f> max <%.1f>\n",
+           p_run->width, p_run->size, (double)sent / sec,
+           (double)p_run->received / sec, (double)p_run->bytes / sec / 1e6,
+           lost, (double)hist_percentile(p_hist, 50.0) / NSEC_PER_USEC,
+           (double)hist_percentile(p_hist, 99.0) / NSEC_PER_USEC,
+           (double)hist_percentile(p_hist, 99.9) / NSEC_PER_USEC,
+           (double)p_hist->max / NSEC_PER_USEC);
+
+    fprintf(p_csv,
+            "%zu,%zu,%zu,%lu,%.3f,%lu,%.0f,%lu,%.0f,%.3f,%lu,%.1f,%.1f,%.1f,"
+            "%.1f,%.1f,%.1f\n",
+            p_conf->controllers, p_run->width, p_run->size, p_conf->rate, sec,
+            sent, (double)sent / sec, p_run->received,
+            (double)p_run->received / sec, (double)p_run->bytes / sec / 1e6,
+            lost, (double)hist_percentile(p_hist, 50.0) / NSEC_PER_USEC,
+            (double)hist_percentile(p_hist, 90.0) / NSEC_PER_USEC,
+            (double)hist_percentile(p_hist, 99.0) / NSEC_PER_USEC,
+            (double)hist_percentile(p_hist, 99.9) / NSEC_PER_USEC,
+            (double)hist_percentile(p_hist, 99.99) / NSEC_PER_USEC,
+            (double)p_hist->max / NSEC_PER_USEC);
+    fflush(p_csv);
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/latency_n%zu_s%zu.hgrm", p_conf->p_dir,
+             p_run->width, p_run->size);
+    FILE *p_out = fopen(path, "w");
+    if (NULL != p_out) {
+        hist_dump(p_hist, p_out, NSEC_PER_USEC);
+        fclose(p_out);
+    }
+
+    bench_teardown(p_run);
+
+    return BENCH_ERR_OK;
+}
+
+/**
+ * @brief Read resident memory of process
+ *
+ * Explicit huge pages are not part of VmRSS, so they are added.
+ *
+ * @param pid process id
+ * @return uint64_t VmRSS and HugetlbPages in KiB, 0 on error
+ */
+static uint64_t bench_rss_kb(int pid) {
+    char path[PATH_MAX];
+    char line[256];
+    uint64_t rss_kb = 0;
+    uint64_t huge_kb = 0;
+
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    FILE *p_file = fopen(path, "r");
+    if (NULL == p_file) {
+        return 0;
+    }
+
+    // NOTE: HugetlbPages follows VmRSS and is absent on older kernels
+    while (NULL != fgets(line, sizeof(line), p_file)) {
+        sscanf(line, "VmRSS: %lu kB", &rss_kb);
+        if (1 == sscanf(line, "HugetlbPages: %lu kB", &huge_kb)) {
+            break;
+        }
+    }
+
+    fclose(p_file);
+
+    return rss_kb + huge_kb;
+}
+
+/**
+ * @brief Read memory of all TCP sockets of host
+ *
+ * Socket buffers live in the kernel, so both bench and server sides count.
+ *
+ * @return uint64_t memory in KiB, 0 on error
+ */
+static uint64_t bench_tcp_kb(void) {
+    char line[256];
+    uint64_t pages = 0;
+
+    FILE *p_file = fopen("/proc/net/sockstat", "r");
+    if (NULL == p_file) {
+        return 0;
+    }
+
+    while (NULL != fgets(line, sizeof(line), p_file)) {
+        const char *p_mem = strstr(line, " mem ");
+        if ((0 == strncmp(line, "TCP:", 4)) && (NULL != p_mem)) {
+            pages = strtoull(&p_mem[5], NULL, 10);
+            break;
+        }
+    }
+
+    fclose(p_file);
+
+    return pages * ((uint64_t)sysconf(_SC_PAGESIZE) / 1024u);
+}
+
+/**
+ * @brief Wait until server has exact count of open connections
+ *
+ * @param p_metrics server metrics
+ * @param conns expected count
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_idle_wait(const metrics_t *p_metrics, uint64_t conns) {
+    const uint64_t until_ns =
+        proto_ts_now() + (CONFIG_BENCH_IDLE_SETTLE_SEC * NSEC_PER_SEC);
+    const struct timespec tick = {.tv_nsec = (long)CONFIG_BENCH_WAIT_MS *
+                                             1000000};
+
+    while (g_running && (proto_ts_now() < until_ns)) {
+        uint64_t open = 0;
+        for (size_t idx = 0; idx < p_metrics->shards; idx++) {
+            open += metrics_get(&p_metrics->shard[idx].conns);
+        }
+
+        if (open == conns) {
+            return BENCH_ERR_OK;
+        }
+
+        nanosleep(&tick, NULL);
+    }
+
+    return BENCH_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Open idle subscriber: connect and send hello, nothing else
+ *
+ * Loopback peers take source address by index, so count of connections is
+ * not limited by ephemeral ports of one address.
+ *
+ * @param p_fd output socket descriptor
+ * @param p_addr server address
+ * @param idx index of connection
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_idle_open(int *p_fd, const struct addrinfo *p_addr,
+                               size_t idx) {
+    *p_fd = socket(p_addr->ai_family, p_addr->ai_socktype | SOCK_CLOEXEC,
+                   p_addr->ai_protocol);
+    if (COMMON_SOCKET_ERR == *p_fd) {
+        return BENCH_ERR_SOCKET;
+    }
+
+    const struct sockaddr_in *p_in =
+        (const struct sockaddr_in *)p_addr->ai_addr;
+    const uint32_t dst = ntohl(p_in->sin_addr.s_addr);
+    if ((AF_INET == p_addr->ai_family) &&
+        (IN_LOOPBACKNET == (dst >> IN_CLASSA_NSHIFT))) {
+        const uint32_t shift = (uint32_t)(idx / CONFIG_BENCH_IDLE_PER_ADDR);
+        struct sockaddr_in src = {
+            .sin_family = AF_INET,
+            .sin_addr.s_addr = htonl(INADDR_LOOPBACK + shift)};
+        int opt = 1;
+
+        // NOTE: port is taken on connect, so it is unique per address pair
+        setsockopt(*p_fd, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &opt,
+                   sizeof(opt));
+        if (COMMON_SOCKET_ERR ==
+            bind(*p_fd, (const struct sockaddr *)&src, sizeof(src))) {
+            client_disconnect(p_fd);
+            return BENCH_ERR_SOCKET;
+        }
+    }
+
+    if ((COMMON_SOCKET_ERR ==
+         connect(*p_fd, p_addr->ai_addr, p_addr->ai_addrlen)) ||
+        (CLIENT_ERR_OK != client_hello(*p_fd, PROTO_ROLE_SUB, NULL, 0))) {
+        client_disconnect(p_fd);
+        return BENCH_ERR_SOCKET;
+    }
+
+    return BENCH_ERR_OK;
+}
+
+/**
+ * @brief Read out frames queued to idle connections
+ *
+ * Heartbeats of the server are not read otherwise, so they would pile up in
+ * receive buffers and count as kernel TCP memory of idle connections.
+ *
+ * @param p_fds sockets of connections
+ * @param count count of sockets
+ */
+static void bench_idle_drain(const int *p_fds, size_t count) {
+    for (size_t idx = 0; idx < count; idx++) {
+        ssize_t ret = 0;
+        do {
+            ret = recv(p_fds[idx], g_recv_buf, sizeof(g_recv_buf),
+                       MSG_DONTWAIT);
+        } while (ret > 0);
+    }
+}
+
+/**
+ * @brief Run one point of idle sweep: hold connections, measure server memory
+ *
+ * @param p_metrics server metrics
+ * @param p_addr server address
+ * @param width count of idle connections
+ * @param base_kb server resident memory without connections
+ * @param p_csv idle report
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_idle_run(const metrics_t *p_metrics,
+                              const struct addrinfo *p_addr, size_t width,
+                              uint64_t base_kb, FILE *p_csv) {
+    int *p_fds = malloc(width * sizeof(int));
+    if (NULL == p_fds) {
+        return BENCH_ERR_NOMEM;
+    }
+
+    const uint64_t tcp_base_kb = bench_tcp_kb();
+    int32_t ret = BENCH_ERR_OK;
+    size_t opened = 0;
+    for (; g_running && (opened < width); opened++) {
+        ret = bench_idle_open(&p_fds[opened], p_addr, opened);
+        if (BENCH_ERR_OK != ret) {
+            fprintf(stderr, "[BENCH] Idle connection <%zu> failed: %s\n",
+                    opened, strerror(errno));
+            break;
+        }
+    }
+
+    if ((BENCH_ERR_OK == ret) && g_running) {
+        ret = bench_idle_wait(p_metrics, width);
+    }
+
+    if ((BENCH_ERR_OK == ret) && g_running) {
+        bench_idle_drain(p_fds, width);
+
+        const uint64_t rss_kb = bench_rss_kb(p_metrics->pid);
+        const uint64_t tcp_kb = bench_tcp_kb();
+        const uint64_t grown_kb = (rss_kb > base_kb) ? (rss_kb - base_kb) : 0;
+        const uint64_t tcp_grown_kb =
+            (tcp_kb > tcp_base_kb) ? (tcp_kb - tcp_base_kb) : 0;
+        const double per_conn = (double)grown_kb * 1024.0 / (double)width;
+        const double per_conn_total = (double)rss_kb * 1024.0 / (double)width;
+        const double tcp_per_conn =
+            (double)tcp_grown_kb * 1024.0 / (double)width;
+
+        printf("[BENCH] idle <%7zu> server rss <%lu> KiB, <%.1f> B/conn over "
+               "base, <%.1f> B/conn total, kernel tcp <%.1f> B/conn\n",
+               width, rss_kb, per_conn, per_conn_total, tcp_per_conn);
+        fprintf(p_csv, "%zu,%lu,%lu,%.1f,%.1f,%lu,%.1f\n", width, base_kb,
+                rss_kb, per_conn, per_conn_total, tcp_grown_kb, tcp_per_conn);
+        fflush(p_csv);
+    } else if (BENCH_ERR_TIMEOUT == ret) {
+        fprintf(stderr, "[BENCH] Server did not take <%zu> idle connections "
+                "in <%lu> s\n", width, CONFIG_BENCH_IDLE_SETTLE_SEC);
+    }
+
+    for (size_t idx = 0; idx < opened; idx++) {
+        client_disconnect(&p_fds[idx]);
+    }
+    free(p_fds);
+
+    // NOTE: next point starts from empty server
+    if ((BENCH_ERR_OK == ret) && g_running) {
+        ret = bench_idle_wait(p_metrics, 0);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Sweep of idle connections. Server must run on this host
+ *
+ * @param p_conf pointer to configuration
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t bench_idle(const bench_conf_t *p_conf) {
+    const metrics_t *p_metrics = NULL;
+    size_t size = 0;
+    const uint16_t port = (uint16_t)strtoul(p_conf->p_port, NULL, 10);
+    if (METRICS_ERR_OK != metrics_open(&p_metrics, &size, port)) {
+        fprintf(stderr, "[BENCH] Cannot open metrics of server on port <%u>\n",
+                port);
+        return BENCH_ERR_PARAM;
+    }
+
+    struct addrinfo hints = {.ai_family = AF_UNSPEC,
+                             .ai_socktype = SOCK_STREAM};
+    struct addrinfo *p_addr = NULL;
+    if (0 != getaddrinfo(p_conf->p_host, p_conf->p_port, &hints, &p_addr)) {
+        fprintf(stderr, "[BENCH] Cannot resolve <%s>\n", p_conf->p_host);
+        metrics_close(p_metrics, size);
+        return BENCH_ERR_PARAM;
+    }
+
+    // NOTE: soft limit is raised up to hard one, the rest is up to caller
+    struct rlimit lim;
+    size_t width_max = 0;
+    for (size_t idx = 0; idx < p_conf->idles_count; idx++) {
+        width_max = (p_conf->idles[idx] > width_max) ? p_conf->idles[idx]
+                                                     : width_max;
+    }
+    getrlimit(RLIMIT_NOFILE, &lim);
+    lim.rlim_cur = lim.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &lim);
+    if ((RLIM_INFINITY != lim.rlim_cur) &&
+        ((width_max + 16u) > (size_t)lim.rlim_cur)) {
+        fprintf(stderr, "[BENCH] Open files limit <%lu> is below <%zu> idle "
+                "connections, raise it with ulimit -n\n",
+                (uint64_t)lim.rlim_cur, width_max);
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/idle.csv", p_conf->p_dir);
+    FILE *p_csv = fopen(path, "w");
+    if (NULL == p_csv) {
+        fprintf(stderr, "[BENCH] Cannot open report <%s>\n", path);
+        freeaddrinfo(p_addr);
+        metrics_close(p_metrics, size);
+        return BENCH_ERR_PARAM;
+    }
+
+    fprintf(p_csv, "connections,base_rss_kb,rss_kb,bytes_per_conn,"
+                   "total_bytes_per_conn,tcp_kb,tcp_bytes_per_conn\n");
+
+    int32_t ret = bench_idle_wait(p_metrics, 0);
+    const uint64_t base_kb = bench_rss_kb(p_metrics->pid);
+    printf("[BENCH] Idle sweep, server pid <%d> rss <%lu> KiB. Reports in "
+           "<%s>\n",
+           p_metrics->pid, base_kb, p_conf->p_dir);
+    if (BENCH_ERR_OK != ret) {
+        fprintf(stderr, "[BENCH] Server has clients, idle sweep needs it "
+                        "empty\n");
+    }
+
+    for (size_t idx = 0; g_running && (BENCH_ERR_OK == ret) &&
+                         (idx < p_conf->idles_count);
+         idx++) {
+        ret = bench_idle_run(p_metrics, p_addr, p_conf->idles[idx], base_kb,
+                             p_csv);
+    }
+
+    fclose(p_csv);
+    freeaddrinfo(p_addr);
+    metrics_close(p_metrics, size);
+
+    return ret;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(int argc, char *argv[]) {
+    struct sigaction sa = {.sa_handler = sigint_handler};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    bench_conf_t conf = {.controllers = 1,
+                         .widths = {1, 10, 100},
+                         .widths_count = 3,
+                         .sizes = {16, 256, 4096},
+                         .sizes_count = 3,
+                         .rate = CONFIG_BENCH_RATE,
+                         .duration_sec = CONFIG_BENCH_DURATION_SEC,
+                         .p_dir = "."};
+    bool usage = false;
+
+    int opt = 0;
+    while (-1 != (opt = getopt(argc, argv, OPTS))) {
+        switch (opt) {
+            case 'm':
+                conf.controllers = (size_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'n':
+                conf.widths_count = bench_parse_list(optarg, conf.widths);
+                break;
+
+            case 's':
+                conf.sizes_count = bench_parse_list(optarg, conf.sizes);
+                break;
+
+            case 'r':
+                conf.rate = strtoull(optarg, NULL, 10);
+                break;
+
+            case 't':
+                conf.duration_sec = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'o':
+                conf.p_dir = optarg;
+                break;
+
+            case 'i':
+                conf.idles_count = bench_parse_list(optarg, conf.idles);
+                usage = usage || (0 == conf.idles_count);
+                break;
+
+            default:
+                usage = true;
+                break;
+        }
+    }
+
+    bool sizes_ok = (conf.sizes_count > 0);
+    for (size_t idx = 0; idx < conf.sizes_count; idx++) {
+        sizes_ok = sizes_ok && (conf.sizes[idx] <= CONFIG_PROTO_PAYLOAD_MAX);
+    }
+
+    if (usage || ((size_t)(argc - optind) != ARGS_COUNT) ||
+        (0 == conf.controllers) || (conf.controllers > BENCH_CTRL_MAX) ||
+        (0 == conf.widths_count) || !sizes_ok || (0 == conf.duration_sec)) {
+        fprintf(stderr,
+                "\nUsage: %s [-m controllers] [-n subs,subs,...] "
+                "[-s size,size,...] [-r msgs/sec] [-t sec] [-o dir] "
+                "[-i conns,conns,...] <host> <port>\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    conf.p_host = argv[optind + ARGS_IDX_HOST];
+    conf.p_port = argv[optind + ARGS_IDX_PORT];
+
+    mkdir(conf.p_dir, 0755);
+
+    // NOTE: idle sweep replaces throughput sweep
+    if (conf.idles_count > 0) {
+        exit((BENCH_ERR_OK == bench_idle(&conf)) ? EXIT_SUCCESS
+                                                 : EXIT_FAILURE);
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/bench.csv", conf.p_dir);
+    FILE *p_csv = fopen(path, "w");
+    if (NULL == p_csv) {
+        fprintf(stderr, "[BENCH] Cannot open report <%s>\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(p_csv,
+            "controllers,subscribers,size,rate,sec,sent,sent_per_sec,"
+            "delivered,delivered_per_sec,mb_per_sec,lost,p50_us,p90_us,"
+            "p99_us,p99_9_us,p99_99_us,max_us\n");
+
+    printf("[BENCH] Controllers <%zu> rate <%lu> msgs/s each, <%lu> s per "
+           "run. Reports in <%s>\n",
+           conf.controllers, conf.rate, conf.duration_sec, conf.p_dir);
+
+    int32_t ret = BENCH_ERR_OK;
+    g_run.p_conf = &conf;
+    g_run.epoll_fd = COMMON_SOCKET_ERR;
+    g_run.timer_fd = COMMON_SOCKET_ERR;
+
+    for (size_t size = 0; g_running && (size < conf.sizes_count); size++) {
+        for (size_t width = 0; g_running && (width < conf.widths_count);
+             width++) {
+            g_run.size = conf.sizes[size];
+            g_run.width = conf.widths[width];
+
+            if (BENCH_ERR_OK != bench_run(&g_run, p_csv)) {
+                ret = BENCH_ERR_SOCKET;
+            }
+        }
+    }
+
+    fclose(p_csv);
+
+    exit((BENCH_ERR_OK == ret) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -44,6 +44,7 @@
 
 #include <client.h>
 #include <ctype.h>
+#include <getopt.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -56,24 +57,46 @@
 
 #include "common.h"
 #include "config.h"
+#include "hist.h"
+#include "proto.h"
 
 /******************************************************************************
  * DEFINES, CONSTS, ENUMS
  ******************************************************************************/
 
-#define ARGS_COUNT ((size_t)3)    /**< Args count for invocations*/
-#define ARGS_IDX_HOST ((size_t)1) /**< Host arg index */
-#define ARGS_IDX_PORT ((size_t)2) /**< Port arg index */
+#define ARGS_COUNT ((size_t)2)    /**< Positional args count for invocations*/
+#define ARGS_IDX_HOST ((size_t)0) /**< Host arg index after options */
+#define ARGS_IDX_PORT ((size_t)1) /**< Port arg index after options */
+
+#define OPTS "qT:r:mbg:i:h" /**< Command line options */
+
+#define NSEC_PER_USEC ((double)1e3) /**< Nanoseconds in microsecond */
 
 /******************************************************************************
  * PRIVATE TYPES
  ******************************************************************************/
 
+/** Receive statistics */
+typedef struct client_stats_s {
+    hist_t latency;     /**< One-way latency, ns */
+    uint64_t frames;    /**< Received frames */
+    uint64_t unstamped; /**< Frames without send timestamp */
+    uint64_t last_seq;  /**< Last received sequence number */
+    uint64_t lost;      /**< Sequence numbers skipped */
+    uint64_t reordered; /**< Frames with sequence number below expected */
+    uint64_t restarts;  /**< Publisher restarts - sequence started from 1 */
+    bool resync;        /**< Next frame starts tracking, nothing is lost */
+} client_stats_t;
+
 /******************************************************************************
  * PRIVATE DATA
  ******************************************************************************/
 
 static int g_socket_fd = COMMON_SOCKET_ERR; /**< Global socket variable */
+static volatile sig_atomic_t g_running = 1; /**< Cleared by Ctrl+C */
+static volatile sig_atomic_t g_dump = 0;    /**< Set by SIGUSR1 */
+static client_stats_t g_stats;              /**< Receive statistics */
+static bool g_quiet = false;                /**< Do not print every frame */
 
 /******************************************************************************
  * PUBLIC DATA
@@ -92,6 +115,9 @@ static int g_socket_fd = COMMON_SOCKET_ERR; /**< Global socket variable */
  ******************************************************************************/
 
 static void sigint_handler(int ctx);
+static void sigusr1_handler(int ctx);
+static void client_frame(const proto_frame_t *p_frame);
+static void client_dump(void);
 
 /******************************************************************************
  * PRIVATE FUNCTIONS
@@ -103,12 +129,77 @@ static void sigint_handler(int ctx);
  * @param sig received signal
  */
 static void sigint_handler(int sig) {
-    signal(sig, SIG_IGN);
-    printf("\n\n[CLIENT] Ctrl+C was pressed. Exit\n\n");
+    (void)sig;
 
-    client_disconnect(&g_socket_fd);
+    // NOTE: main loop stops and dumps statistics
+    g_running = 0;
+}
 
-    exit(EXIT_SUCCESS);
+/**
+ * @brief SIGUSR1 handler. Requests statistics dump
+ *
+ * @param sig received signal
+ */
+static void sigusr1_handler(int sig) {
+    (void)sig;
+
+    g_dump = 1;
+}
+
+/**
+ * @brief Account received frame
+ *
+ * Latency is measured from publisher send timestamp, so only peers on the
+ * same host are comparable. Sequence is tracked for one publisher: a frame
+ * with seq 1 starts new stream.
+ *
+ * @param p_frame pointer to frame
+ */
+static void client_frame(const proto_frame_t *p_frame) {
+    const uint64_t now = proto_ts_now();
+    const uint64_t seq = p_frame->hdr.seq;
+
+    g_stats.frames++;
+
+    if ((0 == p_frame->hdr.ts) || (p_frame->hdr.ts > now)) {
+        g_stats.unstamped++;
+    } else {
+        hist_record(&g_stats.latency, now - p_frame->hdr.ts);
+    }
+
+    if (g_stats.resync) {
+        g_stats.resync = false;
+        g_stats.last_seq = seq;
+        return;
+    }
+
+    if ((1 == seq) && (0 != g_stats.last_seq)) {
+        g_stats.restarts++;
+    } else if (seq > (g_stats.last_seq + 1)) {
+        g_stats.lost += seq - g_stats.last_seq - 1;
+        if (!g_quiet) {
+                printf("[CLIENT] Gap: seq <%lu> expected <%lu>\n", seq,
+                   g_stats.last_seq + 1);
+        }
+    } else if (seq <= g_stats.last_seq) {
+        g_stats.reordered++;
+        return;
+    }
+
+    g_stats.last_seq = seq;
+}
+
+/**
+ * @brief Print received, lost frames and latency distribution in us
+ */
+static void client_dump(void) {
+    printf("[CLIENT] Frames <%lu> unstamped <%lu> lost <%lu> reordered <%lu> "
+           "restarts <%lu>\n",
+           g_stats.frames, g_stats.unstamped, g_stats.lost, g_stats.reordered,
+           g_stats.restarts);
+    hist_print(&g_stats.latency, stdout, "[CLIENT] Latency us:", NSEC_PER_USEC);
+    hist_dump(&g_stats.latency, stdout, NSEC_PER_USEC);
+    fflush(stdout);
 }
 
 /******************************************************************************
@@ -116,15 +207,84 @@ static void sigint_handler(int sig) {
  ******************************************************************************/
 
 int main(int argc, char *argv[]) {
-    signal(SIGINT, sigint_handler);
+    // NOTE: no SA_RESTART - signals interrupt blocking recv
+    struct sigaction sa = {.sa_handler = sigint_handler};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sa.sa_handler = sigusr1_handler;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    // NOTE: patterns point into argv, at most one per argument
+    const char **pp_topics = calloc((size_t)argc, sizeof(char *));
+    size_t topics_count = 0;
+    bool replay = false;
+    uint64_t replay_seq = 0;
+    bool shm = false;
+    bool busy = false;
+    char *p_group = NULL;
+    char *p_group_port = NULL;
+    const char *p_ifaddr = NULL;
+    if (NULL == pp_topics) {
+        exit(EXIT_FAILURE);
+    }
+
+    int opt = 0;
+    while (-1 != (opt = getopt(argc, argv, OPTS))) {
+        switch (opt) {
+            case 'q':
+                g_quiet = true;
+                break;
+
+            case 'T':
+                pp_topics[topics_count++] = optarg;
+                break;
+
+            case 'r':
+                replay = true;
+                replay_seq = (uint64_t)strtoull(optarg, NULL, 10);
+                break;
+
+            case 'm':
+                shm = true;
+                break;
+
+            case 'b':
+                shm = true;
+                busy = true;
+                break;
+
+            case 'g':
+                // NOTE: group is "address:port"
+                p_group = optarg;
+                p_group_port = strrchr(optarg, ':');
+                if (NULL == p_group_port) {
+                    argc = 0;
+                    break;
+                }
+                *p_group_port++ = '\0';
+                break;
 
-    if (argc != ARGS_COUNT) {
-        fprintf(stderr, "\nUsage: %s, <host> <port>\n", argv[0]);
+            case 'i':
+                p_ifaddr = optarg;
+                break;
+
+            default:
+                argc = 0;
+                break;
+        }
+    }
+
+    if (((size_t)(argc - optind) != ARGS_COUNT) ||
+        ((NULL != p_group) && (replay || shm))) {
+        fprintf(stderr,
+                "\nUsage: %s [-q] [-T pattern]... [-r seq] [-m] [-b] "
+                "[-g group:port [-i ifaddr]] <host> <port>\n",
+                argv[0]);
         exit(EXIT_FAILURE);
     }
 
-    int32_t ret =
-        client_connect(argv[ARGS_IDX_HOST], argv[ARGS_IDX_PORT], &g_socket_fd);
+    int32_t ret = client_connect(argv[optind + ARGS_IDX_HOST],
+                                 argv[optind + ARGS_IDX_PORT], &g_socket_fd);
     if (CLIENT_ERR_OK != ret) {
         printf("[CLIENT] Cannot connect to server. Error <%d> Exit\n", ret);
         exit(EXIT_FAILURE);
@@ -132,24 +292,147 @@ int main(int argc, char *argv[]) {
 
     printf("[CLIENT] Connected to server. Press Ctr+C for exit\n");
 
-    while (true) {
-        char buffer[CONFIG_BUFFER_SIZE];
+    // NOTE: group is joined before hello, no datagram of stream is missed
+    static client_mcast_t mcast;
+    if (NULL != p_group) {
+        ret = client_mcast_join(&mcast, p_group, p_group_port, p_ifaddr);
+        if (CLIENT_ERR_OK != ret) {
+            printf("[CLIENT] Cannot join group. Error <%d> Exit\n", ret);
+            exit(EXIT_FAILURE);
+        }
+        printf("[CLIENT] Joined group <%s:%s>\n", p_group, p_group_port);
+    }
+
+    // NOTE: ring is offered before hello, server stops reading subscriber
+    static client_shm_t shm_ring;
+    if (shm && (CLIENT_ERR_OK != client_shm_open(g_socket_fd, &shm_ring))) {
+        printf("[CLIENT] Cannot create shared memory ring. Use socket\n");
+        shm = false;
+    }
+
+    // NOTE: without patterns subscriber gets everything
+    if (NULL != p_group) {
+        ret = client_hello_mcast(g_socket_fd, PROTO_ROLE_SUB, pp_topics,
+                                 topics_count);
+    } else if (replay) {
+        ret = client_hello_replay(g_socket_fd, PROTO_ROLE_SUB, pp_topics,
+                                  topics_count, replay_seq);
+    } else {
+        ret = client_hello(g_socket_fd, PROTO_ROLE_SUB, pp_topics,
+                           topics_count);
+    }
+    if (CLIENT_ERR_OK != ret) {
+        printf("[CLIENT] Cannot send hello. Error <%d> Exit\n", ret);
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t idx = 0; idx < topics_count; idx++) {
+        printf("[CLIENT] Subscribed to <%s>\n", pp_topics[idx]);
+    }
+    free(pp_topics);
+
+    // NOTE: replay starts at server sequence, publisher one of the first
+    // frame is unknown, so frames before it are not lost
+    if (replay) {
+        printf("[CLIENT] Replay from seq <%lu>\n", replay_seq);
+        g_stats.resync = true;
+    }
 
-        ssize_t ret = 0;
-        ret = read(g_socket_fd, buffer, CONFIG_BUFFER_SIZE);
+    if (shm) {
+        shm = (CLIENT_ERR_OK == client_shm_attached(&shm_ring));
+        printf("[CLIENT] %s\n", shm ? (busy ? "Shared memory ring, busy poll"
+                                            : "Shared memory ring")
+                                     : "Ring is not attached. Use socket");
+    }
 
-        if (COMMON_SOCKET_ERR == ret) {
+    static uint8_t buffer[CONFIG_CLIENT_RECV_SIZE];
+    proto_parser_t parser;
+    proto_parser_init(&parser);
+    hist_reset(&g_stats.latency);
+
+    while (g_running) {
+        if (NULL != p_group) {
+            ret = client_mcast_recv(g_socket_fd, &mcast, &parser, buffer,
+                                    sizeof(buffer));
+        } else if (shm) {
+            ret = client_shm_recv(g_socket_fd, &shm_ring, &parser, buffer,
+                                  sizeof(buffer), busy);
+        } else {
+            ret = client_recv(g_socket_fd, &parser, buffer, sizeof(buffer));
+        }
+
+        if (g_dump) {
+            g_dump = 0;
+            client_dump();
+        }
+
+        if (CLIENT_ERR_INTR == ret) {
+            continue;
+        } else if (CLIENT_ERR_SOCKET == ret) {
             printf("[CLIENT] Socket error. Exit\n");
             break;
-        } else if (COMMON_SOCKET_CLOSED == ret) {
+        } else if (CLIENT_ERR_CLOSED == ret) {
             printf("[CLIENT] Connection is closed. Exit\n");
             break;
-        } else {
-            printf("[CLIENT] Received <%ld> bytes: <%s>\n", (size_t)ret,
-                   buffer);
+        }
+
+        // NOTE: one read may carry many frames or a part of one
+        proto_frame_t frame;
+        while (PROTO_ERR_OK == (ret = proto_parser_next(&parser, &frame))) {
+            // NOTE: heartbeats only keep the connection probed
+            if (PROTO_TYPE_DATA != frame.hdr.type) {
+                continue;
+            }
+
+            client_frame(&frame);
+
+            if (!g_quiet) {
+                const size_t topic_len =
+                    (PROTO_TOPIC_LEN(&frame.hdr) <= frame.hdr.len)
+                        ? PROTO_TOPIC_LEN(&frame.hdr)
+                        : 0;
+                if (0 == topic_len) {
+                    printf("[CLIENT] Received frame seq <%lu> <%u> bytes: "
+                           "<%.*s>\n",
+                           frame.hdr.seq, frame.hdr.len, (int)frame.hdr.len,
+                           (const char *)frame.p_payload);
+                } else {
+                    printf("[CLIENT] Received frame seq <%lu> <%u> bytes "
+                           "topic <%.*s>: <%.*s>\n",
+                           frame.hdr.seq, frame.hdr.len, (int)topic_len,
+                           (const char *)frame.p_payload,
+                           (int)(frame.hdr.len - topic_len),
+                           (const char *)&frame.p_payload[topic_len]);
+                }
+            }
+        }
+
+        if (PROTO_ERR_AGAIN != ret) {
+            printf("[CLIENT] Malformed frame. Error <%d> Exit\n", ret);
+            break;
         }
     }
 
+    if (!g_running) {
+        printf("\n\n[CLIENT] Ctrl+C was pressed. Exit\n\n");
+    }
+
+    client_dump();
+
+    if (NULL != p_group) {
+        printf("[CLIENT] Multicast lost <%lu> nacks <%lu> retransmits <%lu> "
+               "dups <%lu> overruns <%lu>%s\n",
+               mcast.stats.lost, mcast.stats.nacks, mcast.stats.retransmits,
+               mcast.stats.dups, mcast.stats.overruns,
+               mcast.unicast ? " (server has no group)" : "");
+        client_mcast_leave(&mcast);
+    }
+
+    proto_parser_deinit(&parser);
+
+    if (shm) {
+        client_shm_close(&shm_ring);
+    }
     client_disconnect(&g_socket_fd);
 
     exit(EXIT_SUCCESS);
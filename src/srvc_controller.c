@@ -53,27 +53,65 @@
 #include <ctype.h>
 #include <string.h>
 #include <signal.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
 #include "client.h"
 #include "common.h"
 #include "config.h"
+#include "proto.h"
 
 /******************************************************************************
  * DEFINES, CONSTS, ENUMS
  ******************************************************************************/
 
-#define ARGS_COUNT ((size_t)3)    /**< Args count for invocations*/
-#define ARGS_IDX_HOST ((size_t)1) /**< Host arg index */
-#define ARGS_IDX_PORT ((size_t)2) /**< Port arg index */
+#define ARGS_COUNT ((size_t)2)    /**< Positional args count for invocations*/
+#define ARGS_IDX_HOST ((size_t)0) /**< Host arg index after options */
+#define ARGS_IDX_PORT ((size_t)1) /**< Port arg index after options */
+
+#define OPTS "r:b:n:s:t:T:h" /**< Command line options */
+
+#define NSEC_PER_SEC ((uint64_t)1000000000u) /**< Nanoseconds in second */
+
+/** Pacer of paced mode */
+typedef enum ctrl_pacer_e {
+    CTRL_PACER_TIMERFD = 0, /**< Sleep on timerfd until batch is due */
+    CTRL_PACER_SPIN,        /**< Busy-wait on monotonic clock */
+} ctrl_pacer_t;
 
 /******************************************************************************
  * PRIVATE TYPES
  ******************************************************************************/
 
+/** Paced mode configuration */
+typedef struct ctrl_conf_s {
+    uint64_t rate;       /**< Target messages per second, 0 - periodic mode */
+    size_t batch;        /**< Max messages per send */
+    uint64_t count;      /**< Messages to send, 0 - until Ctrl+C */
+    size_t size;         /**< Min payload size without topic, padded by \
+                            spaces */
+    ctrl_pacer_t pacer;  /**< Pacer */
+    const char *p_topic; /**< Topic of messages, NULL - no topic */
+} ctrl_conf_t;
+
+/** Paced mode statistics for one report period */
+typedef struct ctrl_stats_s {
+    uint64_t msgs;     /**< Messages sent */
+    uint64_t bytes;    /**< Bytes sent, headers included */
+    uint64_t sends;    /**< Send calls */
+    double lag_sum;    /**< Sum of send lags, ns */
+    double lag_sq_sum; /**< Sum of squared send lags, ns^2 */
+    uint64_t lag_max;  /**< Max send lag, ns */
+} ctrl_stats_t;
+
 /******************************************************************************
  * PRIVATE DATA
  ******************************************************************************/
 
 static int g_socket_fd = COMMON_SOCKET_ERR; /**< Global socket variable */
+static volatile sig_atomic_t g_running = 1; /**< Cleared by Ctrl+C */
 
 /******************************************************************************
  * PUBLIC DATA
@@ -92,6 +130,14 @@ static int g_socket_fd = COMMON_SOCKET_ERR; /**< Global socket variable */
  ******************************************************************************/
 
 static void sigint_handler(int ctx);
+static size_t ctrl_fill(uint8_t *p_buf, const ctrl_conf_t *p_conf,
+                        uint64_t seq, uint64_t ts);
+static void ctrl_wait(const ctrl_conf_t *p_conf, int timer_fd,
+                      uint64_t deadline_ns);
+static void ctrl_report(const ctrl_stats_t *p_stats, double sec,
+                        const char *p_what);
+static int32_t ctrl_run_paced(const ctrl_conf_t *p_conf);
+static int32_t ctrl_run_periodic(const ctrl_conf_t *p_conf);
 
 /******************************************************************************
  * PRIVATE FUNCTIONS
@@ -106,65 +152,356 @@ static void sigint_handler(int sig) {
     signal(sig, SIG_IGN);
     printf("\n\n[CONTROLLER] Ctrl+C was pressed. Exit\n\n");
 
-    client_disconnect(&g_socket_fd);
+    // NOTE: main loop stops and prints summary
+    g_running = 0;
+}
+
+/**
+ * @brief Encode one data frame
+ *
+ * @param p_buf destination, at least PROTO_HDR_SIZE + topic length +
+ * max(size, 32) bytes
+ * @param p_conf pointer to configuration
+ * @param seq sequence number
+ * @param ts send timestamp
+ * @return size_t size of encoded frame
+ */
+static size_t ctrl_fill(uint8_t *p_buf, const ctrl_conf_t *p_conf,
+                        uint64_t seq, uint64_t ts) {
+    const size_t topic_len =
+        (NULL != p_conf->p_topic) ? strlen(p_conf->p_topic) : 0;
+    char *p_payload = (char *)&p_buf[PROTO_HDR_SIZE];
+
+    if (topic_len > 0) {
+        memcpy(p_payload, p_conf->p_topic, topic_len);
+    }
+    size_t len = topic_len + (size_t)sprintf(&p_payload[topic_len],
+                                             "{\"id\" : %lu}", seq);
+
+    if (len < (topic_len + p_conf->size)) {
+        memset(&p_payload[len], ' ', topic_len + p_conf->size - len);
+        len = topic_len + p_conf->size;
+    }
 
-    exit(EXIT_SUCCESS);
+    proto_hdr_t hdr = {.len = (uint32_t)len, .type = PROTO_TYPE_DATA,
+                       .flags = (uint16_t)topic_len, .seq = seq, .ts = ts};
+    proto_hdr_encode(p_buf, &hdr);
+
+    return PROTO_HDR_SIZE + len;
 }
 
-/******************************************************************************
- * PUBLIC FUNCTIONS
- ******************************************************************************/
+/**
+ * @brief Wait until deadline
+ *
+ * @param p_conf pointer to configuration
+ * @param timer_fd timerfd for CTRL_PACER_TIMERFD
+ * @param deadline_ns monotonic deadline
+ */
+static void ctrl_wait(const ctrl_conf_t *p_conf, int timer_fd,
+                      uint64_t deadline_ns) {
+    if (CTRL_PACER_SPIN == p_conf->pacer) {
+        while (g_running && (proto_ts_now() < deadline_ns)) {
+            // NOTE: busy-wait - no wakeup latency, one core is burnt
+        }
+        return;
+    }
 
-int main(int argc, char *argv[]) {
-    signal(SIGINT, sigint_handler);
+    struct itimerspec its = {
+        .it_value = {.tv_sec = (time_t)(deadline_ns / NSEC_PER_SEC),
+                     .tv_nsec = (long)(deadline_ns % NSEC_PER_SEC)}};
+    if (0 != timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL)) {
+        return;
+    }
 
-    if (argc != ARGS_COUNT) {
-        fprintf(stderr, "\nUsage: %s, <host> <port>\n", argv[0]);
-        exit(EXIT_FAILURE);
+    uint64_t expirations = 0;
+    if (sizeof(expirations) !=
+        read(timer_fd, &expirations, sizeof(expirations))) {
+        // NOTE: EINTR on Ctrl+C - caller checks g_running
     }
+}
 
-    int32_t ret =
-        client_connect(argv[ARGS_IDX_HOST], argv[ARGS_IDX_PORT], &g_socket_fd);
-    if (CLIENT_ERR_OK != ret) {
-        printf("[CONTROLLER] Cannot connect to server. Error <%d> Exit\n", ret);
-        exit(EXIT_FAILURE);
+/**
+ * @brief Print achieved rate and send jitter
+ *
+ * Send lag is time between moment when message was due and its send. Jitter
+ * is standard deviation of send lag.
+ *
+ * @param p_stats pointer to statistics
+ * @param sec period length in seconds
+ * @param p_what report name
+ */
+static void ctrl_report(const ctrl_stats_t *p_stats, double sec,
+                        const char *p_what) {
+    double lag_avg = 0.0;
+    double jitter = 0.0;
+
+    if (p_stats->sends > 0) {
+        lag_avg = p_stats->lag_sum / (double)p_stats->sends;
+        double var =
+            (p_stats->lag_sq_sum / (double)p_stats->sends) - (lag_avg * lag_avg);
+        jitter = (var > 0.0) ? sqrt(var) : 0.0;
     }
 
-    printf("[CONTROLLER] Connected to server. Press Ctr+C for exit\n");
+    printf("[CONTROLLER] %s: <%.0f> msgs/s <%.2f> MB/s msgs/send <%.1f> "
+           "lag avg <%.1f> max <%.1f> us jitter <%.1f> us\n",
+           p_what, (double)p_stats->msgs / sec,
+           (double)p_stats->bytes / sec / 1e6,
+           (p_stats->sends > 0)
+               ? ((double)p_stats->msgs / (double)p_stats->sends)
+               : 0.0,
+           lag_avg / 1e3, (double)p_stats->lag_max / 1e3, jitter / 1e3);
+}
+
+/**
+ * @brief Publish messages at target rate
+ *
+ * Message N is due at start + N / rate. Sender wakes when batch is due and
+ * sends all due messages with one writev, so rate holds on average even when
+ * send blocks.
+ *
+ * @param p_conf pointer to configuration
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t ctrl_run_paced(const ctrl_conf_t *p_conf) {
+    const size_t frame_max =
+        PROTO_HDR_SIZE +
+        ((NULL != p_conf->p_topic) ? strlen(p_conf->p_topic) : 0) +
+        ((p_conf->size > 32) ? p_conf->size : 32);
+    uint8_t *p_buf = malloc(p_conf->batch * frame_max);
+    struct iovec *p_iov = calloc(p_conf->batch, sizeof(struct iovec));
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if ((NULL == p_buf) || (NULL == p_iov) ||
+        (COMMON_SOCKET_ERR == timer_fd)) {
+        free(p_buf);
+        free(p_iov);
+        return CLIENT_ERR_PARAM;
+    }
+
+    printf("[CONTROLLER] Paced mode: rate <%lu> msgs/s batch <%zu> pacer "
+           "<%s>\n",
+           p_conf->rate, p_conf->batch,
+           (CTRL_PACER_SPIN == p_conf->pacer) ? "spin" : "timerfd");
+
+    const double ns_per_msg = (double)NSEC_PER_SEC / (double)p_conf->rate;
+    const uint64_t start = proto_ts_now();
+    uint64_t report_at = start + (CONFIG_CTRL_REPORT_SEC * NSEC_PER_SEC);
+    uint64_t report_start = start;
+    uint64_t sent = 0;
+    int32_t ret = CLIENT_ERR_OK;
+    ctrl_stats_t period = {0};
+    ctrl_stats_t total = {0};
+
+    while (g_running && ((0 == p_conf->count) || (sent < p_conf->count))) {
+        uint64_t left = (0 == p_conf->count) ? p_conf->batch
+                                              : (p_conf->count - sent);
+        size_t batch = (left < p_conf->batch) ? (size_t)left : p_conf->batch;
+
+        // NOTE: wait only if whole batch is not due yet
+        uint64_t due_at =
+            start + (uint64_t)((double)(sent + batch) * ns_per_msg);
+        ctrl_wait(p_conf, timer_fd, due_at);
+
+        const uint64_t now = proto_ts_now();
+        uint64_t due = (uint64_t)((double)(now - start) / ns_per_msg);
+        if (due <= sent) {
+            continue;
+        }
+
+        size_t count = ((due - sent) < batch) ? (size_t)(due - sent) : batch;
+        size_t bytes = 0;
+        const uint64_t ts = proto_ts_now();
+        for (size_t idx = 0; idx < count; idx++) {
+            uint8_t *p_frame = &p_buf[idx * frame_max];
+            p_iov[idx].iov_base = p_frame;
+            p_iov[idx].iov_len =
+                ctrl_fill(p_frame, p_conf, sent + idx + 1, ts);
+            bytes += p_iov[idx].iov_len;
+        }
+
+        // NOTE: lag of newest message in batch - pacer wakeup error
+        const uint64_t lag =
+            now - (start + (uint64_t)((double)(sent + count) * ns_per_msg));
+
+        ret = client_sendv(g_socket_fd, p_iov, count);
+        if (CLIENT_ERR_OK != ret) {
+            printf("[CONTROLLER] Socket error. Exit\n");
+            break;
+        }
 
+        sent += count;
+        period.msgs += count;
+        period.bytes += bytes;
+        period.sends++;
+        period.lag_sum += (double)lag;
+        period.lag_sq_sum += (double)lag * (double)lag;
+        if (lag > period.lag_max) {
+            period.lag_max = lag;
+        }
+
+        if (now >= report_at) {
+            ctrl_report(&period, (double)(now - report_start) / 1e9, "Rate");
+
+            total.msgs += period.msgs;
+            total.bytes += period.bytes;
+            total.sends += period.sends;
+            total.lag_sum += period.lag_sum;
+            total.lag_sq_sum += period.lag_sq_sum;
+            if (period.lag_max > total.lag_max) {
+                total.lag_max = period.lag_max;
+            }
+
+            memset(&period, 0x00, sizeof(period));
+            report_start = now;
+            report_at = now + (CONFIG_CTRL_REPORT_SEC * NSEC_PER_SEC);
+        }
+    }
+
+    total.msgs += period.msgs;
+    total.bytes += period.bytes;
+    total.sends += period.sends;
+    total.lag_sum += period.lag_sum;
+    total.lag_sq_sum += period.lag_sq_sum;
+    if (period.lag_max > total.lag_max) {
+        total.lag_max = period.lag_max;
+    }
+
+    ctrl_report(&total, (double)(proto_ts_now() - start) / 1e9, "Total");
+
+    close(timer_fd);
+    free(p_iov);
+    free(p_buf);
+
+    return ret;
+}
+
+/**
+ * @brief Publish one message per CONFIG_CTRL_PERIOD_SEC
+ *
+ * @param p_conf pointer to configuration
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t ctrl_run_periodic(const ctrl_conf_t *p_conf) {
     uint64_t id = 0;
 
-    while (true) {
+    while (g_running) {
         char buffer[CONFIG_BUFFER_SIZE];
 
         ssize_t ret = 0;
 
         id++;
-        ret = snprintf(buffer, CONFIG_BUFFER_SIZE - 1, "{\"id\" : %u}", id);
+        ret = snprintf(buffer, CONFIG_BUFFER_SIZE - 1, "{\"id\" : %lu}", id);
         if (0 > ret) {
             printf("[CONTROLLER] Internal error. Exit\n");
-            break;
+            return CLIENT_ERR_PARAM;
         }
 
-        ret = send(g_socket_fd, buffer, (size_t) ret, MSG_NOSIGNAL);
+        size_t len = (size_t)ret;
+        ret = client_publish(g_socket_fd, id, p_conf->p_topic, buffer, len);
 
-        if (COMMON_SOCKET_ERR == ret) {
+        if (CLIENT_ERR_OK != ret) {
             printf("[CONTROLLER] Socket error. Exit\n");
-            break;
-        } else if (COMMON_SOCKET_CLOSED == ret) {
-            printf("[CONTROLLER] Connection is closed. Exit\n");
-            break;
+            return (int32_t)ret;
         } else {
-            printf("[CONTROLLER] Send <%ld> bytes: <%s>\n", (size_t)ret,
-                   buffer);
+            printf("[CONTROLLER] Send frame seq <%lu> <%zu> bytes: <%s>\n",
+                   id, len, buffer);
         }
 
         sleep(CONFIG_CTRL_PERIOD_SEC);
     }
 
+    return CLIENT_ERR_OK;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(int argc, char *argv[]) {
+    signal(SIGINT, sigint_handler);
+
+    ctrl_conf_t conf = {.rate = 0,
+                        .batch = CONFIG_CTRL_BATCH,
+                        .count = 0,
+                        .size = 0,
+                        .pacer = CTRL_PACER_TIMERFD,
+                        .p_topic = NULL};
+
+    int opt = 0;
+    while (-1 != (opt = getopt(argc, argv, OPTS))) {
+        switch (opt) {
+            case 'r':
+                conf.rate = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'b':
+                conf.batch = (size_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'n':
+                conf.count = strtoull(optarg, NULL, 10);
+                break;
+
+            case 's':
+                conf.size = (size_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                if (0 == strcmp(optarg, "spin")) {
+                    conf.pacer = CTRL_PACER_SPIN;
+                } else if (0 == strcmp(optarg, "timerfd")) {
+                    conf.pacer = CTRL_PACER_TIMERFD;
+                } else {
+                    fprintf(stderr, "[CONTROLLER] Unknown pacer <%s>\n",
+                            optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'T':
+                conf.p_topic = optarg;
+                break;
+
+            default:
+                argc = 0;
+                break;
+        }
+    }
+
+    if (((size_t)(argc - optind) != ARGS_COUNT) || (0 == conf.batch) ||
+        (conf.size > CONFIG_PROTO_PAYLOAD_MAX) ||
+        ((NULL != conf.p_topic) &&
+         (strlen(conf.p_topic) > CONFIG_TOPIC_LEN_MAX))) {
+        fprintf(stderr,
+                "\nUsage: %s [-T topic] [-r msgs/sec [-b batch] [-n count] "
+                "[-s size] [-t timerfd|spin]] <host> <port>\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int32_t ret = client_connect(argv[optind + ARGS_IDX_HOST],
+                                 argv[optind + ARGS_IDX_PORT], &g_socket_fd);
+    if (CLIENT_ERR_OK != ret) {
+        printf("[CONTROLLER] Cannot connect to server. Error <%d> Exit\n", ret);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("[CONTROLLER] Connected to server. Press Ctr+C for exit\n");
+
+    ret = client_hello(g_socket_fd, PROTO_ROLE_PUB, NULL, 0);
+    if (CLIENT_ERR_OK != ret) {
+        printf("[CONTROLLER] Cannot send hello. Error <%d> Exit\n", ret);
+        exit(EXIT_FAILURE);
+    }
+
+    if (0 == conf.rate) {
+        ret = ctrl_run_periodic(&conf);
+    } else {
+        ret = ctrl_run_paced(&conf);
+    }
+
     client_disconnect(&g_socket_fd);
 
-    exit(EXIT_SUCCESS);
+    exit((CLIENT_ERR_OK == ret) ? EXIT_SUCCESS : EXIT_FAILURE);
 }
 
 /******************************************************************************
@@ -42,35 +42,154 @@
  * INCLUDES
  ******************************************************************************/
 
+// NOTE: struct ucred of SO_PEERCRED
+#define _GNU_SOURCE
+
+#include <assert.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
+#include <sched.h>
+#include <signal.h>
 #include <server.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "common.h"
 #include "config.h"
+#include "history.h"
+#include "journal.h"
+#include "mcast.h"
+#include "log.h"
+#include "metrics.h"
+#include "msg.h"
+#include "pool.h"
+#include "proto.h"
+#include "ring.h"
+#include "topic.h"
+#include "twheel.h"
 
 /******************************************************************************
  * DEFINES, CONSTS, ENUMS
  ******************************************************************************/
 
+#define OPTS "a:b:g:i:k:l:s:p:u:v:H:I:K:t:j:h" /**< Command line options */
+
+#define CLIENT_EVENTS (SERVER_EV_READ | SERVER_EV_DATA) /**< Client interest */
+/** Interest of subscriber-only client: reactor reports hangup only */
+#define CLIENT_EVENTS_SUB ((uint32_t)0)
+
+/** Reactor data of listener, never matches client ID */
+#define SHARD_ID_LISTEN ((uint64_t)UINT64_MAX)
+/** Reactor data of inbox eventfd, never matches client ID */
+#define SHARD_ID_WAKE ((uint64_t)UINT64_MAX - 1u)
+/** Reactor data of unix socket listener, never matches client ID */
+#define SHARD_ID_LISTEN_UNIX ((uint64_t)UINT64_MAX - 2u)
+/** No client slot, e.g. sender of message from other shard */
+#define SHARD_SLOT_NONE ((uint32_t)UINT32_MAX)
+
+/** Client flags kept until stale list entries are consumed */
+#define CLIENT_F_LISTED (SERVER_CLIENT_F_DIRTY | SERVER_CLIENT_F_READ)
+
 /******************************************************************************
  * PRIVATE TYPES
  ******************************************************************************/
 
+/** Event loop statistics of shard */
+typedef struct shard_stats_s {
+    uint64_t loops;       /**< Event loop iterations */
+    uint64_t wakeups;     /**< Iterations with ready events */
+    uint64_t msgs;        /**< Messages received from clients */
+    uint64_t msgs_max;    /**< Max messages received in one iteration */
+    uint64_t budget_hits; /**< Reads stopped by fairness budget */
+    uint64_t accepts;     /**< Accepted connections */
+    uint64_t rejects;     /**< Connections closed by admission limit */
+    uint64_t throttles;   /**< Accept batches stopped by admission limit */
+    uint64_t accept_ms;   /**< Sum of accept queue latencies */
+    uint32_t accept_max_ms;  /**< Max accept queue latency */
+    uint32_t accept_queue;   /**< Max accept queue length */
+    uint64_t timeouts;       /**< Clients closed by idle timeout */
+    uint64_t heartbeats;     /**< Heartbeats sent */
+} shard_stats_t;
+
+/** Shard - one reactor thread with own listener and clients */
+typedef struct shard_s {
+    size_t idx;                 /**< Shard index */
+    pthread_t thread;           /**< Shard thread */
+    server_handle_t handle;     /**< Own SO_REUSEPORT listener */
+    server_reactor_t reactor;   /**< Own reactor */
+    server_table_t clients;     /**< Connection table */
+    server_send_t *p_sends;     /**< Flush batch */
+    struct iovec *p_iovs;       /**< iovecs of flush batch */
+    uint8_t *p_recv;            /**< Receive buffer shared by clients */
+    proto_parser_t parser;      /**< Parser of clients without partial frame */
+    uint32_t *p_dirty;          /**< Slots with queued data to flush */
+    size_t dirty_count;         /**< Count of clients to flush */
+    uint32_t *p_pending;        /**< Slots with unread data */
+    size_t pending_count;       /**< Count of clients with unread data */
+    uint32_t *p_shm_wait;       /**< Slots with full shared memory ring */
+    size_t shm_wait_count;      /**< Count of clients with full ring */
+    ring_mpsc_t inbox;          /**< Messages published by other shards */
+    int wake_fd;                /**< eventfd to wake reactor on inbox push */
+    atomic_bool wake_pending;   /**< Wakeup already signaled */
+    uint64_t drops;             /**< Slow clients: dropped messages */
+    uint64_t conflations;       /**< Slow clients: conflated messages */
+    uint64_t slow_closes;       /**< Slow clients: disconnects */
+    shard_stats_t stats;        /**< Event loop statistics */
+    shard_stats_t stats_last;   /**< Statistics at last report */
+    uint64_t report_ms;         /**< Time of next statistics report */
+    uint64_t overflows;         /**< Host listen overflows at last report */
+    size_t pool_objects;        /**< Pool objects at last report */
+    uint64_t admit_tokens;      /**< Admission bucket, 1000 per connection */
+    uint64_t admit_ms;          /**< Time of last admission bucket refill */
+    bool accept_pending;        /**< Backlog may have more connections */
+    bool accept_paused;         /**< Listener is not watched until token */
+    metrics_shard_t *p_metrics; /**< Own block of shared metrics */
+    topic_index_t topics;       /**< Subscriptions of own clients by slot */
+    history_t history;          /**< Last messages for late joiners */
+    twheel_t timers;            /**< Idle and heartbeat timers of clients */
+    msg_t *p_ping;              /**< Heartbeat frame shared by clients */
+    uint64_t now_ms;            /**< Loop clock, read once per iteration */
+} shard_t;
+
 /******************************************************************************
  * PRIVATE DATA
  ******************************************************************************/
 
+static shard_t *g_p_shards = NULL; /**< All shards */
+static size_t g_shards_count = 0;  /**< Count of shards */
+static metrics_t *g_p_metrics = NULL; /**< Shared metrics segment */
+static uint16_t g_port = CONFIG_SRV_PORT; /**< Listening port */
+static journal_t g_journal; /**< Journal storage */
+static journal_t *g_p_journal = NULL; /**< Journal, NULL - disabled */
+static char g_unix_path[SERVER_UNIX_PATH_SIZE]; /**< Unix socket listener */
+static mcast_t g_mcast; /**< Multicast publisher */
+static mcast_t *g_p_mcast = NULL; /**< Multicast, NULL - disabled */
+static atomic_bool g_running = true; /**< Cleared by SIGINT / SIGTERM */
+static atomic_uint_fast64_t g_seq; /**< Server sequence of next data frame */
+
+/** Parsers of clients with a frame split between reads */
+static pool_t g_rx_pool = POOL_INITIALIZER("rx", sizeof(proto_parser_t));
+
+/** Rare client state: shared memory ring and replay position */
+static pool_t g_ext_pool =
+    POOL_INITIALIZER("client_ext", sizeof(server_client_ext_t));
+
 /******************************************************************************
  * PUBLIC DATA
  ******************************************************************************/
@@ -87,165 +206,2205 @@
  * PRIVATE FUNCTION PROTOTYPES
  ******************************************************************************/
 
+static void sigterm_handler(int sig);
+static uint32_t client_interest(const server_client_t *p_client);
+static void client_close(shard_t *p_shard, uint32_t slot);
+static void client_add(shard_t *p_shard, const server_client_t *p_client);
+static bool server_admit(shard_t *p_shard);
+static int server_admit_wait_ms(const shard_t *p_shard);
+static void client_accepted(shard_t *p_shard, const server_client_t *p_client);
+static void server_listen_watch(shard_t *p_shard, uint32_t events);
+static void server_accept_batch(shard_t *p_shard);
+static server_client_ext_t *client_ext(server_client_t *p_client);
+static shmq_t *client_shm(const server_client_t *p_client);
+static void client_enqueue(shard_t *p_shard, uint32_t slot, msg_t *p_msg);
+static void client_writable(shard_t *p_shard, uint32_t slot);
+static void client_timer_arm(shard_t *p_shard, uint32_t slot);
+static void client_timer(shard_t *p_shard, uint32_t slot);
+static void server_timers(shard_t *p_shard);
+static void client_replay_fill(shard_t *p_shard, uint32_t slot);
+static void client_replay_start(shard_t *p_shard, uint32_t slot, uint64_t seq);
+static void server_fanout(shard_t *p_shard, uint32_t sender, msg_t *p_msg);
+static void client_shm_flush(shard_t *p_shard, uint32_t slot, uint64_t now);
+static void server_flush(shard_t *p_shard);
+static void server_publish(shard_t *p_shard, msg_t *p_msg);
+static void client_subscription(shard_t *p_shard, uint32_t slot,
+                                const proto_frame_t *p_frame);
+static bool client_shm_owner(int socket_fd, uid_t *p_owner);
+static void client_shm_attach(shard_t *p_shard, uint32_t slot,
+                              const proto_frame_t *p_frame);
+static void client_nack(shard_t *p_shard, uint32_t slot,
+                        const proto_frame_t *p_frame);
+static int32_t client_hello(shard_t *p_shard, uint32_t slot,
+                            const proto_frame_t *p_frame);
+static void server_inbox_drain(shard_t *p_shard);
+static void client_rx_park(shard_t *p_shard, uint32_t slot);
+static void server_client_data(shard_t *p_shard, uint32_t slot,
+                               const void *p_buf, size_t len);
+static void server_client_read(shard_t *p_shard, uint32_t slot);
+static void server_pending_read(shard_t *p_shard);
+static uint64_t server_now_ms(void);
+static void server_journal_restore(size_t count);
+static int server_stats_report(shard_t *p_shard);
+static int32_t shard_init(shard_t *p_shard, size_t idx,
+                          const server_conf_t *p_conf);
+static void *shard_thread(void *p_arg);
+static void server_run(shard_t *p_shard);
+static void shard_wake(shard_t *p_shard);
+static void server_stop(size_t shards);
+
 /******************************************************************************
  * PRIVATE FUNCTIONS
  ******************************************************************************/
 
-void client_data_handler(int in_sock_fd, int out_sock_fd) {
-    char buf[1024];
-    int count = 0;
-    char ping[] = "ping";
+/**
+ * @brief SIGINT / SIGTERM handler. Only stops event loops, main thread shuts
+ * the server down
+ *
+ * @param sig received signal
+ */
+static void sigterm_handler(int sig) {
+    (void)sig;
+
+    atomic_store(&g_running, false);
+}
+
+/**
+ * @brief Get reactor interest of client by its roles
+ *
+ * @param p_client pointer to client
+ * @return uint32_t mask of SERVER_EV_*
+ */
+static uint32_t client_interest(const server_client_t *p_client) {
+    const uint32_t roles =
+        p_client->flags & (SERVER_CLIENT_F_PUB | SERVER_CLIENT_F_SUB);
+
+    // NOTE: multicast subscriber is read for its nack frames
+    return ((SERVER_CLIENT_F_SUB == roles) &&
+            (0 == (p_client->flags & SERVER_CLIENT_F_MCAST)))
+               ? CLIENT_EVENTS_SUB
+               : CLIENT_EVENTS;
+}
+
+/**
+ * @brief Get rare state of client, allocating it on first use
+ *
+ * @param p_client pointer to client
+ * @return server_client_ext_t* state or NULL if no memory
+ */
+static server_client_ext_t *client_ext(server_client_t *p_client) {
+    if (NULL == p_client->p_ext) {
+        p_client->p_ext = pool_alloc(&g_ext_pool);
+        if (NULL != p_client->p_ext) {
+            memset(p_client->p_ext, 0x00, sizeof(server_client_ext_t));
+        }
+    }
+
+    return p_client->p_ext;
+}
+
+/**
+ * @brief Get shared memory ring of client
+ *
+ * @param p_client pointer to client
+ * @return shmq_t* ring or NULL if client is served via socket
+ */
+static shmq_t *client_shm(const server_client_t *p_client) {
+    return (NULL != p_client->p_ext) ? p_client->p_ext->p_shm : NULL;
+}
+
+/**
+ * @brief Close client connection and remove it from reactor
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_close(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const int fd = p_client->socket_fd;
+
+    if (p_client->drops > 0) {
+        LOG_WARN("[SERVER] Socket fd <%d> dropped <%u> messages", fd,
+                 p_client->drops);
+    }
+
+    twheel_cancel(&p_shard->timers, &p_client->timer);
+    server_reactor_del(&p_shard->reactor, fd);
+    close(fd);
+    topic_unsubscribe_all(&p_shard->topics, slot);
+    metrics_sub(&p_shard->p_metrics->queued, p_client->outq.count);
+    metrics_sub(&p_shard->p_metrics->conns, 1);
+    metrics_sub(&p_shard->p_metrics->pubs,
+                (p_client->flags & SERVER_CLIENT_F_PUB) ? 1u : 0u);
+    metrics_sub(&p_shard->p_metrics->subs,
+                (p_client->flags & SERVER_CLIENT_F_SUB) ? 1u : 0u);
+    metrics_add(&p_shard->p_metrics->closes, 1);
+    server_outq_clear(&p_client->outq);
+    if (NULL != p_client->p_rx) {
+        proto_parser_deinit(p_client->p_rx);
+        pool_free(&g_rx_pool, p_client->p_rx);
+        p_client->p_rx = NULL;
+    }
+    if (NULL != client_shm(p_client)) {
+        shmq_close(p_client->p_ext->p_shm);
+        free(p_client->p_ext->p_shm);
+    }
+    pool_free(&g_ext_pool, p_client->p_ext);
+    p_client->p_ext = NULL;
+    p_client->flags &= CLIENT_F_LISTED;
+    p_client->drops = 0;
+    server_table_remove(&p_shard->clients, slot);
+}
+
+/**
+ * @brief Queue message to client applying slow client policy
+ *
+ * With keyed policy every queued data frame is indexed by topic. Above the
+ * backlog threshold a new frame replaces the pending one of its topic, so a
+ * lagging client gets the last value of every topic and no stale ones.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_msg message
+ */
+static void client_enqueue(shard_t *p_shard, uint32_t slot, msg_t *p_msg) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    server_outq_t *p_outq = &p_client->outq;
+    metrics_shard_t *p_metrics = p_shard->p_metrics;
+    const uint32_t queued = p_outq->count;
+    const server_conf_t *p_conf = &p_shard->handle.conf;
+    p_client->tx_ms = (uint32_t)p_shard->now_ms;
+    proto_hdr_t hdr = {0};
+    uint32_t key = 0;
+    int32_t ret = SERVER_ERR_OK;
+
+    if (SERVER_SLOW_KEYED == p_conf->slow_policy) {
+        proto_hdr_decode(p_msg->data, &hdr);
+        key = topic_hash(&p_msg->data[PROTO_HDR_SIZE], PROTO_TOPIC_LEN(&hdr));
+    }
+
+    if (PROTO_TYPE_DATA != hdr.type) {
+        ret = server_outq_push(p_outq, p_msg);
+    } else if ((p_outq->count >= p_conf->keyed_backlog) &&
+               (SERVER_ERR_OK == server_outq_replace_key(p_outq, p_msg, key))) {
+        p_shard->conflations++;
+        metrics_add(&p_metrics->conflations, 1);
+        p_client->drops++;
+    } else {
+        ret = server_outq_push_key(p_outq, p_msg, key);
+    }
+
+    if (SERVER_ERR_FULL == ret) {
+        switch (p_shard->handle.conf.slow_policy) {
+            case SERVER_SLOW_DISCONNECT:
+                p_shard->slow_closes++;
+                metrics_add(&p_metrics->slow_closes, 1);
+                LOG_WARN("[SERVER] Slow client on socket fd <%d>. Disconnect",
+                         p_client->socket_fd);
+                client_close(p_shard, slot);
+                return;
+
+            case SERVER_SLOW_CONFLATE:
+                ret = server_outq_replace_newest(p_outq, p_msg);
+                p_shard->conflations++;
+                metrics_add(&p_metrics->conflations, 1);
+                break;
 
-    ssize_t ret = 1;
-    while (ret > 0) {
-        printf("send ping \n");
+            case SERVER_SLOW_KEYED:
+                server_outq_drop_oldest(p_outq);
+                ret = (PROTO_TYPE_DATA == hdr.type)
+                          ? server_outq_push_key(p_outq, p_msg, key)
+                          : server_outq_push(p_outq, p_msg);
+                p_shard->drops++;
+                metrics_add(&p_metrics->drops, 1);
+                break;
 
-        ret = send(out_sock_fd, ping, 4, MSG_NOSIGNAL);
-        if (-1 == ret) {
-            close(out_sock_fd);
+            case SERVER_SLOW_DROP_OLDEST:
+            default:
+                server_outq_drop_oldest(p_outq);
+                ret = server_outq_push(p_outq, p_msg);
+                p_shard->drops++;
+                metrics_add(&p_metrics->drops, 1);
+                break;
         }
 
-        sleep(5);
+        p_client->drops++;
+    }
+
+    if (SERVER_ERR_OK != ret) {
+        LOG_ERROR("[SERVER] Error: cannot queue to socket fd <%d>",
+                  p_client->socket_fd);
+        return;
+    }
+
+    // NOTE: full queue keeps its size - one frame out, one in
+    metrics_add(&p_metrics->queued, p_outq->count - queued);
+
+    if (0 == (p_client->flags & SERVER_CLIENT_F_DIRTY)) {
+        p_client->flags |= SERVER_CLIENT_F_DIRTY;
+        p_shard->p_dirty[p_shard->dirty_count++] = slot;
+    }
+}
+
+/**
+ * @brief Client socket became writable: drop write interest and flush
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_writable(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+
+    if (p_client->flags & SERVER_CLIENT_F_WRITE) {
+        p_client->flags &= ~SERVER_CLIENT_F_WRITE;
+        server_reactor_mod(&p_shard->reactor, p_client->socket_fd,
+                           client_interest(p_client), p_client->id);
+    }
+
+    if (p_client->flags & SERVER_CLIENT_F_REPLAY) {
+        client_replay_fill(p_shard, slot);
+    }
+
+    if (0 == (p_client->flags & SERVER_CLIENT_F_DIRTY)) {
+        p_client->flags |= SERVER_CLIENT_F_DIRTY;
+        p_shard->p_dirty[p_shard->dirty_count++] = slot;
+    }
+}
+
+/**
+ * @brief Arm client timer for its nearest deadline
+ *
+ * Reads and queued frames only store loop time, the timer checks it when
+ * expires. So an active client costs one expiration per period, not a
+ * timer update per frame.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_timer_arm(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const server_conf_t *p_conf = &p_shard->handle.conf;
+    const uint64_t now = p_shard->now_ms;
+    uint64_t at_ms = UINT64_MAX;
+
+    // NOTE: client keeps low bits of loop clock, differences survive wrap
+    const uint64_t rx_ms = now - (uint32_t)((uint32_t)now - p_client->rx_ms);
+    const uint64_t tx_ms = now - (uint32_t)((uint32_t)now - p_client->tx_ms);
+
+    // NOTE: subscriber-only client is not read, so it is never idle
+    if ((p_conf->idle_ms > 0) &&
+        (CLIENT_EVENTS_SUB != client_interest(p_client))) {
+        at_ms = rx_ms + p_conf->idle_ms;
+    }
+
+    // NOTE: shared memory client is on the same host, its close is enough
+    if ((p_conf->heartbeat_ms > 0) &&
+        (p_client->flags & SERVER_CLIENT_F_SUB) &&
+        (NULL == client_shm(p_client)) &&
+        ((tx_ms + p_conf->heartbeat_ms) < at_ms)) {
+        at_ms = tx_ms + p_conf->heartbeat_ms;
+    }
+
+    if (UINT64_MAX != at_ms) {
+        twheel_arm(&p_shard->timers, &p_client->timer, at_ms);
     }
 }
 
-void server_run(server_handle_t *p_handle) {
-    if (NULL == p_handle) {
-        printf("[SERVER] Error params. Exit\n");
+/**
+ * @brief Client timer expired: close idle client or send heartbeat
+ *
+ * Heartbeat makes the kernel probe a silent subscriber: a dead peer does
+ * not ack it and the connection is reset after TCP_USER_TIMEOUT.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_timer(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const server_conf_t *p_conf = &p_shard->handle.conf;
+    const uint32_t now = (uint32_t)p_shard->now_ms;
+
+    if ((p_conf->idle_ms > 0) &&
+        (CLIENT_EVENTS_SUB != client_interest(p_client)) &&
+        ((uint32_t)(now - p_client->rx_ms) >= p_conf->idle_ms)) {
+        LOG_INFO("[SERVER] Socket fd <%d> idle for <%u> ms. Disconnect",
+                 p_client->socket_fd, (uint32_t)(now - p_client->rx_ms));
+        p_shard->stats.timeouts++;
+        client_close(p_shard, slot);
         return;
     }
 
-    const int OPEN_MAX = server_max_clients();
-    struct pollfd clients[OPEN_MAX];
+    if ((p_conf->heartbeat_ms > 0) &&
+        ((uint32_t)(now - p_client->tx_ms) >= p_conf->heartbeat_ms)) {
+        // NOTE: pending frames probe the peer the same way
+        if (p_client->outq.count > 0) {
+            p_client->tx_ms = now;
+        } else if ((p_client->flags & SERVER_CLIENT_F_SUB) &&
+                   (NULL == client_shm(p_client))) {
+            p_shard->stats.heartbeats++;
+            client_enqueue(p_shard, slot, p_shard->p_ping);
+            if (COMMON_SOCKET_ERR == p_client->socket_fd) {
+                return;
+            }
+        }
+    }
+
+    client_timer_arm(p_shard, slot);
+}
 
-    printf("[SERVER] Max connections is <%d>\n", OPEN_MAX);
+/**
+ * @brief Take due client timers of this loop iteration
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_timers(shard_t *p_shard) {
+    twheel_node_t *p_node = NULL;
 
-    for (size_t idx = 0; idx < OPEN_MAX; idx++) {
-        clients[idx].fd = COMMON_SOCKET_ERR;
+    twheel_advance(&p_shard->timers, p_shard->now_ms);
+    while (NULL != (p_node = twheel_pop(&p_shard->timers))) {
+        const server_client_t *p_client =
+            (const server_client_t *)((uint8_t *)p_node -
+                                      offsetof(server_client_t, timer));
+        client_timer(p_shard,
+                     (uint32_t)(p_client - p_shard->clients.p_slots));
     }
+}
 
-    clients[0].fd = p_handle->socket_fd;
-    clients[0].events = POLLIN | POLLERR | POLLOUT;
+/**
+ * @brief Queue next part of history to replaying client
+ *
+ * Only free space of outbound queue is filled, the rest waits until client
+ * becomes writable, so a long replay takes one queue per loop iteration and
+ * never delays live fanout to others. Client reaching the newest message
+ * leaves replay and gets live fanout from then on.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_replay_fill(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    server_client_ext_t *p_ext = p_client->p_ext;
+    const history_t *p_history = &p_shard->history;
+    server_outq_t *p_outq = &p_client->outq;
+    const uint32_t queued = p_outq->count;
 
-    size_t peak_idx = 0;
+    // NOTE: messages overwritten while client was behind are lost for it
+    if (p_ext->replay_pos < p_history->tail) {
+        p_client->drops += (uint32_t)(p_history->tail - p_ext->replay_pos);
+        p_ext->replay_pos = p_history->tail;
+    }
 
-    while (true) {
-        int count_ready = poll(clients, peak_idx + 1, -1);
+    while ((p_ext->replay_pos < p_history->head) &&
+           (p_outq->count < CONFIG_SRV_OUTQ_SIZE)) {
+        const history_entry_t *p_entry =
+            history_get(p_history, p_ext->replay_pos++);
+        if (p_entry->seq < p_ext->replay_seq) {
+            continue;
+        }
 
-        // NOTE: If no no new events, just rerun from start
-        if (count_ready <= 0) {
+        proto_hdr_t hdr;
+        proto_hdr_decode(p_entry->p_msg->data, &hdr);
+        if (!topic_sub_matches(&p_shard->topics, slot,
+                               &p_entry->p_msg->data[PROTO_HDR_SIZE],
+                               PROTO_TOPIC_LEN(&hdr))) {
             continue;
         }
 
-        // Check the new connection
-        if (clients[0].revents & POLLIN) {
-            printf("[SERVER] New connection\n");
+        if (SERVER_ERR_OK != server_outq_push(p_outq, p_entry->p_msg)) {
+            LOG_ERROR("[SERVER] Error: cannot queue to socket fd <%d>",
+                      p_client->socket_fd);
+            break;
+        }
+    }
 
-            server_client_t client;
-            int ret = server_accept(p_handle, &client);
-            if (SERVER_ERR_OK != ret) {
-                printf("[SERVER] Error during accept connection\n");
-                continue;
-            }
+    metrics_add(&p_shard->p_metrics->queued, p_outq->count - queued);
 
-            size_t idx = 0;
-            for (idx = 1; idx < OPEN_MAX; idx++) {
-                if (clients[idx].fd < 0) {
-                    clients[idx].fd = client.socket_fd;
-                    clients[idx].events = POLLIN | POLLERR | POLLOUT;
-                    break;
-                }
+    if (p_ext->replay_pos == p_history->head) {
+        p_client->flags &= ~SERVER_CLIENT_F_REPLAY;
+        LOG_DEBUG("[SERVER] Socket fd <%d> replay done",
+                  p_client->socket_fd);
+    }
+
+    if ((p_outq->count > 0) &&
+        (0 == (p_client->flags & SERVER_CLIENT_F_DIRTY))) {
+        p_client->flags |= SERVER_CLIENT_F_DIRTY;
+        p_shard->p_dirty[p_shard->dirty_count++] = slot;
+    }
+}
+
+/**
+ * @brief Start replay of retained messages to subscriber
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param seq replay messages with sequence number not less than this
+ */
+static void client_replay_start(shard_t *p_shard, uint32_t slot, uint64_t seq) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    history_t *p_history = &p_shard->history;
+
+    if (!history_enabled(p_history)) {
+        LOG_WARN("[SERVER] Replay for socket fd <%d>: history is disabled",
+                 p_client->socket_fd);
+        return;
+    }
+
+    history_expire(p_history, proto_ts_now());
+
+    LOG_INFO("[SERVER] Socket fd <%d> replay from seq <%lu>, <%lu> messages "
+             "retained",
+             p_client->socket_fd, seq, p_history->head - p_history->tail);
+
+    server_client_ext_t *p_ext = client_ext(p_client);
+    if (NULL == p_ext) {
+        LOG_ERROR("[SERVER] Error: no memory for replay");
+        return;
+    }
+
+    p_client->flags |= SERVER_CLIENT_F_REPLAY;
+    p_ext->replay_pos = p_history->tail;
+    p_ext->replay_seq = seq;
+    client_replay_fill(p_shard, slot);
+}
+
+/**
+ * @brief Register accepted client in shard
+ *
+ * @param p_shard pointer to shard
+ * @param p_client pointer to accepted client
+ */
+static void client_add(shard_t *p_shard, const server_client_t *p_client) {
+    const int fd = p_client->socket_fd;
+
+    // NOTE: fanout writes are small - Nagle would hold them for ACK
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    // NOTE: with heartbeats only - peer not acking them or data that long is
+    // dead, kernel resets the connection and reactor reports the hangup
+    const server_conf_t *p_conf = &p_shard->handle.conf;
+    unsigned int user_timeout_ms =
+        p_conf->heartbeat_ms * CONFIG_SRV_HEARTBEAT_MISSES;
+    if (user_timeout_ms > 0) {
+        setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &user_timeout_ms,
+                   sizeof(user_timeout_ms));
+    }
+
+    server_client_t *p_added = server_table_add(&p_shard->clients, p_client);
+    if (NULL == p_added) {
+        LOG_ERROR("[SERVER] Error: too many clients");
+        close(fd);
+        return;
+    }
+
+    int32_t ret =
+        server_reactor_add(&p_shard->reactor, fd, CLIENT_EVENTS, p_added->id);
+    if (SERVER_ERR_OK != ret) {
+        LOG_ERROR("[SERVER] Error: cannot watch socket fd <%d>", fd);
+        server_table_remove(&p_shard->clients, SERVER_ID_SLOT(p_added->id));
+        close(fd);
+        return;
+    }
+
+    // NOTE: until hello client has both roles and gets everything until it
+    // subscribes to a topic
+    p_added->flags |= SERVER_CLIENT_F_PUB | SERVER_CLIENT_F_SUB;
+    topic_subscribe(&p_shard->topics, SERVER_ID_SLOT(p_added->id), "*", 1);
+    metrics_add(&p_shard->p_metrics->conns, 1);
+    metrics_add(&p_shard->p_metrics->pubs, 1);
+    metrics_add(&p_shard->p_metrics->subs, 1);
+
+    // NOTE: accepted client is a copy, its timer is not linked anywhere
+    memset(&p_added->timer, 0x00, sizeof(twheel_node_t));
+    p_added->rx_ms = (uint32_t)p_shard->now_ms;
+    p_added->tx_ms = (uint32_t)p_shard->now_ms;
+    client_timer_arm(p_shard, SERVER_ID_SLOT(p_added->id));
+
+    LOG_INFO("[SERVER] New connection on shard <%zu>. Socket fd <%d> id <%lx>",
+             p_shard->idx, fd, p_added->id);
+}
+
+/**
+ * @brief Take admission token for one new connection
+ *
+ * Token bucket refilled with accept_rate tokens per second, burst is one
+ * second of tokens.
+ *
+ * @param p_shard pointer to shard
+ * @return bool true if connection may be admitted
+ */
+static bool server_admit(shard_t *p_shard) {
+    const uint64_t rate = p_shard->handle.conf.accept_rate;
+    if (0 == rate) {
+        return true;
+    }
+
+    const uint64_t now = server_now_ms();
+    p_shard->admit_tokens += (now - p_shard->admit_ms) * rate;
+    p_shard->admit_ms = now;
+    if (p_shard->admit_tokens > (rate * 1000u)) {
+        p_shard->admit_tokens = rate * 1000u;
+    }
+
+    if (p_shard->admit_tokens < 1000u) {
+        return false;
+    }
+
+    p_shard->admit_tokens -= 1000u;
+    return true;
+}
+
+/**
+ * @brief Get time until next admission token
+ *
+ * @param p_shard pointer to shard
+ * @return int time in milliseconds
+ */
+static int server_admit_wait_ms(const shard_t *p_shard) {
+    const uint64_t rate = p_shard->handle.conf.accept_rate;
+    if ((0 == rate) || (p_shard->admit_tokens >= 1000u)) {
+        return 0;
+    }
+
+    return (int)((1000u - p_shard->admit_tokens + rate - 1u) / rate);
+}
+
+/**
+ * @brief Account accepted connection and register it
+ *
+ * @param p_shard pointer to shard
+ * @param p_client pointer to accepted client
+ */
+static void client_accepted(shard_t *p_shard, const server_client_t *p_client) {
+    uint32_t age_ms = 0;
+
+    if (SERVER_ERR_OK == server_client_age(p_client->socket_fd, &age_ms)) {
+        p_shard->stats.accept_ms += age_ms;
+        if (age_ms > p_shard->stats.accept_max_ms) {
+            p_shard->stats.accept_max_ms = age_ms;
+        }
+    }
+
+    p_shard->stats.accepts++;
+    metrics_add(&p_shard->p_metrics->accepts, 1);
+    client_add(p_shard, p_client);
+}
+
+/**
+ * @brief Set reactor interest of all listeners of shard
+ *
+ * @param p_shard pointer to shard
+ * @param events mask of SERVER_EV_*, 0 - not watched
+ */
+static void server_listen_watch(shard_t *p_shard, uint32_t events) {
+    server_reactor_mod(&p_shard->reactor, p_shard->handle.socket_fd, events,
+                       SHARD_ID_LISTEN);
+    if (COMMON_SOCKET_ERR != p_shard->handle.unix_fd) {
+        server_reactor_mod(&p_shard->reactor, p_shard->handle.unix_fd, events,
+                           SHARD_ID_LISTEN_UNIX);
+    }
+}
+
+/**
+ * @brief Accept batch of pending connections under admission limit
+ *
+ * Connections over batch or admission limit stay in kernel backlog, so
+ * established clients keep being served during connection storm.
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_accept_batch(shard_t *p_shard) {
+    uint32_t queued = 0;
+    uint32_t backlog = 0;
+
+    if ((SERVER_ERR_OK ==
+         server_listen_queue(&p_shard->handle, &queued, &backlog)) &&
+        (queued > p_shard->stats.accept_queue)) {
+        p_shard->stats.accept_queue = queued;
+    }
+
+    p_shard->accept_pending = false;
+
+    for (size_t count = 0; count < CONFIG_SRV_ACCEPT_BATCH; count++) {
+        if (!server_admit(p_shard)) {
+            // NOTE: level-triggered backend would report listener on every
+            // wait, so it is not watched until next token
+            if (!p_shard->accept_paused) {
+                p_shard->accept_paused = true;
+                server_listen_watch(p_shard, 0);
             }
 
-            if (OPEN_MAX == idx) {
-                fprintf(stderr, "[SERVER] Error: too many clients\n");
-                close(client.socket_fd);
-            } else {
-                if (idx > peak_idx) {
-                    peak_idx = idx;
-                }
+            p_shard->stats.throttles++;
+            p_shard->accept_pending = true;
+            return;
+        }
+
+        if (p_shard->accept_paused) {
+            p_shard->accept_paused = false;
+            server_listen_watch(p_shard, SERVER_EV_READ | SERVER_EV_ACCEPT);
+        }
+
+        server_client_t client;
+        int32_t ret = server_accept(&p_shard->handle, &client);
+        if (SERVER_ERR_OK != ret) {
+            // NOTE: token was not used
+            if (0 != p_shard->handle.conf.accept_rate) {
+                p_shard->admit_tokens += 1000u;
             }
 
-            --count_ready;
+            if (SERVER_ERR_AGAIN != ret) {
+                LOG_ERROR("[SERVER] Error during accept connection");
+            }
+            return;
         }
 
-        if (count_ready <= 0) {
+        client_accepted(p_shard, &client);
+    }
+
+    // NOTE: edge-triggered reactor will not report the rest of backlog
+    p_shard->accept_pending = true;
+}
+
+/**
+ * @brief Queue message to clients of shard subscribed to its topic
+ *
+ * @param p_shard pointer to shard
+ * @param sender slot of sender or SHARD_SLOT_NONE
+ * @param p_msg message, whole data frame. Every queue takes own reference
+ */
+static void server_fanout(shard_t *p_shard, uint32_t sender, msg_t *p_msg) {
+    server_table_t *p_table = &p_shard->clients;
+    proto_hdr_t hdr;
+    const uint32_t *p_subs = NULL;
+
+    // NOTE: shard 0 gets every message once, so it feeds the group
+    if ((NULL != g_p_mcast) && (0 == p_shard->idx)) {
+        mcast_publish(g_p_mcast, p_msg);
+    }
+
+    // NOTE: topic was validated by receiving shard
+    proto_hdr_decode(p_msg->data, &hdr);
+    history_push(&p_shard->history, p_msg, p_msg->seq);
+    size_t count = topic_match(&p_shard->topics, &p_msg->data[PROTO_HDR_SIZE],
+                               PROTO_TOPIC_LEN(&hdr), &p_subs);
+
+    // NOTE: match is a copy - disconnect of a client does not change it
+    for (size_t idx = 0; idx < count; idx++) {
+        const uint32_t slot = p_subs[idx];
+        // NOTE: replaying client takes the message from history in order,
+        // multicast one - from the group
+        if ((slot == sender) ||
+            (COMMON_SOCKET_ERR == p_table->p_slots[slot].socket_fd) ||
+            (p_table->p_slots[slot].flags &
+             (SERVER_CLIENT_F_REPLAY | SERVER_CLIENT_F_MCAST))) {
             continue;
         }
 
-        char buffer[CONFIG_BUFFER_SIZE];
-        ssize_t ret = 0;
-        bool is_new_message = false;
-        bool ignore_idx = 0;
+        client_enqueue(p_shard, slot, p_msg);
+    }
+}
 
-        for (size_t idx = 0; idx <= peak_idx; idx++) {
-            if (COMMON_SOCKET_ERR == clients[idx].fd) {
-                continue;
-            }
+/**
+ * @brief Copy queued frames of client to its shared memory ring
+ *
+ * No syscall is made unless the client sleeps on the ring. Frames which do
+ * not fit stay queued and are retried on the next flush, so slow client
+ * policy applies to ring clients the same way as to socket ones.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param now flush time
+ */
+static void client_shm_flush(shard_t *p_shard, uint32_t slot, uint64_t now) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    server_outq_t *p_outq = &p_client->outq;
+    metrics_shard_t *p_metrics = p_shard->p_metrics;
+    const uint32_t queued = p_outq->count;
+    uint64_t bytes = 0;
 
-            if (clients[idx].revents & (POLLIN | POLLERR | POLLOUT)) {
-                ret = recv(clients[idx].fd, buffer, CONFIG_BUFFER_SIZE,
-                           MSG_NOSIGNAL | MSG_DONTWAIT);
-
-                if (COMMON_SOCKET_ERR == ret) {
-                    // printf("[SERVER] Error: cannot read from socket fd
-                    // <%d>\n", clients[idx].fd); close(clients[idx].fd);
-                    // clients[idx].fd = COMMON_SOCKET_ERR;
-                } else if (COMMON_SOCKET_CLOSED == ret) {
-                    printf("[SERVER] Connection closed for socket fd <%d>\n",
-                           clients[idx].fd);
-                    close(clients[idx].fd);
-                    clients[idx].fd = COMMON_SOCKET_ERR;
-                } else if ((ret > 0)) {
-                    printf(
-                        "[SERVER] Receive <%u> bytes from controller. "
-                        "Retranslate it\n",
-                        (size_t)ret);
-                    is_new_message = true;
-                    ignore_idx = idx;
-                    break;
-                }
-            }
+    while (p_outq->count > 0) {
+        const msg_t *p_head = server_outq_head(p_outq);
+        const size_t len = p_head->len - p_outq->sent;
+
+        // NOTE: socket may have sent a part of head before ring was mapped
+        if (!shmq_write(p_client->p_ext->p_shm, &p_head->data[p_outq->sent],
+                        len)) {
+            break;
         }
 
-        if (is_new_message) {
-            for (size_t idx = 1; idx <= peak_idx; idx++) {
-                if (idx == ignore_idx) {
-                    continue;
-                }
+        if ((0 == p_outq->sent) && (now >= p_head->ts)) {
+            hist_record(&p_metrics->queue_wait, now - p_head->ts);
+        }
 
-                ret = send(clients[idx].fd, buffer, (size_t)ret, MSG_NOSIGNAL);
-                if (COMMON_SOCKET_ERR == ret) {
-                    printf("[SERVER] Error: cannot read from socket fd <%d>\n",
-                           clients[idx].fd);
-                    close(clients[idx].fd);
-                    clients[idx].fd = COMMON_SOCKET_ERR;
-                } else if (COMMON_SOCKET_CLOSED == ret) {
-                    printf("[SERVER] Connection closed for socket fd <%d>\n",
-                           clients[idx].fd);
-                    close(clients[idx].fd);
-                    clients[idx].fd = COMMON_SOCKET_ERR;
-                }
-            }
+        server_outq_consume(p_outq, len);
+        bytes += len;
+    }
+
+    if (bytes > 0) {
+        shmq_notify(p_client->p_ext->p_shm);
+        metrics_add(&p_metrics->bytes_out, bytes);
+        metrics_add(&p_metrics->msgs_out, queued - p_outq->count);
+        metrics_sub(&p_metrics->queued, queued - p_outq->count);
+    }
+
+    if (p_outq->count > 0) {
+        if (0 == (p_client->flags & SERVER_CLIENT_F_SHM_WAIT)) {
+            p_client->flags |= SERVER_CLIENT_F_SHM_WAIT;
+            p_shard->p_shm_wait[p_shard->shm_wait_count++] = slot;
         }
+    } else if (p_client->flags & SERVER_CLIENT_F_REPLAY) {
+        // NOTE: socket is idle, so writability comes at once and takes
+        // next part of history on the next loop iteration
+        p_client->flags |= SERVER_CLIENT_F_WRITE;
+        server_reactor_mod(&p_shard->reactor, p_client->socket_fd,
+                           client_interest(p_client) | SERVER_EV_WRITE,
+                           p_client->id);
     }
 }
 
-/******************************************************************************
- * PUBLIC FUNCTIONS
- ******************************************************************************/
+/**
+ * @brief Send queued data of all dirty clients without blocking
+ *
+ * Clients which cannot take everything wait for writability, so a slow
+ * reader never stalls the others. Clients with shared memory ring get
+ * their frames copied to the ring instead.
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_flush(shard_t *p_shard) {
+    metrics_shard_t *p_metrics = p_shard->p_metrics;
 
-int main(int argc, char *argv[]) {
-    server_handle_t server_handle;
-    server_conf_t server_conf = {.addr = INADDR_ANY, .port = CONFIG_SRV_PORT};
+    // NOTE: clients with full ring are retried, closed ones lost the flag
+    for (size_t idx = 0; idx < p_shard->shm_wait_count; idx++) {
+        const uint32_t slot = p_shard->p_shm_wait[idx];
+        server_client_t *p_client = &p_shard->clients.p_slots[slot];
 
-    int32_t ret = server_init(&server_handle, &server_conf);
-    if (SERVER_ERR_OK != ret) {
-        printf("[SERVER] Cannot start server. Exit\n");
-        exit(EXIT_FAILURE);
+        if (0 == (p_client->flags & SERVER_CLIENT_F_SHM_WAIT)) {
+            continue;
+        }
+
+        p_client->flags &= ~SERVER_CLIENT_F_SHM_WAIT;
+        if (0 == (p_client->flags & SERVER_CLIENT_F_DIRTY)) {
+            p_client->flags |= SERVER_CLIENT_F_DIRTY;
+            p_shard->p_dirty[p_shard->dirty_count++] = slot;
+        }
     }
+    p_shard->shm_wait_count = 0;
+
+    const uint64_t now = (p_shard->dirty_count > 0) ? proto_ts_now() : 0;
+
+    // NOTE: list is used as stack, so re-added clients never overflow it
+    while (p_shard->dirty_count > 0) {
+        size_t count = 0;
+        size_t iov_used = 0;
+
+        while ((p_shard->dirty_count > 0) && (count < CONFIG_SRV_FLUSH_BATCH)) {
+            uint32_t slot = p_shard->p_dirty[--p_shard->dirty_count];
+            server_client_t *p_client = &p_shard->clients.p_slots[slot];
+
+            p_client->flags &= ~SERVER_CLIENT_F_DIRTY;
+
+            // NOTE: closed clients and full sockets are skipped
+            if ((COMMON_SOCKET_ERR == p_client->socket_fd) ||
+                (0 == p_client->outq.count) ||
+                (p_client->flags & SERVER_CLIENT_F_WRITE)) {
+                continue;
+            }
+
+            if (NULL != client_shm(p_client)) {
+                client_shm_flush(p_shard, slot, now);
+                continue;
+            }
+
+            // NOTE: only first attempt of head frame is sampled
+            const msg_t *p_head = server_outq_head(&p_client->outq);
+            if ((0 == p_client->outq.sent) && (now >= p_head->ts)) {
+                hist_record(&p_metrics->queue_wait, now - p_head->ts);
+            }
+
+            server_send_t *p_send = &p_shard->p_sends[count++];
+            p_send->fd = p_client->socket_fd;
+            p_send->slot = slot;
+            p_send->p_iov = &p_shard->p_iovs[iov_used];
+            p_send->iov_count = server_outq_iov(
+                &p_client->outq, &p_shard->p_iovs[iov_used], CONFIG_SRV_IOV_MAX);
+            iov_used += p_send->iov_count;
+        }
+
+        server_reactor_send_batch(&p_shard->reactor, p_shard->p_sends, count);
+
+        for (size_t idx = 0; idx < count; idx++) {
+            server_send_t *p_send = &p_shard->p_sends[idx];
+            server_client_t *p_client = &p_shard->clients.p_slots[p_send->slot];
+
+            if ((p_send->res < 0) && (-EAGAIN != p_send->res) &&
+                (-EWOULDBLOCK != p_send->res)) {
+                LOG_ERROR("[SERVER] Error: cannot send to socket fd <%d>",
+                          p_send->fd);
+                metrics_add(&p_metrics->send_errors, 1);
+                client_close(p_shard, p_send->slot);
+                continue;
+            }
+
+            if (p_send->res > 0) {
+                const uint32_t queued = p_client->outq.count;
+                server_outq_consume(&p_client->outq, (size_t)p_send->res);
+                metrics_add(&p_metrics->bytes_out, (uint64_t)p_send->res);
+                metrics_add(&p_metrics->msgs_out,
+                            queued - p_client->outq.count);
+                metrics_sub(&p_metrics->queued, queued - p_client->outq.count);
+            }
+
+            // NOTE: replaying client waits for writability to take next
+            // part of history, one part per loop iteration
+            if (0 == p_client->outq.count) {
+                if (0 == (p_client->flags & SERVER_CLIENT_F_REPLAY)) {
+                    continue;
+                }
+            } else if ((p_send->res > 0) &&
+                       (p_send->iov_count == CONFIG_SRV_IOV_MAX)) {
+                // NOTE: iovecs limit reached - flush the rest in this round
+                p_client->flags |= SERVER_CLIENT_F_DIRTY;
+                p_shard->p_dirty[p_shard->dirty_count++] = p_send->slot;
+                continue;
+            }
+
+            p_client->flags |= SERVER_CLIENT_F_WRITE;
+            server_reactor_mod(&p_shard->reactor, p_send->fd,
+                               client_interest(p_client) | SERVER_EV_WRITE,
+                               p_client->id);
+        }
+    }
+}
+
+/**
+ * @brief Publish message to inboxes of all other shards
+ *
+ * A full inbox holds the publishing shard back: it yields to the peer up to
+ * CONFIG_SRV_INBOX_RETRIES times and stops reading its own publishers
+ * meanwhile. Only then the message is dropped for clients of the peer and
+ * counted in drops.
+ *
+ * @param p_shard pointer to publishing shard
+ * @param p_msg message. Every inbox takes own reference
+ */
+static void server_publish(shard_t *p_shard, msg_t *p_msg) {
+    for (size_t idx = 0; idx < g_shards_count; idx++) {
+        shard_t *p_dst = &g_p_shards[idx];
+        if (p_dst == p_shard) {
+            continue;
+        }
+
+        msg_ref(p_msg);
+        bool queued = (RING_ERR_OK == ring_mpsc_push(&p_dst->inbox, p_msg));
+        // NOTE: bounded, so shards with full inboxes of each other do not
+        // wait forever
+        for (size_t retry = 0;
+             !queued && (retry < CONFIG_SRV_INBOX_RETRIES); retry++) {
+            shard_wake(p_dst);
+            sched_yield();
+            queued = (RING_ERR_OK == ring_mpsc_push(&p_dst->inbox, p_msg));
+        }
+
+        if (!queued) {
+            LOG_ERROR("[SERVER] Error: inbox of shard <%zu> is full",
+                      p_dst->idx);
+            metrics_add(&p_shard->p_metrics->drops, 1);
+            msg_unref(p_msg);
+            continue;
+        }
+
+        shard_wake(p_dst);
+    }
+}
+
+/**
+ * @brief Wake event loop of shard
+ *
+ * Only first wakeup after the shard drained its inbox pays for syscall.
+ *
+ * @param p_shard pointer to shard
+ */
+static void shard_wake(shard_t *p_shard) {
+    if (!atomic_exchange(&p_shard->wake_pending, true)) {
+        uint64_t one = 1;
+        if (sizeof(one) != write(p_shard->wake_fd, &one, sizeof(one))) {
+            LOG_ERROR("[SERVER] Error: cannot wake shard <%zu>", p_shard->idx);
+        }
+    }
+}
+
+/**
+ * @brief Fanout all messages published by other shards
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_inbox_drain(shard_t *p_shard) {
+    uint64_t value = 0;
+    if (sizeof(value) != read(p_shard->wake_fd, &value, sizeof(value))) {
+        // NOTE: EAGAIN is fine - counter was already consumed
+    }
+
+    // NOTE: clear flag before draining, so late pushes signal again
+    atomic_store(&p_shard->wake_pending, false);
+
+    void *p_data = NULL;
+    while (RING_ERR_OK == ring_mpsc_pop(&p_shard->inbox, &p_data)) {
+        metrics_add(&p_shard->p_metrics->inbox, 1);
+        server_fanout(p_shard, SHARD_SLOT_NONE, (msg_t *)p_data);
+        msg_unref((msg_t *)p_data);
+    }
+}
+
+/**
+ * @brief Get user a shared memory ring of client must belong to
+ *
+ * Unix socket peer is known by SO_PEERCRED. Loopback TCP peer is not, so
+ * its ring must belong to the server's own user. Other peers are not on
+ * this host and get no ring.
+ *
+ * @param socket_fd socket of client
+ * @param p_owner pointer to owner of ring
+ * @return bool true if client may offer a ring
+ */
+static bool client_shm_owner(int socket_fd, uid_t *p_owner) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+
+    if (0 != getpeername(socket_fd, (struct sockaddr *)&addr, &addr_len)) {
+        return false;
+    }
+
+    if (AF_UNIX == addr.ss_family) {
+        struct ucred cred;
+        socklen_t cred_len = sizeof(cred);
+        if (0 != getsockopt(socket_fd, SOL_SOCKET, SO_PEERCRED, &cred,
+                            &cred_len)) {
+            return false;
+        }
+        *p_owner = cred.uid;
+        return true;
+    }
+
+    bool loopback = false;
+    if (AF_INET == addr.ss_family) {
+        const struct sockaddr_in *p_in = (const struct sockaddr_in *)&addr;
+        loopback = (127u == (ntohl(p_in->sin_addr.s_addr) >> 24));
+    } else if (AF_INET6 == addr.ss_family) {
+        const struct sockaddr_in6 *p_in6 = (const struct sockaddr_in6 *)&addr;
+        loopback = IN6_IS_ADDR_LOOPBACK(&p_in6->sin6_addr) ||
+                   (IN6_IS_ADDR_V4MAPPED(&p_in6->sin6_addr) &&
+                    (127u == p_in6->sin6_addr.s6_addr[12]));
+    }
+
+    *p_owner = geteuid();
+    return loopback;
+}
+
+/**
+ * @brief Apply shm frame: map ring of client and deliver through it
+ *
+ * Only rings named with CONFIG_SHM_PREFIX are mapped, only for peers of
+ * this host and only if the segment belongs to the peer's user. If mapping
+ * fails, client keeps getting frames from the socket and sees the ring was
+ * never attached.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_frame shm frame, payload is ring name
+ */
+static void client_shm_attach(shard_t *p_shard, uint32_t slot,
+                              const proto_frame_t *p_frame) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const size_t prefix_len = strlen(CONFIG_SHM_PREFIX);
+    char name[SHMQ_NAME_SIZE];
+
+    if ((NULL != client_shm(p_client)) || (p_frame->hdr.len >= sizeof(name)) ||
+        (p_frame->hdr.len <= prefix_len) ||
+        (0 != memcmp(p_frame->p_payload, CONFIG_SHM_PREFIX, prefix_len)) ||
+        (NULL != memchr(&p_frame->p_payload[1], '/', p_frame->hdr.len - 1))) {
+        LOG_WARN("[SERVER] Bad shared memory ring from socket fd <%d>",
+                 p_client->socket_fd);
+        return;
+    }
+
+    uid_t owner;
+    if (!client_shm_owner(p_client->socket_fd, &owner)) {
+        LOG_WARN("[SERVER] Shared memory ring from remote socket fd <%d>",
+                 p_client->socket_fd);
+        return;
+    }
+
+    memcpy(name, p_frame->p_payload, p_frame->hdr.len);
+    name[p_frame->hdr.len] = '\0';
+
+    server_client_ext_t *p_ext = client_ext(p_client);
+    shmq_t *p_shm = calloc(1, sizeof(shmq_t));
+    if ((NULL == p_ext) || (NULL == p_shm)) {
+        free(p_shm);
+        LOG_ERROR("[SERVER] Error: no memory for shared memory ring");
+        return;
+    }
+
+    const int32_t ret = shmq_attach(p_shm, name, owner);
+    if (SHMQ_ERR_OK != ret) {
+        LOG_WARN("[SERVER] Cannot attach ring <%s> of socket fd <%d>. "
+                 "Error <%d>",
+                 name, p_client->socket_fd, ret);
+        free(p_shm);
+        return;
+    }
+
+    p_ext->p_shm = p_shm;
+    LOG_INFO("[SERVER] Socket fd <%d> delivery via ring <%s>",
+             p_client->socket_fd, name);
+
+    // NOTE: frames queued for socket go to ring from now on
+    if ((p_client->outq.count > 0) &&
+        (0 == (p_client->flags & SERVER_CLIENT_F_DIRTY))) {
+        p_client->flags |= SERVER_CLIENT_F_DIRTY;
+        p_shard->p_dirty[p_shard->dirty_count++] = slot;
+    }
+}
+
+/**
+ * @brief Apply nack frame: queue retained multicast frames to client
+ *
+ * Frames are queued as they were sent to the group, so they share the
+ * message and go through the same outbound queue as fanout. Frames already
+ * overwritten in the ring are skipped, client counts them lost.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_frame nack frame, seq is the first frame, flags is count
+ */
+static void client_nack(shard_t *p_shard, uint32_t slot,
+                        const proto_frame_t *p_frame) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const uint64_t first = p_frame->hdr.seq;
+    uint32_t count = p_frame->hdr.flags;
+
+    if ((NULL == g_p_mcast) ||
+        (0 == (p_client->flags & SERVER_CLIENT_F_MCAST))) {
+        LOG_WARN("[SERVER] Nack from socket fd <%d> without multicast",
+                 p_client->socket_fd);
+        return;
+    }
+
+    if (count > CONFIG_SRV_OUTQ_SIZE) {
+        count = CONFIG_SRV_OUTQ_SIZE;
+    }
+
+    LOG_DEBUG("[SERVER] Socket fd <%d> nack seq <%lu> count <%u>",
+              p_client->socket_fd, first, count);
+
+    for (uint32_t idx = 0; idx < count; idx++) {
+        msg_t *p_msg = mcast_get(g_p_mcast, first + idx);
+        if (NULL == p_msg) {
+            continue;
+        }
+
+        client_enqueue(p_shard, slot, p_msg);
+        msg_unref(p_msg);
+
+        // NOTE: disconnect policy may close the client
+        if (COMMON_SOCKET_ERR == p_client->socket_fd) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Apply hello frame: set roles and initial subscriptions
+ *
+ * Publisher-only client leaves the topic index, so fanout never visits it.
+ * Subscriber-only client is not read anymore: reactor reports its hangup
+ * only, and its data frames are ignored. Multicast subscriber is still read
+ * for nack frames.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_frame hello frame
+ * @return int32_t 0 if OK, error if client must be closed
+ */
+static int32_t client_hello(shard_t *p_shard, uint32_t slot,
+                            const proto_frame_t *p_frame) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    metrics_shard_t *p_metrics = p_shard->p_metrics;
+    const uint16_t roles = p_frame->hdr.flags & PROTO_ROLE_BOTH;
+
+    if ((p_client->flags & SERVER_CLIENT_F_HELLO) || (0 == roles) ||
+        (0 != (p_frame->hdr.flags &
+               ~(PROTO_ROLE_BOTH | PROTO_HELLO_REPLAY | PROTO_HELLO_MCAST)))) {
+        LOG_WARN("[SERVER] Bad hello roles <%u> from socket fd <%d>", roles,
+                 p_client->socket_fd);
+        return SERVER_ERR_PARAMS;
+    }
+
+    p_client->flags |= SERVER_CLIENT_F_HELLO;
+
+    if (0 == (roles & PROTO_ROLE_PUB)) {
+        p_client->flags &= ~SERVER_CLIENT_F_PUB;
+        metrics_sub(&p_metrics->pubs, 1);
+    }
+
+    if (0 == (roles & PROTO_ROLE_SUB)) {
+        p_client->flags &= ~SERVER_CLIENT_F_SUB;
+        metrics_sub(&p_metrics->subs, 1);
+        topic_unsubscribe_all(&p_shard->topics, slot);
+    }
+
+    // NOTE: patterns are '\n' separated, empty ones are skipped
+    const char *p_pattern = (const char *)p_frame->p_payload;
+    const char *p_end = p_pattern + p_frame->hdr.len;
+    while ((p_client->flags & SERVER_CLIENT_F_SUB) && (p_pattern < p_end)) {
+        const char *p_next = memchr(p_pattern, '\n', (size_t)(p_end - p_pattern));
+        if (NULL == p_next) {
+            p_next = p_end;
+        }
+
+        if (p_next > p_pattern) {
+            proto_frame_t sub = {.hdr = {.type = PROTO_TYPE_SUB,
+                                         .len = (uint32_t)(p_next - p_pattern)},
+                                 .p_payload = (const uint8_t *)p_pattern};
+            client_subscription(p_shard, slot, &sub);
+        }
+        p_pattern = p_next + 1;
+    }
+
+    // NOTE: without group the client keeps getting data frames over TCP
+    if ((p_frame->hdr.flags & PROTO_HELLO_MCAST) &&
+        (p_client->flags & SERVER_CLIENT_F_SUB)) {
+        if (NULL == g_p_mcast) {
+            LOG_WARN("[SERVER] Socket fd <%d> asks for multicast: disabled",
+                     p_client->socket_fd);
+        } else {
+            p_client->flags |= SERVER_CLIENT_F_MCAST;
+        }
+    }
+
+    if (CLIENT_EVENTS_SUB == client_interest(p_client)) {
+        server_reactor_mod(&p_shard->reactor, p_client->socket_fd,
+                           CLIENT_EVENTS_SUB |
+                               ((p_client->flags & SERVER_CLIENT_F_WRITE)
+                                    ? SERVER_EV_WRITE
+                                    : 0u),
+                           p_client->id);
+    }
+
+    LOG_INFO("[SERVER] Socket fd <%d> hello: %s", p_client->socket_fd,
+             (PROTO_ROLE_BOTH == roles)
+                 ? "publisher and subscriber"
+                 : ((PROTO_ROLE_PUB == roles) ? "publisher" : "subscriber"));
+
+    if ((p_frame->hdr.flags & PROTO_HELLO_REPLAY) &&
+        (p_client->flags & SERVER_CLIENT_F_SUB)) {
+        client_replay_start(p_shard, slot, p_frame->hdr.seq);
+    }
+
+    return SERVER_ERR_OK;
+}
+
+/**
+ * @brief Apply subscribe or unsubscribe frame of client
+ *
+ * The first subscription replaces implicit subscription to everything.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_frame subscription frame, payload is pattern
+ */
+static void client_subscription(shard_t *p_shard, uint32_t slot,
+                                const proto_frame_t *p_frame) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    int32_t ret = TOPIC_ERR_OK;
+
+    if (0 == (p_client->flags & SERVER_CLIENT_F_SUB)) {
+        LOG_WARN("[SERVER] Subscription from publisher on socket fd <%d>",
+                 p_client->socket_fd);
+        return;
+    }
+
+    if (PROTO_TYPE_SUB == p_frame->hdr.type) {
+        if (0 == (p_client->flags & SERVER_CLIENT_F_TOPICS)) {
+            p_client->flags |= SERVER_CLIENT_F_TOPICS;
+            topic_unsubscribe_all(&p_shard->topics, slot);
+        }
+
+        ret = topic_subscribe(&p_shard->topics, slot, p_frame->p_payload,
+                              p_frame->hdr.len);
+    } else {
+        ret = topic_unsubscribe(&p_shard->topics, slot, p_frame->p_payload,
+                                p_frame->hdr.len);
+    }
+
+    if (TOPIC_ERR_OK != ret) {
+        LOG_WARN("[SERVER] Cannot %s <%.*s> for socket fd <%d>. Error <%d>",
+                 (PROTO_TYPE_SUB == p_frame->hdr.type) ? "subscribe"
+                                                       : "unsubscribe",
+                 (int)p_frame->hdr.len, (const char *)p_frame->p_payload,
+                 p_client->socket_fd, ret);
+        return;
+    }
+
+    LOG_DEBUG("[SERVER] Socket fd <%d> %s <%.*s>", p_client->socket_fd,
+              (PROTO_TYPE_SUB == p_frame->hdr.type) ? "subscribed to"
+                                                    : "unsubscribed from",
+              (int)p_frame->hdr.len, (const char *)p_frame->p_payload);
+}
+
+/**
+ * @brief Keep parser state of client only while a frame is split
+ *
+ * Clients without partial frame are parsed by the shard parser. A split
+ * frame moves its state to a pooled parser of the client, a completed one
+ * gives the parser back.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void client_rx_park(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+
+    if (NULL != p_client->p_rx) {
+        if (0 == p_client->p_rx->len) {
+            proto_parser_deinit(p_client->p_rx);
+            pool_free(&g_rx_pool, p_client->p_rx);
+            p_client->p_rx = NULL;
+        }
+        return;
+    }
+
+    if (0 == p_shard->parser.len) {
+        return;
+    }
+
+    p_client->p_rx = pool_alloc(&g_rx_pool);
+    if (NULL == p_client->p_rx) {
+        LOG_ERROR("[SERVER] Error: no memory for partial frame of socket fd "
+                  "<%d>",
+                  p_client->socket_fd);
+        proto_parser_deinit(&p_shard->parser);
+        client_close(p_shard, slot);
+        return;
+    }
+
+    // NOTE: storage moves with the state, shard parser starts empty
+    *p_client->p_rx = p_shard->parser;
+    proto_parser_init(&p_shard->parser);
+}
+
+/**
+ * @brief Parse data received from client and retranslate complete frames
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ * @param p_buf received data. Not used after return
+ * @param len received data length
+ */
+static void server_client_data(shard_t *p_shard, uint32_t slot,
+                               const void *p_buf, size_t len) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    metrics_shard_t *p_metrics = p_shard->p_metrics;
+    proto_parser_t *p_parser =
+        (NULL != p_client->p_rx) ? p_client->p_rx : &p_shard->parser;
+    proto_frame_t frame;
+    int32_t ret = PROTO_ERR_OK;
+
+    // NOTE: one timestamp per read, frames of one read arrived together
+    const uint64_t now = proto_ts_now();
+    metrics_add(&p_metrics->bytes_in, len);
+    p_client->rx_ms = (uint32_t)p_shard->now_ms;
+
+    proto_parser_feed(p_parser, p_buf, len);
+
+    while (PROTO_ERR_OK == (ret = proto_parser_next(p_parser, &frame))) {
+        if (PROTO_TYPE_HELLO == frame.hdr.type) {
+            if (SERVER_ERR_OK != client_hello(p_shard, slot, &frame)) {
+                client_close(p_shard, slot);
+                return;
+            }
+            continue;
+        }
+
+        if (PROTO_TYPE_SHM == frame.hdr.type) {
+            client_shm_attach(p_shard, slot, &frame);
+            continue;
+        }
+
+        if (PROTO_TYPE_NACK == frame.hdr.type) {
+            client_nack(p_shard, slot, &frame);
+            if (COMMON_SOCKET_ERR == p_client->socket_fd) {
+                return;
+            }
+            continue;
+        }
+
+        if ((PROTO_TYPE_SUB == frame.hdr.type) ||
+            (PROTO_TYPE_UNSUB == frame.hdr.type)) {
+            client_subscription(p_shard, slot, &frame);
+            continue;
+        }
+
+        if (PROTO_TYPE_DATA != frame.hdr.type) {
+            LOG_WARN("[SERVER] Unknown frame type <%u> from socket fd <%d>",
+                     frame.hdr.type, p_client->socket_fd);
+            continue;
+        }
+
+        if (0 == (p_client->flags & SERVER_CLIENT_F_PUB)) {
+            LOG_WARN("[SERVER] Data frame from subscriber on socket fd <%d>",
+                     p_client->socket_fd);
+            continue;
+        }
+
+        if ((PROTO_TOPIC_LEN(&frame.hdr) > frame.hdr.len) ||
+            (PROTO_TOPIC_LEN(&frame.hdr) > CONFIG_TOPIC_LEN_MAX)) {
+            LOG_WARN("[SERVER] Bad topic length <%u> from socket fd <%d>",
+                     frame.hdr.flags, p_client->socket_fd);
+            continue;
+        }
+
+        LOG_DEBUG("[SERVER] Receive frame seq <%lu> <%u> bytes from "
+                  "controller. Retranslate it",
+                  frame.hdr.seq, frame.hdr.len);
+        p_shard->stats.msgs++;
+        metrics_add(&p_metrics->msgs_in, 1);
+        if ((0 != frame.hdr.ts) && (now >= frame.hdr.ts)) {
+            hist_record(&p_metrics->recv_lag, now - frame.hdr.ts);
+        }
+
+        // NOTE: the only copy - all queues and shards share this message
+        msg_t *p_msg = msg_create(frame.p_data, PROTO_FRAME_SIZE(&frame.hdr));
+        if (NULL == p_msg) {
+            LOG_ERROR("[SERVER] Error: no memory for message");
+            continue;
+        }
+        p_msg->ts = now;
+        // NOTE: publishers number own frames only, replay needs one order
+        p_msg->seq = atomic_fetch_add_explicit(&g_seq, 1, memory_order_relaxed);
+
+        // NOTE: journal writer copies the frame on its own thread
+        if (NULL != g_p_journal) {
+            journal_append(g_p_journal, p_msg);
+        }
+
+        server_fanout(p_shard, slot, p_msg);
+        server_publish(p_shard, p_msg);
+        msg_unref(p_msg);
+    }
+
+    if (PROTO_ERR_AGAIN != ret) {
+        LOG_WARN("[SERVER] Malformed frame from socket fd <%d>. Error <%d>",
+                 p_client->socket_fd, ret);
+        proto_parser_deinit(&p_shard->parser);
+        client_close(p_shard, slot);
+        return;
+    }
+
+    client_rx_park(p_shard, slot);
+}
+
+/**
+ * @brief Read available data from client and retranslate it
+ *
+ * Reading stops after CONFIG_SRV_READ_BUDGET bytes, so one busy publisher
+ * cannot starve others. The rest is read on next loop iteration. Client is
+ * in pending list at most once: a client already there is left to
+ * @server_pending_read.
+ *
+ * @param p_shard pointer to shard
+ * @param slot slot of client
+ */
+static void server_client_read(shard_t *p_shard, uint32_t slot) {
+    server_client_t *p_client = &p_shard->clients.p_slots[slot];
+    const int fd = p_client->socket_fd;
+    size_t budget = CONFIG_SRV_READ_BUDGET;
+
+    if (p_client->flags & SERVER_CLIENT_F_READ) {
+        return;
+    }
+
+    // NOTE: edge-triggered reactor, so drain socket until EAGAIN
+    while (COMMON_SOCKET_ERR != p_client->socket_fd) {
+        if (0 == budget) {
+            // NOTE: no new edge for data left in socket - keep own list
+            p_shard->stats.budget_hits++;
+            p_client->flags |= SERVER_CLIENT_F_READ;
+            // NOTE: unique live slots and processed part of the last pass
+            assert(p_shard->pending_count <
+                   (2u * p_shard->handle.max_clients));
+            p_shard->p_pending[p_shard->pending_count++] = slot;
+            break;
+        }
+
+        size_t size =
+            (budget < CONFIG_SRV_RECV_SIZE) ? budget : CONFIG_SRV_RECV_SIZE;
+        ssize_t ret = recv(fd, p_shard->p_recv, size, 0);
+
+        if (COMMON_SOCKET_ERR == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+
+            if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+                LOG_ERROR("[SERVER] Error: cannot read from socket fd <%d>",
+                          fd);
+                client_close(p_shard, slot);
+            }
+            break;
+        } else if (COMMON_SOCKET_CLOSED == ret) {
+            LOG_INFO("[SERVER] Connection closed for socket fd <%d>", fd);
+            client_close(p_shard, slot);
+            break;
+        }
+
+        budget -= (size_t)ret;
+        server_client_data(p_shard, slot, p_shard->p_recv, (size_t)ret);
+    }
+}
+
+/**
+ * @brief Continue reading clients stopped by fairness budget
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_pending_read(shard_t *p_shard) {
+    const size_t count = p_shard->pending_count;
+
+    // NOTE: clients stopped again are appended after processed part
+    for (size_t idx = 0; idx < count; idx++) {
+        uint32_t slot = p_shard->p_pending[idx];
+        server_client_t *p_client = &p_shard->clients.p_slots[slot];
+
+        // NOTE: flag leaves with list entry, also for closed or reused slot
+        p_client->flags &= ~SERVER_CLIENT_F_READ;
+        if (COMMON_SOCKET_ERR != p_client->socket_fd) {
+            server_client_read(p_shard, slot);
+        }
+    }
+
+    p_shard->pending_count -= count;
+    memmove(p_shard->p_pending, &p_shard->p_pending[count],
+            p_shard->pending_count * sizeof(uint32_t));
+}
+
+/**
+ * @brief Get monotonic time
+ *
+ * @return uint64_t time in milliseconds
+ */
+static uint64_t server_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000u) + ((uint64_t)ts.tv_nsec / 1000000u);
+}
+
+/**
+ * @brief Load the newest journal records into history of every shard
+ *
+ * Subscribers can replay messages published before restart. Receive time of
+ * restored messages is the restore time. Server sequence continues after the
+ * newest journaled one.
+ *
+ * @param count max count of records to load
+ */
+static void server_journal_restore(size_t count) {
+    const uint64_t next = g_p_journal->next;
+    const uint64_t load = (next > count) ? (next - count) : 0;
+    // NOTE: shards number frames before queueing them, so the last record of
+    // every shard is read to find the highest sequence
+    const uint64_t from = (load > g_shards_count) ? (load - g_shards_count)
+                                                  : 0;
+    const uint64_t now = proto_ts_now();
+    const uint8_t *p_frame = NULL;
+    size_t size = 0;
+    uint64_t seq = 0;
+    size_t restored = 0;
+    journal_iter_t iter;
+
+    if (JOURNAL_ERR_OK == journal_iter_init(g_p_journal, &iter, from)) {
+        for (;;) {
+            const bool loaded = (iter.index >= load);
+            if (JOURNAL_ERR_OK !=
+                journal_iter_next(&iter, &p_frame, &size, &seq)) {
+                break;
+            }
+
+            if (seq >= atomic_load(&g_seq)) {
+                atomic_store(&g_seq, seq + 1u);
+            }
+
+            if (!loaded) {
+                continue;
+            }
+
+            msg_t *p_msg = msg_create(p_frame, size);
+            if (NULL == p_msg) {
+                LOG_ERROR("[SERVER] Error: no memory for message");
+                break;
+            }
+            p_msg->ts = now;
+            p_msg->seq = seq;
+
+            for (size_t idx = 0; idx < g_shards_count; idx++) {
+                history_push(&g_p_shards[idx].history, p_msg, seq);
+            }
+            msg_unref(p_msg);
+            restored++;
+        }
+        journal_iter_deinit(&iter);
+    }
+
+    LOG_INFO("[SERVER] Journal <%s>: records <%lu> - <%lu>, <%zu> restored "
+             "to history, next seq <%lu>",
+             g_p_journal->dir, journal_first(g_p_journal), next, restored,
+             atomic_load(&g_seq));
+}
+
+/**
+ * @brief Print event loop statistics once per period
+ *
+ * @param p_shard pointer to shard
+ * @return int time to next report in milliseconds
+ */
+static int server_stats_report(shard_t *p_shard) {
+    const uint64_t now = server_now_ms();
+
+    if (now < p_shard->report_ms) {
+        return (int)(p_shard->report_ms - now);
+    }
+
+    const shard_stats_t *p_cur = &p_shard->stats;
+    shard_stats_t *p_last = &p_shard->stats_last;
+    const uint64_t msgs = p_cur->msgs - p_last->msgs;
+    const uint64_t wakeups = p_cur->wakeups - p_last->wakeups;
+
+    // NOTE: idle shard stays silent
+    if (msgs > 0) {
+        LOG_INFO("[SERVER] Shard <%zu> stats: loops <%lu> wakeups <%lu> "
+                 "msgs <%lu> msgs/wakeup <%.1f> max <%lu> budget hits <%lu>",
+                 p_shard->idx, p_cur->loops - p_last->loops, wakeups, msgs,
+                 (wakeups > 0) ? ((double)msgs / (double)wakeups) : 0.0,
+                 p_cur->msgs_max, p_cur->budget_hits - p_last->budget_hits);
+    }
+
+    const uint64_t accepts = p_cur->accepts - p_last->accepts;
+    const uint64_t rejects = p_cur->rejects - p_last->rejects;
+    const uint64_t throttles = p_cur->throttles - p_last->throttles;
+    const uint64_t overflows = server_listen_overflows();
+
+    if ((accepts > 0) || (rejects > 0) || (throttles > 0) ||
+        (overflows != p_shard->overflows)) {
+        LOG_INFO("[SERVER] Shard <%zu> accept: accepted <%lu> rejected <%lu> "
+                 "throttled <%lu> latency avg <%.1f> max <%u> ms queue max "
+                 "<%u> host listen overflows <%lu>",
+                 p_shard->idx, accepts, rejects, throttles,
+                 (accepts > 0)
+                     ? ((double)(p_cur->accept_ms - p_last->accept_ms) /
+                        (double)accepts)
+                     : 0.0,
+                 p_cur->accept_max_ms, p_cur->accept_queue,
+                 overflows - p_shard->overflows);
+    }
+
+    const uint64_t timeouts = p_cur->timeouts - p_last->timeouts;
+    const uint64_t heartbeats = p_cur->heartbeats - p_last->heartbeats;
+
+    if (timeouts > 0) {
+        LOG_INFO("[SERVER] Shard <%zu> timers: idle closed <%lu> heartbeats "
+                 "<%lu> armed <%zu>",
+                 p_shard->idx, timeouts, heartbeats, p_shard->timers.count);
+    } else if (heartbeats > 0) {
+        LOG_DEBUG("[SERVER] Shard <%zu> timers: heartbeats <%lu> armed <%zu>",
+                  p_shard->idx, heartbeats, p_shard->timers.count);
+    }
+
+    // NOTE: pools are process wide, so the first shard reports them on growth
+    pool_stats_t pools[POOL_MAX];
+    const size_t pools_count = (0 == p_shard->idx)
+                                   ? pool_stats(pools, POOL_MAX)
+                                   : 0;
+    size_t objects = 0;
+    for (size_t idx = 0; idx < pools_count; idx++) {
+        objects += pools[idx].objects;
+    }
+
+    if (objects != p_shard->pool_objects) {
+        for (size_t idx = 0; idx < pools_count; idx++) {
+            LOG_INFO("[SERVER] Pool <%s>: size <%zu> objects <%zu> used <%zu> "
+                     "chunks <%zu> huge <%zu>",
+                     pools[idx].name, pools[idx].size, pools[idx].objects,
+                     pools[idx].used, pools[idx].chunks,
+                     pools[idx].huge_chunks);
+        }
+        p_shard->pool_objects = objects;
+    }
+
+    *p_last = *p_cur;
+    p_shard->overflows = overflows;
+    p_shard->stats.msgs_max = 0;
+    p_shard->stats.accept_max_ms = 0;
+    p_shard->stats.accept_queue = 0;
+    p_shard->report_ms = now + (CONFIG_SRV_STATS_PERIOD_SEC * 1000u);
+
+    return (int)(CONFIG_SRV_STATS_PERIOD_SEC * 1000u);
+}
+
+/**
+ * @brief Init shard: listener, reactor, inbox and clients table
+ *
+ * @param p_shard pointer to shard
+ * @param idx shard index
+ * @param p_conf pointer to server config
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t shard_init(shard_t *p_shard, size_t idx,
+                          const server_conf_t *p_conf) {
+    memset(p_shard, 0x00, sizeof(shard_t));
+    p_shard->idx = idx;
+    p_shard->wake_fd = COMMON_SOCKET_ERR;
+    atomic_init(&p_shard->wake_pending, false);
+
+    int32_t ret = server_init(&p_shard->handle, p_conf);
+    if (SERVER_ERR_OK != ret) {
+        return ret;
+    }
+
+    const size_t OPEN_MAX = p_shard->handle.max_clients;
+
+    ret = server_reactor_init(&p_shard->reactor, p_conf->backend, OPEN_MAX);
+    if (SERVER_ERR_OK != ret) {
+        return ret;
+    }
+
+    ret = server_table_init(&p_shard->clients, OPEN_MAX);
+    if (SERVER_ERR_OK != ret) {
+        return ret;
+    }
+
+    if (TOPIC_ERR_OK != topic_index_init(&p_shard->topics, (uint32_t)OPEN_MAX)) {
+        return SERVER_ERR_NG;
+    }
+
+    if (HISTORY_ERR_OK !=
+        history_init(&p_shard->history, p_conf->history_size,
+                     (uint64_t)p_conf->history_age_sec * 1000000000u)) {
+        return SERVER_ERR_NG;
+    }
+
+    p_shard->p_sends = calloc(CONFIG_SRV_FLUSH_BATCH, sizeof(server_send_t));
+    p_shard->p_iovs =
+        calloc(CONFIG_SRV_FLUSH_BATCH * CONFIG_SRV_IOV_MAX, sizeof(struct iovec));
+    // NOTE: lists are sized by the table like its arrays, only the part
+    // used at once is committed. Processed part of pending list is
+    // compacted only after pass
+    p_shard->p_dirty = pool_reserve_alloc(OPEN_MAX * sizeof(uint32_t));
+    p_shard->p_pending = pool_reserve_alloc(2 * OPEN_MAX * sizeof(uint32_t));
+    p_shard->p_shm_wait = pool_reserve_alloc(OPEN_MAX * sizeof(uint32_t));
+    p_shard->p_recv = malloc(CONFIG_SRV_RECV_SIZE);
+    if ((NULL == p_shard->p_sends) || (NULL == p_shard->p_iovs) ||
+        (NULL == p_shard->p_dirty) || (NULL == p_shard->p_pending) ||
+        (NULL == p_shard->p_shm_wait) || (NULL == p_shard->p_recv)) {
+        return SERVER_ERR_NG;
+    }
+
+    if (RING_ERR_OK != ring_mpsc_init(&p_shard->inbox, CONFIG_SRV_INBOX_SIZE)) {
+        return SERVER_ERR_NG;
+    }
+
+    p_shard->now_ms = server_now_ms();
+    twheel_init(&p_shard->timers, CONFIG_SRV_TICK_MS, p_shard->now_ms);
+
+    // NOTE: heartbeat is never sampled for queue wait
+    uint8_t ping[PROTO_HDR_SIZE];
+    const proto_hdr_t ping_hdr = {.type = PROTO_TYPE_PING};
+    proto_hdr_encode(ping, &ping_hdr);
+    p_shard->p_ping = msg_create(ping, sizeof(ping));
+    if (NULL == p_shard->p_ping) {
+        return SERVER_ERR_NG;
+    }
+    p_shard->p_ping->ts = UINT64_MAX;
+
+    p_shard->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (COMMON_SOCKET_ERR == p_shard->wake_fd) {
+        return SERVER_ERR_SOCKET;
+    }
+
+    ret = server_reactor_add(&p_shard->reactor, p_shard->handle.socket_fd,
+                             SERVER_EV_READ | SERVER_EV_ACCEPT, SHARD_ID_LISTEN);
+    if (SERVER_ERR_OK != ret) {
+        return ret;
+    }
+
+    if (COMMON_SOCKET_ERR != p_shard->handle.unix_fd) {
+        ret = server_reactor_add(&p_shard->reactor, p_shard->handle.unix_fd,
+                                 SERVER_EV_READ | SERVER_EV_ACCEPT,
+                                 SHARD_ID_LISTEN_UNIX);
+        if (SERVER_ERR_OK != ret) {
+            return ret;
+        }
+    }
+
+    return server_reactor_add(&p_shard->reactor, p_shard->wake_fd,
+                              SERVER_EV_READ, SHARD_ID_WAKE);
+}
+
+/**
+ * @brief Shard thread entry
+ *
+ * @param p_arg pointer to shard
+ * @return void* always NULL
+ */
+static void *shard_thread(void *p_arg) {
+    server_run((shard_t *)p_arg);
+    return NULL;
+}
+
+/**
+ * @brief Event loop of shard
+ *
+ * @param p_shard pointer to shard
+ */
+static void server_run(shard_t *p_shard) {
+    if (NULL == p_shard) {
+        LOG_ERROR("[SERVER] Error params. Exit");
+        return;
+    }
+
+    LOG_INFO("[SERVER] Shard <%zu> started. Max connections is <%zu>",
+             p_shard->idx, p_shard->handle.max_clients);
+
+    server_event_t events[CONFIG_SRV_EVENTS_MAX];
+
+    p_shard->report_ms = server_now_ms() + (CONFIG_SRV_STATS_PERIOD_SEC * 1000u);
+    p_shard->overflows = server_listen_overflows();
+    p_shard->admit_ms = server_now_ms();
+    p_shard->admit_tokens = (uint64_t)p_shard->handle.conf.accept_rate * 1000u;
+
+    while (atomic_load(&g_running)) {
+        int timeout_ms = server_stats_report(p_shard);
+
+        // NOTE: clients with unread data must not wait for new events
+        if (p_shard->pending_count > 0) {
+            timeout_ms = 0;
+        }
+
+        // NOTE: full rings are polled, consumer does not signal free space
+        if ((p_shard->shm_wait_count > 0) && (timeout_ms > 1)) {
+            timeout_ms = 1;
+        }
+
+        if (p_shard->accept_pending) {
+            int admit_ms = server_admit_wait_ms(p_shard);
+            if (admit_ms < timeout_ms) {
+                timeout_ms = admit_ms;
+            }
+        }
+
+        const int tick_ms = twheel_wait_ms(&p_shard->timers, p_shard->now_ms);
+        if ((tick_ms >= 0) && (tick_ms < timeout_ms)) {
+            timeout_ms = tick_ms;
+        }
+
+        int count_ready = server_reactor_wait(&p_shard->reactor, events,
+                                              CONFIG_SRV_EVENTS_MAX, timeout_ms);
+        const uint64_t msgs = p_shard->stats.msgs;
+
+        p_shard->now_ms = server_now_ms();
+        p_shard->stats.loops++;
+        metrics_add(&p_shard->p_metrics->loops, 1);
+        if (count_ready > 0) {
+            p_shard->stats.wakeups++;
+            metrics_add(&p_shard->p_metrics->wakeups, 1);
+        }
+
+        // NOTE: every ready client is served in this iteration
+        for (int idx = 0; idx < count_ready; idx++) {
+            const uint64_t id = events[idx].data;
+
+            if ((SHARD_ID_LISTEN == id) || (SHARD_ID_LISTEN_UNIX == id)) {
+                if (events[idx].events & SERVER_EV_ACCEPT) {
+                    // NOTE: backend accepted connection on its own, so
+                    // connection over limit can only be shed
+                    server_client_t client = {.socket_fd = events[idx].res};
+                    if (server_admit(p_shard)) {
+                        client_accepted(p_shard, &client);
+                    } else {
+                        p_shard->stats.rejects++;
+                        metrics_add(&p_shard->p_metrics->rejects, 1);
+                        close(client.socket_fd);
+                    }
+                } else {
+                    p_shard->accept_pending = true;
+                }
+                continue;
+            }
+
+            if (SHARD_ID_WAKE == id) {
+                server_inbox_drain(p_shard);
+                continue;
+            }
+
+            // NOTE: client may be closed earlier in this batch, its slot may
+            // be taken by new client already
+            server_client_t *p_client = server_table_get(&p_shard->clients, id);
+            if (NULL == p_client) {
+                server_reactor_release(&p_shard->reactor, &events[idx]);
+                continue;
+            }
+
+            const uint32_t slot = SERVER_ID_SLOT(id);
+
+            if (events[idx].events & SERVER_EV_DATA) {
+                // NOTE: backend received data on its own
+                if (events[idx].res > 0) {
+                    server_client_data(p_shard, slot, events[idx].p_buf,
+                                       (size_t)events[idx].res);
+                } else {
+                    LOG_INFO("[SERVER] Connection closed for socket fd <%d>",
+                             p_client->socket_fd);
+                    client_close(p_shard, slot);
+                }
+                server_reactor_release(&p_shard->reactor, &events[idx]);
+            } else if (events[idx].events & SERVER_EV_READ) {
+                server_client_read(p_shard, slot);
+            }
+
+            if ((events[idx].events & SERVER_EV_WRITE) &&
+                (COMMON_SOCKET_ERR != p_client->socket_fd)) {
+                client_writable(p_shard, slot);
+            }
+        }
+
+        server_pending_read(p_shard);
+        server_timers(p_shard);
+
+        // NOTE: after clients, so connection storm cannot starve them
+        if (p_shard->accept_pending) {
+            server_accept_batch(p_shard);
+        }
+
+        if ((p_shard->stats.msgs - msgs) > p_shard->stats.msgs_max) {
+            p_shard->stats.msgs_max = p_shard->stats.msgs - msgs;
+        }
+
+        server_flush(p_shard);
+    }
+}
+
+/**
+ * @brief Stop other shards and close what must outlive them
+ *
+ * Journal is closed after shards, so every message accepted into its queue
+ * is written and synced. Clients still connected are closed, so everything
+ * they hold is released.
+ *
+ * @param shards count of shards
+ */
+static void server_stop(size_t shards) {
+    for (size_t idx = 1; idx < shards; idx++) {
+        shard_wake(&g_p_shards[idx]);
+        pthread_join(g_p_shards[idx].thread, NULL);
+    }
+
+    for (size_t idx = 0; idx < shards; idx++) {
+        shard_t *p_shard = &g_p_shards[idx];
+        while (p_shard->clients.live_count > 0) {
+            client_close(p_shard,
+                         p_shard->clients.p_live[p_shard->clients.live_count -
+                                                 1u]);
+        }
+    }
+
+    if (NULL != g_p_journal) {
+        journal_close(g_p_journal);
+        g_p_journal = NULL;
+    }
+
+    metrics_unlink(g_port);
+    if (('\0' != g_unix_path[0]) && (COMMON_UNIX_ABSTRACT != g_unix_path[0])) {
+        unlink(g_unix_path);
+    }
+
+    LOG_INFO("[SERVER] Stopped");
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(int argc, char *argv[]) {
+    server_conf_t server_conf = {.addr = INADDR_ANY,
+                                 .port = CONFIG_SRV_PORT,
+                                 .backend = CONFIG_SRV_BACKEND,
+                                 .slow_policy = CONFIG_SRV_SLOW_POLICY,
+                                 .keyed_backlog = CONFIG_SRV_KEYED_BACKLOG,
+                                 .heartbeat_ms =
+                                     CONFIG_SRV_HEARTBEAT_SEC * 1000u,
+                                 .idle_ms = CONFIG_SRV_IDLE_SEC * 1000u,
+                                 .backlog = CONFIG_SRV_BACKLOG,
+                                 .accept_rate = CONFIG_SRV_ACCEPT_RATE,
+                                 .history_size = CONFIG_SRV_HISTORY_SIZE,
+                                 .history_age_sec = CONFIG_SRV_HISTORY_AGE_SEC};
+    size_t shards = CONFIG_SRV_SHARDS;
+    int log_level = CONFIG_LOG_LEVEL;
+    const char *p_journal_dir = NULL;
+    char *p_mcast_group = NULL;
+    const char *p_mcast_if = NULL;
+
+    int opt = 0;
+    while (-1 != (opt = getopt(argc, argv, OPTS))) {
+        switch (opt) {
+            case 'a':
+                server_conf.accept_rate = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'k':
+                server_conf.keyed_backlog =
+                    (uint32_t)strtoul(optarg, NULL, 10);
+                if (server_conf.keyed_backlog >= CONFIG_SRV_OUTQ_SIZE) {
+                    fprintf(stderr, "[SERVER] Keyed backlog must be below "
+                                    "<%u>\n",
+                            CONFIG_SRV_OUTQ_SIZE);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'K':
+                server_conf.heartbeat_ms =
+                    (uint32_t)strtoul(optarg, NULL, 10) * 1000u;
+                break;
+
+            case 'I':
+                server_conf.idle_ms =
+                    (uint32_t)strtoul(optarg, NULL, 10) * 1000u;
+                break;
+
+            case 'l':
+                server_conf.backlog = (int)strtol(optarg, NULL, 10);
+                break;
+
+            case 'b':
+                if (0 == strcmp(optarg, "poll")) {
+                    server_conf.backend = SERVER_BACKEND_POLL;
+                } else if (0 == strcmp(optarg, "epoll")) {
+                    server_conf.backend = SERVER_BACKEND_EPOLL;
+                } else if (0 == strcmp(optarg, "io_uring")) {
+                    server_conf.backend = SERVER_BACKEND_URING;
+                } else {
+                    fprintf(stderr, "[SERVER] Unknown backend <%s>\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 'p':
+                if (0 == strcmp(optarg, "drop")) {
+                    server_conf.slow_policy = SERVER_SLOW_DROP_OLDEST;
+                } else if (0 == strcmp(optarg, "disconnect")) {
+                    server_conf.slow_policy = SERVER_SLOW_DISCONNECT;
+                } else if (0 == strcmp(optarg, "conflate")) {
+                    server_conf.slow_policy = SERVER_SLOW_CONFLATE;
+                } else if (0 == strcmp(optarg, "keyed")) {
+                    server_conf.slow_policy = SERVER_SLOW_KEYED;
+                } else {
+                    fprintf(stderr, "[SERVER] Unknown policy <%s>\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            case 's':
+                shards = (size_t)strtoul(optarg, NULL, 10);
+                if (0 == shards) {
+                    shards = (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+                }
+                break;
+
+            case 'H':
+                server_conf.history_size = (size_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                server_conf.history_age_sec =
+                    (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'j':
+                p_journal_dir = optarg;
+                break;
+
+            case 'g':
+                p_mcast_group = optarg;
+                break;
+
+            case 'i':
+                p_mcast_if = optarg;
+                break;
+
+            case 'u':
+                if (strlen(optarg) >= sizeof(server_conf.unix_path)) {
+                    fprintf(stderr, "[SERVER] Too long unix socket path\n");
+                    exit(EXIT_FAILURE);
+                }
+                strcpy(server_conf.unix_path, optarg);
+                break;
+
+            case 'v':
+                if (LOG_ERR_OK != log_level_parse(optarg, &log_level)) {
+                    fprintf(stderr, "[SERVER] Unknown log level <%s>\n",
+                            optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            default:
+                fprintf(stderr,
+                        "\nUsage: %s [-b poll|epoll|io_uring] [-s shards] "
+                        "[-p drop|disconnect|conflate|keyed] [-k backlog] "
+                        "[-a accepts/sec] "
+                        "[-l backlog] [-H history] [-t history_sec] "
+                        "[-j journal_dir] [-u unix_path] "
+                        "[-K heartbeat_sec] [-I idle_sec] "
+                        "[-g group:port] [-i mcast_if] "
+                        "[-v error|warn|info|debug]\n",
+                        argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    // NOTE: helper threads inherit blocked stop signals, so the handler
+    // always interrupts the main thread
+    sigset_t stop_sigs;
+    sigemptyset(&stop_sigs);
+    sigaddset(&stop_sigs, SIGINT);
+    sigaddset(&stop_sigs, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_sigs, NULL);
+
+    if (LOG_ERR_OK != log_init(log_level)) {
+        fprintf(stderr, "[SERVER] Cannot start logging. Exit\n");
+        exit(EXIT_FAILURE);
+    }
+
+    server_conf.reuseport = (shards > 1);
+
+    // NOTE: every shard admits its share of connections
+    if (server_conf.accept_rate > 0) {
+        server_conf.accept_rate =
+            (server_conf.accept_rate + (uint32_t)shards - 1u) / (uint32_t)shards;
+    }
+
+    // NOTE: inboxes are cache line aligned, calloc does not keep it
+    g_p_shards = aligned_alloc(_Alignof(shard_t), shards * sizeof(shard_t));
+    if (NULL == g_p_shards) {
+        LOG_ERROR("[SERVER] Cannot allocate shards. Exit");
+        exit(EXIT_FAILURE);
+    }
+    memset(g_p_shards, 0x00, shards * sizeof(shard_t));
+
+    for (size_t idx = 0; idx < shards; idx++) {
+        int32_t ret = shard_init(&g_p_shards[idx], idx, &server_conf);
+        if (SERVER_ERR_EXIST == ret) {
+            LOG_ERROR("[SERVER] Unix socket <%s> is in use or not a socket. "
+                      "Exit",
+                      server_conf.unix_path);
+            exit(EXIT_FAILURE);
+        }
+        if (SERVER_ERR_OK != ret) {
+            LOG_ERROR("[SERVER] Cannot start server. Error <%d> Exit", ret);
+            exit(EXIT_FAILURE);
+        }
+
+        // NOTE: unix sockets have no SO_REUSEPORT balancing, shard 0 owns
+        // the only listener
+        if ('\0' != server_conf.unix_path[0]) {
+            strcpy(g_unix_path, server_conf.unix_path);
+            LOG_INFO("[SERVER] Unix socket <%s> on shard <%zu>", g_unix_path,
+                     idx);
+            server_conf.unix_path[0] = '\0';
+        }
+    }
+
+    // NOTE: segment name is removed on Ctrl+C, readers see stale pid otherwise
+    g_port = server_conf.port;
+    int32_t ret = metrics_create(&g_p_metrics, server_conf.port, shards);
+    if (METRICS_ERR_OK != ret) {
+        LOG_ERROR("[SERVER] Cannot create metrics segment. Error <%d> Exit",
+                  ret);
+        exit(EXIT_FAILURE);
+    }
+    // NOTE: no SA_RESTART, so a signal breaks the reactor wait
+    struct sigaction sa = {.sa_handler = sigterm_handler};
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    for (size_t idx = 0; idx < shards; idx++) {
+        g_p_shards[idx].p_metrics = &g_p_metrics->shard[idx];
+    }
+
+    // NOTE: publish shards count only when all inboxes are ready
+    g_shards_count = shards;
+
+    if (NULL != p_journal_dir) {
+        ret = journal_open(&g_journal, p_journal_dir,
+                           CONFIG_JOURNAL_SEGMENT_SIZE,
+                           CONFIG_JOURNAL_SEGMENTS_MAX);
+        if (JOURNAL_ERR_OK != ret) {
+            LOG_ERROR("[SERVER] Cannot open journal <%s>. Error <%d> Exit",
+                      p_journal_dir, ret);
+            exit(EXIT_FAILURE);
+        }
+
+        g_p_journal = &g_journal;
+        server_journal_restore(server_conf.history_size);
+
+        ret = journal_start(g_p_journal);
+        if (JOURNAL_ERR_OK != ret) {
+            LOG_ERROR("[SERVER] Cannot start journal. Error <%d> Exit", ret);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (NULL != p_mcast_group) {
+        // NOTE: missing port is rejected by mcast_open
+        char *p_port = strrchr(p_mcast_group, ':');
+        if (NULL != p_port) {
+            *p_port++ = '\0';
+        } else {
+            p_port = "";
+        }
+
+        ret = mcast_open(&g_mcast, p_mcast_group, p_port, p_mcast_if,
+                         CONFIG_MCAST_RING_SIZE);
+        if (MCAST_ERR_OK != ret) {
+            LOG_ERROR("[SERVER] Cannot open multicast group <%s>. Error <%d> "
+                      "Exit",
+                      p_mcast_group, ret);
+            exit(EXIT_FAILURE);
+        }
+
+        g_p_mcast = &g_mcast;
+        LOG_INFO("[SERVER] Multicast group <%s:%s>", p_mcast_group, p_port);
+    }
+
+    LOG_INFO("[SERVER] Backend is <%s>. Shards <%zu>",
+             server_backend_name(server_conf.backend), shards);
+
+    for (size_t idx = 1; idx < shards; idx++) {
+        if (0 != pthread_create(&g_p_shards[idx].thread, NULL, shard_thread,
+                                &g_p_shards[idx])) {
+            LOG_ERROR("[SERVER] Cannot start shard <%zu>. Exit", idx);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // NOTE: shard 0 runs in main thread
+    pthread_sigmask(SIG_UNBLOCK, &stop_sigs, NULL);
+    server_run(&g_p_shards[0]);
+    server_stop(shards);
 
-    server_run(&server_handle);
+    // NOTE: writer thread is joined and per-thread rings are drained
+    log_deinit();
 
     return EXIT_SUCCESS;
 }
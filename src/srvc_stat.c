@@ -0,0 +1,334 @@
+/**
+ * @file      srvc_stat.c
+ *
+ * @brief     Service - Live metrics of server
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup Doxygen group
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "hist.h"
+#include "metrics.h"
+#include "proto.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define OPTS "i:c:h" /**< Command line options */
+
+#define NSEC_PER_USEC ((double)1e3) /**< Nanoseconds in microsecond */
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/** Copy of one shard block */
+typedef struct stat_snap_s {
+    uint64_t conns;       /**< Open connections */
+    uint64_t pubs;        /**< Open publishers */
+    uint64_t subs;        /**< Open subscribers */
+    uint64_t accepts;     /**< Accepted connections */
+    uint64_t rejects;     /**< Closed by admission limit */
+    uint64_t closes;      /**< Closed connections */
+    uint64_t msgs_in;     /**< Frames received */
+    uint64_t bytes_in;    /**< Bytes received */
+    uint64_t msgs_out;    /**< Frames sent */
+    uint64_t bytes_out;   /**< Bytes sent */
+    uint64_t send_errors; /**< Failed sends */
+    uint64_t queued;      /**< Frames in outbound queues */
+    uint64_t drops;       /**< Dropped, conflated frames and slow closes */
+    uint64_t loops;       /**< Event loop iterations */
+    uint64_t wakeups;     /**< Iterations with events */
+    hist_t recv_lag;      /**< Publisher to server latency */
+    hist_t queue_wait;    /**< Outbound queue wait */
+} stat_snap_t;
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static volatile sig_atomic_t g_running = 1; /**< Cleared by Ctrl+C */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static void sigint_handler(int ctx);
+static void stat_take(stat_snap_t *p_snap, const metrics_shard_t *p_shard);
+static void stat_print(const char *p_name, const stat_snap_t *p_cur,
+                       const stat_snap_t *p_prev, double sec);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Sigint handler
+ *
+ * @param sig received signal
+ */
+static void sigint_handler(int sig) {
+    (void)sig;
+
+    g_running = 0;
+}
+
+/**
+ * @brief Copy counters of shard. Server is not stopped or notified
+ *
+ * @param p_snap output snapshot
+ * @param p_shard pointer to shard block in shared memory
+ */
+static void stat_take(stat_snap_t *p_snap, const metrics_shard_t *p_shard) {
+    p_snap->conns = metrics_get(&p_shard->conns);
+    p_snap->pubs = metrics_get(&p_shard->pubs);
+    p_snap->subs = metrics_get(&p_shard->subs);
+    p_snap->accepts = metrics_get(&p_shard->accepts);
+    p_snap->rejects = metrics_get(&p_shard->rejects);
+    p_snap->closes = metrics_get(&p_shard->closes);
+    p_snap->msgs_in = metrics_get(&p_shard->msgs_in);
+    p_snap->bytes_in = metrics_get(&p_shard->bytes_in);
+    p_snap->msgs_out = metrics_get(&p_shard->msgs_out);
+    p_snap->bytes_out = metrics_get(&p_shard->bytes_out);
+    p_snap->send_errors = metrics_get(&p_shard->send_errors);
+    p_snap->queued = metrics_get(&p_shard->queued);
+    p_snap->drops = metrics_get(&p_shard->drops) +
+                    metrics_get(&p_shard->conflations) +
+                    metrics_get(&p_shard->slow_closes);
+    p_snap->loops = metrics_get(&p_shard->loops);
+    p_snap->wakeups = metrics_get(&p_shard->wakeups);
+    memcpy(&p_snap->recv_lag, &p_shard->recv_lag, sizeof(hist_t));
+    memcpy(&p_snap->queue_wait, &p_shard->queue_wait, sizeof(hist_t));
+}
+
+/**
+ * @brief Print rates and latency of one shard for period
+ *
+ * @param p_name row name
+ * @param p_cur pointer to snapshot at end of period
+ * @param p_prev pointer to snapshot at start of period
+ * @param sec period length in seconds
+ */
+static void stat_print(const char *p_name, const stat_snap_t *p_cur,
+                       const stat_snap_t *p_prev, double sec) {
+    static hist_t recv_lag;
+    static hist_t queue_wait;
+
+    hist_diff(&recv_lag, &p_cur->recv_lag, &p_prev->recv_lag);
+    hist_diff(&queue_wait, &p_cur->queue_wait, &p_prev->queue_wait);
+
+    printf("%-6s %7lu %6lu %7lu %8.0f %10.0f %8.2f %10.0f %8.2f %8lu %8.0f "
+           "%7.0f %8.1f %8.1f %8.1f %8.1f\n",
+           p_name, p_cur->conns, p_cur->pubs, p_cur->subs,
+           (double)(p_cur->accepts - p_prev->accepts) / sec,
+           (double)(p_cur->msgs_in - p_prev->msgs_in) / sec,
+           (double)(p_cur->bytes_in - p_prev->bytes_in) / sec / 1e6,
+           (double)(p_cur->msgs_out - p_prev->msgs_out) / sec,
+           (double)(p_cur->bytes_out - p_prev->bytes_out) / sec / 1e6,
+           p_cur->queued, (double)(p_cur->drops - p_prev->drops) / sec,
+           (double)(p_cur->send_errors - p_prev->send_errors) / sec,
+           (double)hist_percentile(&recv_lag, 50.0) / NSEC_PER_USEC,
+           (double)hist_percentile(&recv_lag, 99.0) / NSEC_PER_USEC,
+           (double)hist_percentile(&queue_wait, 50.0) / NSEC_PER_USEC,
+           (double)hist_percentile(&queue_wait, 99.0) / NSEC_PER_USEC);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(int argc, char *argv[]) {
+    signal(SIGINT, sigint_handler);
+
+    uint64_t period_sec = CONFIG_STAT_PERIOD_SEC;
+    uint64_t count = 0;
+    uint16_t port = CONFIG_SRV_PORT;
+    bool usage = false;
+
+    int opt = 0;
+    while (-1 != (opt = getopt(argc, argv, OPTS))) {
+        switch (opt) {
+            case 'i':
+                period_sec = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'c':
+                count = strtoull(optarg, NULL, 10);
+                break;
+
+            default:
+                usage = true;
+                break;
+        }
+    }
+
+    if (optind < argc) {
+        port = (uint16_t)strtoul(argv[optind++], NULL, 10);
+    }
+
+    if (usage || (optind != argc) || (0 == period_sec)) {
+        fprintf(stderr, "\nUsage: %s [-i sec] [-c count] [port]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const metrics_t *p_metrics = NULL;
+    size_t size = 0;
+    int32_t ret = metrics_open(&p_metrics, &size, port);
+    if (METRICS_ERR_OK != ret) {
+        printf("[STAT] Cannot open metrics of server on port <%u>. Error <%d> "
+               "Exit\n",
+               port, ret);
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t shards = p_metrics->shards;
+    stat_snap_t *p_prev = calloc(shards + 1, sizeof(stat_snap_t));
+    stat_snap_t *p_cur = calloc(shards + 1, sizeof(stat_snap_t));
+    if ((NULL == p_prev) || (NULL == p_cur)) {
+        printf("[STAT] No memory. Exit\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t idx = 0; idx <= shards; idx++) {
+        hist_reset(&p_prev[idx].recv_lag);
+        hist_reset(&p_prev[idx].queue_wait);
+    }
+
+    // NOTE: first report covers whole server lifetime
+    uint64_t prev_ns = p_metrics->start_ns;
+
+    for (uint64_t iter = 0; g_running && ((0 == count) || (iter < count));
+         iter++) {
+        if (iter > 0) {
+            sleep((unsigned int)period_sec);
+        }
+
+        if ((0 != kill(p_metrics->pid, 0)) && (ESRCH == errno)) {
+            printf("[STAT] Server pid <%d> is not running\n", p_metrics->pid);
+            break;
+        }
+
+        const uint64_t now = proto_ts_now();
+        stat_snap_t *p_total = &p_cur[shards];
+        memset(p_total, 0x00, sizeof(stat_snap_t));
+        hist_reset(&p_total->recv_lag);
+        hist_reset(&p_total->queue_wait);
+
+        for (size_t idx = 0; idx < shards; idx++) {
+            stat_take(&p_cur[idx], &p_metrics->shard[idx]);
+
+            stat_snap_t *p_snap = &p_cur[idx];
+            p_total->conns += p_snap->conns;
+            p_total->pubs += p_snap->pubs;
+            p_total->subs += p_snap->subs;
+            p_total->accepts += p_snap->accepts;
+            p_total->msgs_in += p_snap->msgs_in;
+            p_total->bytes_in += p_snap->bytes_in;
+            p_total->msgs_out += p_snap->msgs_out;
+            p_total->bytes_out += p_snap->bytes_out;
+            p_total->send_errors += p_snap->send_errors;
+            p_total->queued += p_snap->queued;
+            p_total->drops += p_snap->drops;
+            hist_merge(&p_total->recv_lag, &p_snap->recv_lag);
+            hist_merge(&p_total->queue_wait, &p_snap->queue_wait);
+        }
+
+        const double sec = (double)(now - prev_ns) / 1e9;
+        printf("\n[STAT] Server pid <%d> port <%u> uptime <%.0f> s period "
+               "<%.1f> s\n",
+               p_metrics->pid, p_metrics->port,
+               (double)(now - p_metrics->start_ns) / 1e9, sec);
+        printf("%-6s %7s %6s %7s %8s %10s %8s %10s %8s %8s %8s %7s %17s "
+               "%17s\n",
+               "shard", "conns", "pubs", "subs", "accept/s", "in msg/s", "in MB/s",
+               "out msg/s", "out MB/s", "queued", "drops/s", "errs/s",
+               "recv p50/p99 us", "queue p50/p99 us");
+
+        if (shards > 1) {
+            for (size_t idx = 0; idx < shards; idx++) {
+                char name[16];
+                snprintf(name, sizeof(name), "%zu", idx);
+                stat_print(name, &p_cur[idx], &p_prev[idx], sec);
+            }
+        }
+        stat_print("total", &p_cur[shards], &p_prev[shards], sec);
+        fflush(stdout);
+
+        stat_snap_t *p_swap = p_prev;
+        p_prev = p_cur;
+        p_cur = p_swap;
+        prev_ns = now;
+    }
+
+    free(p_prev);
+    free(p_cur);
+    metrics_close(p_metrics, size);
+
+    exit(EXIT_SUCCESS);
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
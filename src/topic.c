@@ -0,0 +1,815 @@
+/**
+ * @file      topic.c
+ *
+ * @brief     Topic subscriptions index
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup topic
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "topic.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define TOPIC_BUCKETS_MIN ((uint32_t)64) /**< Initial count of buckets */
+#define TOPIC_FNV_BASIS ((uint32_t)2166136261u) /**< FNV-1a offset basis */
+#define TOPIC_FNV_PRIME ((uint32_t)16777619u)   /**< FNV-1a prime */
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static topic_entry_t* topic_entry_find(const topic_index_t* p_index,
+                                       const uint8_t* p_topic, size_t len,
+                                       uint32_t hash);
+static topic_entry_t* topic_entry_get(topic_index_t* p_index,
+                                      const uint8_t* p_topic, size_t len);
+static void topic_entry_prune(topic_index_t* p_index, topic_entry_t* p_entry);
+static topic_node_t* topic_node_kid(const topic_node_t* p_node, uint8_t key);
+static topic_node_t* topic_node_get(topic_index_t* p_index,
+                                    const uint8_t* p_prefix, size_t len);
+static void topic_node_prune(topic_node_t* p_node);
+static void topic_node_free(topic_node_t* p_node);
+static topic_set_t* topic_set_find(topic_index_t* p_index,
+                                   const uint8_t* p_pattern, size_t len,
+                                   bool* p_prefix);
+static int32_t topic_set_add(topic_set_t* p_set, uint32_t rec);
+static void topic_set_remove(topic_index_t* p_index, uint32_t rec);
+static void topic_set_prune(topic_index_t* p_index, topic_set_t* p_set,
+                            bool prefix);
+static uint32_t topic_rec_alloc(topic_index_t* p_index);
+static void topic_set_collect(topic_index_t* p_index,
+                              const topic_set_t* p_set, size_t* p_count);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Find exact topic entry
+ *
+ * @param p_index pointer to index
+ * @param p_topic topic bytes
+ * @param len topic length
+ * @param hash hash of topic
+ * @return topic_entry_t* entry or NULL
+ */
+static topic_entry_t* topic_entry_find(const topic_index_t* p_index,
+                                       const uint8_t* p_topic, size_t len,
+                                       uint32_t hash) {
+    topic_entry_t* p_entry = p_index->pp_buckets[hash & p_index->mask];
+
+    while (NULL != p_entry) {
+        if ((p_entry->hash == hash) && (p_entry->len == len) &&
+            (0 == memcmp(p_entry->topic, p_topic, len))) {
+            return p_entry;
+        }
+        p_entry = p_entry->p_next;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find or create exact topic entry. Table grows at load factor 1
+ *
+ * @param p_index pointer to index
+ * @param p_topic topic bytes
+ * @param len topic length
+ * @return topic_entry_t* entry or NULL if no memory
+ */
+static topic_entry_t* topic_entry_get(topic_index_t* p_index,
+                                      const uint8_t* p_topic, size_t len) {
+    const uint32_t hash = topic_hash(p_topic, len);
+
+    topic_entry_t* p_entry = topic_entry_find(p_index, p_topic, len, hash);
+    if (NULL != p_entry) {
+        return p_entry;
+    }
+
+    if (p_index->entries > p_index->mask) {
+        const uint32_t count = (p_index->mask + 1u) * 2u;
+        topic_entry_t** pp_buckets = calloc(count, sizeof(topic_entry_t*));
+        if (NULL != pp_buckets) {
+            for (uint32_t idx = 0; idx <= p_index->mask; idx++) {
+                topic_entry_t* p_cur = p_index->pp_buckets[idx];
+                while (NULL != p_cur) {
+                    topic_entry_t* p_next = p_cur->p_next;
+                    p_cur->p_next = pp_buckets[p_cur->hash & (count - 1u)];
+                    pp_buckets[p_cur->hash & (count - 1u)] = p_cur;
+                    p_cur = p_next;
+                }
+            }
+
+            free(p_index->pp_buckets);
+            p_index->pp_buckets = pp_buckets;
+            p_index->mask = count - 1u;
+        }
+        // NOTE: without memory table only gets longer chains
+    }
+
+    p_entry = calloc(1, sizeof(topic_entry_t) + len);
+    if (NULL == p_entry) {
+        return NULL;
+    }
+
+    p_entry->hash = hash;
+    p_entry->len = (uint32_t)len;
+    memcpy(p_entry->topic, p_topic, len);
+    p_entry->p_next = p_index->pp_buckets[hash & p_index->mask];
+    p_index->pp_buckets[hash & p_index->mask] = p_entry;
+    p_index->entries++;
+
+    return p_entry;
+}
+
+/**
+ * @brief Free exact topic entry without subscribers
+ *
+ * @param p_index pointer to index
+ * @param p_entry entry
+ */
+static void topic_entry_prune(topic_index_t* p_index, topic_entry_t* p_entry) {
+    if (p_entry->set.count > 0) {
+        return;
+    }
+
+    topic_entry_t** pp_cur = &p_index->pp_buckets[p_entry->hash & p_index->mask];
+    while (*pp_cur != p_entry) {
+        pp_cur = &(*pp_cur)->p_next;
+    }
+    *pp_cur = p_entry->p_next;
+
+    free(p_entry->set.p_recs);
+    free(p_entry);
+    p_index->entries--;
+}
+
+/**
+ * @brief Find child of trie node
+ *
+ * @param p_node pointer to node
+ * @param key byte of child
+ * @return topic_node_t* child or NULL
+ */
+static topic_node_t* topic_node_kid(const topic_node_t* p_node, uint8_t key) {
+    // NOTE: topics use small alphabet - linear scan beats binary search
+    for (uint16_t idx = 0; idx < p_node->kids_count; idx++) {
+        if (p_node->p_keys[idx] == key) {
+            return p_node->pp_kids[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find or create trie node of prefix
+ *
+ * @param p_index pointer to index
+ * @param p_prefix prefix bytes
+ * @param len prefix length
+ * @return topic_node_t* node or NULL if no memory
+ */
+static topic_node_t* topic_node_get(topic_index_t* p_index,
+                                    const uint8_t* p_prefix, size_t len) {
+    topic_node_t* p_node = &p_index->root;
+
+    for (size_t depth = 0; depth < len; depth++) {
+        topic_node_t* p_kid = topic_node_kid(p_node, p_prefix[depth]);
+        if (NULL != p_kid) {
+            p_node = p_kid;
+            continue;
+        }
+
+        if (p_node->kids_count == p_node->kids_cap) {
+            const uint16_t cap =
+                (uint16_t)((0 == p_node->kids_cap) ? 2u : (p_node->kids_cap * 2u));
+            topic_node_t** pp_kids =
+                realloc(p_node->pp_kids, cap * sizeof(topic_node_t*));
+            if (NULL == pp_kids) {
+                topic_node_prune(p_node);
+                return NULL;
+            }
+            p_node->pp_kids = pp_kids;
+
+            uint8_t* p_keys = realloc(p_node->p_keys, cap);
+            if (NULL == p_keys) {
+                topic_node_prune(p_node);
+                return NULL;
+            }
+            p_node->p_keys = p_keys;
+            p_node->kids_cap = cap;
+        }
+
+        p_kid = calloc(1, sizeof(topic_node_t));
+        if (NULL == p_kid) {
+            topic_node_prune(p_node);
+            return NULL;
+        }
+
+        p_kid->p_parent = p_node;
+        p_kid->key = p_prefix[depth];
+        p_node->p_keys[p_node->kids_count] = p_kid->key;
+        p_node->pp_kids[p_node->kids_count++] = p_kid;
+        p_node = p_kid;
+    }
+
+    return p_node;
+}
+
+/**
+ * @brief Free trie node without subscribers and children, then its parents
+ *
+ * @param p_node pointer to node
+ */
+static void topic_node_prune(topic_node_t* p_node) {
+    while ((NULL != p_node->p_parent) && (0 == p_node->set.count) &&
+           (0 == p_node->kids_count)) {
+        topic_node_t* p_parent = p_node->p_parent;
+
+        for (uint16_t idx = 0; idx < p_parent->kids_count; idx++) {
+            if (p_parent->pp_kids[idx] == p_node) {
+                p_parent->kids_count--;
+                p_parent->pp_kids[idx] = p_parent->pp_kids[p_parent->kids_count];
+                p_parent->p_keys[idx] = p_parent->p_keys[p_parent->kids_count];
+                break;
+            }
+        }
+
+        topic_node_free(p_node);
+        p_node = p_parent;
+    }
+}
+
+/**
+ * @brief Free trie node and whole subtree
+ *
+ * @param p_node pointer to node
+ */
+static void topic_node_free(topic_node_t* p_node) {
+    for (uint16_t idx = 0; idx < p_node->kids_count; idx++) {
+        topic_node_free(p_node->pp_kids[idx]);
+    }
+
+    free(p_node->pp_kids);
+    free(p_node->p_keys);
+    free(p_node->set.p_recs);
+
+    if (NULL != p_node->p_parent) {
+        free(p_node);
+    }
+}
+
+/**
+ * @brief Find set of pattern without creating it
+ *
+ * @param p_index pointer to index
+ * @param p_pattern pattern bytes
+ * @param len pattern length
+ * @param p_prefix output: pattern is prefix
+ * @return topic_set_t* set or NULL
+ */
+static topic_set_t* topic_set_find(topic_index_t* p_index,
+                                   const uint8_t* p_pattern, size_t len,
+                                   bool* p_prefix) {
+    *p_prefix = (len > 0) && (TOPIC_WILDCARD == p_pattern[len - 1]);
+
+    if (!*p_prefix) {
+        topic_entry_t* p_entry = topic_entry_find(
+            p_index, p_pattern, len, topic_hash(p_pattern, len));
+        return (NULL != p_entry) ? &p_entry->set : NULL;
+    }
+
+    topic_node_t* p_node = &p_index->root;
+    for (size_t depth = 0; (depth < (len - 1)) && (NULL != p_node); depth++) {
+        p_node = topic_node_kid(p_node, p_pattern[depth]);
+    }
+
+    return (NULL != p_node) ? &p_node->set : NULL;
+}
+
+/**
+ * @brief Append record to set
+ *
+ * @param p_set pointer to set
+ * @param rec record index
+ * @return int32_t 0 if OK, error otherwise
+ */
+static int32_t topic_set_add(topic_set_t* p_set, uint32_t rec) {
+    if (p_set->count == p_set->cap) {
+        const uint32_t cap = (0 == p_set->cap) ? 4u : (p_set->cap * 2u);
+        uint32_t* p_recs = realloc(p_set->p_recs, cap * sizeof(uint32_t));
+        if (NULL == p_recs) {
+            return TOPIC_ERR_NOMEM;
+        }
+        p_set->p_recs = p_recs;
+        p_set->cap = cap;
+    }
+
+    p_set->p_recs[p_set->count++] = rec;
+
+    return TOPIC_ERR_OK;
+}
+
+/**
+ * @brief Remove record from its set in O(1), prune empty set owner
+ *
+ * @param p_index pointer to index
+ * @param rec record index
+ */
+static void topic_set_remove(topic_index_t* p_index, uint32_t rec) {
+    topic_rec_t* p_rec = &p_index->p_recs[rec];
+    topic_set_t* p_set = p_rec->p_set;
+
+    const uint32_t last = p_set->p_recs[--p_set->count];
+    p_set->p_recs[p_rec->pos] = last;
+    p_index->p_recs[last].pos = p_rec->pos;
+
+    topic_set_prune(p_index, p_set, p_rec->prefix);
+
+    p_rec->p_set = NULL;
+    p_rec->next = p_index->recs_free;
+    p_index->recs_free = rec;
+}
+
+/**
+ * @brief Free owner of set without subscribers
+ *
+ * @param p_index pointer to index
+ * @param p_set pointer to set
+ * @param prefix set is in trie node, else in hash entry
+ */
+static void topic_set_prune(topic_index_t* p_index, topic_set_t* p_set,
+                            bool prefix) {
+    if (p_set->count > 0) {
+        return;
+    }
+
+    // NOTE: set is the first member of both owners
+    if (prefix) {
+        topic_node_prune((topic_node_t*)p_set);
+    } else {
+        topic_entry_prune(p_index, (topic_entry_t*)p_set);
+    }
+}
+
+/**
+ * @brief Get free record, grow pool if needed. Record stays in free list
+ *
+ * @param p_index pointer to index
+ * @return uint32_t record index or TOPIC_NONE if no memory
+ */
+static uint32_t topic_rec_alloc(topic_index_t* p_index) {
+    if (TOPIC_NONE != p_index->recs_free) {
+        return p_index->recs_free;
+    }
+
+    const uint32_t cap =
+        (0 == p_index->recs_cap) ? 64u : (p_index->recs_cap * 2u);
+    topic_rec_t* p_recs = realloc(p_index->p_recs, cap * sizeof(topic_rec_t));
+    if (NULL == p_recs) {
+        return TOPIC_NONE;
+    }
+
+    // NOTE: new records are chained to free list in index order. Record 0 is
+    // TOPIC_NONE, so zeroed lists of subscribers are empty
+    const uint32_t first = (0 == p_index->recs_cap) ? 1u : p_index->recs_cap;
+    for (uint32_t idx = first; idx < cap; idx++) {
+        p_recs[idx].p_set = NULL;
+        p_recs[idx].next = ((idx + 1u) < cap) ? (idx + 1u) : TOPIC_NONE;
+    }
+
+    p_index->p_recs = p_recs;
+    p_index->recs_free = first;
+    p_index->recs_cap = cap;
+
+    return p_index->recs_free;
+}
+
+/**
+ * @brief Append subscribers of set to match output, once per match
+ *
+ * @param p_index pointer to index
+ * @param p_set pointer to set
+ * @param p_count in/out count of matched subscribers
+ */
+static void topic_set_collect(topic_index_t* p_index,
+                              const topic_set_t* p_set, size_t* p_count) {
+    for (uint32_t idx = 0; idx < p_set->count; idx++) {
+        const uint32_t sub = p_index->p_recs[p_set->p_recs[idx]].sub;
+        if (p_index->p_marks[sub] == p_index->match_gen) {
+            continue;
+        }
+
+        p_index->p_marks[sub] = p_index->match_gen;
+        p_index->p_match[(*p_count)++] = sub;
+    }
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief FNV-1a hash of topic
+ *
+ * @param p_topic topic bytes
+ * @param len topic length
+ * @return uint32_t hash
+ */
+uint32_t topic_hash(const uint8_t* p_topic, size_t len) {
+    uint32_t hash = TOPIC_FNV_BASIS;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        hash = (hash ^ p_topic[idx]) * TOPIC_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Init empty index
+ *
+ * Arrays of subscribers are zeroed, not written, so memory of a subscriber is
+ * committed only when it is used.
+ *
+ * @param p_index pointer to index
+ * @param cap count of subscribers, subscriber IDs are below it
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t topic_index_init(topic_index_t* p_index, uint32_t cap) {
+    if ((NULL == p_index) || (0 == cap) || (UINT32_MAX == cap)) {
+        return TOPIC_ERR_PARAMS;
+    }
+
+    memset(p_index, 0x00, sizeof(topic_index_t));
+    p_index->cap = cap;
+    p_index->recs_free = TOPIC_NONE;
+    p_index->mask = TOPIC_BUCKETS_MIN - 1u;
+    p_index->pp_buckets = calloc(TOPIC_BUCKETS_MIN, sizeof(topic_entry_t*));
+    p_index->p_heads = calloc(cap, sizeof(uint32_t));
+    p_index->p_counts = calloc(cap, sizeof(uint32_t));
+    p_index->p_marks = calloc(cap, sizeof(uint64_t));
+    p_index->p_match = malloc(cap * sizeof(uint32_t));
+    if ((NULL == p_index->pp_buckets) || (NULL == p_index->p_heads) ||
+        (NULL == p_index->p_counts) || (NULL == p_index->p_marks) ||
+        (NULL == p_index->p_match)) {
+        topic_index_deinit(p_index);
+        return TOPIC_ERR_NOMEM;
+    }
+
+    return TOPIC_ERR_OK;
+}
+
+/**
+ * @brief Free all memory of index
+ *
+ * @param p_index pointer to index
+ */
+void topic_index_deinit(topic_index_t* p_index) {
+    if (NULL == p_index) {
+        return;
+    }
+
+    if (NULL != p_index->pp_buckets) {
+        for (uint32_t idx = 0; idx <= p_index->mask; idx++) {
+            topic_entry_t* p_entry = p_index->pp_buckets[idx];
+            while (NULL != p_entry) {
+                topic_entry_t* p_next = p_entry->p_next;
+                free(p_entry->set.p_recs);
+                free(p_entry);
+                p_entry = p_next;
+            }
+        }
+    }
+
+    topic_node_free(&p_index->root);
+    free(p_index->pp_buckets);
+    free(p_index->p_recs);
+    free(p_index->p_heads);
+    free(p_index->p_counts);
+    free(p_index->p_marks);
+    free(p_index->p_match);
+    memset(p_index, 0x00, sizeof(topic_index_t));
+}
+
+/**
+ * @brief Subscribe to pattern. Subscribing twice is not an error
+ *
+ * Pattern ending with TOPIC_WILDCARD matches every topic starting with the
+ * rest of pattern, "*" matches everything. Other patterns match one topic.
+ *
+ * @param p_index pointer to index
+ * @param sub subscriber
+ * @param p_pattern pattern bytes
+ * @param len pattern length
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t topic_subscribe(topic_index_t* p_index, uint32_t sub,
+                        const void* p_pattern, size_t len) {
+    if ((NULL == p_index) || (sub >= p_index->cap) ||
+        ((NULL == p_pattern) && (len > 0)) ||
+        (len > CONFIG_TOPIC_LEN_MAX)) {
+        return TOPIC_ERR_PARAMS;
+    }
+
+    const uint8_t* p_bytes = (const uint8_t*)p_pattern;
+    bool prefix = false;
+
+    topic_set_t* p_set = topic_set_find(p_index, p_bytes, len, &prefix);
+    if (NULL != p_set) {
+        for (uint32_t rec = p_index->p_heads[sub]; TOPIC_NONE != rec;
+             rec = p_index->p_recs[rec].next) {
+            if (p_index->p_recs[rec].p_set == p_set) {
+                return TOPIC_ERR_OK;
+            }
+        }
+    }
+
+    if (p_index->p_counts[sub] >= CONFIG_TOPIC_SUBS_MAX) {
+        return TOPIC_ERR_LIMIT;
+    }
+
+    const uint32_t rec = topic_rec_alloc(p_index);
+    if (TOPIC_NONE == rec) {
+        return TOPIC_ERR_NOMEM;
+    }
+
+    if (NULL == p_set) {
+        if (prefix) {
+            topic_node_t* p_node = topic_node_get(p_index, p_bytes, len - 1);
+            p_set = (NULL != p_node) ? &p_node->set : NULL;
+        } else {
+            topic_entry_t* p_entry = topic_entry_get(p_index, p_bytes, len);
+            p_set = (NULL != p_entry) ? &p_entry->set : NULL;
+        }
+
+        if (NULL == p_set) {
+            return TOPIC_ERR_NOMEM;
+        }
+    }
+
+    if (TOPIC_ERR_OK != topic_set_add(p_set, rec)) {
+        // NOTE: do not leave empty owner created for this call
+        topic_set_prune(p_index, p_set, prefix);
+        return TOPIC_ERR_NOMEM;
+    }
+
+    topic_rec_t* p_rec = &p_index->p_recs[rec];
+    p_index->recs_free = p_rec->next;
+    p_rec->p_set = p_set;
+    p_rec->sub = sub;
+    p_rec->pos = p_set->count - 1u;
+    p_rec->prefix = prefix;
+    p_rec->next = p_index->p_heads[sub];
+    p_index->p_heads[sub] = rec;
+    p_index->p_counts[sub]++;
+
+    return TOPIC_ERR_OK;
+}
+
+/**
+ * @brief Unsubscribe from pattern given at subscription
+ *
+ * @param p_index pointer to index
+ * @param sub subscriber
+ * @param p_pattern pattern bytes
+ * @param len pattern length
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t topic_unsubscribe(topic_index_t* p_index, uint32_t sub,
+                          const void* p_pattern, size_t len) {
+    if ((NULL == p_index) || (sub >= p_index->cap) ||
+        ((NULL == p_pattern) && (len > 0))) {
+        return TOPIC_ERR_PARAMS;
+    }
+
+    bool prefix = false;
+    topic_set_t* p_set =
+        topic_set_find(p_index, (const uint8_t*)p_pattern, len, &prefix);
+    if (NULL == p_set) {
+        return TOPIC_ERR_NOENT;
+    }
+
+    uint32_t* p_link = &p_index->p_heads[sub];
+    while (TOPIC_NONE != *p_link) {
+        const uint32_t rec = *p_link;
+        if (p_index->p_recs[rec].p_set == p_set) {
+            *p_link = p_index->p_recs[rec].next;
+            p_index->p_counts[sub]--;
+            topic_set_remove(p_index, rec);
+            return TOPIC_ERR_OK;
+        }
+        p_link = &p_index->p_recs[rec].next;
+    }
+
+    return TOPIC_ERR_NOENT;
+}
+
+/**
+ * @brief Drop all subscriptions of subscriber, e.g. on disconnect
+ *
+ * @param p_index pointer to index
+ * @param sub subscriber
+ */
+void topic_unsubscribe_all(topic_index_t* p_index, uint32_t sub) {
+    if ((NULL == p_index) || (sub >= p_index->cap)) {
+        return;
+    }
+
+    uint32_t rec = p_index->p_heads[sub];
+    while (TOPIC_NONE != rec) {
+        const uint32_t next = p_index->p_recs[rec].next;
+        topic_set_remove(p_index, rec);
+        rec = next;
+    }
+
+    p_index->p_heads[sub] = TOPIC_NONE;
+    p_index->p_counts[sub] = 0;
+}
+
+/**
+ * @brief Check if subscriber has any pattern
+ *
+ * @param p_index pointer to index
+ * @param sub subscriber
+ * @return bool true if subscribed
+ */
+bool topic_is_subscribed(const topic_index_t* p_index, uint32_t sub) {
+    return (NULL != p_index) && (sub < p_index->cap) &&
+           (TOPIC_NONE != p_index->p_heads[sub]);
+}
+
+/**
+ * @brief Find subscribers of topic
+ *
+ * Every subscriber is returned once even if several patterns match. Output
+ * is valid until next call.
+ *
+ * @param p_index pointer to index
+ * @param p_topic topic bytes
+ * @param len topic length
+ * @param pp_subs output: matched subscribers
+ * @return size_t count of matched subscribers
+ */
+size_t topic_match(topic_index_t* p_index, const void* p_topic, size_t len,
+                   const uint32_t** pp_subs) {
+    if ((NULL == p_index) || (NULL == pp_subs) ||
+        ((NULL == p_topic) && (len > 0))) {
+        return 0;
+    }
+
+    const uint8_t* p_bytes = (const uint8_t*)p_topic;
+    size_t count = 0;
+
+    p_index->match_gen++;
+    *pp_subs = p_index->p_match;
+
+    if (p_index->entries > 0) {
+        topic_entry_t* p_entry =
+            topic_entry_find(p_index, p_bytes, len, topic_hash(p_bytes, len));
+        if (NULL != p_entry) {
+            topic_set_collect(p_index, &p_entry->set, &count);
+        }
+    }
+
+    // NOTE: every node on topic path is a matching prefix
+    const topic_node_t* p_node = &p_index->root;
+    for (size_t depth = 0; NULL != p_node; depth++) {
+        topic_set_collect(p_index, &p_node->set, &count);
+        if (depth == len) {
+            break;
+        }
+        p_node = topic_node_kid(p_node, p_bytes[depth]);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Check if any pattern of subscriber matches topic
+ *
+ * Walks own patterns of subscriber only, so it suits rare per-subscriber
+ * checks, e.g. replay, while fanout uses @topic_match.
+ *
+ * @param p_index pointer to index
+ * @param sub subscriber
+ * @param p_topic topic bytes
+ * @param len topic length
+ * @return bool true if topic matches
+ */
+bool topic_sub_matches(const topic_index_t* p_index, uint32_t sub,
+                       const void* p_topic, size_t len) {
+    if ((NULL == p_index) || (sub >= p_index->cap) ||
+        ((NULL == p_topic) && (len > 0))) {
+        return false;
+    }
+
+    const uint8_t* p_bytes = (const uint8_t*)p_topic;
+
+    for (uint32_t rec = p_index->p_heads[sub]; TOPIC_NONE != rec;
+         rec = p_index->p_recs[rec].next) {
+        const topic_rec_t* p_rec = &p_index->p_recs[rec];
+
+        if (!p_rec->prefix) {
+            const topic_entry_t* p_entry = (const topic_entry_t*)p_rec->p_set;
+            if ((p_entry->len == len) &&
+                ((0 == len) || (0 == memcmp(p_entry->topic, p_bytes, len)))) {
+                return true;
+            }
+            continue;
+        }
+
+        // NOTE: node depth is prefix length, keys are compared bottom-up
+        const topic_node_t* p_node = (const topic_node_t*)p_rec->p_set;
+        size_t depth = 0;
+        for (const topic_node_t* p_up = p_node; NULL != p_up->p_parent;
+             p_up = p_up->p_parent) {
+            depth++;
+        }
+
+        if (depth > len) {
+            continue;
+        }
+
+        while ((NULL != p_node->p_parent) &&
+               (p_node->key == p_bytes[depth - 1])) {
+            p_node = p_node->p_parent;
+            depth--;
+        }
+
+        if (NULL == p_node->p_parent) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,327 @@
+/**
+ * @file      twheel.c
+ *
+ * @brief     Hierarchical timing wheel
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup twheel
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "twheel.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * DEFINES, CONSTS, ENUMS
+ ******************************************************************************/
+
+#define TWHEEL_MASK ((uint64_t)TWHEEL_SLOTS - 1u) /**< Slot index mask */
+/** Farthest reachable expiration, in ticks from now */
+#define TWHEEL_SPAN ((uint64_t)1 << (TWHEEL_BITS * TWHEEL_LEVELS))
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL DATA
+ ******************************************************************************/
+
+/******************************************************************************
+ * EXTERNAL FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+
+static void twheel_list_init(twheel_node_t* p_head);
+static void twheel_link(twheel_node_t* p_head, twheel_node_t* p_node);
+static void twheel_unlink(twheel_node_t* p_node);
+static void twheel_place(twheel_t* p_wheel, twheel_node_t* p_node,
+                         uint64_t base);
+static bool twheel_cascade(twheel_t* p_wheel, size_t level, uint64_t tick);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Make empty circular list
+ *
+ * @param p_head pointer to list head
+ */
+static void twheel_list_init(twheel_node_t* p_head) {
+    p_head->p_next = p_head;
+    p_head->p_prev = p_head;
+}
+
+/**
+ * @brief Link timer at the tail of list
+ *
+ * @param p_head pointer to list head
+ * @param p_node pointer to timer
+ */
+static void twheel_link(twheel_node_t* p_head, twheel_node_t* p_node) {
+    p_node->p_next = p_head;
+    p_node->p_prev = p_head->p_prev;
+    p_head->p_prev->p_next = p_node;
+    p_head->p_prev = p_node;
+}
+
+/**
+ * @brief Unlink timer from its list
+ *
+ * @param p_node pointer to timer
+ */
+static void twheel_unlink(twheel_node_t* p_node) {
+    p_node->p_prev->p_next = p_node->p_next;
+    p_node->p_next->p_prev = p_node->p_prev;
+    p_node->p_next = NULL;
+    p_node->p_prev = NULL;
+}
+
+/**
+ * @brief Link timer to the slot of its expiration
+ *
+ * Level is chosen by distance from base, slot - by expiration itself, so a
+ * slot of level L is reached exactly when its 64^L ticks begin.
+ *
+ * @param p_wheel pointer to wheel
+ * @param p_node pointer to timer
+ * @param base first tick not processed yet
+ */
+static void twheel_place(twheel_t* p_wheel, twheel_node_t* p_node,
+                         uint64_t base) {
+    // NOTE: overdue timer fires on the next processed tick, far one is
+    // clamped to the span and armed again by its owner
+    if (p_node->expires < base) {
+        p_node->expires = base;
+    } else if ((p_node->expires - base) >= TWHEEL_SPAN) {
+        p_node->expires = base + TWHEEL_SPAN - 1u;
+    }
+
+    const uint64_t delta = p_node->expires - base;
+    size_t level = 0;
+    while ((level < (TWHEEL_LEVELS - 1u)) &&
+           (delta >= ((uint64_t)1 << (TWHEEL_BITS * (level + 1u))))) {
+        level++;
+    }
+
+    const uint64_t idx = (p_node->expires >> (TWHEEL_BITS * level)) &
+                         TWHEEL_MASK;
+    twheel_link(&p_wheel->slots[level][idx], p_node);
+}
+
+/**
+ * @brief Move timers of level slot reached by tick one level down
+ *
+ * @param p_wheel pointer to wheel
+ * @param level level above 0
+ * @param tick tick being processed, multiple of 64^level
+ * @return bool true if the slot is the first one, so upper level is reached
+ * as well
+ */
+static bool twheel_cascade(twheel_t* p_wheel, size_t level, uint64_t tick) {
+    const uint64_t idx = (tick >> (TWHEEL_BITS * level)) & TWHEEL_MASK;
+    twheel_node_t* p_head = &p_wheel->slots[level][idx];
+
+    while (p_head->p_next != p_head) {
+        twheel_node_t* p_node = p_head->p_next;
+        twheel_unlink(p_node);
+        twheel_place(p_wheel, p_node, tick);
+    }
+
+    return 0u == idx;
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Init empty wheel
+ *
+ * @param p_wheel pointer to wheel
+ * @param tick_ms tick length, ms
+ * @param now_ms current time, ms
+ * @return int32_t 0 if OK, error otherwise
+ */
+int32_t twheel_init(twheel_t* p_wheel, uint64_t tick_ms, uint64_t now_ms) {
+    if ((NULL == p_wheel) || (0u == tick_ms)) {
+        return TWHEEL_ERR_PARAMS;
+    }
+
+    for (size_t level = 0; level < TWHEEL_LEVELS; level++) {
+        for (size_t idx = 0; idx < TWHEEL_SLOTS; idx++) {
+            twheel_list_init(&p_wheel->slots[level][idx]);
+        }
+    }
+
+    twheel_list_init(&p_wheel->expired);
+    p_wheel->tick_ms = tick_ms;
+    p_wheel->tick = now_ms / tick_ms;
+    p_wheel->count = 0;
+
+    return TWHEEL_ERR_OK;
+}
+
+/**
+ * @brief Arm timer, re-arm if it is armed already
+ *
+ * Timer fires on the first tick not earlier than at_ms.
+ *
+ * @param p_wheel pointer to wheel
+ * @param p_node pointer to timer, zeroed before first use
+ * @param at_ms expiration time, ms
+ */
+void twheel_arm(twheel_t* p_wheel, twheel_node_t* p_node, uint64_t at_ms) {
+    if (twheel_armed(p_node)) {
+        twheel_unlink(p_node);
+    } else {
+        p_wheel->count++;
+    }
+
+    p_node->expires = (at_ms + p_wheel->tick_ms - 1u) / p_wheel->tick_ms;
+    twheel_place(p_wheel, p_node, p_wheel->tick + 1u);
+}
+
+/**
+ * @brief Cancel timer. Not armed timer is ignored
+ *
+ * @param p_wheel pointer to wheel
+ * @param p_node pointer to timer
+ */
+void twheel_cancel(twheel_t* p_wheel, twheel_node_t* p_node) {
+    if (twheel_armed(p_node)) {
+        twheel_unlink(p_node);
+        p_wheel->count--;
+    }
+}
+
+/**
+ * @brief Process ticks up to current time
+ *
+ * Due timers are moved to expired list and taken by @twheel_pop.
+ *
+ * @param p_wheel pointer to wheel
+ * @param now_ms current time, ms
+ */
+void twheel_advance(twheel_t* p_wheel, uint64_t now_ms) {
+    const uint64_t target = now_ms / p_wheel->tick_ms;
+
+    // NOTE: empty wheel has nothing to cascade, so ticks are skipped
+    if (0u == p_wheel->count) {
+        if (target > p_wheel->tick) {
+            p_wheel->tick = target;
+        }
+        return;
+    }
+
+    while (p_wheel->tick < target) {
+        const uint64_t tick = p_wheel->tick + 1u;
+
+        if (0u == (tick & TWHEEL_MASK)) {
+            for (size_t level = 1;
+                 (level < TWHEEL_LEVELS) && twheel_cascade(p_wheel, level, tick);
+                 level++) {
+            }
+        }
+
+        twheel_node_t* p_head = &p_wheel->slots[0][tick & TWHEEL_MASK];
+        while (p_head->p_next != p_head) {
+            twheel_node_t* p_node = p_head->p_next;
+            twheel_unlink(p_node);
+            twheel_link(&p_wheel->expired, p_node);
+        }
+
+        p_wheel->tick = tick;
+    }
+}
+
+/**
+ * @brief Take one due timer
+ *
+ * Timer is not armed anymore, its owner may arm it again.
+ *
+ * @param p_wheel pointer to wheel
+ * @return twheel_node_t* timer or NULL if there are no due timers
+ */
+twheel_node_t* twheel_pop(twheel_t* p_wheel) {
+    twheel_node_t* p_node = p_wheel->expired.p_next;
+    if (p_node == &p_wheel->expired) {
+        return NULL;
+    }
+
+    twheel_unlink(p_node);
+    p_wheel->count--;
+
+    return p_node;
+}
+
+/**
+ * @brief Get time until next tick
+ *
+ * @param p_wheel pointer to wheel
+ * @param now_ms current time, ms
+ * @return int time in milliseconds, -1 if no timer is armed
+ */
+int twheel_wait_ms(const twheel_t* p_wheel, uint64_t now_ms) {
+    if (0u == p_wheel->count) {
+        return -1;
+    }
+
+    const uint64_t next_ms = (p_wheel->tick + 1u) * p_wheel->tick_ms;
+
+    return (next_ms > now_ms) ? (int)(next_ms - now_ms) : 0;
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
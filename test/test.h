@@ -0,0 +1,98 @@
+/**
+ * @file      test.h
+ *
+ * @brief     Unit tests - minimal checks and runner
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+#ifndef __TEST_H_
+#define __TEST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+/** Fail current test with location if condition is false */
+#define TEST_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "[TEST] %s:%d: check failed: %s\n", __FILE__, \
+                    __LINE__, #cond);                                      \
+            g_test_failed++;                                               \
+            return;                                                        \
+        }                                                                  \
+    } while (0)
+
+/** Run test function and report its result */
+#define TEST_RUN(fn)                                                     \
+    do {                                                                 \
+        const unsigned int before = g_test_failed;                       \
+        fn();                                                            \
+        printf("[TEST] %-40s %s\n", #fn,                                 \
+               (before == g_test_failed) ? "OK" : "FAIL");               \
+    } while (0)
+
+/** Exit code of test binary */
+#define TEST_EXIT() ((0u == g_test_failed) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+/** Failed tests of binary, every test file defines it once */
+extern unsigned int g_test_failed;
+
+/******************************************************************************
+ * END OF HEADER'S CODE
+ ******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __TEST_H_
+
+/** @}*/
@@ -0,0 +1,77 @@
+#!/bin/bash
+###############################################################################
+#
+# BSD 2-Clause License
+#
+# Copyright (c) 2024, Danil Borchevkin
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+#    this list of conditions and the following disclaimer in the documentation
+#    and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+# FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+###############################################################################
+
+# Integration test: local server, two topic publishers and three subscribers.
+# Usage: test_integration.sh <dir with srvc_* binaries>
+
+BIN=${1:?dir with binaries}
+TMP=$(mktemp -d)
+COUNT=5000
+FAILED=0
+
+${BIN}/srvc_server > ${TMP}/server.log 2>&1 &
+SERVER_PID=$!
+trap 'kill ${SERVER_PID} 2> /dev/null; rm -rf ${TMP}' EXIT
+sleep 0.5
+
+# Subscribers first, so nothing is published to nobody
+timeout -s INT 6 ${BIN}/srvc_client -q localhost 8888 > ${TMP}/all.log 2>&1 &
+CLIENT_PIDS=$!
+timeout -s INT 6 ${BIN}/srvc_client -q -T 'prices.*' localhost 8888 \
+    > ${TMP}/prices.log 2>&1 &
+CLIENT_PIDS="${CLIENT_PIDS} $!"
+timeout -s INT 6 ${BIN}/srvc_client -q -T news.x localhost 8888 \
+    > ${TMP}/news.log 2>&1 &
+CLIENT_PIDS="${CLIENT_PIDS} $!"
+sleep 0.5
+
+# NOTE: slow client policies drop frames, so rate keeps subscribers ahead
+${BIN}/srvc_controller -r 2000 -n ${COUNT} -T prices.eur localhost 8888 \
+    > /dev/null 2>&1 &
+${BIN}/srvc_controller -r 2000 -n ${COUNT} -T news.x localhost 8888 \
+    > /dev/null 2>&1
+wait ${CLIENT_PIDS}
+
+# check <name> <expected counters>
+check() {
+    if grep -q "Frames <$2" ${TMP}/$1.log; then
+        echo "[TEST] integration $1 OK"
+    else
+        echo "[TEST] integration $1 FAIL: $(grep Frames ${TMP}/$1.log)"
+        FAILED=1
+    fi
+}
+
+# NOTE: sequences of two publishers interleave, only one topic is in order
+check all "$((2 * COUNT))> unstamped <0>"
+check prices "${COUNT}> unstamped <0> lost <0> reordered <0>"
+check news "${COUNT}> unstamped <0> lost <0> reordered <0>"
+
+exit ${FAILED}
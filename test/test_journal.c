@@ -0,0 +1,417 @@
+/**
+ * @file      test_journal.c
+ *
+ * @brief     Unit tests - journal
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "journal.h"
+#include "log.h"
+#include "msg.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define FRAME_LEN ((size_t)1024) /**< Size of test frame */
+#define REC_LEN ((size_t)1040) /**< Record of test frame with header */
+#define SEG_SIZE ((size_t)128 * 1024) /**< Segment, fits one max frame */
+#define SEG_RECS (SEG_SIZE / REC_LEN) /**< Test records per segment */
+#define SEQ(num) ((uint64_t)(num) + 1000u) /**< Sequence of test frame */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Create empty temporary journal directory
+ */
+static bool dir_make(char* p_dir) {
+    strcpy(p_dir, "/tmp/test_journal.XXXXXX");
+    return NULL != mkdtemp(p_dir);
+}
+
+/**
+ * @brief Remove journal directory with its files
+ */
+static void dir_remove(const char* p_dir) {
+    char path[PATH_MAX];
+    DIR* p_handle = opendir(p_dir);
+    struct dirent* p_ent = NULL;
+
+    while ((NULL != p_handle) && (NULL != (p_ent = readdir(p_handle)))) {
+        if ('.' != p_ent->d_name[0]) {
+            snprintf(path, sizeof(path), "%s/%s", p_dir, p_ent->d_name);
+            unlink(path);
+        }
+    }
+    if (NULL != p_handle) {
+        closedir(p_handle);
+    }
+    rmdir(p_dir);
+}
+
+/**
+ * @brief Count files of directory with suffix
+ */
+static size_t dir_count(const char* p_dir, const char* p_suffix) {
+    DIR* p_handle = opendir(p_dir);
+    struct dirent* p_ent = NULL;
+    size_t count = 0;
+
+    while ((NULL != p_handle) && (NULL != (p_ent = readdir(p_handle)))) {
+        const size_t len = strlen(p_ent->d_name);
+        if ((len > strlen(p_suffix)) &&
+            (0 == strcmp(&p_ent->d_name[len - strlen(p_suffix)], p_suffix))) {
+            count++;
+        }
+    }
+    if (NULL != p_handle) {
+        closedir(p_handle);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Build path of journal file, same naming as journal
+ */
+static void file_path(const char* p_dir, uint64_t first, const char* p_suffix,
+                      char* p_path) {
+    snprintf(p_path, PATH_MAX, "%s/%020llu%s", p_dir,
+             (unsigned long long)first, p_suffix);
+}
+
+/**
+ * @brief Queue frame carrying number in its first bytes and its sequence
+ */
+static void append(journal_t* p_journal, uint64_t num) {
+    uint8_t buf[FRAME_LEN];
+
+    memset(buf, 0xA5, sizeof(buf));
+    memcpy(buf, &num, sizeof(num));
+
+    msg_t* p_msg = msg_create(buf, sizeof(buf));
+    TEST_CHECK(NULL != p_msg);
+    p_msg->seq = SEQ(num);
+    TEST_CHECK(JOURNAL_ERR_OK == journal_append(p_journal, p_msg));
+    msg_unref(p_msg);
+}
+
+/**
+ * @brief Write frames with numbers [from, to) into journal and close it
+ */
+static bool write_range(const char* p_dir, size_t segs_max, uint64_t from,
+                        uint64_t to) {
+    journal_t journal;
+
+    if (JOURNAL_ERR_OK != journal_open(&journal, p_dir, SEG_SIZE, segs_max)) {
+        return false;
+    }
+
+    // NOTE: without writer thread close appends the whole queue
+    for (uint64_t num = from; num < to; num++) {
+        append(&journal, num);
+    }
+    journal_close(&journal);
+
+    return true;
+}
+
+/**
+ * @brief Read records from given one and check numbers carried by frames
+ * and sequences of records
+ */
+static bool read_is(const journal_t* p_journal, uint64_t from,
+                    const uint64_t* p_nums, size_t count) {
+    journal_iter_t iter;
+    const uint8_t* p_frame = NULL;
+    size_t size = 0;
+    uint64_t seq = 0;
+    bool ok = (JOURNAL_ERR_OK == journal_iter_init(p_journal, &iter, from));
+
+    for (size_t idx = 0; ok && (idx < count); idx++) {
+        uint64_t num = 0;
+        ok = (JOURNAL_ERR_OK ==
+              journal_iter_next(&iter, &p_frame, &size, &seq)) &&
+             (FRAME_LEN == size);
+        if (ok) {
+            memcpy(&num, p_frame, sizeof(num));
+            ok = (p_nums[idx] == num) && (SEQ(num) == seq);
+        }
+    }
+
+    ok = ok && (JOURNAL_ERR_EMPTY ==
+                journal_iter_next(&iter, &p_frame, &size, &seq));
+    journal_iter_deinit(&iter);
+
+    return ok;
+}
+
+/**
+ * @brief Read records from given one up to the end, frames carry their
+ * record numbers. Reading starts at the oldest retained record at latest
+ */
+static bool read_range(const journal_t* p_journal, uint64_t from,
+                       uint64_t to) {
+    static uint64_t nums[4 * SEG_RECS];
+    const uint64_t first = journal_first(p_journal);
+    const uint64_t start = (from > first) ? from : first;
+
+    for (uint64_t num = start; num < to; num++) {
+        nums[num - start] = num;
+    }
+
+    return read_is(p_journal, from, nums, (size_t)(to - start));
+}
+
+static void test_journal_params(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(JOURNAL_ERR_PARAMS == journal_open(&journal, dir, 4096, 4));
+    TEST_CHECK(JOURNAL_ERR_PARAMS == journal_open(&journal, dir, SEG_SIZE, 0));
+    TEST_CHECK(JOURNAL_ERR_PARAMS == journal_open(&journal, NULL, SEG_SIZE, 4));
+
+    // NOTE: empty journal has one empty segment and nothing to read
+    journal_iter_t iter;
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(0 == journal.next);
+    TEST_CHECK(JOURNAL_ERR_EMPTY == journal_iter_init(&journal, &iter, 0));
+    journal_close(&journal);
+
+    dir_remove(dir);
+}
+
+static void test_journal_reopen(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(write_range(dir, 4, 0, 10));
+    TEST_CHECK(write_range(dir, 4, 10, 20));
+
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(20 == journal.next);
+    TEST_CHECK(read_range(&journal, 0, 20));
+    TEST_CHECK(read_range(&journal, 15, 20));
+    journal_close(&journal);
+
+    dir_remove(dir);
+}
+
+static void test_journal_rotation(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+    const uint64_t total = (3u * SEG_RECS) + 10u;
+
+    // NOTE: four segments written, the oldest one is over limit
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(write_range(dir, 3, 0, total));
+    TEST_CHECK(3 == dir_count(dir, JOURNAL_SEG_SUFFIX));
+    TEST_CHECK(3 == dir_count(dir, JOURNAL_IDX_SUFFIX));
+
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 3));
+    TEST_CHECK(3 == journal.segs_count);
+    TEST_CHECK(SEG_RECS == journal_first(&journal));
+    TEST_CHECK((3u * SEG_RECS) == journal.seg.first);
+    TEST_CHECK(total == journal.next);
+
+    // NOTE: removed records are skipped, reader crosses segments
+    TEST_CHECK(read_range(&journal, 0, total));
+    TEST_CHECK(read_range(&journal, (2u * SEG_RECS) - 1u, total));
+    journal_close(&journal);
+
+    dir_remove(dir);
+}
+
+static void test_journal_sparse_index(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+    char path[PATH_MAX];
+    const uint64_t total = 2u * SEG_RECS;
+
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(write_range(dir, 4, 0, total));
+
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+
+    // NOTE: one entry per CONFIG_JOURNAL_INDEX_STEP records of last segment
+    const journal_seg_t* p_seg = &journal.seg;
+    const size_t entries =
+        (size_t)((SEG_RECS + CONFIG_JOURNAL_INDEX_STEP - 1u) /
+                 CONFIG_JOURNAL_INDEX_STEP);
+    TEST_CHECK(entries == p_seg->idx_used);
+    for (size_t entry = 0; entry < entries; entry++) {
+        const uint64_t index =
+            SEG_RECS + ((uint64_t)entry * CONFIG_JOURNAL_INDEX_STEP);
+        uint64_t num = 0;
+        TEST_CHECK(index == p_seg->p_idx[entry].index);
+        TEST_CHECK(((index - SEG_RECS) * REC_LEN) ==
+                   p_seg->p_idx[entry].offset);
+        memcpy(&num,
+               &p_seg->p_map[p_seg->p_idx[entry].offset +
+                             sizeof(journal_rec_t)],
+               sizeof(num));
+        TEST_CHECK(index == num);
+    }
+
+    // NOTE: start next to entries, on them and at segment edges
+    const uint64_t step = CONFIG_JOURNAL_INDEX_STEP;
+    TEST_CHECK(read_range(&journal, step - 1u, total));
+    TEST_CHECK(read_range(&journal, step, total));
+    TEST_CHECK(read_range(&journal, step + 1u, total));
+    TEST_CHECK(read_range(&journal, SEG_RECS - 1u, total));
+    TEST_CHECK(read_range(&journal, SEG_RECS + step + 3u, total));
+    TEST_CHECK(read_range(&journal, total - 1u, total));
+    journal_iter_t iter;
+    TEST_CHECK(JOURNAL_ERR_EMPTY == journal_iter_init(&journal, &iter, total));
+
+    // NOTE: without index the segment is scanned from its start
+    file_path(dir, 0, JOURNAL_IDX_SUFFIX, path);
+    TEST_CHECK(0 == truncate(path, 0));
+    TEST_CHECK(read_range(&journal, step + 1u, total));
+    journal_close(&journal);
+
+    dir_remove(dir);
+}
+
+static void test_journal_torn_tail(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+    char path[PATH_MAX];
+    const uint8_t garbage = 0x5A;
+
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(write_range(dir, 4, 0, 100));
+
+    // NOTE: last record lost part of its frame in a crash
+    file_path(dir, 0, JOURNAL_SEG_SUFFIX, path);
+    const int fd = open(path, O_WRONLY);
+    TEST_CHECK(-1 != fd);
+    TEST_CHECK(1 == pwrite(fd, &garbage, 1, (off_t)((99u * REC_LEN) + 100u)));
+    close(fd);
+
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(99 == journal.next);
+    TEST_CHECK(read_range(&journal, 0, 99));
+    journal_close(&journal);
+
+    // NOTE: new record takes place of torn one
+    TEST_CHECK(write_range(dir, 4, 1000, 1001));
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(100 == journal.next);
+    const uint64_t nums[] = {97, 98, 1000};
+    TEST_CHECK(read_is(&journal, 97, nums, 3));
+    journal_close(&journal);
+
+    dir_remove(dir);
+}
+
+static void test_journal_writer(void) {
+    journal_t journal;
+    char dir[PATH_MAX];
+    const struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000};
+
+    TEST_CHECK(dir_make(dir));
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(JOURNAL_ERR_OK == journal_start(&journal));
+
+    for (uint64_t num = 0; num < SEG_RECS + 5u; num++) {
+        append(&journal, num);
+        if (0 == (num % 16u)) {
+            nanosleep(&pause, NULL);
+        }
+    }
+    journal_close(&journal);
+
+    TEST_CHECK(JOURNAL_ERR_OK == journal_open(&journal, dir, SEG_SIZE, 4));
+    TEST_CHECK(read_range(&journal, 0, SEG_RECS + 5u));
+    journal_close(&journal);
+
+    msg_stats_t stats;
+    msg_stats(&stats);
+    TEST_CHECK(0 == stats.in_use);
+
+    dir_remove(dir);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    // NOTE: rotation info lines would mix with test report
+    g_log_level = LOG_LEVEL_ERROR;
+
+    TEST_RUN(test_journal_params);
+    TEST_RUN(test_journal_reopen);
+    TEST_RUN(test_journal_rotation);
+    TEST_RUN(test_journal_sparse_index);
+    TEST_RUN(test_journal_torn_tail);
+    TEST_RUN(test_journal_writer);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,416 @@
+/**
+ * @file      test_outq.c
+ *
+ * @brief     Unit tests - client outbound queue
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "config.h"
+#include "msg.h"
+#include "proto.h"
+#include "server.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define FRAME_LEN (PROTO_HDR_SIZE + 9u) /**< Frame: topic and 8 bytes */
+#define TOPIC_A "a" /**< Topic of keyed frames */
+#define TOPIC_B "b" /**< Another topic */
+#define KEY_A ((uint32_t)11) /**< Key of TOPIC_A */
+#define KEY_B ((uint32_t)22) /**< Key of TOPIC_B */
+#define KEY_NONE ((uint32_t)33) /**< Key never pushed */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Create data frame of topic with seq as its identity
+ *
+ * @param p_topic topic, one byte
+ * @param seq sequence number
+ * @return msg_t* message, caller owns one reference
+ */
+static msg_t* frame(const char* p_topic, uint64_t seq) {
+    uint8_t buf[FRAME_LEN];
+    proto_hdr_t hdr = {.len = 9u,
+                       .type = PROTO_TYPE_DATA,
+                       .flags = 1u,
+                       .seq = seq};
+
+    proto_hdr_encode(buf, &hdr);
+    buf[PROTO_HDR_SIZE] = (uint8_t)p_topic[0];
+    memset(&buf[PROTO_HDR_SIZE + 1u], 'x', 8);
+
+    return msg_create(buf, sizeof(buf));
+}
+
+/**
+ * @brief Push new frame, queue keeps the only reference
+ */
+static int32_t push(server_outq_t* p_outq, uint64_t seq) {
+    msg_t* p_msg = frame(TOPIC_B, seq);
+    int32_t ret = server_outq_push(p_outq, p_msg);
+    msg_unref(p_msg);
+    return ret;
+}
+
+/**
+ * @brief Replace newest frame, queue keeps the only reference
+ */
+static int32_t replace(server_outq_t* p_outq, uint64_t seq) {
+    msg_t* p_msg = frame(TOPIC_B, seq);
+    int32_t ret = server_outq_replace_newest(p_outq, p_msg);
+    msg_unref(p_msg);
+    return ret;
+}
+
+/**
+ * @brief Push new keyed frame, queue keeps the only reference
+ */
+static int32_t push_key(server_outq_t* p_outq, const char* p_topic,
+                        uint32_t key, uint64_t seq) {
+    msg_t* p_msg = frame(p_topic, seq);
+    int32_t ret = server_outq_push_key(p_outq, p_msg, key);
+    msg_unref(p_msg);
+    return ret;
+}
+
+/**
+ * @brief Replace keyed frame, queue keeps the only reference
+ */
+static int32_t replace_key(server_outq_t* p_outq, const char* p_topic,
+                           uint32_t key, uint64_t seq) {
+    msg_t* p_msg = frame(p_topic, seq);
+    int32_t ret = server_outq_replace_key(p_outq, p_msg, key);
+    msg_unref(p_msg);
+    return ret;
+}
+
+/**
+ * @brief Check that queued frames have exactly these seqs in order
+ */
+static bool seqs_are(const server_outq_t* p_outq, const uint64_t* p_seqs,
+                     size_t count) {
+    struct iovec iov[CONFIG_SRV_OUTQ_SIZE];
+
+    if (count != server_outq_iov(p_outq, iov, CONFIG_SRV_OUTQ_SIZE)) {
+        return false;
+    }
+
+    for (size_t idx = 0; idx < count; idx++) {
+        proto_hdr_t hdr;
+        // NOTE: partially sent head starts in the middle of its frame
+        const uint8_t* p_frame = (0 == idx)
+                                     ? (const uint8_t*)iov[0].iov_base -
+                                           p_outq->sent
+                                     : (const uint8_t*)iov[idx].iov_base;
+        proto_hdr_decode(p_frame, &hdr);
+        if (p_seqs[idx] != hdr.seq) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check that no message is alive, so queue dropped all references
+ */
+static bool no_leaks(void) {
+    msg_stats_t stats;
+    msg_stats(&stats);
+    return 0 == stats.in_use;
+}
+
+static void test_outq_wrap_keeps_order(void) {
+    server_outq_t outq = {0};
+
+    // NOTE: move head to the middle, so the ring wraps
+    for (uint64_t seq = 1; seq <= CONFIG_SRV_OUTQ_SIZE; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+    server_outq_consume(&outq, (CONFIG_SRV_OUTQ_SIZE - 2u) * FRAME_LEN);
+    for (uint64_t seq = 1; seq <= 3; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, CONFIG_SRV_OUTQ_SIZE + seq));
+    }
+
+    const uint64_t seqs[] = {CONFIG_SRV_OUTQ_SIZE - 1u, CONFIG_SRV_OUTQ_SIZE,
+                             CONFIG_SRV_OUTQ_SIZE + 1u,
+                             CONFIG_SRV_OUTQ_SIZE + 2u,
+                             CONFIG_SRV_OUTQ_SIZE + 3u};
+    TEST_CHECK(seqs_are(&outq, seqs, sizeof(seqs) / sizeof(seqs[0])));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_grow_keeps_order(void) {
+    server_outq_t outq = {0};
+
+    // NOTE: move head inside the first ring, so grow has to unwrap it
+    for (uint64_t seq = 1; seq <= 3; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+    TEST_CHECK(CONFIG_SRV_OUTQ_MIN == outq.cap);
+    TEST_CHECK(SERVER_ERR_OK == server_outq_drop_oldest(&outq));
+    TEST_CHECK(SERVER_ERR_OK == server_outq_drop_oldest(&outq));
+
+    for (uint64_t seq = 4; seq <= 12; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+
+    const uint64_t seqs[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    TEST_CHECK(CONFIG_SRV_OUTQ_SIZE == outq.cap);
+    TEST_CHECK(seqs_are(&outq, seqs, sizeof(seqs) / sizeof(seqs[0])));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_full(void) {
+    server_outq_t outq = {0};
+
+    for (uint64_t seq = 1; seq <= CONFIG_SRV_OUTQ_SIZE; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+    TEST_CHECK(SERVER_ERR_FULL == push(&outq, 0));
+    TEST_CHECK(CONFIG_SRV_OUTQ_SIZE == outq.count);
+    TEST_CHECK(!no_leaks());
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_partial_send(void) {
+    server_outq_t outq = {0};
+
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 1));
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 2));
+
+    server_outq_consume(&outq, 5);
+    TEST_CHECK(5 == outq.sent);
+    TEST_CHECK(2 == outq.count);
+
+    // NOTE: rest of head and part of the next one
+    server_outq_consume(&outq, FRAME_LEN);
+    TEST_CHECK(5 == outq.sent);
+    TEST_CHECK(1 == outq.count);
+
+    const uint64_t seqs[] = {2};
+    TEST_CHECK(seqs_are(&outq, seqs, 1));
+
+    server_outq_consume(&outq, FRAME_LEN - 5);
+    TEST_CHECK(0 == outq.count);
+    TEST_CHECK(0 == outq.sent);
+    TEST_CHECK(no_leaks());
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_release_on_drain(void) {
+    server_outq_t outq = {0};
+
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 1));
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_A, KEY_A, 2));
+
+    server_outq_consume(&outq, 5);
+    TEST_CHECK(5 == outq.sent);
+    TEST_CHECK(2 == outq.count);
+
+    // NOTE: drained queue holds neither ring nor keyed index
+    server_outq_consume(&outq, (2 * FRAME_LEN) - 5);
+    TEST_CHECK(0 == outq.count);
+    TEST_CHECK(NULL == outq.pp_msgs);
+    TEST_CHECK(NULL == outq.p_last);
+    TEST_CHECK(0 == outq.cap);
+    TEST_CHECK(no_leaks());
+
+    // NOTE: and takes the first ring again on next push
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 3));
+    TEST_CHECK(CONFIG_SRV_OUTQ_MIN == outq.cap);
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_drop_partial_head(void) {
+    server_outq_t outq = {0};
+
+    for (uint64_t seq = 1; seq <= 3; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+
+    // NOTE: partially sent head stays, the next one goes
+    server_outq_consume(&outq, 1);
+    TEST_CHECK(SERVER_ERR_OK == server_outq_drop_oldest(&outq));
+
+    const uint64_t seqs[] = {1, 3};
+    TEST_CHECK(1 == outq.sent);
+    TEST_CHECK(seqs_are(&outq, seqs, 2));
+
+    // NOTE: nothing left to drop but the head
+    TEST_CHECK(SERVER_ERR_OK == server_outq_drop_oldest(&outq));
+    TEST_CHECK(SERVER_ERR_OK != server_outq_drop_oldest(&outq));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_replace_newest(void) {
+    server_outq_t outq = {0};
+
+    TEST_CHECK(SERVER_ERR_OK != replace(&outq, 1));
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 1));
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 2));
+    TEST_CHECK(SERVER_ERR_OK == replace(&outq, 3));
+
+    const uint64_t seqs[] = {1, 3};
+    TEST_CHECK(seqs_are(&outq, seqs, 2));
+
+    // NOTE: bytes of the only message are on the wire already
+    server_outq_consume(&outq, FRAME_LEN + 1u);
+    TEST_CHECK(SERVER_ERR_OK != replace(&outq, 4));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_keyed_replace(void) {
+    server_outq_t outq = {0};
+
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_A, KEY_A, 1));
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_B, KEY_B, 2));
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_A, KEY_A, 3));
+
+    // NOTE: only the newest frame of topic is replaced
+    TEST_CHECK(SERVER_ERR_OK == replace_key(&outq, TOPIC_A, KEY_A, 4));
+    TEST_CHECK(SERVER_ERR_AGAIN == replace_key(&outq, TOPIC_A, KEY_NONE, 5));
+
+    // NOTE: key collision with another topic is not a replace
+    TEST_CHECK(SERVER_ERR_AGAIN == replace_key(&outq, TOPIC_B, KEY_A, 6));
+
+    const uint64_t seqs[] = {1, 2, 4};
+    TEST_CHECK(seqs_are(&outq, seqs, 3));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_keyed_partial_head(void) {
+    server_outq_t outq = {0};
+
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_A, KEY_A, 1));
+    server_outq_consume(&outq, 1);
+
+    // NOTE: bytes of head are on the wire already
+    TEST_CHECK(SERVER_ERR_AGAIN == replace_key(&outq, TOPIC_A, KEY_A, 2));
+
+    // NOTE: consumed position is not replaced after the ring moves on
+    server_outq_consume(&outq, FRAME_LEN - 1u);
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 3));
+    TEST_CHECK(SERVER_ERR_AGAIN == replace_key(&outq, TOPIC_A, KEY_A, 4));
+
+    const uint64_t seqs[] = {3};
+    TEST_CHECK(seqs_are(&outq, seqs, 1));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+static void test_outq_keyed_after_grow(void) {
+    server_outq_t outq = {0};
+
+    // NOTE: keyed position is remapped when the first ring grows
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 1));
+    TEST_CHECK(SERVER_ERR_OK == push(&outq, 2));
+    TEST_CHECK(SERVER_ERR_OK == server_outq_drop_oldest(&outq));
+    TEST_CHECK(SERVER_ERR_OK == push_key(&outq, TOPIC_A, KEY_A, 3));
+    for (uint64_t seq = 4; seq <= 12; seq++) {
+        TEST_CHECK(SERVER_ERR_OK == push(&outq, seq));
+    }
+    TEST_CHECK(CONFIG_SRV_OUTQ_SIZE == outq.cap);
+
+    TEST_CHECK(SERVER_ERR_OK == replace_key(&outq, TOPIC_A, KEY_A, 30));
+
+    const uint64_t seqs[] = {2, 30, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    TEST_CHECK(seqs_are(&outq, seqs, sizeof(seqs) / sizeof(seqs[0])));
+
+    server_outq_clear(&outq);
+    TEST_CHECK(no_leaks());
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_outq_wrap_keeps_order);
+    TEST_RUN(test_outq_grow_keeps_order);
+    TEST_RUN(test_outq_full);
+    TEST_RUN(test_outq_partial_send);
+    TEST_RUN(test_outq_release_on_drain);
+    TEST_RUN(test_outq_drop_partial_head);
+    TEST_RUN(test_outq_replace_newest);
+    TEST_RUN(test_outq_keyed_replace);
+    TEST_RUN(test_outq_keyed_partial_head);
+    TEST_RUN(test_outq_keyed_after_grow);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
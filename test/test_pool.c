@@ -0,0 +1,222 @@
+/**
+ * @file      test_pool.c
+ *
+ * @brief     Unit tests - slab pools
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "pool.h"
+#include "ring.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define OBJ_SIZE ((size_t)1000) /**< Object size, not cache line aligned */
+#define OBJ_COUNT ((size_t)100000) /**< Objects passed between threads */
+#define RING_SIZE ((size_t)256) /**< Objects in flight between threads */
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static pool_t g_pool = POOL_INITIALIZER("test", OBJ_SIZE); /**< Single thread */
+static pool_t g_shared = POOL_INITIALIZER("shared", OBJ_SIZE); /**< Passed */
+static ring_mpsc_t g_ring; /**< Allocated objects, producer to main thread */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Producer thread: allocate objects, stamp and pass them on
+ *
+ * @param p_arg unused
+ * @return void* NULL
+ */
+static void* producer(void* p_arg) {
+    (void)p_arg;
+
+    for (size_t num = 0; num < OBJ_COUNT; num++) {
+        uint8_t* p_obj = pool_alloc(&g_shared);
+        if (NULL == p_obj) {
+            return NULL;
+        }
+
+        memcpy(p_obj, &num, sizeof(num));
+        memset(&p_obj[sizeof(num)], (int)(num & 0xFFu),
+               OBJ_SIZE - sizeof(num));
+        while (RING_ERR_FULL == ring_mpsc_push(&g_ring, p_obj)) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check that object holds stamp of producer
+ */
+static bool stamp_is(const uint8_t* p_obj, size_t num) {
+    size_t stamp = 0;
+
+    memcpy(&stamp, p_obj, sizeof(stamp));
+    return (num == stamp) && (p_obj[OBJ_SIZE - 1u] == (uint8_t)(num & 0xFFu));
+}
+
+static void test_pool_alloc_free(void) {
+    uint8_t* p_objs[CONFIG_POOL_CACHE_SIZE];
+    pool_stats_t stats;
+
+    for (size_t idx = 0; idx < CONFIG_POOL_CACHE_SIZE; idx++) {
+        p_objs[idx] = pool_alloc(&g_pool);
+        TEST_CHECK(NULL != p_objs[idx]);
+
+        // NOTE: objects start on cache lines and never overlap
+        TEST_CHECK(0 == ((uintptr_t)p_objs[idx] % 64u));
+        memset(p_objs[idx], (int)idx, OBJ_SIZE);
+    }
+    for (size_t idx = 0; idx < CONFIG_POOL_CACHE_SIZE; idx++) {
+        TEST_CHECK((uint8_t)idx == p_objs[idx][0]);
+        TEST_CHECK((uint8_t)idx == p_objs[idx][OBJ_SIZE - 1u]);
+    }
+
+    pool_usage(&g_pool, &stats);
+    TEST_CHECK(0 == strcmp("test", stats.name));
+    TEST_CHECK(OBJ_SIZE == stats.size);
+    TEST_CHECK(1 == stats.chunks);
+    TEST_CHECK(stats.used >= CONFIG_POOL_CACHE_SIZE);
+
+    // NOTE: thread cache is LIFO, freed object comes back first
+    uint8_t* p_last = p_objs[CONFIG_POOL_CACHE_SIZE - 1u];
+    pool_free(&g_pool, p_last);
+    TEST_CHECK(p_last == pool_alloc(&g_pool));
+
+    for (size_t idx = 0; idx < CONFIG_POOL_CACHE_SIZE; idx++) {
+        pool_free(&g_pool, p_objs[idx]);
+    }
+    pool_free(&g_pool, NULL);
+
+    pool_usage(&g_pool, &stats);
+    TEST_CHECK(1 == stats.chunks);
+}
+
+static void test_pool_cross_thread_free(void) {
+    pthread_t thread;
+    pool_stats_t stats;
+
+    TEST_CHECK(RING_ERR_OK == ring_mpsc_init(&g_ring, RING_SIZE));
+    TEST_CHECK(0 == pthread_create(&thread, NULL, producer, NULL));
+
+    // NOTE: every object is freed by other thread than allocated it
+    for (size_t num = 0; num < OBJ_COUNT; num++) {
+        void* p_obj = NULL;
+        while (RING_ERR_OK != ring_mpsc_pop(&g_ring, &p_obj)) {
+            sched_yield();
+        }
+        TEST_CHECK(stamp_is(p_obj, num));
+        pool_free(&g_shared, p_obj);
+    }
+    TEST_CHECK(0 == pthread_join(thread, NULL));
+    ring_mpsc_deinit(&g_ring);
+
+    // NOTE: freed objects flow back to producer, first chunk is enough
+    pool_usage(&g_shared, &stats);
+    TEST_CHECK(1 == stats.chunks);
+
+    // NOTE: left only in cache of main thread and of exited producer
+    TEST_CHECK(stats.used <= (CONFIG_POOL_CACHE_SIZE + CONFIG_POOL_BATCH));
+
+    // NOTE: main thread reuses objects it freed, no new chunk
+    void* p_objs[CONFIG_POOL_CACHE_SIZE];
+    for (size_t idx = 0; idx < CONFIG_POOL_CACHE_SIZE; idx++) {
+        p_objs[idx] = pool_alloc(&g_shared);
+        TEST_CHECK(NULL != p_objs[idx]);
+    }
+    for (size_t idx = 0; idx < CONFIG_POOL_CACHE_SIZE; idx++) {
+        pool_free(&g_shared, p_objs[idx]);
+    }
+    pool_usage(&g_shared, &stats);
+    TEST_CHECK(1 == stats.chunks);
+}
+
+static void test_pool_stats(void) {
+    pool_stats_t stats[POOL_MAX];
+
+    // NOTE: pools register on first use, in order of it
+    const size_t count = pool_stats(stats, POOL_MAX);
+    TEST_CHECK(2 == count);
+    TEST_CHECK(0 == strcmp("test", stats[0].name));
+    TEST_CHECK(0 == strcmp("shared", stats[1].name));
+    TEST_CHECK(1 == pool_stats(stats, 1));
+    TEST_CHECK(0 == pool_stats(NULL, POOL_MAX));
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_pool_alloc_free);
+    TEST_RUN(test_pool_cross_thread_free);
+    TEST_RUN(test_pool_stats);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
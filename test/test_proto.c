@@ -0,0 +1,243 @@
+/**
+ * @file      test_proto.c
+ *
+ * @brief     Unit tests - frame header and streaming parser
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "proto.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define FRAMES ((size_t)3) /**< Frames in test stream */
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static uint8_t g_stream[FRAMES * (PROTO_HDR_SIZE + 16)]; /**< Test stream */
+static size_t g_stream_len = 0;                          /**< Its length */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Build stream of FRAMES data frames, frame N has N * 7 payload bytes
+ */
+static void stream_build(void) {
+    g_stream_len = 0;
+    for (size_t idx = 0; idx < FRAMES; idx++) {
+        proto_hdr_t hdr = {.len = (uint32_t)(idx * 7u),
+                           .type = PROTO_TYPE_DATA,
+                           .seq = idx + 1u,
+                           .ts = 1000u + idx};
+
+        proto_hdr_encode(&g_stream[g_stream_len], &hdr);
+        memset(&g_stream[g_stream_len + PROTO_HDR_SIZE], (int)('a' + idx),
+               hdr.len);
+        g_stream_len += PROTO_FRAME_SIZE(&hdr);
+    }
+}
+
+/**
+ * @brief Check that frame is the idx-th one of test stream
+ */
+static bool frame_ok(const proto_frame_t* p_frame, size_t idx) {
+    if ((PROTO_TYPE_DATA != p_frame->hdr.type) ||
+        ((idx + 1u) != p_frame->hdr.seq) ||
+        ((1000u + idx) != p_frame->hdr.ts) ||
+        ((idx * 7u) != p_frame->hdr.len)) {
+        return false;
+    }
+
+    for (size_t pos = 0; pos < p_frame->hdr.len; pos++) {
+        if ((uint8_t)('a' + idx) != p_frame->p_payload[pos]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_proto_hdr_roundtrip(void) {
+    uint8_t buf[PROTO_HDR_SIZE];
+    proto_hdr_t in = {.len = 0x01020304u,
+                      .type = PROTO_TYPE_DATA,
+                      .flags = 0xA0B0u,
+                      .seq = 0x1122334455667788ull,
+                      .ts = 0x8877665544332211ull};
+    proto_hdr_t out;
+
+    proto_hdr_encode(buf, &in);
+    proto_hdr_decode(buf, &out);
+
+    // NOTE: wire format is big-endian
+    TEST_CHECK(0x01 == buf[0]);
+    TEST_CHECK(0x04 == buf[3]);
+    TEST_CHECK(0 == memcmp(&in, &out, sizeof(in)));
+}
+
+static void test_proto_parser_in_place(void) {
+    proto_parser_t parser;
+    proto_frame_t frame;
+
+    stream_build();
+    proto_parser_init(&parser);
+    proto_parser_feed(&parser, g_stream, g_stream_len);
+
+    for (size_t idx = 0; idx < FRAMES; idx++) {
+        TEST_CHECK(PROTO_ERR_OK == proto_parser_next(&parser, &frame));
+        TEST_CHECK(frame_ok(&frame, idx));
+        TEST_CHECK((frame.p_data >= g_stream) &&
+                   (frame.p_data < &g_stream[g_stream_len]));
+    }
+
+    TEST_CHECK(PROTO_ERR_AGAIN == proto_parser_next(&parser, &frame));
+    TEST_CHECK(NULL == parser.p_buf);
+    proto_parser_deinit(&parser);
+}
+
+static void test_proto_parser_byte_by_byte(void) {
+    proto_parser_t parser;
+    proto_frame_t frame;
+    size_t count = 0;
+
+    stream_build();
+    proto_parser_init(&parser);
+
+    for (size_t pos = 0; pos < g_stream_len; pos++) {
+        proto_parser_feed(&parser, &g_stream[pos], 1);
+
+        int32_t ret = PROTO_ERR_OK;
+        while (PROTO_ERR_OK == (ret = proto_parser_next(&parser, &frame))) {
+            TEST_CHECK(frame_ok(&frame, count));
+            count++;
+        }
+        TEST_CHECK(PROTO_ERR_AGAIN == ret);
+    }
+
+    TEST_CHECK(FRAMES == count);
+    TEST_CHECK(0 == parser.len);
+    proto_parser_deinit(&parser);
+}
+
+static void test_proto_parser_moved(void) {
+    proto_parser_t shared;
+    proto_parser_t own;
+    proto_frame_t frame;
+    const size_t split = PROTO_HDR_SIZE + 3u;
+
+    // NOTE: server parks partial frame by copying shared parser state
+    stream_build();
+    proto_parser_init(&shared);
+    proto_parser_feed(&shared, g_stream, split);
+    TEST_CHECK(PROTO_ERR_OK == proto_parser_next(&shared, &frame));
+    TEST_CHECK(frame_ok(&frame, 0));
+    TEST_CHECK(PROTO_ERR_AGAIN == proto_parser_next(&shared, &frame));
+    TEST_CHECK(shared.len > 0);
+
+    own = shared;
+    proto_parser_init(&shared);
+    proto_parser_feed(&own, &g_stream[split], g_stream_len - split);
+    TEST_CHECK(PROTO_ERR_OK == proto_parser_next(&own, &frame));
+    TEST_CHECK(frame_ok(&frame, 1));
+    TEST_CHECK(PROTO_ERR_OK == proto_parser_next(&own, &frame));
+    TEST_CHECK(frame_ok(&frame, 2));
+    TEST_CHECK(NULL == shared.p_buf);
+    proto_parser_deinit(&own);
+}
+
+static void test_proto_parser_too_long(void) {
+    proto_parser_t parser;
+    proto_frame_t frame;
+    uint8_t buf[PROTO_HDR_SIZE];
+    proto_hdr_t hdr = {.len = CONFIG_PROTO_PAYLOAD_MAX + 1u,
+                       .type = PROTO_TYPE_DATA};
+
+    proto_hdr_encode(buf, &hdr);
+
+    proto_parser_init(&parser);
+    proto_parser_feed(&parser, buf, sizeof(buf));
+    TEST_CHECK(PROTO_ERR_FRAME == proto_parser_next(&parser, &frame));
+    proto_parser_deinit(&parser);
+
+    // NOTE: the same header split between reads
+    proto_parser_init(&parser);
+    proto_parser_feed(&parser, buf, 5);
+    TEST_CHECK(PROTO_ERR_AGAIN == proto_parser_next(&parser, &frame));
+    proto_parser_feed(&parser, &buf[5], sizeof(buf) - 5u);
+    TEST_CHECK(PROTO_ERR_FRAME == proto_parser_next(&parser, &frame));
+    proto_parser_deinit(&parser);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_proto_hdr_roundtrip);
+    TEST_RUN(test_proto_parser_in_place);
+    TEST_RUN(test_proto_parser_byte_by_byte);
+    TEST_RUN(test_proto_parser_moved);
+    TEST_RUN(test_proto_parser_too_long);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,184 @@
+/**
+ * @file      test_ring.c
+ *
+ * @brief     Unit tests - MPSC ring
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ring.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define PRODUCERS ((size_t)4)        /**< Producer threads */
+#define PER_PRODUCER ((size_t)100000) /**< Pushes of every producer */
+
+/** Value pushed by producer, never NULL */
+#define VALUE(producer, num) \
+    ((void*)(uintptr_t)((((uint64_t)(producer)) << 32) | ((num) + 1u)))
+
+/******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static ring_mpsc_t g_ring; /**< Ring shared by producers */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Producer thread: push own sequence, spin while ring is full
+ *
+ * @param p_arg producer index
+ * @return void* NULL
+ */
+static void* producer(void* p_arg) {
+    const size_t idx = (size_t)(uintptr_t)p_arg;
+
+    for (size_t num = 0; num < PER_PRODUCER; num++) {
+        while (RING_ERR_FULL == ring_mpsc_push(&g_ring, VALUE(idx, num))) {
+        }
+    }
+
+    return NULL;
+}
+
+static void test_ring_params(void) {
+    ring_mpsc_t ring;
+
+    TEST_CHECK(RING_ERR_PARAMS == ring_mpsc_init(&ring, 0));
+    TEST_CHECK(RING_ERR_PARAMS == ring_mpsc_init(&ring, 3));
+    TEST_CHECK(RING_ERR_PARAMS == ring_mpsc_init(NULL, 4));
+}
+
+static void test_ring_fifo_full_empty(void) {
+    ring_mpsc_t ring;
+    void* p_data = NULL;
+
+    TEST_CHECK(RING_ERR_OK == ring_mpsc_init(&ring, 4));
+    TEST_CHECK(RING_ERR_EMPTY == ring_mpsc_pop(&ring, &p_data));
+
+    // NOTE: several laps, so cell sequences wrap too
+    for (uintptr_t lap = 0; lap < 3; lap++) {
+        for (uintptr_t num = 1; num <= 4; num++) {
+            TEST_CHECK(RING_ERR_OK ==
+                       ring_mpsc_push(&ring, (void*)(lap * 10 + num)));
+        }
+        TEST_CHECK(RING_ERR_FULL == ring_mpsc_push(&ring, (void*)99));
+
+        for (uintptr_t num = 1; num <= 4; num++) {
+            TEST_CHECK(RING_ERR_OK == ring_mpsc_pop(&ring, &p_data));
+            TEST_CHECK((void*)(lap * 10 + num) == p_data);
+        }
+        TEST_CHECK(RING_ERR_EMPTY == ring_mpsc_pop(&ring, &p_data));
+    }
+
+    ring_mpsc_deinit(&ring);
+}
+
+static void test_ring_producers(void) {
+    pthread_t threads[PRODUCERS];
+    uint64_t next[PRODUCERS] = {0};
+    size_t popped = 0;
+
+    TEST_CHECK(RING_ERR_OK == ring_mpsc_init(&g_ring, 1024));
+    for (size_t idx = 0; idx < PRODUCERS; idx++) {
+        TEST_CHECK(0 == pthread_create(&threads[idx], NULL, producer,
+                                       (void*)(uintptr_t)idx));
+    }
+
+    // NOTE: every producer's values must come out in its own order
+    bool ordered = true;
+    while (popped < (PRODUCERS * PER_PRODUCER)) {
+        void* p_data = NULL;
+        if (RING_ERR_OK != ring_mpsc_pop(&g_ring, &p_data)) {
+            continue;
+        }
+
+        const uint64_t value = (uint64_t)(uintptr_t)p_data;
+        const size_t idx = (size_t)(value >> 32);
+        ordered = ordered && (idx < PRODUCERS) &&
+                  ((value & UINT32_MAX) == (next[idx] + 1u));
+        if (idx < PRODUCERS) {
+            next[idx]++;
+        }
+        popped++;
+    }
+
+    for (size_t idx = 0; idx < PRODUCERS; idx++) {
+        pthread_join(threads[idx], NULL);
+    }
+
+    void* p_data = NULL;
+    TEST_CHECK(ordered);
+    TEST_CHECK(RING_ERR_EMPTY == ring_mpsc_pop(&g_ring, &p_data));
+    ring_mpsc_deinit(&g_ring);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_ring_params);
+    TEST_RUN(test_ring_fifo_full_empty);
+    TEST_RUN(test_ring_producers);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,224 @@
+/**
+ * @file      test_table.c
+ *
+ * @brief     Unit tests - connection table
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "server.h"
+#include "test.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define CAP ((size_t)4) /**< Slots of test table */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Add client with socket fd as its identity
+ */
+static server_client_t* add(server_table_t* p_table, int fd) {
+    server_client_t client;
+
+    memset(&client, 0x00, sizeof(client));
+    client.socket_fd = fd;
+
+    return server_table_add(p_table, &client);
+}
+
+/**
+ * @brief Check that live list holds exactly these fds, positions included
+ */
+static bool live_are(const server_table_t* p_table, const int* p_fds,
+                     size_t count) {
+    if (count != p_table->live_count) {
+        return false;
+    }
+
+    for (uint32_t idx = 0; idx < p_table->live_count; idx++) {
+        const server_client_t* p_client =
+            &p_table->p_slots[p_table->p_live[idx]];
+        if ((p_fds[idx] != p_client->socket_fd) ||
+            (idx != p_client->live_idx)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_table_add_get(void) {
+    server_table_t table;
+
+    TEST_CHECK(SERVER_ERR_OK == server_table_init(&table, CAP));
+
+    for (int fd = 10; fd < 13; fd++) {
+        server_client_t* p_client = add(&table, fd);
+        TEST_CHECK(NULL != p_client);
+
+        // NOTE: first use of slot is generation 0
+        const uint32_t slot = (uint32_t)(fd - 10);
+        TEST_CHECK(SERVER_ID(slot, 0) == p_client->id);
+        TEST_CHECK(p_client == server_table_get(&table, p_client->id));
+    }
+
+    const int fds[] = {10, 11, 12};
+    TEST_CHECK(live_are(&table, fds, 3));
+    TEST_CHECK(NULL == server_table_get(&table, SERVER_ID(3, 0)));
+    TEST_CHECK(NULL == server_table_get(&table, SERVER_ID(CAP, 0)));
+
+    server_table_deinit(&table);
+}
+
+static void test_table_remove_dense(void) {
+    server_table_t table;
+
+    TEST_CHECK(SERVER_ERR_OK == server_table_init(&table, CAP));
+    for (int fd = 10; fd < 13; fd++) {
+        TEST_CHECK(NULL != add(&table, fd));
+    }
+
+    // NOTE: last live slot takes place of removed one
+    server_table_remove(&table, 0);
+    const int fds[] = {12, 11};
+    TEST_CHECK(live_are(&table, fds, 2));
+
+    // NOTE: free slot is not removed twice
+    server_table_remove(&table, 0);
+    TEST_CHECK(live_are(&table, fds, 2));
+
+    server_table_remove(&table, 2);
+    server_table_remove(&table, 1);
+    TEST_CHECK(0 == table.live_count);
+
+    server_table_deinit(&table);
+}
+
+static void test_table_reuse_generation(void) {
+    server_table_t table;
+
+    TEST_CHECK(SERVER_ERR_OK == server_table_init(&table, CAP));
+    TEST_CHECK(NULL != add(&table, 10));
+    const uint64_t old_id = add(&table, 11)->id;
+    TEST_CHECK(NULL != add(&table, 12));
+
+    server_table_remove(&table, SERVER_ID_SLOT(old_id));
+    TEST_CHECK(NULL == server_table_get(&table, old_id));
+
+    // NOTE: freed slot is reused first, with next generation
+    server_client_t* p_client = add(&table, 13);
+    TEST_CHECK(NULL != p_client);
+    TEST_CHECK(SERVER_ID_SLOT(old_id) == SERVER_ID_SLOT(p_client->id));
+    TEST_CHECK(SERVER_ID(SERVER_ID_SLOT(old_id), 1) == p_client->id);
+    TEST_CHECK(NULL == server_table_get(&table, old_id));
+    TEST_CHECK(p_client == server_table_get(&table, p_client->id));
+
+    server_table_deinit(&table);
+}
+
+static void test_table_full(void) {
+    server_table_t table;
+
+    TEST_CHECK(SERVER_ERR_OK == server_table_init(&table, CAP));
+    for (int fd = 10; fd < (10 + (int)CAP); fd++) {
+        TEST_CHECK(NULL != add(&table, fd));
+    }
+    TEST_CHECK(NULL == add(&table, 20));
+    TEST_CHECK(CAP == table.live_count);
+
+    server_table_remove(&table, 1);
+    TEST_CHECK(NULL != add(&table, 20));
+    TEST_CHECK(NULL == add(&table, 21));
+
+    server_table_deinit(&table);
+}
+
+static void test_table_listed_flags(void) {
+    server_table_t table;
+
+    TEST_CHECK(SERVER_ERR_OK == server_table_init(&table, CAP));
+    server_client_t* p_client = add(&table, 10);
+    TEST_CHECK(NULL != p_client);
+
+    // NOTE: slot stays in owner's dirty list after the client is gone
+    p_client->flags |= SERVER_CLIENT_F_DIRTY;
+    server_table_remove(&table, SERVER_ID_SLOT(p_client->id));
+
+    p_client = add(&table, 11);
+    TEST_CHECK(NULL != p_client);
+    TEST_CHECK(0 != (p_client->flags & SERVER_CLIENT_F_DIRTY));
+
+    server_table_deinit(&table);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_table_add_get);
+    TEST_RUN(test_table_remove_dense);
+    TEST_RUN(test_table_reuse_generation);
+    TEST_RUN(test_table_full);
+    TEST_RUN(test_table_listed_flags);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
@@ -0,0 +1,274 @@
+/**
+ * @file      test_topic.c
+ *
+ * @brief     Unit tests - topic routing index
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "test.h"
+#include "topic.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define CAP ((uint32_t)8) /**< Subscribers of test index */
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Subscribe to pattern given as string
+ */
+static int32_t sub(topic_index_t* p_index, uint32_t id, const char* p_pattern) {
+    return topic_subscribe(p_index, id, p_pattern, strlen(p_pattern));
+}
+
+/**
+ * @brief Unsubscribe from pattern given as string
+ */
+static int32_t unsub(topic_index_t* p_index, uint32_t id,
+                     const char* p_pattern) {
+    return topic_unsubscribe(p_index, id, p_pattern, strlen(p_pattern));
+}
+
+/**
+ * @brief Match topic and check that exactly these subscribers are found
+ */
+static bool match_is(topic_index_t* p_index, const char* p_topic,
+                     const uint32_t* p_subs, size_t count) {
+    const uint32_t* p_found = NULL;
+    if (count != topic_match(p_index, p_topic, strlen(p_topic), &p_found)) {
+        return false;
+    }
+
+    // NOTE: order of output is not defined
+    for (size_t idx = 0; idx < count; idx++) {
+        bool found = false;
+        for (size_t pos = 0; pos < count; pos++) {
+            found = found || (p_subs[idx] == p_found[pos]);
+        }
+        if (!found) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void test_topic_exact(void) {
+    topic_index_t index;
+
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.eurusd"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 2, "md.eurusd"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 3, "md.usdjpy"));
+    TEST_CHECK(2 == index.entries);
+
+    const uint32_t eur[] = {1, 2};
+    const uint32_t jpy[] = {3};
+    TEST_CHECK(match_is(&index, "md.eurusd", eur, 2));
+    TEST_CHECK(match_is(&index, "md.usdjpy", jpy, 1));
+    TEST_CHECK(match_is(&index, "md.eur", NULL, 0));
+    TEST_CHECK(match_is(&index, "md.eurusd.x", NULL, 0));
+
+    topic_index_deinit(&index);
+}
+
+static void test_topic_prefix(void) {
+    topic_index_t index;
+
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 2, "md.eur*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 3, "*"));
+    TEST_CHECK(0 == index.entries);
+
+    const uint32_t eur[] = {1, 2, 3};
+    const uint32_t jpy[] = {1, 3};
+    const uint32_t all[] = {3};
+    TEST_CHECK(match_is(&index, "md.eurusd", eur, 3));
+    TEST_CHECK(match_is(&index, "md.eur", eur, 3));
+    TEST_CHECK(match_is(&index, "md.usdjpy", jpy, 2));
+    TEST_CHECK(match_is(&index, "md.", jpy, 2));
+    TEST_CHECK(match_is(&index, "md", all, 1));
+    TEST_CHECK(match_is(&index, "", all, 1));
+
+    topic_index_deinit(&index);
+}
+
+static void test_topic_match_once(void) {
+    topic_index_t index;
+
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+
+    // NOTE: one subscriber, every pattern matches the topic
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 4, "md.eurusd"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 4, "md.*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 4, "md.eur*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 4, "*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 5, "md.*"));
+
+    // NOTE: subscribing twice keeps one record
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 4, "md.*"));
+    TEST_CHECK(4 == index.p_counts[4]);
+
+    const uint32_t subs[] = {4, 5};
+    TEST_CHECK(match_is(&index, "md.eurusd", subs, 2));
+    TEST_CHECK(match_is(&index, "md.eurusd", subs, 2));
+
+    topic_index_deinit(&index);
+}
+
+static void test_topic_unsubscribe_prunes(void) {
+    topic_index_t index;
+
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.eurusd"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.eur*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 2, "md.eur*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 2, "md.*"));
+
+    TEST_CHECK(TOPIC_ERR_NOENT == unsub(&index, 1, "md.*"));
+    TEST_CHECK(TOPIC_ERR_NOENT == unsub(&index, 1, "md.usdjpy"));
+    TEST_CHECK(TOPIC_ERR_NOENT == unsub(&index, 3, "md.eur*"));
+
+    TEST_CHECK(TOPIC_ERR_OK == unsub(&index, 1, "md.eurusd"));
+    TEST_CHECK(0 == index.entries);
+    TEST_CHECK(TOPIC_ERR_NOENT == unsub(&index, 1, "md.eurusd"));
+
+    // NOTE: node shared with other subscriber stays
+    TEST_CHECK(TOPIC_ERR_OK == unsub(&index, 1, "md.eur*"));
+    TEST_CHECK(!topic_is_subscribed(&index, 1));
+    const uint32_t subs[] = {2};
+    TEST_CHECK(match_is(&index, "md.eurusd", subs, 1));
+
+    // NOTE: "md.eur" branch goes, "md." path stays for "md.*"
+    TEST_CHECK(TOPIC_ERR_OK == unsub(&index, 2, "md.eur*"));
+    TEST_CHECK(1 == index.root.kids_count);
+    TEST_CHECK(match_is(&index, "md.eurusd", subs, 1));
+
+    TEST_CHECK(TOPIC_ERR_OK == unsub(&index, 2, "md.*"));
+    TEST_CHECK(0 == index.root.kids_count);
+    TEST_CHECK(match_is(&index, "md.eurusd", NULL, 0));
+    TEST_CHECK(!topic_is_subscribed(&index, 2));
+
+    topic_index_deinit(&index);
+}
+
+static void test_topic_unsubscribe_all(void) {
+    topic_index_t index;
+
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+    // NOTE: zeroed lists of a fresh index are empty
+    TEST_CHECK(!topic_is_subscribed(&index, 0));
+    TEST_CHECK(!topic_is_subscribed(&index, CAP - 1u));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.eurusd"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "md.*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "ref.*"));
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 2, "md.eurusd"));
+    TEST_CHECK(topic_is_subscribed(&index, 1));
+
+    topic_unsubscribe_all(&index, 1);
+    TEST_CHECK(!topic_is_subscribed(&index, 1));
+    TEST_CHECK(0 == index.p_counts[1]);
+    TEST_CHECK(1 == index.entries);
+    TEST_CHECK(0 == index.root.kids_count);
+
+    const uint32_t subs[] = {2};
+    TEST_CHECK(match_is(&index, "md.eurusd", subs, 1));
+    TEST_CHECK(match_is(&index, "ref.x", NULL, 0));
+
+    // NOTE: freed records are reused
+    TEST_CHECK(TOPIC_ERR_OK == sub(&index, 1, "ref.*"));
+    TEST_CHECK(match_is(&index, "ref.x", (const uint32_t[]){1}, 1));
+
+    topic_index_deinit(&index);
+}
+
+static void test_topic_params(void) {
+    topic_index_t index;
+    uint8_t pattern[CONFIG_TOPIC_LEN_MAX + 1];
+
+    memset(pattern, 'a', sizeof(pattern));
+    TEST_CHECK(TOPIC_ERR_PARAMS == topic_index_init(&index, 0));
+    TEST_CHECK(TOPIC_ERR_OK == topic_index_init(&index, CAP));
+    TEST_CHECK(TOPIC_ERR_PARAMS == sub(&index, CAP, "md.*"));
+    TEST_CHECK(TOPIC_ERR_PARAMS ==
+               topic_subscribe(&index, 1, pattern, sizeof(pattern)));
+    TEST_CHECK(TOPIC_ERR_OK ==
+               topic_subscribe(&index, 1, pattern, sizeof(pattern) - 1u));
+    TEST_CHECK(!topic_is_subscribed(&index, CAP));
+
+    topic_index_deinit(&index);
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_topic_exact);
+    TEST_RUN(test_topic_prefix);
+    TEST_RUN(test_topic_match_once);
+    TEST_RUN(test_topic_unsubscribe_prunes);
+    TEST_RUN(test_topic_unsubscribe_all);
+    TEST_RUN(test_topic_params);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/
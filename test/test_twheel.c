@@ -0,0 +1,183 @@
+/**
+ * @file      test_twheel.c
+ *
+ * @brief     Unit tests - hierarchical timing wheel
+ *
+ * @date      2026-10-17
+ *
+ * @par
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2024, Danil Borchevkin
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/** \addtogroup test
+ *  @{
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "twheel.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#define START_MS ((uint64_t)1000003) /**< Wheel start, not slot aligned */
+
+/******************************************************************************
+ * PRIVATE TYPES
+ ******************************************************************************/
+
+/** Timer with its owner data */
+typedef struct test_timer_s {
+    twheel_node_t node; /**< Wheel node */
+    uint64_t at_ms;     /**< Requested expiration */
+    uint64_t fired_ms;  /**< Time of pop, 0 - not fired */
+} test_timer_t;
+
+/******************************************************************************
+ * PUBLIC DATA
+ ******************************************************************************/
+
+unsigned int g_test_failed = 0;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Step clock by 1 ms up to end_ms and record when timers fire
+ *
+ * @param p_wheel pointer to wheel
+ * @param now_ms start time
+ * @param end_ms end time, inclusive
+ */
+static void run(twheel_t* p_wheel, uint64_t now_ms, uint64_t end_ms) {
+    for (; now_ms <= end_ms; now_ms++) {
+        twheel_advance(p_wheel, now_ms);
+
+        twheel_node_t* p_node = NULL;
+        while (NULL != (p_node = twheel_pop(p_wheel))) {
+            test_timer_t* p_timer =
+                (test_timer_t*)((uint8_t*)p_node - offsetof(test_timer_t, node));
+            p_timer->fired_ms = now_ms;
+        }
+    }
+}
+
+static void test_twheel_levels_exact(void) {
+    // NOTE: delays around every level boundary, so timers cascade
+    const uint64_t delays[] = {1,    2,    63,    64,    65,     4095,
+                               4096, 4097, 70000, 262143, 262144, 262151,
+                               300000};
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+    test_timer_t timers[sizeof(delays) / sizeof(delays[0])];
+    twheel_t wheel;
+
+    memset(timers, 0x00, sizeof(timers));
+    TEST_CHECK(TWHEEL_ERR_OK == twheel_init(&wheel, 1, START_MS));
+    TEST_CHECK(-1 == twheel_wait_ms(&wheel, START_MS));
+
+    for (size_t idx = 0; idx < count; idx++) {
+        timers[idx].at_ms = START_MS + delays[idx];
+        twheel_arm(&wheel, &timers[idx].node, timers[idx].at_ms);
+    }
+    TEST_CHECK(count == wheel.count);
+
+    run(&wheel, START_MS, START_MS + delays[count - 1] + 10);
+
+    for (size_t idx = 0; idx < count; idx++) {
+        TEST_CHECK(timers[idx].at_ms == timers[idx].fired_ms);
+        TEST_CHECK(!twheel_armed(&timers[idx].node));
+    }
+    TEST_CHECK(0 == wheel.count);
+}
+
+static void test_twheel_cancel_rearm(void) {
+    test_timer_t cancelled = {0};
+    test_timer_t moved = {0};
+    twheel_t wheel;
+
+    TEST_CHECK(TWHEEL_ERR_OK == twheel_init(&wheel, 1, START_MS));
+    twheel_arm(&wheel, &cancelled.node, START_MS + 100);
+    twheel_arm(&wheel, &moved.node, START_MS + 5000);
+    twheel_cancel(&wheel, &cancelled.node);
+    twheel_cancel(&wheel, &cancelled.node);
+
+    // NOTE: re-arm of armed timer moves it, count stays
+    moved.at_ms = START_MS + 70;
+    twheel_arm(&wheel, &moved.node, moved.at_ms);
+    TEST_CHECK(1 == wheel.count);
+
+    run(&wheel, START_MS, START_MS + 6000);
+    TEST_CHECK(0 == cancelled.fired_ms);
+    TEST_CHECK(moved.at_ms == moved.fired_ms);
+    TEST_CHECK(0 == wheel.count);
+}
+
+static void test_twheel_overdue_and_ticks(void) {
+    test_timer_t overdue = {0};
+    test_timer_t rounded = {0};
+    twheel_t wheel;
+
+    // NOTE: 10 ms ticks, expiration is rounded up to the tick
+    TEST_CHECK(TWHEEL_ERR_OK == twheel_init(&wheel, 10, START_MS));
+    twheel_arm(&wheel, &overdue.node, START_MS - 500);
+    twheel_arm(&wheel, &rounded.node, START_MS + 25);
+    TEST_CHECK(7 == twheel_wait_ms(&wheel, START_MS));
+
+    run(&wheel, START_MS, START_MS + 100);
+    TEST_CHECK(START_MS + 7 == overdue.fired_ms);
+    TEST_CHECK(START_MS + 27 == rounded.fired_ms);
+    TEST_CHECK(-1 == twheel_wait_ms(&wheel, START_MS + 100));
+}
+
+/******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+int main(void) {
+    TEST_RUN(test_twheel_levels_exact);
+    TEST_RUN(test_twheel_cancel_rearm);
+    TEST_RUN(test_twheel_overdue_and_ticks);
+
+    return TEST_EXIT();
+}
+
+/******************************************************************************
+ * END OF SOURCE'S CODE
+ ******************************************************************************/
+/** @}*/